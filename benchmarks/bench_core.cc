@@ -0,0 +1,188 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// IoBuffer, Reactor::Post and DnsResolver cache hits.
+
+#include <uv.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "holytls/core/io_buffer.h"
+#include "holytls/core/reactor.h"
+#include "holytls/util/dns_resolver.h"
+#include "microbench.h"
+
+namespace holytls {
+namespace {
+
+using microbench::DoNotOptimize;
+using microbench::State;
+
+// ============================================================================
+// IoBuffer
+// ============================================================================
+
+// Steady-state appends: the buffer is drained once it holds 1 MiB, as a
+// send buffer is once the socket takes the data
+void BenchIoBufferAppend(State& state, size_t len) {
+  std::vector<uint8_t> data(len, 'x');
+  core::IoBuffer buffer;
+  for (auto _ : state) {
+    buffer.Append(data.data(), data.size());
+    if (buffer.Size() >= 1024 * 1024) {
+      buffer.Skip(buffer.Size());
+    }
+  }
+  DoNotOptimize(buffer.Size());
+  state.SetBytesPerOp(len);
+}
+
+// Fill with 4 KiB reads, then take the body out as one vector
+void BenchIoBufferTakeContiguous(State& state, size_t total) {
+  std::vector<uint8_t> data(4096, 'x');
+  for (auto _ : state) {
+    core::IoBuffer buffer;
+    for (size_t n = 0; n < total; n += data.size()) {
+      buffer.Append(data.data(), std::min(data.size(), total - n));
+    }
+    std::vector<uint8_t> body = buffer.TakeContiguous();
+    DoNotOptimize(body.data());
+  }
+  state.SetBytesPerOp(total);
+}
+
+MICROBENCH("io_buffer/append/64",
+           [](State& state) { BenchIoBufferAppend(state, 64); });
+MICROBENCH("io_buffer/append/1024",
+           [](State& state) { BenchIoBufferAppend(state, 1024); });
+MICROBENCH("io_buffer/append/16384",
+           [](State& state) { BenchIoBufferAppend(state, 16384); });
+MICROBENCH("io_buffer/take_contiguous/16384",
+           [](State& state) { BenchIoBufferTakeContiguous(state, 16384); });
+MICROBENCH("io_buffer/take_contiguous/262144",
+           [](State& state) { BenchIoBufferTakeContiguous(state, 262144); });
+
+// ============================================================================
+// Reactor::Post
+// ============================================================================
+
+// Runs a reactor on its own thread for the duration of a benchmark
+class ReactorThread {
+ public:
+  ReactorThread() {
+    ok_ = reactor_.Initialize();
+    if (ok_) {
+      thread_ = std::thread([this] { reactor_.Run(); });
+      while (!reactor_.running()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  ~ReactorThread() {
+    if (thread_.joinable()) {
+      reactor_.Stop();
+      thread_.join();
+    }
+  }
+
+  bool ok() const { return ok_; }
+  core::Reactor& reactor() { return reactor_; }
+
+ private:
+  core::Reactor reactor_;
+  std::thread thread_;
+  bool ok_ = false;
+};
+
+void WaitFor(const std::atomic<uint64_t>& counter, uint64_t target) {
+  while (counter.load(std::memory_order_acquire) < target) {
+    std::this_thread::yield();
+  }
+}
+
+// Throughput: post from this thread, wait for the reactor every 256 posts
+// so the queue stays bounded
+void BenchReactorPost(State& state) {
+  ReactorThread thread;
+  if (!thread.ok()) {
+    state.SkipWithError("reactor init failed");
+    return;
+  }
+  std::atomic<uint64_t> ran{0};
+  uint64_t posted = 0;
+  for (auto _ : state) {
+    thread.reactor().Post(
+        [&ran] { ran.fetch_add(1, std::memory_order_release); });
+    if (++posted % 256 == 0) {
+      WaitFor(ran, posted);
+    }
+  }
+  WaitFor(ran, posted);
+}
+
+// Latency: post one callback and spin until it has run
+void BenchReactorPostRoundTrip(State& state) {
+  ReactorThread thread;
+  if (!thread.ok()) {
+    state.SkipWithError("reactor init failed");
+    return;
+  }
+  std::atomic<uint64_t> ran{0};
+  uint64_t posted = 0;
+  for (auto _ : state) {
+    thread.reactor().Post(
+        [&ran] { ran.fetch_add(1, std::memory_order_release); });
+    WaitFor(ran, ++posted);
+  }
+}
+
+MICROBENCH("reactor/post_cross_thread", BenchReactorPost);
+MICROBENCH("reactor/post_round_trip", BenchReactorPostRoundTrip);
+
+// ============================================================================
+// DnsResolver
+// ============================================================================
+
+// Cached lookups answer synchronously from ResolveAsync
+void BenchDnsCacheHit(State& state) {
+  uv_loop_t loop;
+  uv_loop_init(&loop);
+  {
+    util::DnsResolver resolver(&loop);
+    const std::string host = "localhost";
+
+    bool resolved = false;
+    resolver.ResolveAsync(
+        host, [&resolved](const std::vector<util::ResolvedAddress>& addresses,
+                          const std::string& /*error*/) {
+          resolved = !addresses.empty();
+        });
+    uv_run(&loop, UV_RUN_DEFAULT);
+    if (!resolved) {
+      state.SkipWithError("cannot resolve localhost");
+    } else {
+      size_t answered = 0;
+      for (auto _ : state) {
+        resolver.ResolveAsync(
+            host, [&answered](const std::vector<util::ResolvedAddress>&,
+                              const std::string&) { ++answered; });
+      }
+      if (answered != state.iterations()) {
+        state.SkipWithError("lookups missed the cache");
+      }
+    }
+  }
+  uv_run(&loop, UV_RUN_DEFAULT);
+  uv_loop_close(&loop);
+}
+
+MICROBENCH("dns_resolver/cache_hit", BenchDnsCacheHit);
+
+}  // namespace
+}  // namespace holytls
@@ -0,0 +1,112 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Response body decompression, one benchmark per codec.
+
+#include <brotli/encode.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "holytls/util/decompressor.h"
+#include "microbench.h"
+
+namespace holytls {
+namespace {
+
+using microbench::DoNotOptimize;
+using microbench::State;
+
+// 64 KiB of JSON-like text with some variety, so ratios look like real APIs
+std::vector<uint8_t> MakeBody() {
+  std::string text;
+  for (int i = 0; text.size() < 65536; ++i) {
+    text += "{\"id\":" + std::to_string(i * 7919 % 100003) +
+            ",\"name\":\"item-" + std::to_string(i) +
+            "\",\"tags\":[\"alpha\",\"beta\"],\"price\":" +
+            std::to_string(i % 97) + "." + std::to_string(i % 10) + "},";
+  }
+  text.resize(65536);
+  return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+const std::vector<uint8_t>& Body() {
+  static const std::vector<uint8_t> body = MakeBody();
+  return body;
+}
+
+// window_bits: 16 + MAX_WBITS for gzip, -MAX_WBITS for raw deflate
+std::vector<uint8_t> CompressZlib(const std::vector<uint8_t>& input,
+                                  int window_bits) {
+  z_stream strm = {};
+  deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8,
+               Z_DEFAULT_STRATEGY);
+  std::vector<uint8_t> out(deflateBound(&strm, input.size()));
+  strm.next_in = const_cast<Bytef*>(input.data());
+  strm.avail_in = static_cast<uInt>(input.size());
+  strm.next_out = out.data();
+  strm.avail_out = static_cast<uInt>(out.size());
+  deflate(&strm, Z_FINISH);
+  out.resize(strm.total_out);
+  deflateEnd(&strm);
+  return out;
+}
+
+std::vector<uint8_t> CompressBrotli(const std::vector<uint8_t>& input) {
+  size_t size = BrotliEncoderMaxCompressedSize(input.size());
+  std::vector<uint8_t> out(size);
+  BrotliEncoderCompress(BROTLI_DEFAULT_QUALITY, BROTLI_DEFAULT_WINDOW,
+                        BROTLI_MODE_TEXT, input.size(), input.data(), &size,
+                        out.data());
+  out.resize(size);
+  return out;
+}
+
+std::vector<uint8_t> CompressZstd(const std::vector<uint8_t>& input) {
+  std::vector<uint8_t> out(ZSTD_compressBound(input.size()));
+  size_t size =
+      ZSTD_compress(out.data(), out.size(), input.data(), input.size(), 3);
+  out.resize(ZSTD_isError(size) ? 0 : size);
+  return out;
+}
+
+// Decode into a reused output vector, as the client does per response
+void BenchDecompress(State& state, util::ContentEncoding encoding,
+                     const std::vector<uint8_t>& compressed) {
+  std::vector<uint8_t> output;
+  if (compressed.empty() ||
+      !util::Decompress(encoding, compressed, output) ||
+      output != Body()) {
+    state.SkipWithError("round trip failed");
+    return;
+  }
+  state.SetCxxHeapOnly();  // zlib, brotli and zstd allocate with malloc
+  for (auto _ : state) {
+    util::Decompress(encoding, compressed, output);
+    DoNotOptimize(output.data());
+  }
+  state.SetBytesPerOp(Body().size());
+}
+
+MICROBENCH("decompress/gzip/65536", [](State& state) {
+  static const auto input = CompressZlib(Body(), 16 + MAX_WBITS);
+  BenchDecompress(state, util::ContentEncoding::kGzip, input);
+});
+MICROBENCH("decompress/deflate/65536", [](State& state) {
+  static const auto input = CompressZlib(Body(), -MAX_WBITS);
+  BenchDecompress(state, util::ContentEncoding::kDeflate, input);
+});
+MICROBENCH("decompress/brotli/65536", [](State& state) {
+  static const auto input = CompressBrotli(Body());
+  BenchDecompress(state, util::ContentEncoding::kBrotli, input);
+});
+MICROBENCH("decompress/zstd/65536", [](State& state) {
+  static const auto input = CompressZstd(Body());
+  BenchDecompress(state, util::ContentEncoding::kZstd, input);
+});
+
+}  // namespace
+}  // namespace holytls
@@ -0,0 +1,241 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// H2Session request encoding and response decoding.
+//
+// Requests are encoded into the client session and the output discarded.
+// For decoding, a batch of responses is recorded once from an nghttp2
+// server session and replayed into fresh client sessions: stream ids and
+// HPACK state are deterministic, so the bytes match what a live server
+// would send.
+
+#include <nghttp2/nghttp2.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "holytls/http2/chrome_h2_profile.h"
+#include "holytls/http2/h2_session.h"
+#include "microbench.h"
+
+namespace holytls {
+namespace {
+
+using microbench::DoNotOptimize;
+using microbench::State;
+
+// Streams per client session before it is replaced (outside the timing)
+constexpr size_t kBatch = 512;
+
+constexpr uint8_t kResponseBody[64] = {};
+
+http2::H2Headers MakeRequest() {
+  http2::H2Headers headers = http2::H2Headers::ForRequest(
+      "GET", "https://www.example.com/api/v1/items?page=2");
+  headers.Add("sec-ch-ua", "\"Chromium\";v=\"143\", \"Not A(Brand\";v=\"24\"");
+  headers.Add("sec-ch-ua-mobile", "?0");
+  headers.Add("sec-ch-ua-platform", "\"Windows\"");
+  headers.Add("user-agent",
+              "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 "
+              "(KHTML, like Gecko) Chrome/143.0.0.0 Safari/537.36");
+  headers.Add("accept", "application/json, text/plain, */*");
+  headers.Add("accept-encoding", "gzip, deflate, br, zstd");
+  headers.Add("accept-language", "en-US,en;q=0.9");
+  headers.Add("cookie", "session=abc123; theme=dark");
+  return headers;
+}
+
+std::unique_ptr<http2::H2Session> NewClient() {
+  auto session = std::make_unique<http2::H2Session>(
+      http2::GetChromeH2Profile(ChromeVersion::kLatest),
+      http2::H2SessionCallbacks{});
+  if (!session->Initialize()) {
+    return nullptr;
+  }
+  return session;
+}
+
+// Drain pending output, optionally keeping it
+void Flush(http2::H2Session* session, std::vector<uint8_t>* out) {
+  while (true) {
+    auto [data, len] = session->GetPendingData();
+    if (len == 0) {
+      break;
+    }
+    if (out != nullptr) {
+      out->insert(out->end(), data, data + len);
+    }
+    session->DataSent(len);
+  }
+}
+
+int32_t Submit(http2::H2Session* session, const http2::H2Headers& headers,
+               size_t* closed) {
+  http2::H2StreamCallbacks callbacks;
+  callbacks.on_headers = [](int32_t, const http2::PackedHeaders& h) {
+    DoNotOptimize(h);
+  };
+  callbacks.on_data = [](int32_t, const uint8_t* data, size_t) {
+    DoNotOptimize(data);
+  };
+  callbacks.on_close = [closed](int32_t, uint32_t) { ++*closed; };
+  return session->SubmitRequest(headers, std::move(callbacks));
+}
+
+// ============================================================================
+// Recorded server responses
+// ============================================================================
+
+// Server half: answers every request with 200 and a 64-byte body
+struct Responder {
+  nghttp2_session* session = nullptr;
+
+  static ssize_t ReadBody(nghttp2_session*, int32_t, uint8_t* buf,
+                          size_t length, uint32_t* data_flags,
+                          nghttp2_data_source*, void*) {
+    size_t n = std::min(length, sizeof(kResponseBody));
+    std::memcpy(buf, kResponseBody, n);
+    *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+    return static_cast<ssize_t>(n);
+  }
+
+  static int OnFrameRecv(nghttp2_session* session, const nghttp2_frame* frame,
+                         void*) {
+    if (frame->hd.type == NGHTTP2_HEADERS &&
+        (frame->hd.flags & NGHTTP2_FLAG_END_STREAM) != 0) {
+      nghttp2_nv nva[] = {
+          {(uint8_t*)":status", (uint8_t*)"200", 7, 3, NGHTTP2_NV_FLAG_NONE},
+          {(uint8_t*)"content-type", (uint8_t*)"application/json", 12, 16,
+           NGHTTP2_NV_FLAG_NONE},
+          {(uint8_t*)"content-length", (uint8_t*)"64", 14, 2,
+           NGHTTP2_NV_FLAG_NONE},
+          {(uint8_t*)"server", (uint8_t*)"bench", 6, 5, NGHTTP2_NV_FLAG_NONE},
+      };
+      nghttp2_data_provider provider;
+      provider.source.ptr = nullptr;
+      provider.read_callback = ReadBody;
+      nghttp2_submit_response(session, frame->hd.stream_id, nva,
+                              sizeof(nva) / sizeof(nva[0]), &provider);
+    }
+    return 0;
+  }
+
+  Responder() {
+    nghttp2_session_callbacks* callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+                                                         OnFrameRecv);
+    nghttp2_session_server_new(&session, callbacks, nullptr);
+    nghttp2_session_callbacks_del(callbacks);
+    nghttp2_submit_settings(session, NGHTTP2_FLAG_NONE, nullptr, 0);
+  }
+  ~Responder() { nghttp2_session_del(session); }
+
+  // Feed client bytes and collect the reply
+  std::vector<uint8_t> Exchange(const std::vector<uint8_t>& in) {
+    nghttp2_session_mem_recv(session, in.data(), in.size());
+    std::vector<uint8_t> out;
+    const uint8_t* data;
+    ssize_t n;
+    while ((n = nghttp2_session_mem_send(session, &data)) > 0) {
+      out.insert(out.end(), data, data + n);
+    }
+    return out;
+  }
+};
+
+// Server bytes for streams 1, 3, ... of a fresh client session; entry i
+// completes request i (entry 0 also carries the server SETTINGS)
+std::vector<std::vector<uint8_t>> RecordResponses(
+    const http2::H2Headers& request) {
+  std::vector<std::vector<uint8_t>> responses;
+  auto client = NewClient();
+  if (client == nullptr) {
+    return responses;
+  }
+  Responder responder;
+  size_t closed = 0;
+  std::vector<uint8_t> out;
+  Flush(client.get(), &out);  // Preface
+  for (size_t i = 0; i < kBatch; ++i) {
+    Submit(client.get(), request, &closed);
+    Flush(client.get(), &out);
+    responses.push_back(responder.Exchange(out));
+    out.clear();
+    // Close the stream so the client stays under the concurrency limit
+    client->Receive(responses.back().data(), responses.back().size());
+  }
+  if (closed != kBatch) {
+    responses.clear();
+  }
+  return responses;
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+void BenchH2EncodeRequest(State& state) {
+  http2::H2Headers request = MakeRequest();
+  std::unique_ptr<http2::H2Session> client;
+  size_t closed = 0;
+  size_t submitted = kBatch;
+  state.SetCxxHeapOnly();  // nghttp2 allocates with malloc
+  for (auto _ : state) {
+    if (submitted == kBatch) {
+      state.PauseTiming();
+      client = NewClient();
+      Flush(client.get(), nullptr);
+      submitted = 0;
+      state.ResumeTiming();
+    }
+    int32_t stream_id = Submit(client.get(), request, &closed);
+    Flush(client.get(), nullptr);
+    DoNotOptimize(stream_id);
+    ++submitted;
+  }
+}
+
+void BenchH2DecodeResponse(State& state) {
+  http2::H2Headers request = MakeRequest();
+  static const auto responses = RecordResponses(request);
+  if (responses.size() != kBatch) {
+    state.SkipWithError("recording responses failed");
+    return;
+  }
+
+  std::unique_ptr<http2::H2Session> client;
+  size_t closed = 0;
+  size_t received = kBatch;
+  state.SetCxxHeapOnly();  // nghttp2 allocates with malloc
+  for (auto _ : state) {
+    if (received == kBatch) {
+      state.PauseTiming();
+      client = NewClient();
+      for (size_t i = 0; i < kBatch; ++i) {
+        Submit(client.get(), request, &closed);
+      }
+      Flush(client.get(), nullptr);
+      received = 0;
+      state.ResumeTiming();
+    }
+    const std::vector<uint8_t>& bytes = responses[received];
+    client->Receive(bytes.data(), bytes.size());
+    Flush(client.get(), nullptr);  // WINDOW_UPDATE / SETTINGS ACK
+    ++received;
+  }
+
+  // Every replayed response must have completed its stream
+  if (closed < state.iterations()) {
+    state.SkipWithError("responses did not close their streams");
+  }
+}
+
+MICROBENCH("h2_session/encode_request", BenchH2EncodeRequest);
+MICROBENCH("h2_session/decode_response", BenchH2DecodeResponse);
+
+}  // namespace
+}  // namespace holytls
@@ -0,0 +1,147 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Header packing, URL parsing, cookie and Alt-Svc lookups.
+
+#include <holytls/http/alt_svc_cache.h>
+#include <holytls/http/cookie_jar.h>
+#include <holytls/util/url_parser.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "holytls/http2/header_ids.h"
+#include "holytls/http2/packed_headers.h"
+#include "microbench.h"
+
+namespace holytls {
+namespace {
+
+using microbench::DoNotOptimize;
+using microbench::State;
+
+// Typical response header block: known names plus a few custom ones
+constexpr std::pair<std::string_view, std::string_view> kResponseHeaders[] = {
+    {"content-type", "application/json; charset=utf-8"},
+    {"content-length", "1432"},
+    {"date", "Sat, 17 Oct 2026 12:00:00 GMT"},
+    {"server", "nginx"},
+    {"cache-control", "private, max-age=0"},
+    {"etag", "\"5d8c72a5edda8d6a\""},
+    {"vary", "Accept-Encoding"},
+    {"content-encoding", "br"},
+    {"strict-transport-security", "max-age=31536000; includeSubDomains"},
+    {"x-request-id", "7f3a9c2e-1b4d-4e8f-9a6b-2c5d8e1f4a7b"},
+    {"x-frame-options", "SAMEORIGIN"},
+    {"set-cookie", "session=abc123; Path=/; Secure; HttpOnly"},
+};
+
+// ============================================================================
+// PackedHeaders / header ids
+// ============================================================================
+
+void BenchPackedHeadersBuild(State& state) {
+  http2::PackedHeadersBuilder builder;
+  for (auto _ : state) {
+    builder.SetStatus("200");
+    for (const auto& [name, value] : kResponseHeaders) {
+      builder.Add(name, value);
+    }
+    http2::PackedHeaders headers = builder.Build();
+    DoNotOptimize(headers);
+  }
+}
+
+// One lookup per header in the block, known and custom mixed
+void BenchLookupHeaderId(State& state) {
+  for (auto _ : state) {
+    for (const auto& [name, value] : kResponseHeaders) {
+      DoNotOptimize(http2::LookupHeaderId(name));
+    }
+  }
+}
+
+MICROBENCH("packed_headers/build", BenchPackedHeadersBuild);
+MICROBENCH("header_ids/lookup", BenchLookupHeaderId);
+
+// ============================================================================
+// URL parsing
+// ============================================================================
+
+void BenchParseUrl(State& state) {
+  constexpr std::string_view kUrl =
+      "https://api.example.com:8443/v1/items/42?page=2&sort=desc#details";
+  util::ParsedUrl parsed;
+  for (auto _ : state) {
+    bool ok = util::ParseUrl(kUrl, &parsed);
+    DoNotOptimize(ok);
+  }
+}
+
+MICROBENCH("url_parser/parse", BenchParseUrl);
+
+// ============================================================================
+// CookieJar
+// ============================================================================
+
+// Jar holding cookies for several sites; the lookup matches 5 of them
+void BenchCookieJarGetHeader(State& state) {
+  http::CookieJar jar;
+  for (int site = 0; site < 8; ++site) {
+    std::string url = "https://site" + std::to_string(site) + ".example/";
+    for (int i = 0; i < 5; ++i) {
+      jar.ProcessSetCookie(url, "c" + std::to_string(i) + "=value" +
+                                    std::to_string(i) + "; Path=/; Secure");
+    }
+  }
+  for (auto _ : state) {
+    std::string header = jar.GetCookieHeader("https://site3.example/page");
+    DoNotOptimize(header.data());
+  }
+}
+
+MICROBENCH("cookie_jar/get_cookie_header", BenchCookieJarGetHeader);
+
+// ============================================================================
+// AltSvcCache
+// ============================================================================
+
+void BenchAltSvcLookupHit(State& state) {
+  http::AltSvcCache cache;
+  for (int i = 0; i < 64; ++i) {
+    cache.ProcessAltSvc("host" + std::to_string(i) + ".example", 443,
+                        "h3=\":443\"; ma=86400");
+  }
+  for (auto _ : state) {
+    DoNotOptimize(cache.HasHttp3Support("host17.example", 443));
+  }
+}
+
+void BenchAltSvcLookupMiss(State& state) {
+  http::AltSvcCache cache;
+  for (int i = 0; i < 64; ++i) {
+    cache.ProcessAltSvc("host" + std::to_string(i) + ".example", 443,
+                        "h3=\":443\"; ma=86400");
+  }
+  for (auto _ : state) {
+    DoNotOptimize(cache.HasHttp3Support("unknown.example", 443));
+  }
+}
+
+void BenchAltSvcGetEndpoint(State& state) {
+  http::AltSvcCache cache;
+  cache.ProcessAltSvc("www.example.com", 443,
+                      "h3=\":443\"; ma=86400, h3-29=\":443\"; ma=86400");
+  for (auto _ : state) {
+    auto endpoint = cache.GetHttp3Endpoint("www.example.com", 443);
+    DoNotOptimize(endpoint);
+  }
+}
+
+MICROBENCH("alt_svc_cache/has_http3_hit", BenchAltSvcLookupHit);
+MICROBENCH("alt_svc_cache/has_http3_miss", BenchAltSvcLookupMiss);
+MICROBENCH("alt_svc_cache/get_http3_endpoint", BenchAltSvcGetEndpoint);
+
+}  // namespace
+}  // namespace holytls
@@ -0,0 +1,262 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Microbenchmark runner and counting allocator.
+//
+// Usage: ./holytls_microbench [--filter SUBSTR] [--min-time SECONDS] [--list]
+
+#include "microbench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <print>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// Counting allocator
+// ============================================================================
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_allocated_bytes{0};
+
+void* CountedAlloc(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* CountedAlignedAlloc(size_t size, std::align_val_t align) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  size_t alignment = static_cast<size_t>(align);
+  size = (size + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+  return _aligned_malloc(size == 0 ? alignment : size, alignment);
+#else
+  return std::aligned_alloc(alignment, size == 0 ? alignment : size);
+#endif
+}
+
+void AlignedFree(void* ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  void* ptr = CountedAlloc(size);
+  if (ptr == nullptr) {
+    std::abort();  // Built without exceptions
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) { return ::operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return CountedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return CountedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+  void* ptr = CountedAlignedAlloc(size, align);
+  if (ptr == nullptr) {
+    std::abort();  // Built without exceptions
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+  return ::operator new(size, align);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+
+namespace holytls {
+namespace microbench {
+
+AllocCounters ReadAllocCounters() {
+  AllocCounters counters;
+  counters.allocations = g_allocations.load(std::memory_order_relaxed);
+  counters.bytes = g_allocated_bytes.load(std::memory_order_relaxed);
+  return counters;
+}
+
+void State::ResumeTiming() {
+  start_allocs_ = ReadAllocCounters();
+  start_ = std::chrono::steady_clock::now();
+}
+
+void State::PauseTiming() {
+  elapsed_ += std::chrono::steady_clock::now() - start_;
+  AllocCounters now = ReadAllocCounters();
+  allocs_.allocations += now.allocations - start_allocs_.allocations;
+  allocs_.bytes += now.bytes - start_allocs_.bytes;
+}
+
+namespace {
+
+struct Benchmark {
+  std::string name;
+  BenchFunction function;
+};
+
+std::vector<Benchmark>& Registry() {
+  static std::vector<Benchmark> registry;
+  return registry;
+}
+
+struct RunOptions {
+  std::string filter;      // Substring of the benchmark name
+  double min_time = 0.2;   // Seconds per measured run
+};
+
+constexpr uint64_t kMaxIterations = 1'000'000'000;
+
+// Set once a benchmark printed C++-heap-only allocation columns
+bool g_cxx_heap_only_shown = false;
+
+void RunBenchmark(const Benchmark& bench, const RunOptions& options) {
+  auto min_time = std::chrono::duration<double>(options.min_time);
+
+  // Grow the iteration count until the run is long enough to trust
+  uint64_t iterations = 1;
+  while (true) {
+    State state(iterations);
+    bench.function(state);
+    if (!state.error().empty()) {
+      std::println("{:<40} ERROR: {}", bench.name, state.error());
+      return;
+    }
+
+    auto elapsed = state.elapsed();
+    if (elapsed >= min_time || iterations >= kMaxIterations) {
+      double n = static_cast<double>(iterations);
+      double ns_per_op = static_cast<double>(elapsed.count()) / n;
+      AllocCounters allocs = state.allocs();
+      // '*': allocations made through malloc are not in the counts
+      const char* mark = state.cxx_heap_only() ? "*" : " ";
+      g_cxx_heap_only_shown |= state.cxx_heap_only();
+      std::print("{:<40} {:>12.1f} {:>12} {:>10.2f}{} {:>12.1f}{}",
+                 bench.name, ns_per_op, iterations,
+                 static_cast<double>(allocs.allocations) / n, mark,
+                 static_cast<double>(allocs.bytes) / n, mark);
+      if (state.bytes_per_op() > 0 && elapsed.count() > 0) {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        std::print(" {:>10.1f} MiB/s",
+                   static_cast<double>(state.bytes_per_op()) * n /
+                       (1024.0 * 1024.0) / seconds);
+      }
+      std::println("");
+      return;
+    }
+
+    // Aim 40% past the target so the next run is usually the last
+    double scale = 10.0;
+    if (elapsed.count() > 0) {
+      scale = std::clamp(min_time / elapsed * 1.4, 1.5, 10.0);
+    }
+    iterations = std::min<uint64_t>(
+        kMaxIterations,
+        static_cast<uint64_t>(static_cast<double>(iterations) * scale) + 1);
+  }
+}
+
+void PrintUsage(const char* program) {
+  std::println(
+      "Usage: {} [options]\n"
+      "\n"
+      "Options:\n"
+      "  --filter SUBSTR    Only run benchmarks whose name contains SUBSTR\n"
+      "  --min-time SECONDS Minimum measured time per benchmark (default: "
+      "0.2)\n"
+      "  --list             List benchmarks\n"
+      "  --help             Show this help",
+      program);
+}
+
+}  // namespace
+
+bool Register(std::string name, BenchFunction function) {
+  Registry().push_back({std::move(name), std::move(function)});
+  return true;
+}
+
+}  // namespace microbench
+}  // namespace holytls
+
+int main(int argc, char* argv[]) {
+  using namespace holytls::microbench;
+
+  RunOptions options;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--help") == 0 ||
+        std::strcmp(argv[i], "-h") == 0) {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+    if (std::strcmp(argv[i], "--list") == 0) {
+      for (const Benchmark& bench : Registry()) {
+        std::println("{}", bench.name);
+      }
+      return 0;
+    }
+    if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      options.min_time = std::atof(argv[++i]);
+    } else {
+      std::println(stderr, "Unknown option: {}", argv[i]);
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  std::println("{:<40} {:>12} {:>12} {:>10}  {:>12}", "Benchmark", "ns/op",
+               "iterations", "allocs/op", "bytes/op");
+  std::println("{}", std::string(92, '-'));
+  for (const Benchmark& bench : Registry()) {
+    if (!options.filter.empty() &&
+        bench.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    RunBenchmark(bench, options);
+  }
+  if (g_cxx_heap_only_shown) {
+    std::println(
+        "\n* C++ heap only: malloc calls from C libraries (nghttp2, zlib, "
+        "brotli, zstd) are not counted");
+  }
+  return 0;
+}
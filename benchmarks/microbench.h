@@ -0,0 +1,154 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Minimal microbenchmark harness.
+//
+// Benchmarks register a function taking a State and loop over it:
+//
+//   void BenchFoo(microbench::State& state) {
+//     Setup();                 // Not timed
+//     for (auto _ : state) {   // Timed
+//       microbench::DoNotOptimize(Foo());
+//     }
+//   }
+//   MICROBENCH("foo", BenchFoo);
+//
+// The runner grows the iteration count until a run takes at least
+// --min-time, then reports time, heap allocations and allocated bytes per
+// operation. Allocations are counted by replacing the global operator new
+// (microbench.cc), so they include every thread, not just the benchmark's.
+// C libraries that call malloc directly (nghttp2, zlib, brotli, zstd) are
+// not counted; benchmarks that use them call SetCxxHeapOnly() and their
+// allocation columns are marked as such.
+
+#ifndef HOLYTLS_BENCHMARKS_MICROBENCH_H_
+#define HOLYTLS_BENCHMARKS_MICROBENCH_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace holytls {
+namespace microbench {
+
+// Heap activity since process start (all threads)
+struct AllocCounters {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+};
+
+AllocCounters ReadAllocCounters();
+
+class State {
+ public:
+  explicit State(uint64_t iterations) : iterations_(iterations) {}
+
+  // Range-for support: timing starts at begin() and stops at the end
+  struct Sentinel {};
+  struct [[maybe_unused]] Value {};  // No unused-variable warning for `_`
+  class Iterator {
+   public:
+    explicit Iterator(State* state) : state_(state) {}
+    bool operator!=(Sentinel) {
+      if (state_->remaining_ == 0) {
+        state_->PauseTiming();
+        return false;
+      }
+      return true;
+    }
+    void operator++() { --state_->remaining_; }
+    Value operator*() const { return Value{}; }
+
+   private:
+    State* state_;
+  };
+
+  Iterator begin() {
+    remaining_ = iterations_;
+    elapsed_ = std::chrono::nanoseconds(0);
+    allocs_ = AllocCounters{};
+    ResumeTiming();
+    return Iterator(this);
+  }
+  Sentinel end() { return Sentinel{}; }
+
+  uint64_t iterations() const { return iterations_; }
+
+  // Exclude work inside the loop (e.g. per-batch setup) from the results
+  void PauseTiming();
+  void ResumeTiming();
+
+  // Bytes handled per iteration, for a throughput column
+  void SetBytesPerOp(uint64_t bytes) { bytes_per_op_ = bytes; }
+  uint64_t bytes_per_op() const { return bytes_per_op_; }
+
+  // The code under test also allocates through malloc, which the counters
+  // miss: the allocation columns cover the C++ heap only
+  void SetCxxHeapOnly() { cxx_heap_only_ = true; }
+  bool cxx_heap_only() const { return cxx_heap_only_; }
+
+  // Mark the run as failed (e.g. setup could not complete)
+  void SkipWithError(std::string message) { error_ = std::move(message); }
+  const std::string& error() const { return error_; }
+
+  // Results, valid once the loop has finished
+  std::chrono::nanoseconds elapsed() const { return elapsed_; }
+  AllocCounters allocs() const { return allocs_; }
+
+ private:
+  uint64_t iterations_;
+  uint64_t remaining_ = 0;
+  uint64_t bytes_per_op_ = 0;
+  bool cxx_heap_only_ = false;
+  std::string error_;
+
+  std::chrono::steady_clock::time_point start_;
+  AllocCounters start_allocs_;
+  std::chrono::nanoseconds elapsed_{0};
+  AllocCounters allocs_;
+};
+
+using BenchFunction = std::function<void(State&)>;
+
+// Add a benchmark to the global registry. Returns true so it can
+// initialize a static (see MICROBENCH).
+bool Register(std::string name, BenchFunction function);
+
+// Keep `value` (and everything it points to) from being optimized away
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Force pending writes to memory
+inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : : "memory");
+#else
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+}  // namespace microbench
+}  // namespace holytls
+
+#define MICROBENCH_CONCAT_INNER(a, b) a##b
+#define MICROBENCH_CONCAT(a, b) MICROBENCH_CONCAT_INNER(a, b)
+
+// Register `function` under `name` at static-initialization time
+#define MICROBENCH(name, function)                              \
+  [[maybe_unused]] static const bool MICROBENCH_CONCAT(        \
+      microbench_registered_, __COUNTER__) =                    \
+      ::holytls::microbench::Register(name, function)
+
+#endif  // HOLYTLS_BENCHMARKS_MICROBENCH_H_
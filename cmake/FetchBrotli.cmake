@@ -22,5 +22,6 @@ FetchContent_MakeAvailable(brotli)
 # brotli builds: brotlicommon, brotlidec, brotlienc (static by default with BUNDLED_MODE)
 add_library(brotli::brotlidec ALIAS brotlidec)
 add_library(brotli::brotlicommon ALIAS brotlicommon)
+add_library(brotli::brotlienc ALIAS brotlienc)  # Benchmarks only
 
 message(STATUS "brotli configured (brotli::brotlidec)")
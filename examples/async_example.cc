@@ -47,6 +47,10 @@ Task<void> RunAll(AsyncClient& client) {
     std::println("Request 2: {} ({} bytes)", result3.value().status_code,
                  result3.value().body.size());
     std::println("  Response: {}", result3.value().body_string());
+    const Timing& timing = result3.value().timing;
+    std::println("  Reused connection: {}, TTFB: {} us, total: {} us",
+                 timing.connection_reused, timing.ttfb.count(),
+                 timing.total.count());
   } else {
     std::println("Request 2 failed: {}", result3.error().message);
   }
@@ -59,6 +63,10 @@ Task<void> RunAll(AsyncClient& client) {
   std::println("Requests failed: {}", stats.requests_failed);
   std::println("Connections created: {}", stats.connections_created);
   std::println("Connections reused: {}", stats.connections_reused);
+  std::println("TLS handshake p50/p99: {:.1f}/{:.1f} ms", stats.tls.p50_ms,
+               stats.tls.p99_ms);
+  std::println("TTFB p50/p99: {:.1f}/{:.1f} ms", stats.ttfb.p50_ms,
+               stats.ttfb.p99_ms);
 
   std::println("\n=== Done ===");
 }
@@ -37,8 +37,8 @@ Task<void> RunRequest(AsyncClient& client, const std::string& url) {
     std::println("\nResponse Status: {}", response.status_code);
 
     std::println("Headers:");
-    for (const auto& header : response.headers) {
-      std::println("  {}: {}", header.name, header.value);
+    for (auto [name, value] : response.headers) {
+      std::println("  {}: {}", name, value);
     }
 
     std::println("\nBody size: {} bytes", response.body.size());
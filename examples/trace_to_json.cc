@@ -0,0 +1,32 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Tool: convert a binary trace file to Chrome trace-event JSON
+//
+// Record a trace by building with -DHOLYTLS_TRACING=ON, setting
+// ClientConfig::trace.ring_capacity and saving HttpClient::CollectTrace()
+// with core::WriteTraceFile. Open the JSON in https://ui.perfetto.dev or
+// chrome://tracing.
+//
+// Usage: ./trace_to_json trace.bin > trace.json
+
+#include <print>
+#include <vector>
+
+#include "holytls/core/trace.h"
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::println(stderr, "Usage: {} <trace.bin>", argv[0]);
+    return 1;
+  }
+
+  std::vector<holytls::core::TraceRecord> records;
+  if (!holytls::core::ReadTraceFile(argv[1], &records)) {
+    std::println(stderr, "Failed to read trace file: {}", argv[1]);
+    return 1;
+  }
+
+  std::println("{}", holytls::core::TraceToChromeJson(records));
+  return 0;
+}
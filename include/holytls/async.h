@@ -4,10 +4,18 @@
 #ifndef HOLYTLS_ASYNC_H_
 #define HOLYTLS_ASYNC_H_
 
+#include <algorithm>
+#include <atomic>
 #include <coroutine>
-#include <functional>
+#include <cstddef>
+#include <cstdlib>
 #include <memory>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "holytls/client.h"
 #include "holytls/error.h"
@@ -17,53 +25,197 @@ namespace holytls {
 
 namespace detail {
 
-// Shared state for callback-based awaitable
-// Must be heap-allocated to survive across await suspension
-template <typename T>
-struct CallbackState {
-  std::optional<AsyncResult<T>> result;
-  std::coroutine_handle<> continuation;
+// Awaitable for HttpClient::SendAsync
+// Converts SendAsync(request, callback) into co_await SendAsync(request).
+//
+// The result is stored in the awaitable itself, which lives in the awaiting
+// coroutine's frame while it is suspended, and the completion callback only
+// captures `this` (fits std::function's inline storage). Awaiting therefore
+// allocates nothing of its own. The coroutine resumes directly on the
+// reactor thread that completed the request.
+class RequestAwaitable {
+ public:
+  RequestAwaitable(HttpClient* client, Request request)
+      : client_(client), request_(std::move(request)) {}
+
+  bool await_ready() noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> continuation) {
+    continuation_ = continuation;
+
+    // The callback may run (and resume the coroutine, destroying *this)
+    // before SendAsync returns; nothing may touch members after this call
+    client_->SendAsync(std::move(request_),
+                       [this](Response response, Error error) {
+                         if (error) {
+                           result_.emplace(std::move(error));
+                         } else {
+                           result_.emplace(std::move(response));
+                         }
+                         continuation_.resume();
+                       });
+  }
+
+  AsyncResult<Response> await_resume() { return std::move(*result_); }
+
+ private:
+  HttpClient* client_;
+  Request request_;
+  std::optional<AsyncResult<Response>> result_;
+  std::coroutine_handle<> continuation_;
 };
 
-// Awaitable that wraps a callback-based async operation
-// Converts SendAsync(request, callback) into co_await SendAsync(request)
-template <typename T>
-class CallbackAwaitable {
+// Counts children still running; the last one to finish resumes the
+// awaiting coroutine. Starts at children + 1 so that children completing
+// while the rest are still being started can't resume it early.
+class Latch {
  public:
-  using ResultType = AsyncResult<T>;
-  using CallbackType = std::function<void(std::function<void(T, Error)>)>;
+  explicit Latch(size_t count) : remaining_(count + 1) {}
 
-  explicit CallbackAwaitable(CallbackType initiator)
-      : initiator_(std::move(initiator)),
-        state_(std::make_shared<CallbackState<T>>()) {}
+  // Called by each child when it finishes (any thread)
+  void Arrive() {
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      parent_.resume();
+    }
+  }
 
-  bool await_ready() noexcept { return false; }
+  // co_await latch.Start(fn): records the awaiting coroutine, runs fn() to
+  // start the children, then suspends unless they all finished already
+  template <typename StartFn>
+  auto Start(StartFn start) {
+    struct Awaiter {
+      Latch* latch;
+      StartFn start;
 
-  void await_suspend(std::coroutine_handle<> continuation) {
-    state_->continuation = continuation;
-
-    // Capture state by shared_ptr so it survives after this object is destroyed
-    auto state = state_;
-    initiator_([state](T value, Error error) mutable {
-      if (error) {
-        state->result = ResultType(std::move(error));
-      } else {
-        state->result = ResultType(std::move(value));
+      bool await_ready() noexcept { return false; }
+
+      bool await_suspend(std::coroutine_handle<> parent) {
+        latch->parent_ = parent;
+        start();
+        return latch->remaining_.fetch_sub(1, std::memory_order_acq_rel) > 1;
       }
-      if (state->continuation) {
-        // Resume the coroutine - this is called from reactor thread
-        state->continuation.resume();
+
+      void await_resume() noexcept {}
+    };
+    return Awaiter{this, std::move(start)};
+  }
+
+ private:
+  std::atomic<size_t> remaining_;
+  std::coroutine_handle<> parent_;
+};
+
+template <typename T>
+Detached WhenAllChild(const Task<T>& task, std::optional<T>* out,
+                      Latch* latch) {
+  out->emplace(co_await task);
+  latch->Arrive();
+}
+
+inline Detached WhenAllChild(const Task<void>& task, Latch* latch) {
+  co_await task;
+  latch->Arrive();
+}
+
+template <typename... Ts, size_t... I>
+std::tuple<Ts...> TakeAll(std::tuple<std::optional<Ts>...>& results,
+                          std::index_sequence<I...>) {
+  return std::tuple<Ts...>(std::move(*std::get<I>(results))...);
+}
+
+}  // namespace detail
+
+// Result of WhenAny: which task finished first and its value
+template <typename T>
+struct WhenAnyResult {
+  size_t index;
+  T value;
+};
+
+namespace detail {
+
+// Shared by WhenAny and its children. Heap-allocated because the children
+// outlive the WhenAny that started them: the first to finish wins and the
+// rest run to completion in the background (in-flight requests can't be
+// cancelled). Freed by whoever drops the last reference.
+template <typename T>
+class WhenAnyState {
+ public:
+  explicit WhenAnyState(std::vector<Task<T>> tasks)
+      : tasks_(std::move(tasks)), refs_(tasks_.size() + 1) {}
+
+  // Non-copyable, non-movable
+  WhenAnyState(const WhenAnyState&) = delete;
+  WhenAnyState& operator=(const WhenAnyState&) = delete;
+  WhenAnyState(WhenAnyState&&) = delete;
+  WhenAnyState& operator=(WhenAnyState&&) = delete;
+
+  // Starts every child, then suspends unless one already won
+  auto Start() {
+    struct Awaiter {
+      WhenAnyState* state;
+
+      bool await_ready() noexcept { return false; }
+
+      bool await_suspend(std::coroutine_handle<> parent) {
+        state->parent_ = parent;
+        for (size_t i = 0; i < state->tasks_.size(); ++i) {
+          Child(state->tasks_[i], i, state);
+        }
+        return !state->Signal();
       }
-    });
+
+      void await_resume() noexcept {}
+    };
+    return Awaiter{this};
   }
 
-  ResultType await_resume() { return std::move(*state_->result); }
+  WhenAnyResult<T> TakeResult() { return std::move(*result_); }
+
+  void Release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
 
  private:
-  CallbackType initiator_;
-  std::shared_ptr<CallbackState<T>> state_;
+  static Detached Child(const Task<T>& task, size_t index,
+                        WhenAnyState* state) {
+    auto&& value = co_await task;
+    if (!state->won_.exchange(true, std::memory_order_acq_rel)) {
+      state->result_.emplace(WhenAnyResult<T>{index, std::move(value)});
+      if (state->Signal()) {
+        state->parent_.resume();
+      }
+    }
+    state->Release();
+  }
+
+  // Winner and starter both signal; the second one resumes the parent
+  bool Signal() {
+    return pending_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+
+  std::vector<Task<T>> tasks_;
+  std::atomic<size_t> refs_;
+  std::atomic<bool> won_{false};
+  std::atomic<int> pending_{2};
+  std::optional<WhenAnyResult<T>> result_;
+  std::coroutine_handle<> parent_;
 };
 
+// Pulls items off a shared cursor until the range is exhausted
+template <typename Range, typename Fn>
+Detached ForEachWorker(Range& items, Fn& fn, std::atomic<size_t>* next,
+                       Latch* latch) {
+  size_t count = static_cast<size_t>(std::ranges::size(items));
+  for (size_t i = next->fetch_add(1, std::memory_order_relaxed); i < count;
+       i = next->fetch_add(1, std::memory_order_relaxed)) {
+    co_await fn(std::ranges::begin(items)[i]);
+  }
+  latch->Arrive();
+}
+
 }  // namespace detail
 
 // Async wrapper around HttpClient that provides coroutine-based API
@@ -92,11 +244,7 @@ class AsyncClient {
 
   // Send a request asynchronously - returns awaitable
   auto SendAsync(Request request) {
-    return detail::CallbackAwaitable<Response>(
-        [this, request = std::move(request)](
-            std::function<void(Response, Error)> callback) mutable {
-          client_->SendAsync(std::move(request), std::move(callback));
-        });
+    return detail::RequestAwaitable(client_.get(), std::move(request));
   }
 
   // Convenience methods that return awaitables
@@ -179,8 +327,10 @@ class AsyncClient {
   }
 
   // Event loop control (delegates to underlying HttpClient)
+  void Start() { client_->Start(); }
   void Run() { client_->Run(); }
   void RunOnce() { client_->RunOnce(); }
+  void WaitIdle() { client_->WaitIdle(); }
   void Stop() { client_->Stop(); }
   bool IsRunning() const { return client_->IsRunning(); }
 
@@ -210,39 +360,122 @@ class AsyncClient {
 //   // In main():
 //   RunAsync(client, FetchData(client));
 //
+// The calling thread blocks on a condition variable until the task is done;
+// the coroutine itself runs on the reactor threads.
 template <typename T>
 void RunAsync(AsyncClient& client, Task<T> task) {
-  // Start the task
-  task.resume();
-
-  // Run the event loop until the task completes
-  while (!task.done()) {
-    client.RunOnce();
-  }
+  client.Start();
+  task.sync_wait();
 }
 
 // Overload for multiple tasks - runs all concurrently
 template <typename... Tasks>
 void RunAsync(AsyncClient& client, Tasks&&... tasks) {
-  // Start all tasks
-  (tasks.resume(), ...);
+  client.Start();
 
-  // Create a check function
-  auto all_done = [&]() { return (tasks.done() && ...); };
-
-  // Run until all complete
-  while (!all_done()) {
-    client.RunOnce();
-  }
+  detail::SyncWaitEvent event(sizeof...(Tasks));
+  (detail::SyncWaitDriver(tasks, &event), ...);
+  event.Wait();
 }
 
 // WhenAll - wait for multiple tasks to complete
-// Returns a Task that completes when all input tasks complete
+// Returns a Task that completes when all input tasks complete. The tasks
+// run concurrently; each resumes on whichever reactor completes its I/O.
+//
+//   auto [a, b] = co_await WhenAll(client.Get(url1), client.Get(url2));
+//
 template <typename... Ts>
-Task<std::tuple<AsyncResult<Ts>...>> WhenAll(Task<AsyncResult<Ts>>... tasks);
+  requires(sizeof...(Ts) > 0 && (!std::is_void_v<Ts> && ...))
+Task<std::tuple<Ts...>> WhenAll(Task<Ts>... tasks) {
+  std::tuple<std::optional<Ts>...> results;
+  detail::Latch latch(sizeof...(Ts));
+
+  auto refs = std::forward_as_tuple(tasks...);
+  co_await latch.Start([&] {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      (detail::WhenAllChild(std::get<I>(refs), &std::get<I>(results), &latch),
+       ...);
+    }(std::index_sequence_for<Ts...>{});
+  });
+
+  co_return detail::TakeAll(results, std::index_sequence_for<Ts...>{});
+}
+
+// Homogeneous WhenAll - results in input order
+template <typename T>
+  requires(!std::is_void_v<T>)
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> tasks) {
+  std::vector<std::optional<T>> results(tasks.size());
+  detail::Latch latch(tasks.size());
+
+  co_await latch.Start([&] {
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      detail::WhenAllChild(tasks[i], &results[i], &latch);
+    }
+  });
+
+  std::vector<T> values;
+  values.reserve(results.size());
+  for (auto& result : results) {
+    values.push_back(std::move(*result));
+  }
+  co_return values;
+}
+
+inline Task<void> WhenAll(std::vector<Task<void>> tasks) {
+  detail::Latch latch(tasks.size());
+
+  co_await latch.Start([&] {
+    for (const auto& task : tasks) {
+      detail::WhenAllChild(task, &latch);
+    }
+  });
+}
 
 // WhenAny - wait for any task to complete
-// Returns a Task that completes when any input task completes
+// Returns a Task that completes when any input task completes, with its
+// index and value. The remaining tasks keep running to completion in the
+// background and their results are discarded. `tasks` must not be empty.
+template <typename T>
+  requires(!std::is_void_v<T>)
+Task<WhenAnyResult<T>> WhenAny(std::vector<Task<T>> tasks) {
+  if (tasks.empty()) {
+    std::abort();
+  }
+
+  auto* state = new detail::WhenAnyState<T>(std::move(tasks));
+  co_await state->Start();
+
+  WhenAnyResult<T> result = state->TakeResult();
+  state->Release();
+  co_return result;
+}
+
+// ForEachConcurrent - run fn(item) for every item, at most `limit` at a time
+// `fn` returns a Task (its value is discarded). `items` must be a random
+// access range that stays alive until the returned Task completes.
+//
+//   co_await ForEachConcurrent(urls, 8, [&](const std::string& url) {
+//     return Fetch(client, url);
+//   });
+//
+template <std::ranges::random_access_range Range, typename Fn>
+Task<void> ForEachConcurrent(Range& items, size_t limit, Fn fn) {
+  size_t count = static_cast<size_t>(std::ranges::size(items));
+  size_t workers = std::min(limit == 0 ? size_t{1} : limit, count);
+  if (workers == 0) {
+    co_return;
+  }
+
+  std::atomic<size_t> next{0};
+  detail::Latch latch(workers);
+
+  co_await latch.Start([&] {
+    for (size_t i = 0; i < workers; ++i) {
+      detail::ForEachWorker(items, fn, &next, &latch);
+    }
+  });
+}
 
 }  // namespace holytls
 
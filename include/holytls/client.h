@@ -4,9 +4,13 @@
 #ifndef HOLYTLS_CLIENT_H_
 #define HOLYTLS_CLIENT_H_
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <span>
 #include <string>
 #include <string_view>
@@ -15,6 +19,8 @@
 #include "holytls/config.h"
 #include "holytls/error.h"
 #include "holytls/http/ordered_headers.h"
+#include "holytls/http2/chrome_header_profile.h"
+#include "holytls/http2/packed_headers.h"
 #include "holytls/types.h"
 
 
@@ -28,8 +34,17 @@
 namespace holytls {
 namespace core {
 class ReactorContext;
+struct RawResponse;
+enum class StreamError : uint8_t;
+}
+namespace http {
+class RequestHeaders;
+}
+namespace http2 {
+class ChromeHeaderTemplates;
 }
 namespace pool {
+class HostPool;
 class PooledConnection;
 class QuicPooledConnection;
 }
@@ -40,6 +55,9 @@ struct ParsedUrl;
 
 namespace holytls {
 
+class RequestCoalescer;
+class RequestHedger;
+
 // HTTP request method
 enum class Method {
   kGet,
@@ -66,6 +84,17 @@ struct Request {
   // When set, bypasses Chrome auto-generation - user provides all headers
   std::span<const std::string_view> header_order;
 
+  // Fetch metadata for auto-generated Chrome headers (selects the template
+  // and the sec-fetch-* values)
+  http2::FetchContext fetch;
+
+  // RFC 9218 priority. Orders the request against others waiting for its
+  // reactor and for a stream to its origin; background urgencies (4-7)
+  // leave the last free stream to more urgent requests. Anything but the
+  // defaults is signalled to the server in a `priority` header (HTTP/2
+  // and HTTP/3), unless the request sets one or uses header_order.
+  Priority priority;
+
   // Builder methods (chainable)
   Request& SetMethod(Method m);
   Request& SetUrl(std::string_view u);
@@ -75,41 +104,101 @@ struct Request {
   Request& SetTimeout(std::chrono::milliseconds t);
   Request& SetHeaderOrder(std::span<const std::string_view> order);
   Request& SetHeaders(const http::headers::OrderedHeaders& h);
+  Request& SetFetchContext(const http2::FetchContext& f);
+  Request& SetPriority(uint8_t urgency, bool incremental = false);
 };
 
-// Timing information for response
+// Per-request phase timing.
+// Measured on the reactor's cached loop clock (millisecond resolution) unless
+// ClientConfig::high_resolution_timing is set. Connection setup is charged to
+// the first request on a connection; reused connections report zero connect
+// and TLS time. Connect and TLS are reported for TCP connections only.
 struct Timing {
-  std::chrono::milliseconds dns{0};
-  std::chrono::milliseconds connect{0};
-  std::chrono::milliseconds tls{0};
-  std::chrono::milliseconds ttfb{0};  // Time to first byte
-  std::chrono::milliseconds total{0};
+  std::chrono::microseconds queue{0};    // Waiting for a reactor/connection
+  std::chrono::microseconds dns{0};
+  std::chrono::microseconds connect{0};  // TCP connect (+ proxy tunnel)
+  std::chrono::microseconds tls{0};      // TLS handshake
+  std::chrono::microseconds ttfb{0};     // Request sent to response headers
+  std::chrono::microseconds total{0};    // SendAsync to response complete
+  bool connection_reused = false;
+  bool tls_resumed = false;              // TLS session resumption
+};
+
+// One followed redirect: the URL that answered with a 3xx, where it pointed
+// and the timing of that exchange alone (`timing.total` covers the hop)
+struct RedirectHop {
+  std::string url;
+  int status_code = 0;
+  std::string location;  // Resolved absolute URL of the next hop
+  Timing timing;
 };
 
 // HTTP response
+// Headers are the packed block produced by the protocol session (one buffer,
+// known names interned as HeaderId); the body is moved in from the
+// connection. Iterate with `for (auto [name, value] : response.headers)`.
 struct Response {
   int status_code = 0;
-  Headers headers;
+  http2::PackedHeaders headers;
   std::vector<uint8_t> body;
-  Timing timing;
+  Timing timing;  // Final hop; `total` spans the whole redirect chain
+
+  // Redirects followed to reach this response, in order (empty when the
+  // first response was final). The final URL is redirects.back().location.
+  std::vector<RedirectHop> redirects;
+
+  // Served by ClientConfig::response_cache: a fresh hit, or a stored body
+  // the origin confirmed with a 304
+  bool from_cache = false;
+
+  // Joined an identical request already in flight (ClientConfig::coalesce)
+  // instead of being sent; `timing` except `total` is that exchange's
+  bool coalesced = false;
+
+  // Answered by the hedged copy of the request (ClientConfig::hedge)
+  bool hedged = false;
+
+  // Body buffer shared by every request of a coalesced exchange. When set,
+  // `body` is empty; body_view() and body_string() read either.
+  std::shared_ptr<const std::vector<uint8_t>> shared_body;
 
   Response() = default;
-  Response(int code, Headers hdrs, std::vector<uint8_t> data)
+  Response(int code, http2::PackedHeaders hdrs, std::vector<uint8_t> data)
       : status_code(code), headers(std::move(hdrs)), body(std::move(data)) {}
 
   // Computed queries
   bool is_success() const { return status_code >= 200 && status_code < 300; }
   bool is_redirect() const { return status_code >= 300 && status_code < 400; }
 
-  // Header utilities
-  std::string_view GetHeader(std::string_view name) const;
-  bool HasHeader(std::string_view name) const;
+  // Header utilities (known names match case-insensitively)
+  std::string_view GetHeader(std::string_view name) const {
+    return headers.Get(name);
+  }
+  std::string_view GetHeader(http2::HeaderId id) const {
+    return headers.Get(id);
+  }
+  bool HasHeader(std::string_view name) const { return headers.Has(name); }
+  bool HasHeader(http2::HeaderId id) const { return !headers.Get(id).empty(); }
 
   // Body utilities
+  std::span<const uint8_t> body_view() const {
+    return shared_body != nullptr ? std::span<const uint8_t>(*shared_body)
+                                  : std::span<const uint8_t>(body);
+  }
   std::string_view body_string() const;
   size_t content_length() const;
 };
 
+// Outcome of a request submitted without a callback (see
+// HttpClient::SendAsync(Request)); `error` is set when the request failed
+struct ResponseResult {
+  Response response;
+  Error error;
+
+  bool ok() const { return !error; }
+  explicit operator bool() const { return ok(); }
+};
+
 // Callback types
 using ResponseCallback = std::function<void(Response response, Error error)>;
 using ProgressCallback = std::function<void(size_t downloaded, size_t total)>;
@@ -134,17 +223,43 @@ class HttpClient {
   void SendAsync(Request request, ResponseCallback callback,
                  ProgressCallback progress);
 
-  // Event loop control
-  void Run();      // Run until Stop() is called
-  void RunOnce();  // Process pending events once
+  // Asynchronous request returning a future. Starts the reactors if needed
+  // so the future can be waited on right away.
+  std::future<ResponseResult> SendAsync(Request request);
+
+  // Event loop control. The reactors run on background threads; these only
+  // block the calling thread, woken by request completions (no polling).
+  void Start();    // Start reactor threads and return immediately
+  void Run();      // Block until Stop() is called
+  void RunOnce();  // Block until a request completes (bounded wait)
   void Stop();     // Signal event loop to stop
 
+  // Block until every submitted request has completed (its callback has
+  // returned). Requests issued from callbacks are waited for too.
+  void WaitIdle();
+
+  // Block until `predicate` returns true or Stop() is called. The predicate
+  // is evaluated on the calling thread after each request completes.
+  void RunUntil(const std::function<bool()>& predicate);
+
+  // Requests submitted and not yet completed, across all reactors
+  size_t InFlight() const;
+
   // Check if event loop is running
   bool IsRunning() const;
 
   // Get current statistics
   ClientStats GetStats() const;
 
+  // Lifecycle trace records held in the per-reactor rings
+  // (TraceConfig::ring_capacity), ordered by time. Save with
+  // core::WriteTraceFile or convert with core::TraceToChromeJson.
+  std::vector<core::TraceRecord> CollectTrace() const;
+
+  // Memory charged per subsystem and per reactor, with high-water marks
+  // and backpressure counts (requires HOLYTLS_MEMORY_ACCOUNTING=ON)
+  MemoryStats GetMemoryStats() const;
+
   ChromeVersion GetChromeVersion() const;
 
  private:
@@ -152,28 +267,132 @@ class HttpClient {
   static TlsConfig MakeTlsConfig(const ClientConfig& config);
   static core::ReactorManagerConfig MakeReactorConfig(const ClientConfig& config);
 
+  // Request start and DNS duration, carried through queueing so the
+  // response can be given its phase timing (microseconds). Redirect hops
+  // restart the hop clock and keep the request's start.
+  struct RequestClock {
+    uint64_t start_us = 0;
+    uint64_t hop_start_us = 0;
+    uint64_t dns_us = 0;
+    int redirects = 0;  // Hops followed so far
+    int replays = 0;    // Times sent again after the server refused it
+  };
+
+  // Current time on the timing clock of `ctx`'s reactor (reactor thread)
+  uint64_t NowUs(const core::ReactorContext* ctx) const;
+
   void ProcessRequest(core::ReactorContext* ctx, Request request,
                       util::ParsedUrl parsed, ResponseCallback callback,
-                      ProgressCallback progress);
+                      ProgressCallback progress, RequestClock clock);
+
+  // DNS, then a pooled connection (waiting for one if needed), then send.
+  // The part of ProcessRequest that replayed requests go through again.
+  void ResolveAndSend(core::ReactorContext* ctx, Request request,
+                      util::ParsedUrl parsed, ResponseCallback callback,
+                      RequestClock clock);
+
+  // Wake threads blocked in Run/RunOnce/RunUntil/WaitIdle
+  void NotifyWaiters();
+
+  // Block until `done` returns true (evaluated under wait_mutex_), or until
+  // `timeout` elapses when it is nonzero
+  void WaitFor(const std::function<bool()>& done,
+               std::chrono::milliseconds timeout = {});
 
   void QueueRequest(core::ReactorContext* ctx, const util::ParsedUrl& parsed,
                     const std::vector<util::ResolvedAddress>& addresses,
-                    Request request, ResponseCallback callback, bool use_quic,
-                    int retry_count = 0);
+                    Request request, ResponseCallback callback,
+                    RequestClock clock, bool use_quic, int retry_count = 0);
+
+  // Queue a request on its TCP host pool until a stream is free for its
+  // urgency, then send it. Fails with kTimeout if none is within the
+  // request's timeout.
+  void WaitForTcpSlot(core::ReactorContext* ctx, pool::HostPool* host_pool,
+                      const util::ParsedUrl& parsed, Request request,
+                      ResponseCallback callback, RequestClock clock);
+
+  // Fill `out` with the request's regular headers: Chrome template plus user
+  // headers and cookie-jar cookies (or user headers only in full control mode)
+  void BuildRequestHeaders(const Request& request,
+                           http::RequestHeaders* out) const;
+
+  // Feed Set-Cookie to the cookie jar and Alt-Svc to the Alt-Svc cache
+  void ProcessResponseHeaders(const http2::PackedHeaders& headers,
+                              std::string_view request_url,
+                              std::string_view origin_host,
+                              uint16_t origin_port);
+
+  // Consult the response cache on the reactor before DNS. Completes fresh
+  // hits and returns true; otherwise may add conditional headers to
+  // `request` and wraps `callback` to store the response (or reuse the
+  // stored body on a 304). Unsafe methods invalidate the URL on success.
+  bool ApplyResponseCache(core::ReactorContext* ctx, Request* request,
+                          ResponseCallback* callback,
+                          const RequestClock& clock);
+
+  // Called with a completed response before it is delivered. When it is a
+  // redirect to follow, rewrites `request` for the next hop and re-enters
+  // ProcessRequest on this reactor (same-origin hops pick the connection
+  // just released back to the pool); `callback` then records the hop in
+  // Response::redirects. Returns false when `response` is final.
+  bool FollowRedirect(core::ReactorContext* ctx, Request* request,
+                      Response* response, ResponseCallback* callback,
+                      const RequestClock& clock);
 
   void SendOnTcpConnection(core::ReactorContext* ctx,
                            pool::PooledConnection* pooled,
                            const util::ParsedUrl& parsed, Request request,
-                           ResponseCallback callback);
+                           ResponseCallback callback, RequestClock clock);
+
+  // A request sent over TCP: the request, its completion, and the copies
+  // of it on the wire (the first send, and a hedge)
+  struct TcpExchange;
+
+  // Send one copy of `exchange`'s request on `pooled`, a stream slot
+  // already acquired for it
+  void SendTcpAttempt(core::ReactorContext* ctx,
+                      const std::shared_ptr<TcpExchange>& exchange,
+                      size_t index, pool::PooledConnection* pooled);
+  void OnTcpResponse(core::ReactorContext* ctx,
+                     const std::shared_ptr<TcpExchange>& exchange,
+                     size_t index, core::RawResponse core_resp);
+  void OnTcpError(core::ReactorContext* ctx,
+                  const std::shared_ptr<TcpExchange>& exchange, size_t index,
+                  const std::string& error, core::StreamError kind);
+
+  // Mark `exchange` answered: stop its hedge delay and cancel the copies
+  // still on the wire
+  void SettleExchange(core::ReactorContext* ctx, TcpExchange* exchange);
+
+  // Start the hedge delay for `exchange`, then send the hedge on another
+  // connection if the first copy has no response headers by then
+  void ArmHedge(core::ReactorContext* ctx,
+                const std::shared_ptr<TcpExchange>& exchange);
+  void LaunchHedge(core::ReactorContext* ctx,
+                   const std::shared_ptr<TcpExchange>& exchange);
 
 #if defined(HOLYTLS_BUILD_QUIC) || defined(HOLYTLS_QUIC_AVAILABLE)
   void SendOnQuicConnection(core::ReactorContext* ctx,
                             pool::QuicPooledConnection* quic_conn,
                             const util::ParsedUrl& parsed, Request request,
-                            ResponseCallback callback);
+                            ResponseCallback callback, RequestClock clock);
 #endif
 
   ClientConfig config_;
+
+  // Precomputed Chrome header templates (immutable, shared by all reactors).
+  // Declared before the reactors so queued requests never outlive it.
+  std::unique_ptr<http2::ChromeHeaderTemplates> header_templates_;
+
+  // Per-reactor in-flight request coalescing, indexed by reactor (empty
+  // unless config_.coalesce.enabled). Declared before the reactors so
+  // queued leader callbacks never outlive it.
+  std::vector<std::unique_ptr<RequestCoalescer>> coalescers_;
+
+  // Per-reactor hedging state, indexed by reactor (empty unless
+  // config_.hedge.enabled)
+  std::vector<std::unique_ptr<RequestHedger>> hedgers_;
+
   tls::TlsContextFactory tls_factory_;
   core::ReactorManager reactor_manager_;
   std::atomic<bool> running_{false};
@@ -185,10 +404,15 @@ class HttpClient {
   http::AltSvcCache* alt_svc_cache_ = nullptr;
   bool alt_svc_enabled_ = true;
 
-  // Statistics
-  std::atomic<size_t> requests_sent_{0};
-  std::atomic<size_t> requests_completed_{0};
-  std::atomic<size_t> requests_failed_{0};
+  // HTTP response cache (borrowed pointer, not owned)
+  http::ResponseCache* response_cache_ = nullptr;
+
+  // Blocking waits: completions notify wait_cv_ only while waiters_ > 0
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+  std::atomic<size_t> waiters_{0};
+  std::atomic<uint64_t> completions_{0};
+
 };
 
 }  // namespace holytls
@@ -17,7 +17,11 @@ namespace holytls {
 namespace http {
 class CookieJar;
 class AltSvcCache;
+class ResponseCache;
 }  // namespace http
+namespace core {
+class TraceSink;
+}  // namespace core
 
 // Chrome version to impersonate
 enum class ChromeVersion {
@@ -102,6 +106,28 @@ struct Http3Config {
   uint64_t qpack_blocked_streams = 100;
 };
 
+// Adaptive per-origin concurrency (see holytls/pool/concurrency_limiter.h).
+// When enabled each origin's requests in flight are capped by a limit that
+// grows while its time to first byte stays near the baseline and shrinks
+// as it rises or the origin sheds load (429, 503, connection errors).
+// Requests over the limit wait in the origin's queue.
+struct ConcurrencyLimitConfig {
+  bool enabled = false;
+
+  size_t initial_limit = 20;
+  size_t min_limit = 2;
+  size_t max_limit = 1000;
+
+  // Weight of each new estimate in the limit (0-1]
+  double smoothing = 0.2;
+
+  // Limit multiplier on a shed request, applied at most once per RTT
+  double backoff_ratio = 0.9;
+
+  // Latency increase over the baseline tolerated before the limit shrinks
+  double rtt_tolerance = 1.5;
+};
+
 // Connection pool configuration
 struct PoolConfig {
   // Per-host connection limits (Chrome uses 6)
@@ -114,21 +140,102 @@ struct PoolConfig {
   std::chrono::milliseconds idle_timeout{300000};    // 5 minutes
   std::chrono::milliseconds connect_timeout{30000};  // 30 seconds
 
+  // Longest a request waits in an origin's queue for a stream, within its
+  // own timeout. Queued requests fail sooner if the connection they wait
+  // on cannot be established.
+  std::chrono::milliseconds queue_timeout{10000};  // 10 seconds
+
   // HTTP/2 multiplexing
   bool enable_multiplexing = true;
   size_t max_streams_per_connection = 100;
 
   // Connection keep-alive
   std::chrono::milliseconds keepalive_interval{45000};  // 45 seconds
+
+  // Adaptive cap on requests in flight per origin
+  ConcurrencyLimitConfig concurrency_limit;
 };
 
 // Threading configuration
+// How requests for an origin are assigned to reactor threads
+enum class ReactorPlacement {
+  kHash,         // Static hash of host:port (one reactor per origin)
+  kBoundedLoad,  // Consistent hashing with bounded loads; hot origins
+                 // spill onto additional reactors
+};
+
+// Socket I/O backend of each reactor
+enum class ReactorBackend {
+  kLibuv,    // uv_poll_t readiness; recv/send per read and write
+  kIoUring,  // Linux io_uring: multishot recv into provided buffers,
+             // batched sends, registered fds (HOLYTLS_IO_URING builds;
+             // falls back to kLibuv where unavailable)
+};
+
 struct ThreadConfig {
   // Number of worker threads (0 = auto-detect CPU cores)
   size_t num_workers = 0;
 
   // Pin worker threads to CPU cores
   bool pin_to_cores = false;
+
+  // Reactor placement policy
+  ReactorPlacement placement = ReactorPlacement::kBoundedLoad;
+
+  // Bounded-load factor: a reactor accepts new work while its load is at
+  // most load_factor * average load (>= 1.0; lower spreads more eagerly)
+  double load_factor = 1.25;
+
+  // Most reactors a single hot origin may be spread across (0 = all)
+  size_t max_reactors_per_origin = 4;
+
+  // A reactor whose posted-callback lag exceeds this is treated as full
+  std::chrono::microseconds max_loop_lag{5000};
+
+  // Socket I/O backend
+  ReactorBackend backend = ReactorBackend::kLibuv;
+};
+
+// Socket buffer sizing
+enum class SocketBufferMode {
+  kAutotune,  // Leave kernel defaults (keeps Linux receive autotuning)
+  kFixed,     // SO_RCVBUF/SO_SNDBUF = buffer_size on every socket
+  kAdaptive,  // Autotune until the buffer reaches the autotuning
+              // ceiling, then grow SO_RCVBUF up to max_buffer_size while
+              // a connection's bandwidth-delay product outgrows it
+};
+
+// Per-connection TCP tuning
+struct SocketConfig {
+  SocketBufferMode buffer_mode = SocketBufferMode::kAutotune;
+
+  // Buffer size for kFixed
+  size_t buffer_size = 256 * 1024;
+
+  // Ceiling for kAdaptive. Only sizes above the autotuning ceiling
+  // (net.ipv4.tcp_rmem[2], 6 MB by default) have any effect, and reaching
+  // them takes CAP_NET_ADMIN (SO_RCVBUFFORCE) or net.core.rmem_max raised
+  // to at least half of this. Otherwise kAdaptive behaves as kAutotune.
+  size_t max_buffer_size = 16 * 1024 * 1024;
+
+  // Linux-only options, ignored elsewhere (0/false = leave unset)
+  size_t notsent_lowat = 0;                    // TCP_NOTSENT_LOWAT (bytes)
+  bool quickack = false;                       // TCP_QUICKACK at connect
+  std::chrono::milliseconds user_timeout{0};   // TCP_USER_TIMEOUT
+  std::chrono::microseconds busy_poll{0};      // SO_BUSY_POLL
+  bool bind_address_no_port = false;           // IP_BIND_ADDRESS_NO_PORT
+
+  // Source address to bind before connecting (empty = any). With
+  // bind_address_no_port the port is picked at connect time, so many
+  // connections to different servers can share one local port range.
+  std::string local_address;
+
+  // TCP Fast Open for direct connections (Linux, TCP_FASTOPEN_CONNECT).
+  // Once the kernel holds a cookie for a server the ClientHello rides in
+  // the SYN, saving a round trip on reconnects. Falls back to a normal
+  // handshake when the kernel or server lacks support, and each host pool
+  // stops using it for an origin whose servers keep ignoring it.
+  bool tcp_fast_open = false;
 };
 
 // DNS configuration
@@ -195,6 +302,74 @@ struct AltSvcConfig {
   std::chrono::seconds failure_penalty{300};
 };
 
+// In-flight request coalescing. Identical GET and HEAD requests without a
+// body that are in flight on the same reactor share one exchange: later
+// ones attach to the first one's completion instead of being sent, and all
+// receive one refcounted body (Response::shared_body). The first request's
+// timeout and redirects apply to the requests joined to it.
+struct CoalesceConfig {
+  bool enabled = false;
+
+  // Request headers (any case) that must also match, as set on the Request.
+  // Headers added by the client (Chrome template, cookie jar) are the same
+  // for identical requests and need not be listed.
+  std::vector<std::string> key_headers = {
+      "authorization",   "cookie", "accept",        "accept-encoding",
+      "accept-language", "range",  "if-none-match", "if-modified-since",
+  };
+};
+
+// Hedged requests. A GET or HEAD without a body whose response headers
+// have not arrived after the reactor's `percentile` time to first byte is
+// sent again on another connection, preferring another resolved address.
+// The first response is delivered and the other stream is reset. Requests
+// refused by the server (REFUSED_STREAM, or above a GOAWAY's last stream
+// id) are replayed whether or not hedging is enabled.
+struct HedgeConfig {
+  bool enabled = false;
+
+  // Time-to-first-byte percentile (0-100) after which to hedge
+  double percentile = 95.0;
+
+  // Floor on the hedge delay
+  std::chrono::milliseconds min_delay{5};
+
+  // Hedges allowed per request sent (0.05 = at most 5% extra load)
+  double budget = 0.05;
+
+  // TTFB samples a reactor needs before it hedges
+  size_t min_samples = 100;
+};
+
+// Connection and stream lifecycle tracing (see holytls/core/trace.h).
+// Only takes effect when the library is built with HOLYTLS_TRACING=ON.
+struct TraceConfig {
+  // Custom sink (not owned). Called from every reactor thread, so it must
+  // be thread-safe.
+  core::TraceSink* sink = nullptr;
+
+  // Keep the last ring_capacity records per reactor in memory instead of
+  // using `sink`; read back with HttpClient::CollectTrace(). 0 = disabled.
+  size_t ring_capacity = 0;
+};
+
+// Memory caps (see holytls/memory/memory_accounting.h).
+// Only takes effect when the library is built with
+// HOLYTLS_MEMORY_ACCOUNTING=ON; usage is reported by GetMemoryStats().
+struct MemoryConfig {
+  // Cap on the memory charged to each reactor (0 = no cap). Over it the
+  // client applies backpressure instead of allocating further.
+  size_t max_bytes_per_reactor = 0;
+
+  // Hold new streams on that reactor's connections until usage drops below
+  // 7/8 of the cap. Streams already open keep reading, so they complete
+  // and release the memory they hold.
+  bool pause_new_streams = true;
+
+  // Fail new requests placed on that reactor with ErrorCode::kMemoryLimit
+  bool reject_requests = true;
+};
+
 // Main client configuration
 struct ClientConfig {
   TlsConfig tls;
@@ -203,8 +378,13 @@ struct ClientConfig {
   PoolConfig pool;
   ThreadConfig threads;
   DnsConfig dns;
+  SocketConfig socket;
   ProxyConfig proxy;
   AltSvcConfig alt_svc;
+  TraceConfig trace;
+  MemoryConfig memory;
+  CoalesceConfig coalesce;
+  HedgeConfig hedge;
 
   // Protocol selection
   ProtocolPreference protocol = ProtocolPreference::kHttp2Preferred;
@@ -219,25 +399,67 @@ struct ClientConfig {
   // from responses and subsequent requests may use HTTP/3 automatically.
   http::AltSvcCache* alt_svc_cache = nullptr;
 
+  // HTTP response cache (optional, not owned; see
+  // holytls/http/response_cache.h). Fresh hits complete without touching
+  // the network; stale entries are revalidated with conditional requests.
+  http::ResponseCache* response_cache = nullptr;
+
   // Default request timeout
   std::chrono::milliseconds default_timeout{30000};
 
   // User-Agent string (empty = auto-generate from chrome_version)
   std::string user_agent;
 
-  // Follow redirects
+  // Auto-generate Chrome request headers (user-agent, sec-ch-ua, accept,
+  // sec-fetch-*, ...) from templates built once per client. User headers
+  // with the same name override in place. Ignored when a request sets
+  // header_order (full control mode).
+  bool chrome_headers = true;
+
+  // Follow 301/302/303/307/308 on the reactor that ran the request, up to
+  // max_redirects hops (the last 3xx is delivered once the limit is hit).
+  // 303, and 301/302 after POST, continue as GET without the body. Hops
+  // are listed in Response::redirects.
   bool follow_redirects = true;
   int max_redirects = 10;
 
   // Automatic response body decompression (br, gzip, zstd, deflate)
   bool auto_decompress = true;
 
+  // Measure Response::timing and the GetStats() latency histograms with
+  // uv_hrtime() (microseconds) instead of the reactor's cached loop clock
+  // (milliseconds, free to read). Costs a clock read per phase boundary.
+  bool high_resolution_timing = false;
+
   // Factory methods for common configurations
   // Factory methods for common configurations
   static ClientConfig Chrome143();
   static ClientConfig ChromeLatest();
 };
 
+// Latency distribution of one request phase
+struct LatencyStats {
+  uint64_t count = 0;
+  double mean_ms = 0.0;
+  double p50_ms = 0.0;
+  double p90_ms = 0.0;
+  double p99_ms = 0.0;
+  double p999_ms = 0.0;
+  double max_ms = 0.0;
+};
+
+// Adaptive concurrency state of one origin
+struct OriginConcurrencyStats {
+  std::string host;
+  uint16_t port = 0;
+  size_t limit = 0;  // Requests allowed in flight
+  size_t in_flight = 0;
+  size_t queued = 0;    // Waiting for the limit or a stream
+  double rtt_ms = 0.0;  // Latest time to first byte
+  double baseline_rtt_ms = 0.0;
+  size_t drops = 0;  // Limit cuts (429, 503, connection errors)
+};
+
 // Runtime statistics
 struct ClientStats {
   // Connection statistics
@@ -247,23 +469,77 @@ struct ClientStats {
   size_t connections_created = 0;
   size_t connections_reused = 0;
   size_t connections_failed = 0;
+  size_t fast_open_attempts = 0;  // Connects with TCP Fast Open enabled
+  size_t fast_open_accepted = 0;  // ... whose SYN data the server accepted
 
   // Request statistics
   size_t requests_sent = 0;
   size_t requests_completed = 0;
   size_t requests_failed = 0;
   size_t requests_timeout = 0;
+  size_t requests_coalesced = 0;  // Joined an identical in-flight request
+  size_t requests_hedged = 0;     // Sent a second time (HedgeConfig)
+  size_t hedges_won = 0;          // ... where the second copy answered first
+  size_t requests_replayed = 0;   // Sent again after the server refused it
 
   // Data transfer
   uint64_t bytes_sent = 0;
   uint64_t bytes_received = 0;
 
-  // Latency percentiles (milliseconds)
+  // Average latencies (milliseconds)
   double avg_dns_time_ms = 0.0;
   double avg_connect_time_ms = 0.0;
   double avg_tls_time_ms = 0.0;
   double avg_ttfb_ms = 0.0;
   double avg_total_time_ms = 0.0;
+
+  // Latency distributions, merged from per-reactor HDR histograms
+  // (values within 6.25%)
+  LatencyStats dns;
+  LatencyStats connect;
+  LatencyStats tls;
+  LatencyStats ttfb;   // Request submitted to response headers
+  LatencyStats total;  // SendAsync to completion (successful requests)
+
+  // Adaptive concurrency per origin (PoolConfig::concurrency_limit), one
+  // entry per reactor the origin is placed on
+  std::vector<OriginConcurrencyStats> origins;
+};
+
+// Bytes currently charged and the high-water mark
+struct MemoryUsage {
+  size_t current_bytes = 0;
+  size_t peak_bytes = 0;
+};
+
+// Memory accounting snapshot (all zero unless built with
+// HOLYTLS_MEMORY_ACCOUNTING=ON). Subsystem and total figures are summed
+// over the reactors and the shared account; their peaks are the sum of
+// each account's peak, an upper bound on the combined peak.
+struct MemoryStats {
+  bool enabled = false;
+
+  // By subsystem
+  MemoryUsage tls;              // BoringSSL
+  MemoryUsage h2_session;       // nghttp2 state, HTTP/2 send buffers
+  MemoryUsage stream_buffers;   // Request headers, HTTP/1.1 send buffers
+  MemoryUsage response_bodies;  // Bodies being received
+  MemoryUsage decompression;    // zlib/brotli decoder state
+  MemoryUsage dns_cache;        // Resolver cache
+  MemoryUsage cookie_jar;       // Stored cookies
+  MemoryUsage pool_metadata;    // Connections, slabs, buffer pools
+  MemoryUsage other;            // Arenas and untagged allocations
+  MemoryUsage total;            // All of the above
+
+  // By owner: each reactor (in reactor order), and allocations made off
+  // the reactors (user threads, cookie jars)
+  std::vector<MemoryUsage> reactors;
+  MemoryUsage shared;
+
+  // Backpressure
+  size_t limit_per_reactor = 0;
+  uint64_t streams_paused = 0;     // Times a connection held new streams
+  uint64_t requests_rejected = 0;  // Failed with ErrorCode::kMemoryLimit
 };
 
 }  // namespace holytls
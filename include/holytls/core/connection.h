@@ -9,6 +9,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <span>
 #include <string>
@@ -18,8 +19,12 @@
 #include "holytls/config.h"
 #include "holytls/core/io_buffer.h"
 #include "holytls/core/reactor.h"
+#include "holytls/core/stats.h"
+#include "holytls/core/trace.h"
+#include "holytls/http/request_headers.h"
 #include "holytls/http1/h1_session.h"
 #include "holytls/http2/h2_session.h"
+#include "holytls/memory/memory_accounting.h"
 #include "holytls/proxy/http_proxy.h"
 #include "holytls/proxy/socks_proxy.h"
 #include "holytls/tls/tls_connection.h"
@@ -38,11 +43,26 @@ enum class ConnectionState {
   kError,         // Error occurred
 };
 
+// Per-request timing recorded by the connection, in microseconds on the
+// connection clock (see ConnectionOptions::high_resolution_timing).
+// Connection setup is attributed to every request sent before the
+// connection was established; requests sent after see reused = true and
+// zero connect/TLS time.
+struct RequestTiming {
+  uint64_t connect_us = 0;     // TCP connect (and proxy tunnel) duration
+  uint64_t tls_us = 0;         // TLS handshake duration
+  uint64_t sent_us = 0;        // Timestamp: submitted to the session
+  uint64_t first_byte_us = 0;  // Timestamp: response headers received
+  bool reused = false;
+  bool tls_resumed = false;
+};
+
 // Raw response data (internal representation with packed headers)
 struct RawResponse {
   int status_code = 0;
   http2::PackedHeaders headers;
   std::vector<uint8_t> body;
+  RequestTiming timing;
 
   std::string body_string() const {
     return std::string(body.begin(), body.end());
@@ -52,10 +72,21 @@ struct RawResponse {
 // Forward declaration for callback types
 class Connection;
 
+// Why a request failed on its connection
+enum class StreamError : uint8_t {
+  kFailed,   // Connection or stream error; the server may have processed it
+  kRefused,  // Not processed by the server (REFUSED_STREAM, or above the
+             // last stream id of a GOAWAY), so it is safe to send again
+};
+
 // Callback types
-using ResponseCallback = std::function<void(const RawResponse& response)>;
-using ErrorCallback = std::function<void(const std::string& error)>;
+// The response is handed over by value so receivers can move headers and body
+using ResponseCallback = std::function<void(RawResponse response)>;
+using ErrorCallback =
+    std::function<void(const std::string& error, StreamError kind)>;
 using IdleCallback = std::function<void(Connection*)>;
+using ConnectedCallback = std::function<void(Connection*)>;
+using ClosedCallback = std::function<void(Connection*)>;
 
 // Connection configuration options
 struct ConnectionOptions {
@@ -64,6 +95,24 @@ struct ConnectionOptions {
 
   // Proxy configuration (optional)
   ProxyConfig proxy;
+
+  // Socket buffer sizing and TCP options
+  SocketConfig socket;
+
+  // Statistics block of the owning reactor (optional, not owned)
+  ReactorStats* stats = nullptr;
+
+  // Time phases with uv_hrtime() instead of the reactor's cached
+  // millisecond clock
+  bool high_resolution_timing = false;
+
+  // Lifecycle trace sink of the owning reactor (optional, not owned)
+  TraceSink* trace = nullptr;
+
+  // Memory account of the owning reactor. While it is over its cap the
+  // connection opens no new streams; open ones keep reading so they can
+  // complete and release memory (optional, not owned).
+  memory::MemoryAccount* memory = nullptr;
 };
 
 // HTTP/2 connection over TLS.
@@ -73,6 +122,14 @@ class Connection : public EventHandler {
   // Callback for when connection becomes idle (no active requests)
   IdleCallback idle_callback;
 
+  // Callback for when the TLS handshake completes
+  ConnectedCallback connected_callback;
+
+  // Callback for when the connection failed or the peer closed it, after
+  // its requests were failed. The reactor keeps running; the owner removes
+  // the connection (not from inside this callback).
+  ClosedCallback closed_callback;
+
   Connection(Reactor* reactor, tls::TlsContextFactory* tls_factory,
              const std::string& host, uint16_t port,
              const ConnectionOptions& options = {});
@@ -88,23 +145,42 @@ class Connection : public EventHandler {
   // ip can be IPv4 or IPv6 address
   bool Connect(std::string_view ip, bool ipv6 = false);
 
-  // Send a request with auto-generated Chrome headers
-  void SendRequest(
+  // Send a request with auto-generated Chrome headers. Returns an id for
+  // CancelRequest() and ResponseStarted().
+  uint64_t SendRequest(
       const std::string& method, const std::string& path,
       const std::vector<std::pair<std::string, std::string>>& headers,
       ResponseCallback on_response, ErrorCallback on_error = nullptr) {
-    SendRequest(method, path, headers, {}, on_response, on_error);
+    return SendRequest(method, path, headers, {}, on_response, on_error);
   }
 
   // Send a request with custom header order (full control mode)
   // If header_order is non-empty, headers are sent in that order
   // Otherwise, Chrome headers are auto-generated
-  void SendRequest(
+  uint64_t SendRequest(
       const std::string& method, const std::string& path,
       const std::vector<std::pair<std::string, std::string>>& headers,
       std::span<const std::string_view> header_order,
       ResponseCallback on_response, ErrorCallback on_error = nullptr);
 
+  // Send a request from a prebuilt header block (single-copy path).
+  // method and path must be set; scheme and authority default to https and
+  // the connection host. The block is kept alive until the stream closes so
+  // HTTP/2 can submit it without copying.
+  uint64_t SendRequest(http::RequestHeaders headers,
+                       std::span<const std::string_view> header_order,
+                       ResponseCallback on_response,
+                       ErrorCallback on_error = nullptr);
+
+  // Abandon a request: drop it if it is still queued, or reset its HTTP/2
+  // stream. Its callbacks are not invoked. Returns false if it already
+  // completed, or is an HTTP/1.1 request on the wire (which can only be
+  // abandoned by closing the connection, so it completes normally).
+  bool CancelRequest(uint64_t request_id);
+
+  // Whether response headers have arrived for a request in flight
+  bool ResponseStarted(uint64_t request_id) const;
+
   // Close the connection
   void Close();
 
@@ -125,6 +201,32 @@ class Connection : public EventHandler {
     return false;
   }
 
+  // HTTP/2 connection that will open no more streams (GOAWAY received or
+  // session failed); requests already on it may still complete
+  bool IsGoingAway() const {
+    return state_ == ConnectionState::kConnected && h2_ &&
+           !h2_->CanSubmitRequest();
+  }
+
+  // Why the connection failed or closed (empty if it did not)
+  const std::string& last_error() const { return last_error_; }
+
+  // Address passed to Connect() (the origin's, also when proxied)
+  const std::string& peer_ip() const { return peer_ip_; }
+  bool peer_ipv6() const { return peer_ipv6_; }
+
+  // Whether the TLS handshake resumed a previous session
+  bool TlsResumed() const { return tls_resumed_; }
+
+  // TCP Fast Open: whether connect used it, and whether the server took
+  // the data in our SYN (known once connected)
+  bool FastOpenAttempted() const { return fast_open_attempted_; }
+  bool FastOpenAccepted() const { return fast_open_accepted_; }
+
+  // Current time on the connection clock (microseconds). Defaults to the
+  // reactor's cached loop time; uv_hrtime() with high_resolution_timing.
+  uint64_t NowUs() const;
+
   // Check if connection is using HTTP/2
   bool IsHttp2() const { return h2_ != nullptr; }
 
@@ -147,27 +249,91 @@ class Connection : public EventHandler {
   void HandleConnected();
   void FlushSendBuffer();
   void SetError(const std::string& msg);
+  void StartTls();
+
+  // Close after a failure (`error`) or the peer's close (empty), fail the
+  // requests left and notify closed_callback
+  void Abort(const std::string& error = {});
+
+  // Report every request, pending or active, as failed and drop it. The
+  // ones the server never saw (never sent, or above a GOAWAY's last
+  // stream id) are kRefused so the caller may send them again.
+  void FailRequests();
+
+  // Report pending requests as kRefused and drop them
+  void RefusePending();
+
+  // kAdaptive buffer sizing: account `n` received bytes and, once
+  // autotuning has topped out, grow SO_RCVBUF when the observed
+  // bandwidth-delay product no longer fits
+  void AdaptReceiveBuffer(size_t n);
+
+  // Submit queued requests in order while the connection accepts them
+  void SubmitPending();
+
+  // Memory backpressure (see ConnectionOptions::memory): hold new streams
+  // in pending_requests_ while the account is over its cap, and poll the
+  // account on a timer until it drops below the resume mark
+  bool PauseStreamsIfOverLimit();
+  void ResumeStreams();
+  static void OnResumeTimer(uv_timer_t* handle);
 
   Reactor* reactor_;
   tls::TlsContextFactory* tls_factory_;
   std::string host_;
   uint16_t port_;
+  std::string peer_ip_;
+  bool peer_ipv6_ = false;
 
   util::socket_t fd_ = util::kInvalidSocket;
   ConnectionState state_ = ConnectionState::kClosed;
 
+  // Setup phases (connection clock, microseconds). Durations are reported
+  // on the first request and in the latency histograms.
+  uint64_t connect_start_us_ = 0;
+  uint64_t tls_start_us_ = 0;
+  uint64_t connect_us_ = 0;
+  uint64_t tls_us_ = 0;
+  bool tls_resumed_ = false;
+  bool fast_open_attempted_ = false;
+  bool fast_open_accepted_ = false;
+
+  // Id of the next request (ids start at 1)
+  uint64_t next_request_id_ = 1;
+
+  // Highest stream id the server's GOAWAY says it may have processed;
+  // streams above it never reached the application
+  int32_t goaway_last_stream_id_ = std::numeric_limits<int32_t>::max();
+
+  // Receive throughput window for kAdaptive buffer sizing
+  size_t rcvbuf_size_ = 0;
+  uint64_t rcv_window_start_us_ = 0;
+  uint64_t rcv_window_bytes_ = 0;
+
+  // Memory backpressure state
+  bool streams_paused_ = false;
+  uv_timer_t* resume_timer_ = nullptr;
+
+  // The connection object itself, charged as pool metadata
+  memory::MemoryCharge charge_{memory::MemoryTag::kPoolMetadata};
+
   std::unique_ptr<proxy::HttpProxyTunnel> http_proxy_;
   std::unique_ptr<proxy::SocksProxyTunnel> socks_proxy_;
   std::unique_ptr<tls::TlsConnection> tls_;
   std::unique_ptr<http2::H2Session> h2_;
   std::unique_ptr<http1::H1Session> h1_;
 
+  // Submit to the negotiated session (connection must be ready)
+  void SubmitRequest(uint64_t request_id, http::RequestHeaders headers,
+                     bool preserve_order, bool reused,
+                     ResponseCallback on_response, ErrorCallback on_error);
+
   // Pending request data (for when connection is still being established)
   struct PendingRequest {
-    std::string method;
-    std::string path;
-    std::vector<std::pair<std::string, std::string>> headers;
-    std::vector<std::string_view> header_order;  // Stored copy for pending
+    uint64_t request_id = 0;
+    http::RequestHeaders headers;  // Already ordered if preserve_order
+    bool preserve_order = false;
+    bool reused = false;
     ResponseCallback on_response;
     ErrorCallback on_error;
   };
@@ -175,8 +341,12 @@ class Connection : public EventHandler {
 
   // Active response tracking
   struct ActiveRequest {
+    uint64_t request_id = 0;
     ResponseCallback on_response;
     ErrorCallback on_error;
+    // Referenced in place by nghttp2 (NO_COPY) until the stream closes
+    http::RequestHeaders request_headers;
+    RequestTiming timing;
     int status_code = 0;
     http2::PackedHeaders headers;
     IoBuffer body_buffer;  // O(1) append instead of O(n) vector insert
@@ -15,6 +15,8 @@
 #include <string_view>
 #include <vector>
 
+#include "holytls/memory/memory_accounting.h"
+
 // Platform-specific iovec definition
 #ifdef _WIN32
 namespace holytls {
@@ -89,6 +91,9 @@ class IoBuffer {
   size_t Capacity() const { return capacity_; }
   bool Empty() const { return size_ == 0; }
 
+  // Subsystem the chunk capacity is charged to (memory accounting builds)
+  void SetMemoryTag(memory::MemoryTag tag) { charge_.SetTag(tag); }
+
   // Clear all data
   void Clear();
 
@@ -124,6 +129,7 @@ class IoBuffer {
   std::deque<Chunk> chunks_;
   size_t size_ = 0;      // Total readable bytes
   size_t capacity_ = 0;  // Total allocated capacity
+  memory::MemoryCharge charge_{memory::MemoryTag::kStreamBuffers};
 };
 
 }  // namespace core
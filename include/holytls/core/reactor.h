@@ -19,10 +19,17 @@
 #include <vector>
 
 #include "holytls/base/types.h"
+#include "holytls/config.h"
+#include "holytls/types.h"
+
+// BoringSSL BIO (openssl/base.h)
+struct bio_st;
 
 namespace holytls {
 namespace core {
 
+class UringBackend;
+
 // Maximum file descriptors supported (can be adjusted)
 inline constexpr size_t kMaxFds = 65536;
 
@@ -72,7 +79,7 @@ struct EventHandler {
   // No virtual destructor - we don't delete through base pointer
   ~EventHandler() = default;
 
-  // Methods are now dispatched statically via Reactor::OnPollEvent
+  // Methods are now dispatched statically via Reactor::DispatchEvent
   // Subclasses (like Connection) must implement:
   // void OnReadable();
   // void OnWritable();
@@ -85,6 +92,13 @@ struct ReactorConfig {
   int max_events = 1024;         // Hint for max concurrent handlers
   int epoll_timeout_ms = 100;    // Timer resolution (for compatibility)
   bool use_edge_trigger = true;  // Ignored in libuv (uses level-triggered)
+
+  // kIoUring needs a HOLYTLS_IO_URING build and a kernel with provided
+  // buffers (IORING_OP_PROVIDE_BUFFERS, 5.7+). Buffer rings, fixed files
+  // and multishot recv are used where the kernel has them (5.19+, 6.0+);
+  // otherwise per-buffer provide, plain fds and single-shot recv. The
+  // reactor falls back to libuv only when that setup fails (last_error()).
+  ReactorBackend backend = ReactorBackend::kLibuv;
 };
 
 // Internal poll handle data
@@ -127,6 +141,14 @@ class Reactor {
 
   bool Contains(int fd) const;
 
+  // Switch a registered handler's socket to completion-based I/O and
+  // return a BIO over it for the TLS layer (caller owns it). nullptr on
+  // the libuv backend, where the socket fd is read and written directly.
+  bio_st* AttachStream(EventHandler* handler);
+
+  // Backend actually in use (kLibuv after a failed io_uring setup)
+  ReactorBackend backend() const;
+
   void Run();
   void RunOnce();
   void RunFor(int timeout_ms);
@@ -137,11 +159,24 @@ class Reactor {
   // Get current monotonic time in milliseconds (cached per iteration)
   uint64_t now_ms() const { return now_ms_; }
 
-  // Schedule a callback to run on next iteration
-  void Post(std::function<void()> callback);
+  // Schedule a callback to run on next iteration. Callbacks posted for the
+  // same iteration run most urgent first (RFC 9218 urgency, 0 highest), in
+  // posting order within an urgency.
+  void Post(std::function<void()> callback,
+            uint8_t urgency = Priority::kDefaultUrgency);
 
   // Get number of registered handlers
-  size_t handler_count() const { return fd_table_.Count(); }
+  size_t handler_count() const;
+
+  // Load signals for reactor placement (readable from any thread)
+  // Posted callbacks waiting to run
+  size_t posted_depth() const {
+    return posted_depth_.load(std::memory_order_relaxed);
+  }
+  // Smoothed delay between Post() and the callback running, in microseconds
+  uint64_t loop_lag_us() const {
+    return loop_lag_us_.load(std::memory_order_relaxed);
+  }
 
   // Access the underlying loop (for advanced use)
   uv_loop_t* loop() { return loop_; }
@@ -150,6 +185,9 @@ class Reactor {
   void UpdateTime();
   void ProcessPostedCallbacks();
 
+  // Deliver poll events to a handler; shared by both backends
+  static void DispatchEvent(EventHandler* handler, int status, int events);
+
   static void OnPollEvent(uv_poll_t* handle, int status, int events);
   static void OnTimerCallback(uv_timer_t* handle);
   static void OnAsyncCallback(uv_async_t* handle);
@@ -165,11 +203,25 @@ class Reactor {
   // O(1) fd -> PollData lookup (replaces unordered_map)
   FdTable<PollData, kMaxFds> fd_table_;
 
+#if defined(HOLYTLS_IO_URING)
+  // Set when ReactorBackend::kIoUring is in use; owns every socket then
+  std::unique_ptr<UringBackend> uring_;
+#endif
+
+  struct PostedCallback {
+    std::function<void()> callback;
+    uint8_t urgency;
+  };
+
   // Posted callbacks (thread-safe addition, processed on event loop thread)
   std::mutex posted_mutex_;
-  std::vector<std::function<void()>> posted_callbacks_;
-  std::vector<std::function<void()>> pending_callbacks_;
+  std::vector<PostedCallback> posted_callbacks_;
+  std::vector<PostedCallback> pending_callbacks_;
+  bool posted_reorder_ = false;  // A queued post has a non-default urgency
   std::atomic<bool> has_posted_{false};
+  uint64_t first_post_ns_ = 0;  // uv_hrtime() of oldest queued post
+  std::atomic<size_t> posted_depth_{0};
+  std::atomic<uint64_t> loop_lag_us_{0};
 
   // Error message from last failed initialization
   std::string last_error_;
@@ -9,13 +9,20 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "holytls/config.h"
 #include "holytls/core/reactor.h"
+#include "holytls/core/stats.h"
+#include "holytls/core/trace.h"
 #include "holytls/memory/buffer_pool.h"
+#include "holytls/memory/memory_accounting.h"
 #include "holytls/pool/connection_pool.h"
 #include "holytls/tls/tls_context.h"
 #include "holytls/util/dns_resolver.h"
@@ -31,14 +38,37 @@ struct ReactorManagerConfig {
   // Pin threads to CPU cores (improves cache locality)
   bool pin_to_cores = false;
 
+  // Socket I/O backend of every reactor
+  ReactorBackend backend = ReactorBackend::kLibuv;
+
   // Per-reactor buffer pool configuration
   size_t buffer_pool_small_count = 64;
   size_t buffer_pool_medium_count = 16;
   size_t buffer_pool_large_count = 4;
+
+  // Placement policy (see ThreadConfig)
+  ReactorPlacement placement = ReactorPlacement::kBoundedLoad;
+  double load_factor = 1.25;
+  size_t max_reactors_per_origin = 4;
+  uint64_t max_loop_lag_us = 5000;
+
+  // Tracing: per-reactor rings when trace_ring_capacity > 0, otherwise the
+  // shared trace_sink (optional, not owned)
+  TraceSink* trace_sink = nullptr;
+  size_t trace_ring_capacity = 0;
+
+  // Per-reactor memory cap (0 = none) and whether connections hold new
+  // streams while over it. Only enforced with HOLYTLS_MEMORY_ACCOUNTING.
+  size_t memory_limit_per_reactor = 0;
+  bool memory_pause_new_streams = true;
 };
 
 // Per-reactor thread context with all resources
 struct ReactorContext {
+  // Memory charged by this reactor's objects. Declared first so it outlives
+  // the reactor's own objects; charges held elsewhere keep it alive.
+  memory::MemoryAccountPtr memory;
+
   // The reactor (event loop)
   std::unique_ptr<Reactor> reactor;
 
@@ -49,17 +79,34 @@ struct ReactorContext {
   std::unique_ptr<memory::BufferPool> buffer_pool;
   std::unique_ptr<util::DnsResolver> dns_resolver;
   std::unique_ptr<pool::ConnectionPool> connection_pool;
+  std::unique_ptr<ReactorStats> stats;
+
+  // Trace sink for this reactor's events: its own ring, the configured
+  // shared sink, or null
+  std::unique_ptr<TraceRing> trace_ring;
+  TraceSink* trace = nullptr;
 
   // Reactor index
   size_t index = 0;
 
   // Running flag
   std::atomic<bool> running{false};
+
+  // Requests placed on this reactor and not yet completed. Written by the
+  // submitting thread and the reactor thread; kept on its own cache line.
+  alignas(64) std::atomic<size_t> in_flight{0};
 };
 
 // Manages multiple reactor threads for parallel I/O processing.
 // Each reactor runs in its own thread with dedicated resources.
-// Connections are distributed across reactors using consistent hashing.
+//
+// Origins are placed with consistent hashing with bounded loads: an origin
+// hashes onto a ring of virtual nodes and takes the first reactor whose load
+// (in-flight requests + queued posts, or "full" when its loop lags) is within
+// load_factor of the average. The choice is remembered so connections are
+// reused. When every reactor an origin owns is over the bound, the origin
+// spills onto the next eligible reactor on the ring, up to
+// max_reactors_per_origin, and gets a HostPool there too.
 class ReactorManager {
  public:
   explicit ReactorManager(const ReactorManagerConfig& config = {});
@@ -85,18 +132,26 @@ class ReactorManager {
   bool IsRunning() const { return running_.load(std::memory_order_acquire); }
   size_t NumReactors() const { return contexts_.size(); }
 
-  // Get reactor for a host (consistent hashing for connection affinity)
-  // Same host:port always maps to same reactor for connection reuse
+  // Get reactor for a host according to the placement policy. With kHash
+  // the same host:port always maps to the same reactor; with kBoundedLoad a
+  // hot origin may be spread over several reactors.
   ReactorContext* GetReactorForHost(std::string_view host, uint16_t port);
 
+  // Same as GetReactorForHost, and counts one in-flight request on the
+  // returned reactor. Pair with ReleaseReactor when the request completes.
+  ReactorContext* AcquireReactorForHost(std::string_view host, uint16_t port);
+  void ReleaseReactor(ReactorContext* ctx);
+
   // Get reactor by index
   ReactorContext* GetReactor(size_t index);
 
   // Round-robin reactor selection (for load balancing new hosts)
   ReactorContext* GetNextReactor();
 
-  // Post callback to specific reactor (thread-safe)
-  void Post(size_t reactor_index, std::function<void()> callback);
+  // Post callback to specific reactor (thread-safe), ahead of less urgent
+  // posts waiting for the same iteration (see Reactor::Post)
+  void Post(size_t reactor_index, std::function<void()> callback,
+            uint8_t urgency = Priority::kDefaultUrgency);
 
   // Post callback to all reactors (thread-safe)
   void PostAll(std::function<void()> callback);
@@ -104,9 +159,44 @@ class ReactorManager {
   // Get total connections across all reactors
   size_t TotalConnections() const;
 
+  // Get total in-flight requests across all reactors
+  size_t TotalInFlight() const;
+
+  // Merge every reactor's statistics (safe while reactors are running)
+  StatsSnapshot SnapshotStats() const;
+
+  // Records held in the per-reactor trace rings, ordered by time
+  std::vector<TraceRecord> CollectTrace() const;
+
+  // Per-reactor memory accounts, in reactor order
+  std::vector<const memory::MemoryAccount*> MemoryAccounts() const;
+
+  // Current placement load of a reactor (in-flight + queued posts)
+  size_t ReactorLoad(size_t index) const;
+
  private:
+  // Reactors an origin has been placed on (bounded-load policy)
+  struct OriginPlacement {
+    std::vector<uint16_t> reactors;
+  };
+
+  // Virtual nodes per reactor on the hash ring
+  static constexpr size_t kVirtualNodes = 64;
+
+  // Placement entries kept before single-reactor origins are forgotten
+  static constexpr size_t kMaxTrackedOrigins = 16384;
+
   void RunReactor(ReactorContext* ctx);
   size_t GetReactorIndex(std::string_view host, uint16_t port) const;
+  size_t PlaceBoundedLoad(std::string_view host, uint16_t port, bool acquire);
+
+  // Walk the ring from `hash` to the first reactor not in `exclude` that is
+  // within `bound`; SIZE_MAX if there is none
+  size_t FindOnRing(uint64_t hash, const std::vector<uint16_t>& exclude,
+                    size_t bound) const;
+  size_t LeastLoaded() const;
+  bool IsOverBound(size_t index, size_t bound) const;
+  size_t LoadBound() const;
 
   ReactorManagerConfig config_;
   tls::TlsContextFactory* tls_factory_ = nullptr;
@@ -114,6 +204,11 @@ class ReactorManager {
 
   std::vector<std::unique_ptr<ReactorContext>> contexts_;
   std::atomic<size_t> next_reactor_{0};  // For round-robin
+
+  // Bounded-load placement state (origins keyed by host:port hash)
+  std::vector<std::pair<uint64_t, uint16_t>> ring_;  // (hash, reactor) sorted
+  std::mutex placement_mutex_;
+  std::unordered_map<uint64_t, OriginPlacement> origins_;
   std::atomic<bool> running_{false};
   bool initialized_ = false;
 };
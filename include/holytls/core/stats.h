@@ -0,0 +1,224 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#ifndef HOLYTLS_CORE_STATS_H_
+#define HOLYTLS_CORE_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace holytls {
+namespace core {
+
+// Counter with a single writer (the owning reactor thread) and any number
+// of readers. Add() is a relaxed load + store, not a locked RMW, so updates
+// cost the same as a plain increment while reads stay race-free.
+class StatCounter {
+ public:
+  void Add(uint64_t n = 1) {
+    value_.store(value_.load(std::memory_order_relaxed) + n,
+                 std::memory_order_relaxed);
+  }
+
+  void Set(uint64_t value) {
+    value_.store(value, std::memory_order_relaxed);
+  }
+
+  uint64_t Get() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+// HDR-style latency histogram in microseconds.
+//
+// Values below 16 get their own bucket; above that each power of two is
+// split into 16 linear sub-buckets, so any recorded value is reported
+// within 1/16 (6.25%) of its true value. Covers up to 2^40 us (~12 days);
+// larger values land in the last bucket. Single writer, like StatCounter.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+  static constexpr size_t kMaxExponent = 40;
+  static constexpr size_t kBuckets =
+      (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+  void Record(uint64_t value_us) {
+    counts_[BucketIndex(value_us)].Add();
+    count_.Add();
+    sum_.Add(value_us);
+    if (value_us > max_.Get()) {
+      max_.Set(value_us);
+    }
+  }
+
+  uint64_t count() const { return count_.Get(); }
+
+  // Bucket for a value: identity below kSubBuckets, then
+  // (exponent, top kSubBucketBits bits below the leading one)
+  static size_t BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<size_t>(value);
+    }
+    size_t exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+    if (exponent > kMaxExponent) {
+      return kBuckets - 1;
+    }
+    size_t shift = exponent - kSubBucketBits;
+    size_t sub = static_cast<size_t>(value >> shift);  // [16, 32)
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + sub - kSubBuckets;
+  }
+
+  // Largest value that maps to `index`
+  static uint64_t BucketUpperBound(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    size_t exponent = index / kSubBuckets + kSubBucketBits - 1;
+    uint64_t sub = index % kSubBuckets + kSubBuckets;
+    size_t shift = exponent - kSubBucketBits;
+    return ((sub + 1) << shift) - 1;
+  }
+
+ private:
+  friend class HistogramSnapshot;
+
+  std::array<StatCounter, kBuckets> counts_{};
+  StatCounter count_;
+  StatCounter sum_;
+  StatCounter max_;
+};
+
+// Point-in-time copy of one or more merged histograms
+class HistogramSnapshot {
+ public:
+  // Add the current contents of `histogram`
+  void Merge(const LatencyHistogram& histogram);
+
+  uint64_t count() const { return count_; }
+  uint64_t max() const { return max_; }
+  double mean() const {
+    return count_ == 0 ? 0.0
+                       : static_cast<double>(sum_) / static_cast<double>(count_);
+  }
+
+  // Value at percentile p (0-100); 0 when empty. Reported as the upper
+  // bound of the bucket holding that rank, capped at the recorded maximum.
+  uint64_t Percentile(double p) const;
+
+ private:
+  std::array<uint64_t, LatencyHistogram::kBuckets> counts_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+};
+
+// Adaptive concurrency state of one origin's HostPool
+// (see pool::ConcurrencyLimiter). Written by the reactor thread that owns
+// the pool; host and port are set before it is registered.
+struct OriginLimitStats {
+  std::string host;
+  uint16_t port = 0;
+
+  StatCounter limit;
+  StatCounter in_flight;
+  StatCounter queued;           // Waiting for a slot
+  StatCounter rtt_us;           // Latest time to first byte
+  StatCounter baseline_rtt_us;  // Long-term average the limit adapts to
+  StatCounter drops;            // Limit cuts (429, 503, connection errors)
+};
+
+// Per-reactor statistics block. Written only by the owning reactor thread;
+// read from any thread by merging snapshots. Cache-line aligned so blocks of
+// neighbouring reactors never share a line.
+struct alignas(64) ReactorStats {
+  // Connections
+  StatCounter connections_created;
+  StatCounter connections_reused;  // Requests sent on an established conn
+  StatCounter connections_failed;  // Failed before becoming ready
+  StatCounter fast_open_attempts;  // Connects with TCP Fast Open enabled
+  StatCounter fast_open_accepted;  // Server accepted data in our SYN
+
+  // Requests
+  StatCounter requests_sent;
+  StatCounter requests_completed;
+  StatCounter requests_failed;
+  StatCounter requests_timeout;
+  StatCounter requests_coalesced;  // Joined an identical in-flight request
+  StatCounter requests_hedged;     // Sent a second time (HedgeConfig)
+  StatCounter hedges_won;          // ... where the second copy answered first
+  StatCounter requests_replayed;   // Sent again after the server refused it
+
+  // Application bytes through TLS
+  StatCounter bytes_sent;
+  StatCounter bytes_received;
+
+  // Phase latencies (microseconds)
+  LatencyHistogram dns;
+  LatencyHistogram connect;
+  LatencyHistogram tls;
+  LatencyHistogram ttfb;
+  LatencyHistogram total;
+
+  // Origins with an adaptive concurrency limit. Registered by their pools
+  // on the reactor thread; the list is locked so readers can walk it.
+  void RegisterOrigin(const OriginLimitStats* origin);
+  void UnregisterOrigin(const OriginLimitStats* origin);
+
+  mutable std::mutex origins_mutex;
+  std::vector<const OriginLimitStats*> origins;
+};
+
+// Copy of one OriginLimitStats
+struct OriginLimitSnapshot {
+  std::string host;
+  uint16_t port = 0;
+  uint64_t limit = 0;
+  uint64_t in_flight = 0;
+  uint64_t queued = 0;
+  uint64_t rtt_us = 0;
+  uint64_t baseline_rtt_us = 0;
+  uint64_t drops = 0;
+};
+
+// Merged view of any number of ReactorStats
+struct StatsSnapshot {
+  uint64_t connections_created = 0;
+  uint64_t connections_reused = 0;
+  uint64_t connections_failed = 0;
+  uint64_t fast_open_attempts = 0;
+  uint64_t fast_open_accepted = 0;
+  uint64_t requests_sent = 0;
+  uint64_t requests_completed = 0;
+  uint64_t requests_failed = 0;
+  uint64_t requests_timeout = 0;
+  uint64_t requests_coalesced = 0;
+  uint64_t requests_hedged = 0;
+  uint64_t hedges_won = 0;
+  uint64_t requests_replayed = 0;
+  uint64_t bytes_sent = 0;
+  uint64_t bytes_received = 0;
+
+  HistogramSnapshot dns;
+  HistogramSnapshot connect;
+  HistogramSnapshot tls;
+  HistogramSnapshot ttfb;
+  HistogramSnapshot total;
+
+  // One entry per origin per reactor it is placed on
+  std::vector<OriginLimitSnapshot> origins;
+
+  void Merge(const ReactorStats& stats);
+};
+
+}  // namespace core
+}  // namespace holytls
+
+#endif  // HOLYTLS_CORE_STATS_H_
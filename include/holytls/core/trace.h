@@ -0,0 +1,144 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#ifndef HOLYTLS_CORE_TRACE_H_
+#define HOLYTLS_CORE_TRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace holytls {
+namespace core {
+
+// Lifecycle tracing of connections and streams.
+//
+// The client calls Trace() at fixed points (DNS, connect, proxy tunnel, TLS,
+// ALPN, HTTP/2 control frames, stream open/first byte/end, pool
+// acquire/release). Calls are compiled out unless the library is built with
+// HOLYTLS_TRACING, so the default build pays nothing for them.
+#if defined(HOLYTLS_TRACING) && HOLYTLS_TRACING
+inline constexpr bool kTracingEnabled = true;
+#else
+inline constexpr bool kTracingEnabled = false;
+#endif
+
+enum class TraceEvent : uint8_t {
+  kDnsStart,          // id: host hash
+  kDnsEnd,            // id: host hash, arg: addresses resolved
+  kConnectStart,      // TCP connect started
+  kConnectEnd,        // arg: 1 on success, 0 on failure
+  kProxyTunnelStart,  // CONNECT / SOCKS handshake started
+  kProxyTunnelEnd,    // arg: 1 on success, 0 on failure
+  kTlsStart,
+  kTlsEnd,            // arg: 0 failed, 1 full handshake, 2 resumed
+  kAlpn,              // arg: negotiated HTTP major version (1 or 2)
+  kH2Settings,        // arg: 1 for a SETTINGS ACK
+  kH2Goaway,          // stream: last stream id, arg: error code
+  kH2RstStream,       // arg: error code
+  kStreamOpen,
+  kStreamFirstByte,   // Response headers received
+  kStreamEnd,         // arg: error code (0 on success, REFUSED_STREAM or
+                      // INTERNAL_ERROR when the connection drops the
+                      // stream, CANCEL when the request is cancelled)
+  kPoolAcquire,       // arg: active streams after acquire
+  kPoolRelease,       // arg: active streams after release
+};
+
+// Name of an event as shown in trace viewers
+std::string_view TraceEventName(TraceEvent event);
+
+// One fixed-size binary trace record
+struct TraceRecord {
+  uint64_t time_us = 0;  // uv_hrtime() in microseconds
+  uint64_t id = 0;       // Connection address (host hash for DNS events)
+  int64_t stream = -1;   // Stream id, -1 for connection-level events
+  uint64_t arg = 0;      // Event specific, see TraceEvent
+  uint32_t reactor = 0;  // Index of the reactor that emitted the event
+  TraceEvent event = TraceEvent::kDnsStart;
+};
+
+static_assert(std::is_trivially_copyable_v<TraceRecord>);
+
+// Receives trace records. Called on reactor threads; a sink shared by
+// several reactors must be thread-safe.
+class TraceSink {
+ public:
+  virtual ~TraceSink() = default;
+  virtual void Record(const TraceRecord& record) = 0;
+};
+
+// Keeps the most recent `capacity` records, overwriting the oldest. One
+// ring per reactor: the lock is only contended while a snapshot is taken.
+class TraceRing : public TraceSink {
+ public:
+  explicit TraceRing(size_t capacity);
+
+  void Record(const TraceRecord& record) override;
+
+  // Records currently held, oldest first
+  std::vector<TraceRecord> Snapshot() const;
+
+  size_t capacity() const { return records_.size(); }
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<TraceRecord> records_;
+  uint64_t written_ = 0;
+};
+
+namespace detail {
+
+// Stamp time and reactor, then hand the record to `sink`
+void EmitTrace(TraceSink* sink, TraceEvent event, uint64_t id, int64_t stream,
+               uint64_t arg);
+
+}  // namespace detail
+
+// Reactor index stamped on records emitted from the calling thread
+void SetTraceReactor(uint32_t reactor);
+
+// Emit an event to `sink` (may be null). Compiles to nothing without
+// HOLYTLS_TRACING: the body is discarded at instantiation.
+template <typename Id>
+inline void Trace(TraceSink* sink, TraceEvent event, Id id,
+                  int64_t stream = -1, uint64_t arg = 0) {
+  if constexpr (kTracingEnabled) {
+    if (sink != nullptr) {
+      uint64_t raw;
+      if constexpr (std::is_pointer_v<Id>) {
+        raw = reinterpret_cast<uintptr_t>(id);
+      } else {
+        raw = static_cast<uint64_t>(id);
+      }
+      detail::EmitTrace(sink, event, raw, stream, arg);
+    }
+  } else {
+    (void)sink;
+    (void)event;
+    (void)id;
+    (void)stream;
+    (void)arg;
+  }
+}
+
+// Binary trace file: 8-byte magic "HTLSTRC1" followed by raw TraceRecords
+// in host byte order
+bool WriteTraceFile(const std::string& path,
+                    std::span<const TraceRecord> records);
+bool ReadTraceFile(const std::string& path, std::vector<TraceRecord>* out);
+
+// Chrome trace-event JSON (loads in Perfetto and chrome://tracing). Phase
+// pairs become async spans keyed by connection (and stream); the rest are
+// instant events. One track per reactor.
+std::string TraceToChromeJson(std::span<const TraceRecord> records);
+
+}  // namespace core
+}  // namespace holytls
+
+#endif  // HOLYTLS_CORE_TRACE_H_
@@ -19,6 +19,7 @@ enum class ErrorCode : uint8_t {
   kCancelled,
   kInvalidUrl,
   kInternal,
+  kMemoryLimit,  // Rejected: the reactor is over its memory cap
 };
 
 struct Error {
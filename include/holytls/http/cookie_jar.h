@@ -13,6 +13,8 @@
 #include <string_view>
 #include <vector>
 
+#include "holytls/memory/memory_accounting.h"
+
 namespace holytls {
 namespace http {
 
@@ -131,8 +133,12 @@ class CookieJar {
   static void ParseAttribute(std::string_view attr, Cookie* cookie,
                              uint64_t now_ms);
 
+  // Recharge the stored cookies' footprint (caller holds mutex_)
+  void UpdateMemoryCharge();
+
   mutable std::mutex mutex_;
   std::vector<Cookie> cookies_;
+  memory::MemoryCharge charge_{memory::MemoryTag::kCookieJar};
 };
 
 }  // namespace http
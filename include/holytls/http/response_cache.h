@@ -0,0 +1,228 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#ifndef HOLYTLS_HTTP_RESPONSE_CACHE_H_
+#define HOLYTLS_HTTP_RESPONSE_CACHE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "holytls/http2/packed_headers.h"
+#include "holytls/types.h"
+
+namespace holytls {
+namespace http {
+
+class CacheSegmentStore;
+
+// Response cache configuration
+struct ResponseCacheConfig {
+  // Memory tier budget, split evenly across the shards
+  size_t max_memory_bytes = 64 * 1024 * 1024;
+
+  // Independently locked LRU shards (reactors rarely contend on one)
+  size_t shards = 16;
+
+  // Responses larger than this are not stored
+  size_t max_entry_bytes = 8 * 1024 * 1024;
+
+  // Directory for the on-disk tier (empty = memory only). Entries are
+  // written through to memory-mapped segment files by a background thread
+  // and survive restarts; memory misses fall back to it. Entries larger
+  // than a segment are kept in memory only. Not available on Windows.
+  std::string disk_path;
+  size_t max_disk_bytes = 256 * 1024 * 1024;
+  size_t disk_segment_bytes = 16 * 1024 * 1024;
+};
+
+// A stored response with its freshness state (RFC 9111 §4.2). Times are
+// wall-clock milliseconds since the epoch.
+struct CachedResponse {
+  int status_code = 0;
+  http2::PackedHeaders headers;
+  std::vector<uint8_t> body;
+
+  uint64_t response_time_ms = 0;  // Received (or last revalidated)
+  uint64_t initial_age_ms = 0;    // Corrected age on arrival
+  uint64_t lifetime_ms = 0;       // Freshness lifetime
+  bool no_cache = false;          // Revalidate before every use
+
+  // Request headers named by Vary, with the values they were sent with
+  Headers vary;
+
+  uint64_t AgeMs(uint64_t now_ms) const {
+    return initial_age_ms +
+           (now_ms > response_time_ms ? now_ms - response_time_ms : 0);
+  }
+  bool IsFresh(uint64_t now_ms) const {
+    return !no_cache && lifetime_ms > AgeMs(now_ms);
+  }
+
+  std::string_view etag() const { return headers.Get(http2::HeaderId::kEtag); }
+  std::string_view last_modified() const {
+    return headers.Get(http2::HeaderId::kLastModified);
+  }
+  bool HasValidator() const {
+    return !etag().empty() || !last_modified().empty();
+  }
+
+  // Approximate memory footprint
+  size_t ByteSize() const;
+};
+
+// Result of ResponseCache::Lookup
+struct CacheLookup {
+  std::shared_ptr<const CachedResponse> entry;  // nullptr on a miss
+  bool fresh = false;  // Usable as-is; otherwise revalidate `entry`
+};
+
+// Value of a request header as sent (empty when absent). Used for Vary
+// matching and request Cache-Control.
+using RequestHeaderLookup =
+    std::function<std::string_view(std::string_view name)>;
+
+struct ResponseCacheStats {
+  uint64_t hits = 0;           // Fresh entries served
+  uint64_t misses = 0;         // No usable entry
+  uint64_t stale = 0;          // Entries returned for revalidation
+  uint64_t revalidations = 0;  // 304s that reused a stored body
+  uint64_t stores = 0;
+  uint64_t evictions = 0;  // Memory tier LRU evictions
+  size_t memory_entries = 0;
+  size_t memory_bytes = 0;
+  size_t disk_entries = 0;
+  size_t disk_bytes = 0;
+  uint64_t disk_dropped = 0;  // Writes skipped while the writer was behind
+};
+
+// Thread-safe private HTTP cache (RFC 9111)
+//
+// 1. Responses to GET are stored keyed by method and URL; Vary selects
+//    between requests by the listed request headers
+// 2. Freshness comes from Cache-Control max-age, Expires or the
+//    Last-Modified heuristic, less the Age the response arrived with
+// 3. Stale entries with an ETag or Last-Modified are revalidated; a 304
+//    freshens the entry and its body is reused
+// 4. Successful unsafe requests (POST, PUT, ...) invalidate their URL
+//
+// Set ClientConfig::response_cache to use it from HttpClient; fresh hits
+// complete without DNS, the connection pool or the network.
+class ResponseCache {
+ public:
+  explicit ResponseCache(const ResponseCacheConfig& config = {});
+  ~ResponseCache();
+
+  // Non-copyable, non-movable
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // Only GET responses are stored and served
+  static bool IsCacheableMethod(std::string_view method);
+
+  // Find a stored response for the request. Honors request no-store (a
+  // miss), no-cache and max-age (stale).
+  CacheLookup Lookup(std::string_view method, std::string_view url,
+                     const RequestHeaderLookup& request_header);
+
+  // Store a response if RFC 9111 §3 allows it. `request_time_ms` is when
+  // the request was sent. Returns true if stored; a no-store response also
+  // removes any stored entry.
+  bool Store(std::string_view method, std::string_view url,
+             const RequestHeaderLookup& request_header, int status_code,
+             const http2::PackedHeaders& headers,
+             std::span<const uint8_t> body, uint64_t request_time_ms);
+
+  // Freshen `entry` with the headers of a 304 received for it (§4.3.4) and
+  // return the updated entry
+  std::shared_ptr<const CachedResponse> Revalidated(
+      std::string_view method, std::string_view url,
+      const std::shared_ptr<const CachedResponse>& entry,
+      const http2::PackedHeaders& headers, uint64_t request_time_ms);
+
+  // Drop whatever is stored for `url` (§4.4)
+  void Invalidate(std::string_view url);
+
+  void Clear();
+
+  ResponseCacheStats GetStats() const;
+
+  // Whether the on-disk tier opened
+  bool disk_enabled() const { return disk_ != nullptr; }
+
+  // Wall clock (milliseconds since the epoch)
+  static uint64_t NowMs();
+
+ private:
+  struct Node {
+    std::string key;
+    std::shared_ptr<const CachedResponse> entry;
+    size_t bytes = 0;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::list<Node> lru;  // Most recently used first
+    std::unordered_map<std::string_view, std::list<Node>::iterator> index;
+    size_t bytes = 0;
+  };
+
+  static std::string MakeKey(std::string_view method, std::string_view url);
+  Shard& ShardFor(std::string_view key);
+
+  // Insert into the memory tier (and the disk tier when `persist` is set)
+  void Insert(const std::string& key,
+              std::shared_ptr<const CachedResponse> entry, bool persist);
+  void Remove(const std::string& key);
+
+  // Disk tier writes go through one queue, in order, so reactors never copy
+  // bodies into the mapped segments. A null entry is a removal.
+  struct DiskWrite {
+    std::string key;
+    std::shared_ptr<const CachedResponse> entry;
+    size_t bytes = 0;
+  };
+  void QueueDiskWrite(const std::string& key,
+                      std::shared_ptr<const CachedResponse> entry);
+  void RunDiskWriter();
+
+  ResponseCacheConfig config_;
+  size_t shard_budget_;
+  std::unique_ptr<Shard[]> shards_;
+  std::unique_ptr<CacheSegmentStore> disk_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> stale_{0};
+  std::atomic<uint64_t> revalidations_{0};
+  std::atomic<uint64_t> stores_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> disk_dropped_{0};
+
+  // Disk writer state. disk_write_mutex_ is held across each write so
+  // Clear() cannot land between a dequeue and its write.
+  std::mutex disk_queue_mutex_;
+  std::condition_variable disk_queue_cv_;
+  std::deque<DiskWrite> disk_queue_;
+  size_t disk_queue_bytes_ = 0;
+  bool disk_writer_stop_ = false;
+  std::mutex disk_write_mutex_;
+  std::thread disk_writer_;
+};
+
+}  // namespace http
+}  // namespace holytls
+
+#endif  // HOLYTLS_HTTP_RESPONSE_CACHE_H_
@@ -0,0 +1,84 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// ConcurrencyLimiter - adaptive in-flight request limit for one origin.
+//
+// Gradient-based, in the style of Netflix's Gradient2: a long-term average
+// of the time to first byte is the baseline, and each sample moves the
+// limit by the ratio of baseline to sample, plus a queue allowance of
+// sqrt(limit) so the limit keeps probing upwards while latency is flat.
+// Rising latency (queueing at the server) shrinks it; 429/503 responses
+// and connection errors cut it multiplicatively, and a Retry-After holds
+// it from growing until the server says it may. Samples taken while fewer
+// than half the permitted requests are in flight say nothing about the
+// server's capacity and are ignored.
+//
+// Single-threaded, like the HostPool that owns it. Times are passed in so
+// the algorithm can be driven without a reactor.
+
+#ifndef HOLYTLS_POOL_CONCURRENCY_LIMITER_H_
+#define HOLYTLS_POOL_CONCURRENCY_LIMITER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "holytls/config.h"
+
+namespace holytls {
+namespace pool {
+
+class ConcurrencyLimiter {
+ public:
+  explicit ConcurrencyLimiter(const ConcurrencyLimitConfig& config);
+
+  // Requests that may be in flight at once
+  size_t limit() const { return static_cast<size_t>(limit_); }
+
+  // A request completed at `now_ms` with `rtt_us` from send to response
+  // headers while `in_flight` requests (itself included) were outstanding
+  void OnSample(uint64_t now_ms, uint64_t rtt_us, size_t in_flight);
+
+  // A request was shed by the origin (429, 503) or failed on the
+  // connection. `retry_after_ms` (0 = none) holds the limit from growing
+  // for that long after `now_ms`.
+  void OnDrop(uint64_t now_ms, uint64_t retry_after_ms = 0);
+
+  // Whether a Retry-After hold is in effect at `now_ms`
+  bool Held(uint64_t now_ms) const { return now_ms < hold_until_ms_; }
+
+  // Latest sample and the long-term baseline (microseconds, 0 = none yet)
+  uint64_t rtt_us() const { return last_rtt_us_; }
+  uint64_t baseline_rtt_us() const {
+    return static_cast<uint64_t>(long_rtt_us_);
+  }
+
+  // Times the limit was cut
+  uint64_t drops() const { return drops_; }
+
+  // Samples averaged before the baseline becomes an EWMA
+  static constexpr uint64_t kWarmupSamples = 10;
+
+  // Baseline EWMA window in samples
+  static constexpr double kLongWindow = 600.0;
+
+ private:
+  ConcurrencyLimitConfig config_;
+
+  double limit_;
+  double long_rtt_us_ = 0.0;
+  uint64_t last_rtt_us_ = 0;
+  uint64_t samples_ = 0;
+  uint64_t drops_ = 0;
+
+  // Set by OnDrop; OnSample does not raise the limit before this
+  uint64_t hold_until_ms_ = 0;
+
+  // When the limit was last cut, so one burst of shed requests cuts it once
+  uint64_t last_drop_ms_ = 0;
+  bool dropped_ = false;
+};
+
+}  // namespace pool
+}  // namespace holytls
+
+#endif  // HOLYTLS_POOL_CONCURRENCY_LIMITER_H_
@@ -13,6 +13,9 @@
 
 #include "holytls/config.h"
 #include "holytls/core/reactor.h"
+#include "holytls/core/stats.h"
+#include "holytls/core/trace.h"
+#include "holytls/memory/memory_accounting.h"
 #include "holytls/tls/tls_context.h"
 
 // Forward declare QUIC types to avoid including heavy headers
@@ -52,6 +55,25 @@ struct ConnectionPoolConfig {
 
   // Proxy configuration
   ProxyConfig proxy;
+
+  // Socket buffer sizing and TCP options
+  SocketConfig socket;
+
+  // Statistics block of the owning reactor (optional, not owned)
+  core::ReactorStats* stats = nullptr;
+
+  // Time connection phases with uv_hrtime() (see ConnectionOptions)
+  bool high_resolution_timing = false;
+
+  // Trace sink of the owning reactor (optional, not owned)
+  core::TraceSink* trace = nullptr;
+
+  // Memory account of the owning reactor; connections open no new streams
+  // while it is over its cap (optional, not owned)
+  memory::MemoryAccount* memory = nullptr;
+
+  // Adaptive cap on requests in flight per host
+  ConcurrencyLimitConfig concurrency_limit;
 };
 
 // Result type for protocol-agnostic connection acquisition
@@ -79,9 +101,11 @@ class ConnectionPool {
 
   // Protocol-agnostic connection acquisition
   // Returns either a TCP connection (HTTP/1 or HTTP/2) or QUIC connection
-  // (HTTP/3) based on the pool's protocol preference
-  AnyPooledConnection AcquireAnyConnection(const std::string& host,
-                                           uint16_t port);
+  // (HTTP/3) based on the pool's protocol preference. TCP connections are
+  // handed out by urgency (see HostPool::AcquireConnection).
+  AnyPooledConnection AcquireAnyConnection(
+      const std::string& host, uint16_t port,
+      uint8_t urgency = Priority::kDefaultUrgency);
 
   // Release any connection type back to the pool
   void ReleaseAnyConnection(AnyPooledConnection conn);
@@ -91,8 +115,9 @@ class ConnectionPool {
 
   // TCP-specific: Acquire a connection to host:port
   // Returns nullptr if pool is exhausted
-  PooledConnection* AcquireTcpConnection(const std::string& host,
-                                         uint16_t port);
+  PooledConnection* AcquireTcpConnection(
+      const std::string& host, uint16_t port,
+      uint8_t urgency = Priority::kDefaultUrgency);
 
   // TCP-specific: Release a connection back to the pool
   void ReleaseTcpConnection(PooledConnection* conn);
@@ -6,14 +6,22 @@
 
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "holytls/config.h"
 #include "holytls/core/connection.h"
 #include "holytls/core/reactor.h"
+#include "holytls/core/stats.h"
+#include "holytls/memory/memory_accounting.h"
+#include "holytls/memory/slab_allocator.h"
+#include "holytls/pool/concurrency_limiter.h"
 #include "holytls/tls/tls_context.h"
+#include "holytls/types.h"
 
 namespace holytls {
 namespace pool {
@@ -22,7 +30,7 @@ namespace pool {
 class HostPool;
 
 // Pooled connection wrapper with pool metadata
-struct PooledConnection {
+struct PooledConnection : memory::SlabAllocated<PooledConnection> {
   // The underlying connection
   std::unique_ptr<core::Connection> connection;
 
@@ -40,17 +48,53 @@ struct PooledConnection {
   // Health tracking
   size_t consecutive_errors = 0;
   bool marked_for_removal = false;
+  bool established = false;  // TLS handshake completed at least once
 
-  bool HasCapacity() const {
-    // Query connection for actual max streams (handles HTTP/1.1 vs HTTP/2)
-    size_t actual_max = max_streams;
+  // Query connection for actual max streams (handles HTTP/1.1 vs HTTP/2)
+  size_t StreamLimit() const {
     if (connection && connection->IsConnected()) {
-      actual_max = connection->MaxConcurrentStreams();
+      return connection->MaxConcurrentStreams();
     }
-    return active_stream_count < actual_max && !marked_for_removal;
+    return max_streams;
+  }
+
+  bool HasCapacity() const {
+    return active_stream_count < StreamLimit() && !marked_for_removal;
   }
 
   bool IsIdle() const { return active_stream_count == 0; }
+
+  // Whether the connection can take no more requests: closed, failed, or
+  // told by the server (GOAWAY) to stop opening streams
+  bool IsRetiring() const {
+    if (!connection) {
+      return true;
+    }
+    switch (connection->state()) {
+      case core::ConnectionState::kConnected:
+        return connection->IsGoingAway();
+      case core::ConnectionState::kClosed:
+      case core::ConnectionState::kError:
+        return true;
+      default:
+        return false;
+    }
+  }
+};
+
+// TCP Fast Open outcomes for one origin (see SocketConfig::tcp_fast_open)
+struct FastOpenStats {
+  size_t attempts = 0;  // Connections established with TFO enabled
+  size_t accepted = 0;  // ... whose SYN data the server accepted
+
+  // Established TFO connections in a row whose SYN data was not accepted.
+  // The first connection to a server only fetches the cookie, so one miss
+  // is expected.
+  size_t consecutive_misses = 0;
+
+  // Set once consecutive_misses reaches the limit: the origin (or a
+  // middlebox in front of it) does not support TFO
+  bool disabled = false;
 };
 
 // Callback for when a pooled connection needs to be created
@@ -67,11 +111,47 @@ struct HostPoolConfig {
 
   // Proxy configuration
   ProxyConfig proxy;
+
+  // Socket buffer sizing and TCP options
+  SocketConfig socket;
+
+  // Statistics block of the owning reactor (optional, not owned)
+  core::ReactorStats* stats = nullptr;
+
+  // Time connection phases with uv_hrtime() (see ConnectionOptions)
+  bool high_resolution_timing = false;
+
+  // Trace sink of the owning reactor (optional, not owned)
+  core::TraceSink* trace = nullptr;
+
+  // Memory account of the owning reactor; connections open no new streams
+  // while it is over its cap (optional, not owned)
+  memory::MemoryAccount* memory = nullptr;
+
+  // Adaptive cap on requests in flight to this host
+  ConcurrencyLimitConfig concurrency_limit;
 };
 
+// Invoked with an acquired connection when a queued request gets a stream
+// slot. With nullptr the request was cancelled (empty `error`), or the
+// pool has no connection left for it to wait on (`error` says why).
+using SlotCallback =
+    std::function<void(PooledConnection* conn, std::string_view error)>;
+
 // Per-host connection pool.
 // Manages connections to a single host:port pair.
 // NOT thread-safe - designed for single-reactor use.
+//
+// Requests that find no free stream wait in a queue ordered by urgency
+// (FIFO within one) and are handed connections as they come up and as
+// streams are released. If the last connection fails before it is ever
+// established, the queue is failed with its error. Background requests (Priority::is_background) do
+// not take the last free stream of a pool at its connection limit while
+// another stream is busy, so interactive requests always find a slot.
+//
+// With ConcurrencyLimitConfig::enabled, requests in flight are also capped
+// by a ConcurrencyLimiter fed through RecordSample() and RecordDrop();
+// requests over the limit queue the same way.
 class HostPool {
  public:
   // Read-only pool identity (set at construction)
@@ -88,16 +168,55 @@ class HostPool {
   HostPool(HostPool&&) = delete;
   HostPool& operator=(HostPool&&) = delete;
 
-  // Acquire a connection with available stream capacity.
-  // Returns nullptr if no connection available and at limit.
+  // Acquire a connection with available stream capacity for a request of
+  // `urgency`. Returns nullptr if none is available, or if a queued request
+  // at least as urgent is waiting (it is served first).
   // The connection is marked as having one more active stream.
-  PooledConnection* AcquireConnection();
+  PooledConnection* AcquireConnection(
+      uint8_t urgency = Priority::kDefaultUrgency);
+
+  // Connection for a hedged copy of a request in flight on `avoid`: another
+  // connection with a free stream, preferring one to a different address.
+  // Connections still being set up qualify; the request waits on them.
+  // Returns nullptr if there is none or the concurrency limit is reached.
+  PooledConnection* AcquireAlternate(const PooledConnection* avoid);
+
+  // Queue a request for the next stream slot its urgency allows. Returns an
+  // id for Cancel().
+  uint64_t Enqueue(uint8_t urgency, SlotCallback on_slot);
+
+  // Remove a queued request and invoke its callback with nullptr. Returns
+  // false if it was already served.
+  bool Cancel(uint64_t id);
+
+  // Requests waiting for a stream slot
+  size_t PendingRequests() const { return pending_.size(); }
+
+  // Streams in use across all connections
+  size_t InFlight() const;
+
+  // Whether the adaptive limit is reached; further requests queue rather
+  // than open connections
+  bool AtConcurrencyLimit() const {
+    return limiter_ && InFlight() >= limiter_->limit();
+  }
+
+  // Feed the adaptive limit (no-ops when it is disabled). Call before the
+  // request's stream is released: a response arrived `rtt_us` after the
+  // request was sent, or the origin shed it (429, 503, connection error),
+  // with `retry_after_ms` from its Retry-After.
+  void RecordSample(uint64_t rtt_us);
+  void RecordDrop(uint64_t retry_after_ms = 0);
+
+  // Adaptive limiter, or nullptr when disabled
+  const ConcurrencyLimiter* limiter() const { return limiter_.get(); }
 
   // Release a connection (decrements stream count).
   // If connection becomes idle, it's moved to idle list.
   void ReleaseConnection(PooledConnection* conn);
 
-  // Mark a connection as failed (removes from pool).
+  // Release a stream whose connection failed under it, and retire the
+  // connection (removed once no other stream uses it).
   void FailConnection(PooledConnection* conn);
 
   // Create a new connection (async - returns immediately).
@@ -114,19 +233,68 @@ class HostPool {
   size_t ActiveConnections() const;
   size_t IdleConnections() const;
 
+  // TCP Fast Open outcomes for this origin
+  const FastOpenStats& fast_open() const { return fast_open_; }
+
+  // Consecutive misses after which TFO is no longer used for an origin
+  static constexpr size_t kMaxFastOpenMisses = 3;
+
  private:
+  void OnConnectionEstablished(core::Connection* conn);
   void OnConnectionIdle(core::Connection* conn);
+
+  // A connection failed or was closed by the peer: retire it, and open a
+  // replacement if it had been working and requests are queued
+  void OnConnectionClosed(PooledConnection* conn);
+
+  // Fail every queued request with `error`
+  void FailPending(std::string_view error);
   void RemoveConnection(PooledConnection* conn);
   void CleanupMarkedConnections();
+
+  // Take `conn` out of service; it is closed and destroyed on the next
+  // loop iteration, as this may run inside one of its own callbacks
+  void Retire(std::unique_ptr<PooledConnection> conn);
   PooledConnection* FindConnectionWithCapacity();
   PooledConnection* FindIdleConnection();
 
+  // Connection for a request of `urgency`, ignoring the queue
+  PooledConnection* TryAcquire(uint8_t urgency);
+
+  // Run DispatchPending() on the next loop iteration. Streams are freed
+  // and connections come up inside connection callbacks, where sending is
+  // not safe.
+  void ScheduleDispatch();
+
+  // Hand free streams to queued requests, most urgent first
+  void DispatchPending();
+
+  // Copy the limiter state into limit_stats_
+  void PublishLimit();
+
   HostPoolConfig config_;
   core::Reactor* reactor_;
   tls::TlsContextFactory* tls_factory_;
 
   // All connections (owns the PooledConnection objects)
   std::vector<std::unique_ptr<PooledConnection>> connections_;
+
+  // Removed connections awaiting destruction (see Retire())
+  std::vector<std::unique_ptr<PooledConnection>> retired_;
+
+  FastOpenStats fast_open_;
+
+  // Queued requests keyed by (urgency, arrival)
+  std::map<std::pair<uint8_t, uint64_t>, SlotCallback> pending_;
+  uint64_t next_pending_id_ = 1;
+  bool dispatching_ = false;
+  bool dispatch_posted_ = false;
+
+  std::unique_ptr<ConcurrencyLimiter> limiter_;
+  core::OriginLimitStats limit_stats_;  // Registered with config_.stats
+
+  // Expires with the pool; posted dispatches check it
+  std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
 };
 
 }  // namespace pool
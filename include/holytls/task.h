@@ -4,8 +4,12 @@
 #ifndef HOLYTLS_TASK_H_
 #define HOLYTLS_TASK_H_
 
+#include <condition_variable>
 #include <coroutine>
+#include <cstddef>
 #include <cstdlib>
+#include <mutex>
+#include <new>
 #include <optional>
 #include <utility>
 #include <variant>
@@ -20,9 +24,92 @@ class Task;
 
 namespace detail {
 
+// Per-thread cache of coroutine frames, bucketed by size.
+//
+// Each reactor thread gets its own free lists, so in steady state creating
+// a coroutine does not touch malloc. A frame freed on a different thread
+// than the one that allocated it simply joins the freeing thread's cache.
+// Large frames and overflow beyond kMaxCachedFrames go to operator new.
+class FrameCache {
+ public:
+  static constexpr size_t kGranularity = 64;
+  static constexpr size_t kClasses = 32;  // Frames up to 2 KiB are cached
+  static constexpr size_t kMaxCachedFrames = 256;  // Per class
+
+  FrameCache() = default;
+  ~FrameCache() {
+    for (Bucket& bucket : buckets_) {
+      while (bucket.head) {
+        FreeFrame* frame = bucket.head;
+        bucket.head = frame->next;
+        ::operator delete(frame);
+      }
+    }
+  }
+
+  // Non-copyable, non-movable
+  FrameCache(const FrameCache&) = delete;
+  FrameCache& operator=(const FrameCache&) = delete;
+  FrameCache(FrameCache&&) = delete;
+  FrameCache& operator=(FrameCache&&) = delete;
+
+  static FrameCache& Local() {
+    thread_local FrameCache cache;
+    return cache;
+  }
+
+  void* Allocate(size_t size) {
+    size_t cls = (size - 1) / kGranularity;
+    if (cls >= kClasses) {
+      return ::operator new(size);
+    }
+    Bucket& bucket = buckets_[cls];
+    if (bucket.head) {
+      FreeFrame* frame = bucket.head;
+      bucket.head = frame->next;
+      --bucket.count;
+      return frame;
+    }
+    return ::operator new((cls + 1) * kGranularity);
+  }
+
+  void Deallocate(void* ptr, size_t size) noexcept {
+    size_t cls = (size - 1) / kGranularity;
+    if (cls >= kClasses || buckets_[cls].count >= kMaxCachedFrames) {
+      ::operator delete(ptr);
+      return;
+    }
+    Bucket& bucket = buckets_[cls];
+    bucket.head = new (ptr) FreeFrame{bucket.head};
+    ++bucket.count;
+  }
+
+ private:
+  struct FreeFrame {
+    FreeFrame* next;
+  };
+
+  struct Bucket {
+    FreeFrame* head = nullptr;
+    size_t count = 0;
+  };
+
+  Bucket buckets_[kClasses];
+};
+
+// Frames of every coroutine type in the library come from FrameCache
+struct PooledFrame {
+  static void* operator new(size_t size) {
+    return FrameCache::Local().Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) noexcept {
+    FrameCache::Local().Deallocate(ptr, size);
+  }
+};
+
 // Promise base with common functionality
 template <typename T>
-struct TaskPromiseBase {
+struct TaskPromiseBase : PooledFrame {
   std::coroutine_handle<> continuation_;
 
   auto initial_suspend() noexcept { return std::suspend_always{}; }
@@ -31,6 +118,46 @@ struct TaskPromiseBase {
   [[noreturn]] void unhandled_exception() noexcept { std::abort(); }
 };
 
+// Fire-and-forget coroutine used to drive Tasks. Starts immediately and
+// frees its own frame when it returns.
+struct Detached {
+  struct promise_type : PooledFrame {
+    Detached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    [[noreturn]] void unhandled_exception() noexcept { std::abort(); }
+  };
+};
+
+// Blocks a non-reactor thread until `count` Tasks have finished.
+// Set() notifies under the lock, so the waiter can't return (and destroy
+// the event) while a reactor thread is still inside Set().
+class SyncWaitEvent {
+ public:
+  explicit SyncWaitEvent(size_t count = 1) : remaining_(count) {}
+
+  void Set() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--remaining_ == 0) {
+      cv_.notify_all();
+    }
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return remaining_ == 0; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t remaining_;
+};
+
+template <typename T>
+Detached SyncWaitDriver(const Task<T>& task, SyncWaitEvent* event);
+
 // Promise for Task<T> where T is not void
 template <typename T>
 struct TaskPromise : TaskPromiseBase<T> {
@@ -157,54 +284,14 @@ class Task {
     return Awaiter{handle_};
   }
 
-  // Start the coroutine and block until completion (for sync contexts)
-  // WARNING: This will block the calling thread!
+  // Start the coroutine and block until it completes. The task must be able
+  // to finish without this thread (e.g. on reactor threads); never call this
+  // from a reactor thread.
   T sync_wait() {
-    struct SyncWaiter {
-      std::coroutine_handle<> handle_;
-      bool done_ = false;
-
-      bool await_ready() noexcept { return false; }
-
-      void await_suspend(std::coroutine_handle<> h) noexcept { handle_ = h; }
-
-      void await_resume() noexcept {}
-    };
-
-    // Create a wrapper coroutine that signals completion
-    struct Runner {
-      Task& task_;
-      bool& done_;
-
-      struct promise_type {
-        Runner get_return_object() noexcept {
-          return Runner{*static_cast<Task*>(nullptr),
-                        *static_cast<bool*>(nullptr)};
-        }
-        auto initial_suspend() noexcept { return std::suspend_never{}; }
-        auto final_suspend() noexcept { return std::suspend_never{}; }
-        void return_void() noexcept {}
-        void unhandled_exception() { std::terminate(); }
-      };
-    };
-
-    // Simple blocking implementation
-    bool done = false;
-    auto wrapper = [](Task task, bool* done_ptr) -> Task<T> {
-      auto result = co_await std::move(task);
-      *done_ptr = true;
-      co_return result;
-    };
-
-    auto wrapped = wrapper(std::move(*this), &done);
-    wrapped.handle_.resume();
-
-    // Spin until done (not ideal, but works for simple cases)
-    while (!done && !wrapped.handle_.done()) {
-      // In a real implementation, you'd integrate with an event loop
-    }
-
-    return std::move(wrapped.handle_.promise()).result();
+    detail::SyncWaitEvent event;
+    detail::SyncWaitDriver(*this, &event);
+    event.Wait();
+    return std::move(handle_.promise()).result();
   }
 
   // Resume the coroutine (for manual control)
@@ -227,6 +314,13 @@ class Task {
 // Implementation of get_return_object
 namespace detail {
 
+// Awaits `task` (result stays in its promise) and signals `event`
+template <typename T>
+Detached SyncWaitDriver(const Task<T>& task, SyncWaitEvent* event) {
+  co_await task;
+  event->Set();
+}
+
 template <typename T>
 Task<T> TaskPromise<T>::get_return_object() noexcept {
   return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
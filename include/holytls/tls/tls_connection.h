@@ -59,9 +59,11 @@ class TlsConnection {
   const std::string hostname;
 
   // Create TLS connection wrapping the given socket fd.
-  // Port is used for session cache keying.
+  // Port is used for session cache keying. When `bio` is given (the
+  // io_uring reactor's stream BIO), records go through it instead of the
+  // fd, and the connection takes ownership of it.
   TlsConnection(TlsContextFactory* factory, int socket_fd,
-                std::string_view host, uint16_t p = 443);
+                std::string_view host, uint16_t p = 443, BIO* bio = nullptr);
   ~TlsConnection();
 
   // Non-copyable, non-movable
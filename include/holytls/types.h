@@ -22,6 +22,21 @@ struct Header {
 // Collection of HTTP headers
 using Headers = std::vector<Header>;
 
+// Extensible priority of a request (RFC 9218). Lower urgency is more
+// important; a request without one is treated as the defaults.
+struct Priority {
+  static constexpr uint8_t kDefaultUrgency = 3;
+  static constexpr uint8_t kLowestUrgency = 7;
+
+  uint8_t urgency = kDefaultUrgency;  // 0 (highest) to 7 (lowest)
+  bool incremental = false;           // Response is usable as it arrives
+
+  // Less urgent than the default: bulk work that yields connection slots
+  bool is_background() const { return urgency > kDefaultUrgency; }
+
+  bool operator==(const Priority&) const = default;
+};
+
 // Forward declaration for OrderedHeaders (see holytls/http/ordered_headers.h)
 namespace http {
 class OrderedHeaders;
@@ -15,6 +15,8 @@
 #include <string_view>
 #include <vector>
 
+#include "holytls/memory/memory_accounting.h"
+
 namespace holytls {
 namespace util {
 
@@ -94,6 +96,9 @@ class DnsResolver {
   DnsCacheEntry cache_[kMaxCacheEntries] = {};
   size_t cache_hits_ = 0;
   size_t cache_misses_ = 0;
+
+  // The cache is embedded in the resolver; its size is charged once
+  memory::MemoryCharge cache_charge_{memory::MemoryTag::kDnsCache};
 };
 
 }  // namespace util
@@ -4,9 +4,11 @@
 #ifndef HOLYTLS_UTIL_SOCKET_UTILS_H_
 #define HOLYTLS_UTIL_SOCKET_UTILS_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 
+#include "holytls/config.h"
 #include "holytls/util/platform.h"
 
 namespace holytls {
@@ -16,8 +18,46 @@ namespace util {
 // Returns socket on success, kInvalidSocket on error
 socket_t CreateTcpSocket(bool ipv6);
 
-// Configure socket options (TCP_NODELAY, SO_KEEPALIVE, etc.)
-void ConfigureSocket(socket_t sock);
+// Configure socket options: TCP_NODELAY and SO_KEEPALIVE, plus buffer
+// sizing and the Linux TCP options selected in `config`
+void ConfigureSocket(socket_t sock, const SocketConfig& config = {});
+
+// Bind to a local source address with an ephemeral port
+// Returns false if the address is invalid or bind fails
+bool BindLocalAddress(socket_t sock, std::string_view ip, bool ipv6);
+
+// Kernel receive buffer size (as reported by SO_RCVBUF), 0 on error
+size_t GetReceiveBufferSize(socket_t sock);
+
+// Request a receive buffer that GetReceiveBufferSize() will report as
+// `bytes`. Linux doubles the value set (bookkeeping overhead), so half is
+// passed there. Disables autotuning on Linux. Uses SO_RCVBUFFORCE where
+// permitted (CAP_NET_ADMIN); otherwise fails rather than let the kernel
+// clamp a size above MaxReceiveBufferSize().
+bool SetReceiveBufferSize(socket_t sock, size_t bytes);
+
+// Largest size SetReceiveBufferSize() can reach without CAP_NET_ADMIN, in
+// the same units (net.core.rmem_max on Linux, doubled). Autotuning may
+// exceed it; SIZE_MAX where unknown.
+size_t MaxReceiveBufferSize();
+
+// Largest size receive autotuning grows a buffer to (net.ipv4.tcp_rmem[2]
+// on Linux). SIZE_MAX elsewhere, where the ceiling is unknown.
+size_t AutotuneReceiveBufferMax();
+
+// Smoothed round-trip time from TCP_INFO (Linux only)
+// Returns false where unavailable
+bool GetTcpRtt(socket_t sock, uint32_t* rtt_us);
+
+// Enable TCP Fast Open for the next connect (Linux TCP_FASTOPEN_CONNECT).
+// connect() then returns at once and the SYN goes out with the first write,
+// carrying its data when the kernel has a cookie for the server.
+// Returns false where unsupported; the socket connects normally.
+bool EnableTcpFastOpen(socket_t sock);
+
+// Whether the server acknowledged the data sent in our SYN (TCP_INFO).
+// Valid once the handshake has completed; false where unavailable.
+bool TcpFastOpenAccepted(socket_t sock);
 
 // Start non-blocking connect to the given IP and port
 // Returns 0 if connect completed immediately, -1 on error, 1 if in progress
@@ -12,6 +12,8 @@
 #include <cstdlib>
 #include <cstring>
 
+#include "holytls/memory/memory_accounting.h"
+
 // Branch prediction hints - MSVC doesn't have __builtin_expect
 #ifdef _MSC_VER
 #define HOLYTLS_LIKELY(x) (x)
@@ -33,16 +35,18 @@ inline constexpr size_t kCacheLineSize = 64;
 // All allocations are 8-byte aligned by default.
 // Memory is freed in bulk when the arena is destroyed or reset.
 struct Arena {
-  uint8_t* base;      // Start of current block
-  uint8_t* pos;       // Current allocation position
-  uint8_t* end;       // End of current block
-  Arena* prev;        // Previous block (for chaining)
-  size_t block_size;  // Size of each block
+  uint8_t* base;          // Start of current block
+  uint8_t* pos;           // Current allocation position
+  uint8_t* end;           // End of current block
+  Arena* prev;            // Previous block (for chaining)
+  size_t block_size;      // Size of each block
+  memory::MemoryTag tag;  // Accounting tag, inherited by chained blocks
 
   // Create arena with specified block size
-  static Arena* Create(size_t block_size = kArenaDefaultBlockSize) {
+  static Arena* Create(size_t block_size = kArenaDefaultBlockSize,
+                       memory::MemoryTag tag = memory::MemoryTag::kOther) {
     size_t total = sizeof(Arena) + block_size;
-    auto* mem = static_cast<uint8_t*>(std::malloc(total));
+    auto* mem = static_cast<uint8_t*>(memory::TaggedAlloc(total, tag));
     if (!mem) return nullptr;
 
     auto* arena = reinterpret_cast<Arena*>(mem);
@@ -51,6 +55,7 @@ struct Arena {
     arena->end = arena->base + block_size;
     arena->prev = nullptr;
     arena->block_size = block_size;
+    arena->tag = tag;
     return arena;
   }
 
@@ -58,7 +63,7 @@ struct Arena {
   static void Destroy(Arena* arena) {
     while (arena) {
       Arena* prev = arena->prev;
-      std::free(arena);
+      memory::TaggedFree(arena);
       arena = prev;
     }
   }
@@ -80,7 +85,7 @@ inline void ArenaClear(Arena* arena) {
   Arena* prev = arena->prev;
   while (prev) {
     Arena* next = prev->prev;
-    std::free(prev);
+    memory::TaggedFree(prev);
     prev = next;
   }
   arena->prev = nullptr;
@@ -107,7 +112,7 @@ inline void* ArenaPush(Arena* arena, size_t size) {
     new_block_size = aligned_size;
   }
 
-  Arena* new_arena = Arena::Create(new_block_size);
+  Arena* new_arena = Arena::Create(new_block_size, arena->tag);
   if (HOLYTLS_UNLIKELY(!new_arena)) return nullptr;
 
   // Chain old block by swapping (keeps arena pointer stable)
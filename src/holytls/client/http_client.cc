@@ -3,23 +3,36 @@
 
 #include "holytls/client.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <deque>
+#include <initializer_list>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <variant>
 
+#include "holytls/client/request_coalescer.h"
+#include "holytls/client/request_hedger.h"
 #include "holytls/config.h"
 #include "holytls/core/reactor_manager.h"
+#include "holytls/core/stats.h"
 #include "holytls/http/alt_svc_cache.h"
 #include "holytls/http/cookie_jar.h"
+#include "holytls/http/http_date.h"
+#include "holytls/http/redirect.h"
+#include "holytls/http/response_cache.h"
+#include "holytls/http/request_headers.h"
+#include "holytls/http2/chrome_header_template.h"
+#include "holytls/memory/memory_accounting.h"
 #include "holytls/pool/connection_pool.h"
 #include "holytls/pool/host_pool.h"
 #include "holytls/tls/tls_context.h"
 #include "holytls/util/dns_resolver.h"
+#include "holytls/util/sv_helpers.h"
 #include "holytls/util/url_parser.h"
 
 #if defined(HOLYTLS_BUILD_QUIC)
@@ -105,38 +118,152 @@ Request& Request::SetHeaders(const http::headers::OrderedHeaders& h) {
   return *this;
 }
 
-// Response implementation
-std::string_view Response::GetHeader(std::string_view name) const {
-  for (const auto& header : headers) {
-    if (header.name == name) {
-      return header.value;
-    }
-  }
-  return "";
+Request& Request::SetFetchContext(const http2::FetchContext& f) {
+  fetch = f;
+  return *this;
 }
 
-bool Response::HasHeader(std::string_view name) const {
-  for (const auto& header : headers) {
-    if (header.name == name) {
-      return true;
-    }
-  }
-  return false;
+Request& Request::SetPriority(uint8_t urgency, bool incremental) {
+  priority.urgency = std::min(urgency, Priority::kLowestUrgency);
+  priority.incremental = incremental;
+  return *this;
 }
 
+// Response implementation
 std::string_view Response::body_string() const {
-  return std::string_view(reinterpret_cast<const char*>(body.data()),
-                          body.size());
+  std::span<const uint8_t> bytes = body_view();
+  return std::string_view(reinterpret_cast<const char*>(bytes.data()),
+                          bytes.size());
 }
 
 size_t Response::content_length() const {
-  auto cl = GetHeader("content-length");
+  auto cl = GetHeader(http2::HeaderId::kContentLength);
   if (cl.empty()) {
-    return body.size();
+    return body_view().size();
   }
   return static_cast<size_t>(std::stoul(std::string(cl)));
 }
 
+namespace {
+
+// Histogram (microseconds) to public latency summary (milliseconds)
+LatencyStats ToLatencyStats(const core::HistogramSnapshot& histogram) {
+  auto ms = [](uint64_t us) { return static_cast<double>(us) / 1000.0; };
+  LatencyStats out;
+  out.count = histogram.count();
+  out.mean_ms = histogram.mean() / 1000.0;
+  out.p50_ms = ms(histogram.Percentile(50.0));
+  out.p90_ms = ms(histogram.Percentile(90.0));
+  out.p99_ms = ms(histogram.Percentile(99.0));
+  out.p999_ms = ms(histogram.Percentile(99.9));
+  out.max_ms = ms(histogram.max());
+  return out;
+}
+
+// Clamped difference. Start stamps taken on the caller thread are precise
+// while reactor stamps may come from the coarser cached loop clock.
+uint64_t Elapsed(uint64_t from_us, uint64_t to_us) {
+  return to_us > from_us ? to_us - from_us : 0;
+}
+
+// Phase breakdown of a completed request. Queue time is what elapsed before
+// the request was sent that DNS and connection setup don't account for, on
+// the current redirect hop; the total runs from the request's start.
+Timing MakeTiming(uint64_t start_us, uint64_t hop_start_us, uint64_t dns_us,
+                  const core::RequestTiming& conn, uint64_t end_us) {
+  using std::chrono::microseconds;
+  uint64_t setup_us = dns_us + conn.connect_us + conn.tls_us;
+  Timing timing;
+  timing.queue =
+      microseconds(Elapsed(setup_us, Elapsed(hop_start_us, conn.sent_us)));
+  timing.dns = microseconds(dns_us);
+  timing.connect = microseconds(conn.connect_us);
+  timing.tls = microseconds(conn.tls_us);
+  timing.ttfb = microseconds(Elapsed(conn.sent_us, conn.first_byte_us));
+  timing.total = microseconds(Elapsed(start_us, end_us));
+  timing.connection_reused = conn.reused;
+  timing.tls_resumed = conn.tls_resumed;
+  return timing;
+}
+
+// Value of a header in a built request block (case-insensitive)
+std::string_view FindHeader(const http::RequestHeaders& headers,
+                            std::string_view name) {
+  for (const auto& h : headers.headers()) {
+    if (sv::EqualsIgnoreCase(h.name, name)) {
+      return h.value;
+    }
+  }
+  return {};
+}
+
+bool HasHeader(const Headers& headers, std::string_view name) {
+  return std::ranges::any_of(headers, [name](const Header& h) {
+    return sv::EqualsIgnoreCase(h.name, name);
+  });
+}
+
+// Drop user headers named in `names` (case-insensitive)
+void EraseHeaders(Headers* headers,
+                  std::initializer_list<std::string_view> names) {
+  std::erase_if(*headers, [names](const Header& h) {
+    return std::ranges::any_of(names, [&h](std::string_view name) {
+      return sv::EqualsIgnoreCase(h.name, name);
+    });
+  });
+}
+
+// RFC 9218 priority header value. Defaults are omitted, so the default
+// priority sends no header.
+std::string_view PriorityHeaderValue(const Priority& priority) {
+  static constexpr std::string_view kValues[][2] = {
+      {"u=0", "u=0, i"}, {"u=1", "u=1, i"}, {"u=2", "u=2, i"},
+      {"", "i"},         {"u=4", "u=4, i"}, {"u=5", "u=5, i"},
+      {"u=6", "u=6, i"}, {"u=7", "u=7, i"},
+  };
+  return kValues[std::min(priority.urgency, Priority::kLowestUrgency)]
+                [priority.incremental ? 1 : 0];
+}
+
+// Deadline of a request queued on a host pool for a stream
+struct SlotTimer {
+  uv_timer_t handle;
+  pool::HostPool* host_pool = nullptr;
+  uint64_t waiter = 0;
+};
+
+void CloseSlotTimer(SlotTimer* timer) {
+  uv_timer_stop(&timer->handle);
+  uv_close(reinterpret_cast<uv_handle_t*>(&timer->handle),
+           [](uv_handle_t* h) { delete static_cast<SlotTimer*>(h->data); });
+}
+
+// Times a request refused by the server is sent again before its error is
+// delivered
+constexpr int kMaxReplays = 2;
+
+// Feed an origin's adaptive concurrency limit with a response: 429 and 503
+// are the origin shedding load, anything else is a latency sample
+void RecordLimitOutcome(pool::HostPool* host_pool, int status_code,
+                        const http2::PackedHeaders& headers,
+                        const core::RequestTiming& timing) {
+  if (!host_pool || !host_pool->limiter()) {
+    return;
+  }
+  if (status_code == 429 || status_code == 503) {
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    host_pool->RecordDrop(
+        http::ParseRetryAfter(headers.Get(http2::HeaderId::kRetryAfter),
+                              static_cast<uint64_t>(now_ms)));
+    return;
+  }
+  host_pool->RecordSample(Elapsed(timing.sent_us, timing.first_byte_us));
+}
+
+}  // namespace
+
 // Pending request in queue
 struct PendingRequest {
   Request request;
@@ -148,7 +275,11 @@ struct PendingRequest {
 // HttpClient implementation
 
 HttpClient::HttpClient(const ClientConfig& config)
-    : config_(config), reactor_manager_(MakeReactorConfig(config)) {
+    : config_(config),
+      header_templates_(std::make_unique<http2::ChromeHeaderTemplates>(
+          http2::GetChromeHeaderProfile(config.http2.chrome_version),
+          config.user_agent)),
+      reactor_manager_(MakeReactorConfig(config)) {
   // Initialize TLS factory (two-phase init)
   if (!tls_factory_.Initialize(MakeTlsConfig(config))) {
     // TLS initialization failed - error available via
@@ -167,8 +298,11 @@ HttpClient::HttpClient(const ClientConfig& config)
   pool_config.max_streams_per_connection =
       config.pool.max_streams_per_connection;
   pool_config.proxy = config.proxy;
+  pool_config.socket = config.socket;
   pool_config.protocol = config.protocol;
   pool_config.http3 = config.http3;
+  pool_config.high_resolution_timing = config.high_resolution_timing;
+  pool_config.concurrency_limit = config.pool.concurrency_limit;
 
   // Initialize reactor manager
   reactor_manager_.Initialize(&tls_factory_, pool_config);
@@ -179,6 +313,24 @@ HttpClient::HttpClient(const ClientConfig& config)
   // Store Alt-Svc cache reference
   alt_svc_cache_ = config.alt_svc_cache;
   alt_svc_enabled_ = config.alt_svc.enabled;
+
+  // Store response cache reference
+  response_cache_ = config.response_cache;
+
+  if (config.coalesce.enabled) {
+    coalescers_.reserve(reactor_manager_.NumReactors());
+    for (size_t i = 0; i < reactor_manager_.NumReactors(); ++i) {
+      coalescers_.push_back(
+          std::make_unique<RequestCoalescer>(config.coalesce.key_headers));
+    }
+  }
+
+  if (config.hedge.enabled) {
+    hedgers_.reserve(reactor_manager_.NumReactors());
+    for (size_t i = 0; i < reactor_manager_.NumReactors(); ++i) {
+      hedgers_.push_back(std::make_unique<RequestHedger>(config.hedge));
+    }
+  }
 }
 
 HttpClient::~HttpClient() { Stop(); }
@@ -208,7 +360,7 @@ void HttpClient::SendAsync(Request request, ResponseCallback callback,
     return;
   }
 
-  auto* ctx = reactor_manager_.GetReactorForHost(parsed.host, parsed.port);
+  auto* ctx = reactor_manager_.AcquireReactorForHost(parsed.host, parsed.port);
   if (!ctx) {
     if (callback) {
       callback(Response{}, Error{ErrorCode::kInternal, "No reactor available"});
@@ -216,41 +368,136 @@ void HttpClient::SendAsync(Request request, ResponseCallback callback,
     return;
   }
 
-  // Post request processing to the reactor thread
+  // Stamped here so Timing::queue includes the wait for the reactor. The
+  // cached loop clock is only readable on the reactor thread, so the wait
+  // is measured with uv_hrtime() and rebased onto NowUs() there.
+  uint64_t posted_us = uv_hrtime() / 1000;
+
+  // The reactor's in-flight count drops once the callback has returned, so
+  // WaitIdle() never wakes between a callback and requests it issues
+  callback = [this, ctx, callback = std::move(callback)](Response response,
+                                                         Error error) {
+    if (!error) {
+      ctx->stats->total.Record(
+          static_cast<uint64_t>(response.timing.total.count()));
+    }
+    if (callback) {
+      callback(std::move(response), std::move(error));
+    }
+    reactor_manager_.ReleaseReactor(ctx);
+    completions_.fetch_add(1, std::memory_order_relaxed);
+    NotifyWaiters();
+  };
+
+  // Post request processing to the reactor thread, ahead of less urgent
+  // requests posted for the same loop iteration
+  uint8_t urgency = request.priority.urgency;
   reactor_manager_.Post(
-      ctx->index, [this, ctx, request = std::move(request),
-                   parsed = std::move(parsed), callback = std::move(callback),
-                   progress = std::move(progress)]() mutable {
+      ctx->index,
+      [this, ctx, request = std::move(request), parsed = std::move(parsed),
+       callback = std::move(callback), progress = std::move(progress),
+       posted_us]() mutable {
+        uint64_t start_us = posted_us;
+        if (!config_.high_resolution_timing) {
+          uint64_t now_us = NowUs(ctx);
+          uint64_t waited_us = Elapsed(posted_us, uv_hrtime() / 1000);
+          start_us = now_us - std::min(now_us, waited_us);
+        }
         ProcessRequest(ctx, std::move(request), std::move(parsed),
-                       std::move(callback), std::move(progress));
-      });
+                       std::move(callback), std::move(progress),
+                       RequestClock{start_us, start_us});
+      },
+      urgency);
 }
 
-void HttpClient::Run() {
+std::future<ResponseResult> HttpClient::SendAsync(Request request) {
+  // std::function must be copyable, so the promise is shared
+  auto promise = std::make_shared<std::promise<ResponseResult>>();
+  auto future = promise->get_future();
+
+  Start();
+  SendAsync(std::move(request), [promise](Response response, Error error) {
+    promise->set_value(ResponseResult{std::move(response), std::move(error)});
+  });
+  return future;
+}
+
+void HttpClient::Start() {
   running_.store(true, std::memory_order_release);
   reactor_manager_.Start();
+}
 
-  // Background threads handle the reactors; main thread just waits
-  while (running_.load(std::memory_order_acquire)) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-  }
+void HttpClient::Run() {
+  Start();
+  WaitFor([this] { return !running_.load(std::memory_order_acquire); });
 }
 
 void HttpClient::RunOnce() {
-  if (!reactor_manager_.IsRunning()) {
-    reactor_manager_.Start();
-    // Give background threads time to start
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-  }
-  // Background threads handle the work; yield to let them run
-  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  // Same worst case as the old fixed sleep, but returns on the first
+  // completion (or immediately when nothing is in flight)
+  constexpr std::chrono::milliseconds kMaxWait{10};
+
+  Start();
+  uint64_t completions = completions_.load(std::memory_order_acquire);
+  WaitFor(
+      [this, completions] {
+        return completions_.load(std::memory_order_acquire) != completions ||
+               InFlight() == 0;
+      },
+      kMaxWait);
+}
+
+void HttpClient::WaitIdle() {
+  Start();
+  WaitFor([this] {
+    return InFlight() == 0 || !running_.load(std::memory_order_acquire);
+  });
+}
+
+void HttpClient::RunUntil(const std::function<bool()>& predicate) {
+  Start();
+  WaitFor([this, &predicate] {
+    return predicate() || !running_.load(std::memory_order_acquire);
+  });
+}
+
+size_t HttpClient::InFlight() const {
+  return reactor_manager_.TotalInFlight();
 }
 
 void HttpClient::Stop() {
   running_.store(false, std::memory_order_release);
+  NotifyWaiters();
   reactor_manager_.Stop();
 }
 
+void HttpClient::NotifyWaiters() {
+  // Pairs with the increment in WaitFor: either the waiter sees this
+  // completion when it evaluates its predicate, or we see the waiter
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  // Taking the lock orders the notify after a waiter that is between its
+  // predicate check and going to sleep
+  { std::lock_guard<std::mutex> lock(wait_mutex_); }
+  wait_cv_.notify_all();
+}
+
+void HttpClient::WaitFor(const std::function<bool()>& done,
+                         std::chrono::milliseconds timeout) {
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+  {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    if (timeout.count() > 0) {
+      wait_cv_.wait_for(lock, timeout, done);
+    } else {
+      wait_cv_.wait(lock, done);
+    }
+  }
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
 bool HttpClient::IsRunning() const {
   return running_.load(std::memory_order_acquire);
 }
@@ -259,13 +506,99 @@ ClientStats HttpClient::GetStats() const {
   ClientStats stats;
   stats.total_connections = reactor_manager_.TotalConnections();
   stats.active_connections = reactor_manager_.TotalConnections();
-  stats.requests_sent = requests_sent_.load(std::memory_order_relaxed);
-  stats.requests_completed =
-      requests_completed_.load(std::memory_order_relaxed);
-  stats.requests_failed = requests_failed_.load(std::memory_order_relaxed);
+
+  // Merge-on-read: each reactor writes only its own block
+  core::StatsSnapshot snapshot = reactor_manager_.SnapshotStats();
+  stats.connections_created = snapshot.connections_created;
+  stats.connections_reused = snapshot.connections_reused;
+  stats.connections_failed = snapshot.connections_failed;
+  stats.fast_open_attempts = snapshot.fast_open_attempts;
+  stats.fast_open_accepted = snapshot.fast_open_accepted;
+  stats.requests_sent = snapshot.requests_sent;
+  stats.requests_completed = snapshot.requests_completed;
+  stats.requests_failed = snapshot.requests_failed;
+  stats.requests_timeout = snapshot.requests_timeout;
+  stats.requests_coalesced = snapshot.requests_coalesced;
+  stats.requests_hedged = snapshot.requests_hedged;
+  stats.hedges_won = snapshot.hedges_won;
+  stats.requests_replayed = snapshot.requests_replayed;
+  stats.bytes_sent = snapshot.bytes_sent;
+  stats.bytes_received = snapshot.bytes_received;
+
+  stats.dns = ToLatencyStats(snapshot.dns);
+  stats.connect = ToLatencyStats(snapshot.connect);
+  stats.tls = ToLatencyStats(snapshot.tls);
+  stats.ttfb = ToLatencyStats(snapshot.ttfb);
+  stats.total = ToLatencyStats(snapshot.total);
+
+  stats.avg_dns_time_ms = stats.dns.mean_ms;
+  stats.avg_connect_time_ms = stats.connect.mean_ms;
+  stats.avg_tls_time_ms = stats.tls.mean_ms;
+  stats.avg_ttfb_ms = stats.ttfb.mean_ms;
+  stats.avg_total_time_ms = stats.total.mean_ms;
+
+  for (const auto& origin : snapshot.origins) {
+    OriginConcurrencyStats& out = stats.origins.emplace_back();
+    out.host = origin.host;
+    out.port = origin.port;
+    out.limit = origin.limit;
+    out.in_flight = origin.in_flight;
+    out.queued = origin.queued;
+    out.rtt_ms = static_cast<double>(origin.rtt_us) / 1000.0;
+    out.baseline_rtt_ms = static_cast<double>(origin.baseline_rtt_us) / 1000.0;
+    out.drops = origin.drops;
+  }
+  return stats;
+}
+
+std::vector<core::TraceRecord> HttpClient::CollectTrace() const {
+  return reactor_manager_.CollectTrace();
+}
+
+MemoryStats HttpClient::GetMemoryStats() const {
+  using memory::MemoryTag;
+  MemoryStats stats;
+  stats.enabled = memory::kMemoryAccountingEnabled;
+  stats.limit_per_reactor = config_.memory.max_bytes_per_reactor;
+
+  const std::pair<MemoryTag, MemoryUsage*> by_tag[] = {
+      {MemoryTag::kTls, &stats.tls},
+      {MemoryTag::kH2Session, &stats.h2_session},
+      {MemoryTag::kStreamBuffers, &stats.stream_buffers},
+      {MemoryTag::kResponseBodies, &stats.response_bodies},
+      {MemoryTag::kDecompression, &stats.decompression},
+      {MemoryTag::kDnsCache, &stats.dns_cache},
+      {MemoryTag::kCookieJar, &stats.cookie_jar},
+      {MemoryTag::kPoolMetadata, &stats.pool_metadata},
+      {MemoryTag::kOther, &stats.other},
+  };
+  auto add = [&](const memory::MemoryAccount& account) {
+    for (const auto& [tag, usage] : by_tag) {
+      usage->current_bytes += account.current(tag);
+      usage->peak_bytes += account.peak(tag);
+    }
+    stats.total.current_bytes += account.total();
+    stats.total.peak_bytes += account.total_peak();
+    stats.streams_paused += account.streams_paused();
+    stats.requests_rejected += account.requests_rejected();
+    return MemoryUsage{account.total(), account.total_peak()};
+  };
+
+  for (const memory::MemoryAccount* account :
+       reactor_manager_.MemoryAccounts()) {
+    stats.reactors.push_back(add(*account));
+  }
+  stats.shared = add(*memory::SharedMemoryAccount());
   return stats;
 }
 
+uint64_t HttpClient::NowUs(const core::ReactorContext* ctx) const {
+  if (config_.high_resolution_timing) {
+    return uv_hrtime() / 1000;
+  }
+  return ctx->reactor->now_ms() * 1000;
+}
+
 ChromeVersion HttpClient::GetChromeVersion() const {
   return config_.tls.chrome_version;
 }
@@ -279,34 +612,112 @@ core::ReactorManagerConfig HttpClient::MakeReactorConfig(
   core::ReactorManagerConfig rc;
   rc.num_reactors = config.threads.num_workers;
   rc.pin_to_cores = config.threads.pin_to_cores;
+  rc.backend = config.threads.backend;
+  rc.placement = config.threads.placement;
+  rc.load_factor = std::max(config.threads.load_factor, 1.0);
+  rc.max_reactors_per_origin = config.threads.max_reactors_per_origin;
+  rc.max_loop_lag_us =
+      static_cast<uint64_t>(config.threads.max_loop_lag.count());
+  rc.trace_sink = config.trace.sink;
+  rc.trace_ring_capacity = config.trace.ring_capacity;
+  rc.memory_limit_per_reactor = config.memory.max_bytes_per_reactor;
+  rc.memory_pause_new_streams = config.memory.pause_new_streams;
   return rc;
 }
 
 void HttpClient::ProcessRequest(core::ReactorContext* ctx, Request request,
                                 util::ParsedUrl parsed,
                                 ResponseCallback callback,
-                                ProgressCallback /*progress*/) {
+                                ProgressCallback /*progress*/,
+                                RequestClock clock) {
+  // Shed load rather than let a reactor over its memory cap grow further
+  if (config_.memory.reject_requests && ctx->memory->OverLimit()) {
+    ctx->memory->CountRejectedRequest();
+    if (callback) {
+      callback(Response{},
+               Error{ErrorCode::kMemoryLimit, "Reactor over memory limit"});
+    }
+    ctx->stats->requests_failed.Add();
+    return;
+  }
+
+  // Identical requests in flight on this reactor share one exchange. The
+  // leader is registered before the response cache wraps its callback, so
+  // joined requests see the response as the cache delivers it. Redirect hops
+  // stay out: the chain's first URL is still registered, and a hop back to
+  // it would join itself and never complete.
+  if (!coalescers_.empty() && clock.redirects == 0) {
+    RequestCoalescer* coalescer = coalescers_[ctx->index].get();
+    std::string key = coalescer->Key(request);
+    if (!key.empty() && coalescer->InFlight(key)) {
+      ctx->stats->requests_coalesced.Add();
+      coalescer->Join(key, [this, ctx, start_us = clock.start_us,
+                            callback = std::move(callback)](Response response,
+                                                            Error error) {
+        response.coalesced = true;
+        response.timing.total =
+            std::chrono::microseconds(Elapsed(start_us, NowUs(ctx)));
+        if (error) {
+          ctx->stats->requests_failed.Add();
+        } else {
+          ctx->stats->requests_completed.Add();
+        }
+        if (callback) {
+          callback(std::move(response), std::move(error));
+        }
+      });
+      return;
+    }
+    if (!key.empty()) {
+      coalescer->Lead(key, &callback);
+    }
+  }
+
+  // Fresh cache hits complete here, before DNS and the connection pool
+  if (response_cache_ != nullptr &&
+      ApplyResponseCache(ctx, &request, &callback, clock)) {
+    return;
+  }
+
+  ResolveAndSend(ctx, std::move(request), std::move(parsed),
+                 std::move(callback), clock);
+}
+
+void HttpClient::ResolveAndSend(core::ReactorContext* ctx, Request request,
+                                util::ParsedUrl parsed,
+                                ResponseCallback callback,
+                                RequestClock clock) {
   // Copy host before moving parsed into lambda (avoids reference
   // invalidation)
   std::string host = parsed.host;
+  uint64_t dns_start_us = NowUs(ctx);
+  size_t host_hash = std::hash<std::string_view>{}(host);
+  core::Trace(ctx->trace, core::TraceEvent::kDnsStart, host_hash);
   ctx->dns_resolver->ResolveAsync(
-      host, [this, ctx, request = std::move(request),
-             parsed = std::move(parsed), callback = std::move(callback)](
+      host, [this, ctx, clock, dns_start_us, host_hash,
+             request = std::move(request), parsed = std::move(parsed),
+             callback = std::move(callback)](
                 const std::vector<util::ResolvedAddress>& addresses,
                 const std::string& error) mutable {
+        clock.dns_us = NowUs(ctx) - dns_start_us;
+        ctx->stats->dns.Record(clock.dns_us);
+        core::Trace(ctx->trace, core::TraceEvent::kDnsEnd, host_hash, -1,
+                    addresses.size());
+
         if (!error.empty() || addresses.empty()) {
           if (callback) {
             callback(Response{},
                      Error{ErrorCode::kDns,
                            error.empty() ? "No addresses found" : error});
           }
-          requests_failed_.fetch_add(1, std::memory_order_relaxed);
+          ctx->stats->requests_failed.Add();
           return;
         }
 
         // Protocol-agnostic connection acquisition
         auto* pool = ctx->connection_pool.get();
-        auto any_conn = pool->AcquireAnyConnection(parsed.host, parsed.port);
+        auto any_conn = pool->AcquireAnyConnection(parsed.host, parsed.port,
+                                                   request.priority.urgency);
 
         // Check if we got a connection
         bool has_connection =
@@ -339,7 +750,7 @@ void HttpClient::ProcessRequest(core::ReactorContext* ctx, Request request,
                 quic_pool->CreateConnection(addr.ip, addr.is_ipv6)) {
               // Queue request for when QUIC connection is ready
               QueueRequest(ctx, parsed, addresses, std::move(request),
-                           std::move(callback), true);
+                           std::move(callback), clock, true);
               return;
             }
             // QUIC failed, mark in cache and fall through to TCP if allowed
@@ -351,7 +762,7 @@ void HttpClient::ProcessRequest(core::ReactorContext* ctx, Request request,
                 callback(Response{}, Error{ErrorCode::kConnection,
                                            "Failed to create QUIC connection"});
               }
-              requests_failed_.fetch_add(1, std::memory_order_relaxed);
+              ctx->stats->requests_failed.Add();
               return;
             }
           }
@@ -364,38 +775,43 @@ void HttpClient::ProcessRequest(core::ReactorContext* ctx, Request request,
               callback(Response{}, Error{ErrorCode::kConnection,
                                          "Failed to create host pool"});
             }
-            requests_failed_.fetch_add(1, std::memory_order_relaxed);
+            ctx->stats->requests_failed.Add();
             return;
           }
 
-          if (!host_pool->CreateConnection(addr.ip, addr.is_ipv6)) {
+          // At the connection limit the request waits for a stream on the
+          // connections already open; at the adaptive concurrency limit it
+          // waits for a request to finish
+          if (!host_pool->AtConcurrencyLimit() &&
+              !host_pool->CreateConnection(addr.ip, addr.is_ipv6) &&
+              host_pool->TotalConnections() == 0) {
             if (callback) {
               callback(Response{}, Error{ErrorCode::kConnection,
                                          "Failed to create connection"});
             }
-            requests_failed_.fetch_add(1, std::memory_order_relaxed);
+            ctx->stats->requests_failed.Add();
             return;
           }
 
-          // Queue request for when TCP connection is ready
-          QueueRequest(ctx, parsed, addresses, std::move(request),
-                       std::move(callback), false);
+          // Queue request for a stream, by urgency
+          WaitForTcpSlot(ctx, host_pool, parsed, std::move(request),
+                         std::move(callback), clock);
           return;
         }
 
         // Send request on existing connection
         std::visit(
-            [this, &ctx, &parsed, &request, &callback](auto* conn) {
+            [this, &ctx, &parsed, &request, &callback, &clock](auto* conn) {
               if constexpr (std::is_same_v<decltype(conn),
                                            pool::PooledConnection*>) {
                 SendOnTcpConnection(ctx, conn, parsed, std::move(request),
-                                    std::move(callback));
+                                    std::move(callback), clock);
               }
 #if HOLYTLS_QUIC_AVAILABLE
               else if constexpr (std::is_same_v<decltype(conn),
                                                 pool::QuicPooledConnection*>) {
                 SendOnQuicConnection(ctx, conn, parsed, std::move(request),
-                                     std::move(callback));
+                                     std::move(callback), clock);
               }
 #endif
             },
@@ -407,15 +823,16 @@ void HttpClient::QueueRequest(core::ReactorContext* ctx,
                               const util::ParsedUrl& parsed,
                               const std::vector<util::ResolvedAddress>& addresses,
                               Request request, ResponseCallback callback,
-                              bool use_quic, int retry_count) {
+                              RequestClock clock, bool use_quic,
+                              int retry_count) {
   constexpr int kMaxRetries = 50;     // Max retries (50 * 100ms = 5s total)
   constexpr int kRetryDelayMs = 100;  // Delay between retries
 
   // Schedule a delayed retry using a timer
   // Note: Capture kMaxRetries for use in lambda
   auto retry_fn = [this, ctx, parsed, addresses, request = std::move(request),
-                   callback = std::move(callback), use_quic, retry_count,
-                   kMaxRetries]() mutable {
+                   callback = std::move(callback), clock, use_quic,
+                   retry_count, kMaxRetries]() mutable {
     auto* pool = ctx->connection_pool.get();
 
 #if HOLYTLS_QUIC_AVAILABLE
@@ -423,7 +840,7 @@ void HttpClient::QueueRequest(core::ReactorContext* ctx,
       auto* quic_conn = pool->AcquireQuicConnection(parsed.host, parsed.port);
       if (quic_conn && quic_conn->IsConnected()) {
         SendOnQuicConnection(ctx, quic_conn, parsed, std::move(request),
-                             std::move(callback));
+                             std::move(callback), clock);
         return;
       }
 
@@ -454,17 +871,18 @@ void HttpClient::QueueRequest(core::ReactorContext* ctx,
         // Continue with TCP - keep retry count for overall timeout
         // (40 more retries = 4 more seconds for TCP to connect)
         QueueRequest(ctx, parsed, addresses, std::move(request),
-                     std::move(callback), false, retry_count);
+                     std::move(callback), clock, false, retry_count);
         return;
       }
     } else
 #endif
     {
       (void)use_quic;  // Suppress unused warning when QUIC not available
-      auto* pooled = pool->AcquireTcpConnection(parsed.host, parsed.port);
+      auto* pooled = pool->AcquireTcpConnection(parsed.host, parsed.port,
+                                                request.priority.urgency);
       if (pooled && pooled->connection && pooled->connection->IsConnected()) {
         SendOnTcpConnection(ctx, pooled, parsed, std::move(request),
-                            std::move(callback));
+                            std::move(callback), clock);
         return;
       }
     }
@@ -472,14 +890,15 @@ void HttpClient::QueueRequest(core::ReactorContext* ctx,
     if (retry_count < kMaxRetries) {
       // Retry after delay
       QueueRequest(ctx, parsed, addresses, std::move(request),
-                   std::move(callback), use_quic, retry_count + 1);
+                   std::move(callback), clock, use_quic, retry_count + 1);
     } else {
       // Max retries exceeded
+      ctx->stats->requests_timeout.Add();
       if (callback) {
         callback(Response{},
                  Error{ErrorCode::kTimeout, "Connection timeout after retries"});
       }
-      requests_failed_.fetch_add(1, std::memory_order_relaxed);
+      ctx->stats->requests_failed.Add();
     }
   };
 
@@ -505,92 +924,555 @@ void HttpClient::QueueRequest(core::ReactorContext* ctx,
   }
 }
 
-void HttpClient::SendOnTcpConnection(core::ReactorContext* ctx,
-                                     pool::PooledConnection* pooled,
-                                     const util::ParsedUrl& parsed,
-                                     Request request,
-                                     ResponseCallback callback) {
-  requests_sent_.fetch_add(1, std::memory_order_relaxed);
-
-  // Convert headers to connection format
-  std::vector<std::pair<std::string, std::string>> conn_headers;
-  for (const auto& h : request.headers) {
-    conn_headers.emplace_back(h.name, h.value);
+void HttpClient::ProcessResponseHeaders(const http2::PackedHeaders& headers,
+                                        std::string_view request_url,
+                                        std::string_view origin_host,
+                                        uint16_t origin_port) {
+  bool cookies = cookie_jar_ != nullptr;
+  bool alt_svc = alt_svc_cache_ != nullptr && alt_svc_enabled_;
+  if (!cookies && !alt_svc) return;
+
+  // Single pass, matched by interned id
+  for (size_t i = 0; i < headers.size(); ++i) {
+    http2::HeaderId id = headers.id(i);
+    if (id == http2::HeaderId::kSetCookie && cookies) {
+      cookie_jar_->ProcessSetCookie(request_url, headers.value(i));
+    } else if (id == http2::HeaderId::kAltSvc && alt_svc) {
+      alt_svc_cache_->ProcessAltSvc(origin_host, origin_port,
+                                    headers.value(i));
+    }
   }
+}
 
-  // Add cookies from cookie jar if available
+void HttpClient::BuildRequestHeaders(const Request& request,
+                                     http::RequestHeaders* out) const {
+  std::string cookie_header;
   if (cookie_jar_) {
-    std::string cookie_header = cookie_jar_->GetCookieHeader(request.url);
+    cookie_header = cookie_jar_->GetCookieHeader(request.url);
+  }
+
+  if (config_.chrome_headers && request.header_order.empty()) {
+    // Chrome template: static entries are referenced, only dynamic values
+    // copy
+    header_templates_->Apply(request.fetch, request.headers, cookie_header,
+                             out);
+  } else {
+    // User headers only (names keep the caller's case)
+    for (const auto& h : request.headers) {
+      out->Add(h.name, h.value);
+    }
     if (!cookie_header.empty()) {
-      conn_headers.emplace_back("cookie", std::move(cookie_header));
+      out->AddStaticName("cookie", cookie_header);
     }
   }
 
-  // Share callback between success and error handlers to avoid double-move
-  auto shared_cb = std::make_shared<ResponseCallback>(std::move(callback));
-
-  // Capture URL and host/port for cookie and Alt-Svc processing
-  std::string request_url = request.url;
-  std::string origin_host = parsed.host;
-  uint16_t origin_port = parsed.port;
+  // Priority goes last, as Chrome sends it. Full control mode (header_order)
+  // sends exactly the user's headers.
+  std::string_view priority = PriorityHeaderValue(request.priority);
+  if (!priority.empty() && request.header_order.empty() &&
+      !HasHeader(request.headers, "priority")) {
+    out->AddStatic("priority", priority);
+  }
+}
 
-  pooled->connection->SendRequest(
-      std::string(MethodToString(request.method)), parsed.PathWithQuery(),
-      conn_headers, request.header_order,
-      [this, ctx, pooled, shared_cb, request_url = std::move(request_url),
-       origin_host = std::move(origin_host),
-       origin_port](const core::RawResponse& core_resp) mutable {
-        // Convert headers
-        Headers resp_headers;
-        for (size_t i = 0; i < core_resp.headers.size(); ++i) {
-          resp_headers.push_back({std::string(core_resp.headers.name(i)),
-                                  std::string(core_resp.headers.value(i))});
+void HttpClient::WaitForTcpSlot(core::ReactorContext* ctx,
+                                pool::HostPool* host_pool,
+                                const util::ParsedUrl& parsed, Request request,
+                                ResponseCallback callback, RequestClock clock) {
+  auto* timer = new SlotTimer;
+  timer->handle.data = timer;
+  timer->host_pool = host_pool;
+  uv_timer_init(ctx->reactor->loop(), &timer->handle);
+
+  auto timeout_ms = static_cast<uint64_t>(
+      std::min(request.timeout, config_.pool.queue_timeout).count());
+  uint8_t urgency = request.priority.urgency;
+  timer->waiter = host_pool->Enqueue(
+      urgency, [this, ctx, timer, parsed, request = std::move(request),
+                callback = std::move(callback),
+                clock](pool::PooledConnection* conn,
+                       std::string_view error) mutable {
+        if (conn == nullptr && !error.empty()) {
+          // The connection it waited on could not be established
+          CloseSlotTimer(timer);
+          if (callback) {
+            callback(Response{},
+                     Error{ErrorCode::kConnection, std::string(error)});
+          }
+          ctx->stats->requests_failed.Add();
+          return;
         }
-
-        // Process Set-Cookie headers if cookie jar is available
-        if (cookie_jar_) {
-          for (size_t i = 0; i < core_resp.headers.size(); ++i) {
-            std::string_view name = core_resp.headers.name(i);
-            if (name == "set-cookie") {
-              cookie_jar_->ProcessSetCookie(request_url,
-                                            core_resp.headers.value(i));
-            }
+        if (conn == nullptr) {
+          // Cancelled by the deadline, which closes the timer itself
+          ctx->stats->requests_timeout.Add();
+          if (callback) {
+            callback(Response{}, Error{ErrorCode::kTimeout,
+                                       "Timed out waiting for a connection"});
           }
+          ctx->stats->requests_failed.Add();
+          return;
         }
+        CloseSlotTimer(timer);
+        SendOnTcpConnection(ctx, conn, parsed, std::move(request),
+                            std::move(callback), clock);
+      });
 
-        // Process Alt-Svc headers for HTTP/3 discovery
-        if (alt_svc_cache_ && alt_svc_enabled_) {
-          for (size_t i = 0; i < core_resp.headers.size(); ++i) {
-            std::string_view name = core_resp.headers.name(i);
-            if (name == "alt-svc") {
-              alt_svc_cache_->ProcessAltSvc(origin_host, origin_port,
-                                            core_resp.headers.value(i));
-            }
-          }
+  uv_timer_start(
+      &timer->handle,
+      [](uv_timer_t* handle) {
+        auto* slot_timer = static_cast<SlotTimer*>(handle->data);
+        slot_timer->host_pool->Cancel(slot_timer->waiter);
+        uv_close(reinterpret_cast<uv_handle_t*>(handle), [](uv_handle_t* h) {
+          delete static_cast<SlotTimer*>(h->data);
+        });
+      },
+      timeout_ms, 0);
+}
+
+bool HttpClient::ApplyResponseCache(core::ReactorContext* ctx,
+                                    Request* request,
+                                    ResponseCallback* callback,
+                                    const RequestClock& clock) {
+  std::string_view method = MethodToString(request->method);
+  if (!http::ResponseCache::IsCacheableMethod(method)) {
+    // A successful unsafe request invalidates what is stored for its URL
+    if (request->method != Method::kHead &&
+        request->method != Method::kOptions) {
+      *callback = [this, url = request->url, callback = std::move(*callback)](
+                      Response response, Error error) {
+        if (!error && response.status_code >= 200 &&
+            response.status_code < 400) {
+          response_cache_->Invalidate(url);
         }
+        if (callback) {
+          callback(std::move(response), std::move(error));
+        }
+      };
+    }
+    return false;
+  }
+
+  // Conditional requests made by the caller go straight to the origin
+  if (HasHeader(request->headers, "if-none-match") ||
+      HasHeader(request->headers, "if-modified-since")) {
+    return false;
+  }
 
-        // Build response
-        Response response(core_resp.status_code, std::move(resp_headers),
-                          core_resp.body);
+  // Vary and request Cache-Control are matched against the headers as they
+  // will be sent (Chrome template, user headers, cookies)
+  auto sent = std::make_shared<http::RequestHeaders>();
+  BuildRequestHeaders(*request, sent.get());
+  http::RequestHeaderLookup sent_header = [sent](std::string_view name) {
+    return FindHeader(*sent, name);
+  };
 
-        // Release connection back to pool
-        ctx->connection_pool->ReleaseTcpConnection(pooled);
+  uint64_t request_time_ms = http::ResponseCache::NowMs();
+  http::CacheLookup hit =
+      response_cache_->Lookup(method, request->url, sent_header);
+  if (hit.entry != nullptr && hit.fresh) {
+    Response response(hit.entry->status_code, hit.entry->headers,
+                      hit.entry->body);
+    response.from_cache = true;
+    response.timing.total =
+        std::chrono::microseconds(Elapsed(clock.start_us, NowUs(ctx)));
+    ctx->stats->requests_completed.Add();
+    if (*callback) {
+      (*callback)(std::move(response), Error{});
+    }
+    return true;
+  }
 
-        requests_completed_.fetch_add(1, std::memory_order_relaxed);
+  // Stale: ask the origin whether the stored body is still current
+  std::shared_ptr<const http::CachedResponse> stale;
+  if (hit.entry != nullptr && hit.entry->HasValidator()) {
+    stale = std::move(hit.entry);
+    if (!stale->etag().empty()) {
+      request->headers.push_back(
+          {"if-none-match", std::string(stale->etag())});
+    }
+    if (!stale->last_modified().empty()) {
+      request->headers.push_back(
+          {"if-modified-since", std::string(stale->last_modified())});
+    }
+  }
 
-        if (*shared_cb) {
-          (*shared_cb)(std::move(response), Error{});
+  // Redirected responses are stored by the last hop's own wrapper, under
+  // the URL that produced them
+  *callback = [this, url = request->url, sent_header = std::move(sent_header),
+               stale = std::move(stale), request_time_ms,
+               callback = std::move(*callback)](Response response,
+                                                Error error) {
+    if (!error && response.redirects.empty()) {
+      if (stale != nullptr && response.status_code == 304) {
+        auto updated = response_cache_->Revalidated(
+            "GET", url, stale, response.headers, request_time_ms);
+        Response cached(updated->status_code, updated->headers,
+                        updated->body);
+        cached.timing = response.timing;
+        cached.from_cache = true;
+        response = std::move(cached);
+      } else {
+        response_cache_->Store("GET", url, sent_header, response.status_code,
+                               response.headers, response.body,
+                               request_time_ms);
+      }
+    }
+    if (callback) {
+      callback(std::move(response), std::move(error));
+    }
+  };
+  return false;
+}
+
+bool HttpClient::FollowRedirect(core::ReactorContext* ctx, Request* request,
+                                Response* response, ResponseCallback* callback,
+                                const RequestClock& clock) {
+  if (!http::IsFollowableRedirect(response->status_code) ||
+      clock.redirects >= config_.max_redirects) {
+    return false;
+  }
+
+  // Unresolvable and plain-HTTP targets deliver the 3xx as the response
+  util::ParsedUrl base;
+  util::ParsedUrl next;
+  std::string location;
+  if (!util::ParseUrl(request->url, &base) ||
+      !http::ResolveLocation(base,
+                             response->GetHeader(http2::HeaderId::kLocation),
+                             &location) ||
+      !util::ParseUrl(location, &next) || !next.IsHttps()) {
+    return false;
+  }
+
+  uint64_t now_us = NowUs(ctx);
+  RedirectHop hop;
+  hop.url = std::move(request->url);
+  hop.status_code = response->status_code;
+  hop.location = location;
+  hop.timing = response->timing;
+  hop.timing.total =
+      std::chrono::microseconds(Elapsed(clock.hop_start_us, now_us));
+
+  // A rewritten method loses the body and the headers describing it
+  if (http::RedirectRewritesToGet(response->status_code,
+                                  MethodToString(request->method))) {
+    request->method = Method::kGet;
+    request->body.clear();
+    EraseHeaders(&request->headers,
+                 {"content-type", "content-length", "content-encoding",
+                  "content-language", "content-location"});
+  }
+
+  // Caller-set credentials stay with the origin they were meant for.
+  // Cookie-jar cookies (including any set by this response) are looked up
+  // again for the new URL when the next hop's headers are built.
+  if (!http::IsSameOrigin(base, next)) {
+    EraseHeaders(&request->headers,
+                 {"authorization", "proxy-authorization", "cookie"});
+  }
+  request->url = std::move(location);
+
+  // Hops are prepended on the way out, so the chain reads first to last
+  ResponseCallback delivered =
+      [hop = std::move(hop), callback = std::move(*callback)](
+          Response final_response, Error error) mutable {
+        final_response.redirects.insert(final_response.redirects.begin(),
+                                        std::move(hop));
+        if (callback) {
+          callback(std::move(final_response), std::move(error));
         }
+      };
+
+  RequestClock next_clock = clock;
+  next_clock.hop_start_us = now_us;
+  next_clock.redirects = clock.redirects + 1;
+
+  // Deferred to the next loop iteration: the connection is still inside its
+  // completion callback. Same-origin hops then find it idle in the pool.
+  ctx->reactor->Post([this, ctx, request = std::move(*request),
+                      next = std::move(next), delivered = std::move(delivered),
+                      next_clock]() mutable {
+    ProcessRequest(ctx, std::move(request), std::move(next),
+                   std::move(delivered), nullptr, next_clock);
+  });
+  return true;
+}
+
+struct HttpClient::TcpExchange {
+  Request request;
+  util::ParsedUrl parsed;
+  ResponseCallback callback;
+  RequestClock clock;
+
+  // Copies on the wire: [0] the first send, [1] the hedge
+  struct Attempt {
+    pool::PooledConnection* pooled = nullptr;
+    uint64_t request_id = 0;
+    bool active = false;  // Sent and not yet completed or cancelled
+  };
+  std::array<Attempt, 2> attempts;
+
+  // Response or error delivered (or the request handed on for a replay)
+  bool done = false;
+
+  // Hedge delay. `self` keeps the exchange alive until the handle closes.
+  uv_timer_t hedge_timer;
+  std::shared_ptr<TcpExchange> self;
+  HttpClient* client = nullptr;
+  core::ReactorContext* ctx = nullptr;
+
+  void CloseHedgeTimer() {
+    if (!self) {
+      return;
+    }
+    uv_timer_stop(&hedge_timer);
+    uv_close(reinterpret_cast<uv_handle_t*>(&hedge_timer), [](uv_handle_t* h) {
+      // Last reference may go here; libuv is done with the handle
+      static_cast<TcpExchange*>(h->data)->self.reset();
+    });
+  }
+
+  bool AnyActive() const {
+    return std::ranges::any_of(attempts, &Attempt::active);
+  }
+};
+
+void HttpClient::SendOnTcpConnection(core::ReactorContext* ctx,
+                                     pool::PooledConnection* pooled,
+                                     const util::ParsedUrl& parsed,
+                                     Request request,
+                                     ResponseCallback callback,
+                                     RequestClock clock) {
+  // Kept with the exchange for redirects, replays and hedges
+  auto exchange = std::make_shared<TcpExchange>();
+  exchange->request = std::move(request);
+  exchange->parsed = parsed;
+  exchange->callback = std::move(callback);
+  exchange->clock = clock;
+
+  SendTcpAttempt(ctx, exchange, 0, pooled);
+
+  if (!hedgers_.empty()) {
+    hedgers_[ctx->index]->OnRequest();
+    if (RequestHedger::Eligible(exchange->request)) {
+      ArmHedge(ctx, exchange);
+    }
+  }
+}
+
+void HttpClient::SendTcpAttempt(core::ReactorContext* ctx,
+                                const std::shared_ptr<TcpExchange>& exchange,
+                                size_t index, pool::PooledConnection* pooled) {
+  ctx->stats->requests_sent.Add();
+
+  // Build the header block once; it is referenced in place down to the wire
+  const Request& request = exchange->request;
+  http::RequestHeaders conn_headers;
+  conn_headers.SetMethodStatic(MethodToString(request.method));
+  conn_headers.SetPath(exchange->parsed.PathWithQuery());
+  BuildRequestHeaders(request, &conn_headers);
+
+  TcpExchange::Attempt& attempt = exchange->attempts[index];
+  attempt.pooled = pooled;
+  attempt.active = true;
+  uint64_t request_id = pooled->connection->SendRequest(
+      std::move(conn_headers), request.header_order,
+      [this, ctx, exchange, index](core::RawResponse core_resp) {
+        OnTcpResponse(ctx, exchange, index, std::move(core_resp));
+      },
+      [this, ctx, exchange, index](const std::string& error,
+                                   core::StreamError kind) {
+        OnTcpError(ctx, exchange, index, error, kind);
+      });
+
+  // A submit that failed at once has already been reported
+  if (attempt.active) {
+    attempt.request_id = request_id;
+  }
+}
+
+void HttpClient::OnTcpResponse(core::ReactorContext* ctx,
+                               const std::shared_ptr<TcpExchange>& exchange,
+                               size_t index, core::RawResponse core_resp) {
+  TcpExchange::Attempt& attempt = exchange->attempts[index];
+  pool::PooledConnection* pooled = attempt.pooled;
+  attempt.active = false;
+  RecordLimitOutcome(pooled->host_pool, core_resp.status_code,
+                     core_resp.headers, core_resp.timing);
+
+  // Lost to the other copy but could not be cancelled (HTTP/1.1)
+  if (exchange->done) {
+    ctx->connection_pool->ReleaseTcpConnection(pooled);
+    return;
+  }
+  SettleExchange(ctx, exchange.get());
+
+  const util::ParsedUrl& parsed = exchange->parsed;
+  ProcessResponseHeaders(core_resp.headers, exchange->request.url,
+                         parsed.host, parsed.port);
+
+  // Build response (headers and body are moved, not copied)
+  const RequestClock& clock = exchange->clock;
+  Response response(core_resp.status_code, std::move(core_resp.headers),
+                    std::move(core_resp.body));
+  response.timing = MakeTiming(clock.start_us, clock.hop_start_us,
+                               clock.dns_us, core_resp.timing, NowUs(ctx));
+  if (index > 0) {
+    response.hedged = true;
+    ctx->stats->hedges_won.Add();
+  }
+
+  // Release connection back to pool
+  ctx->connection_pool->ReleaseTcpConnection(pooled);
+
+  ctx->stats->requests_completed.Add();
+
+  if (config_.follow_redirects &&
+      FollowRedirect(ctx, &exchange->request, &response, &exchange->callback,
+                     clock)) {
+    return;
+  }
+
+  if (exchange->callback) {
+    exchange->callback(std::move(response), Error{});
+  }
+}
+
+void HttpClient::OnTcpError(core::ReactorContext* ctx,
+                            const std::shared_ptr<TcpExchange>& exchange,
+                            size_t index, const std::string& error,
+                            core::StreamError kind) {
+  TcpExchange::Attempt& attempt = exchange->attempts[index];
+  pool::PooledConnection* pooled = attempt.pooled;
+  attempt.active = false;
+
+  if (kind == core::StreamError::kRefused) {
+    // Nothing was processed here, but the connection may not be usable:
+    // the pool retires one that is going away, failed to connect or
+    // closed (IsRetiring) once it is idle
+    ctx->connection_pool->ReleaseTcpConnection(pooled);
+  } else {
+    if (pooled->host_pool) {
+      pooled->host_pool->RecordDrop();
+    }
+
+    // Mark connection as failed
+    ctx->connection_pool->RemoveTcpConnection(pooled);
+  }
+
+  // Already answered, or the other copy may still answer
+  if (exchange->done || exchange->AnyActive()) {
+    return;
+  }
+  SettleExchange(ctx, exchange.get());
+
+  // The server never saw it: send it again, from DNS on, outside this
+  // connection callback
+  if (kind == core::StreamError::kRefused &&
+      exchange->clock.replays < kMaxReplays) {
+    ctx->stats->requests_replayed.Add();
+    RequestClock clock = exchange->clock;
+    clock.replays++;
+    uint8_t urgency = exchange->request.priority.urgency;
+    ctx->reactor->Post(
+        [this, ctx, exchange, clock] {
+          ResolveAndSend(ctx, std::move(exchange->request), exchange->parsed,
+                         std::move(exchange->callback), clock);
+        },
+        urgency);
+    return;
+  }
+
+  ctx->stats->requests_failed.Add();
+
+  if (exchange->callback) {
+    exchange->callback(Response{}, Error{ErrorCode::kConnection, error});
+  }
+}
+
+void HttpClient::SettleExchange(core::ReactorContext* ctx,
+                                TcpExchange* exchange) {
+  exchange->done = true;
+  exchange->CloseHedgeTimer();
+
+  // Reset the losing copy's stream and free its slot
+  for (auto& attempt : exchange->attempts) {
+    if (attempt.active &&
+        attempt.pooled->connection->CancelRequest(attempt.request_id)) {
+      attempt.active = false;
+      ctx->connection_pool->ReleaseTcpConnection(attempt.pooled);
+    }
+  }
+}
+
+void HttpClient::ArmHedge(core::ReactorContext* ctx,
+                          const std::shared_ptr<TcpExchange>& exchange) {
+  uint64_t delay_us =
+      hedgers_[ctx->index]->DelayUs(ctx->stats->ttfb, NowUs(ctx));
+  if (delay_us == 0 || !exchange->attempts[0].active) {
+    return;
+  }
+
+  exchange->client = this;
+  exchange->ctx = ctx;
+  exchange->self = exchange;
+  uv_timer_init(ctx->reactor->loop(), &exchange->hedge_timer);
+  exchange->hedge_timer.data = exchange.get();
+  uv_timer_start(
+      &exchange->hedge_timer,
+      [](uv_timer_t* handle) {
+        std::shared_ptr<TcpExchange> timed =
+            static_cast<TcpExchange*>(handle->data)->self;
+        timed->CloseHedgeTimer();
+        timed->client->LaunchHedge(timed->ctx, timed);
       },
-      [this, ctx, pooled, shared_cb](const std::string& error) mutable {
-        // Mark connection as failed
-        ctx->connection_pool->RemoveTcpConnection(pooled);
+      (delay_us + 999) / 1000, 0);
+}
 
-        requests_failed_.fetch_add(1, std::memory_order_relaxed);
+void HttpClient::LaunchHedge(core::ReactorContext* ctx,
+                             const std::shared_ptr<TcpExchange>& exchange) {
+  const TcpExchange::Attempt& first = exchange->attempts[0];
+  if (exchange->done || !first.active ||
+      first.pooled->connection->ResponseStarted(first.request_id) ||
+      !hedgers_[ctx->index]->TryHedge()) {
+    return;
+  }
 
-        if (*shared_cb) {
-          (*shared_cb)(Response{}, Error{ErrorCode::kConnection, error});
+  // Addresses come from the DNS cache, so this normally completes at once
+  ctx->dns_resolver->ResolveAsync(
+      exchange->parsed.host,
+      [this, ctx, exchange](const std::vector<util::ResolvedAddress>& addresses,
+                            const std::string& /*error*/) {
+        const TcpExchange::Attempt& primary = exchange->attempts[0];
+        if (exchange->done || !primary.active) {
+          return;
         }
+
+        // Another connection, ideally to another address; open one to an
+        // address not yet tried if that is all the pool lacks
+        pool::HostPool* host_pool = primary.pooled->host_pool;
+        const std::string& first_ip = primary.pooled->connection->peer_ip();
+        pool::PooledConnection* pooled =
+            host_pool->AcquireAlternate(primary.pooled);
+        if (pooled == nullptr || pooled->connection->peer_ip() == first_ip) {
+          auto other = std::ranges::find_if(
+              addresses, [&first_ip](const util::ResolvedAddress& address) {
+                return address.ip != first_ip;
+              });
+          if (other != addresses.end() &&
+              host_pool->CreateConnection(other->ip, other->is_ipv6)) {
+            if (pooled != nullptr) {
+              host_pool->ReleaseConnection(pooled);
+            }
+            pooled = host_pool->AcquireAlternate(primary.pooled);
+          }
+        }
+        if (pooled == nullptr) {
+          return;
+        }
+
+        ctx->stats->requests_hedged.Add();
+        SendTcpAttempt(ctx, exchange, 1, pooled);
       });
 }
 
@@ -599,8 +1481,9 @@ void HttpClient::SendOnQuicConnection(core::ReactorContext* ctx,
                                       pool::QuicPooledConnection* quic_conn,
                                       const util::ParsedUrl& parsed,
                                       Request request,
-                                      ResponseCallback callback) {
-  requests_sent_.fetch_add(1, std::memory_order_relaxed);
+                                      ResponseCallback callback,
+                                      RequestClock clock) {
+  ctx->stats->requests_sent.Add();
 
   // Build H2Headers from request
   http2::H2Headers h2_headers;
@@ -612,17 +1495,11 @@ void HttpClient::SendOnQuicConnection(core::ReactorContext* ctx,
   h2_headers.path = parsed.PathWithQuery();
   h2_headers.scheme = "https";
 
-  // Add custom headers
-  for (const auto& h : request.headers) {
-    h2_headers.headers.emplace_back(h.name, h.value);
-  }
-
-  // Add cookies from cookie jar if available
-  if (cookie_jar_) {
-    std::string cookie_header = cookie_jar_->GetCookieHeader(request.url);
-    if (!cookie_header.empty()) {
-      h2_headers.headers.emplace_back("cookie", std::move(cookie_header));
-    }
+  http::RequestHeaders request_headers;
+  BuildRequestHeaders(request, &request_headers);
+  h2_headers.headers.reserve(request_headers.size());
+  for (const auto& h : request_headers.headers()) {
+    h2_headers.headers.emplace_back(std::string(h.name), std::string(h.value));
   }
 
   // Share callback between success and error handlers
@@ -631,39 +1508,39 @@ void HttpClient::SendOnQuicConnection(core::ReactorContext* ctx,
   std::string origin_host = parsed.host;
   uint16_t origin_port = parsed.port;
 
+  // Kept for building the next hop if the response is a redirect
+  std::shared_ptr<Request> redirect_request;
+  if (config_.follow_redirects) {
+    redirect_request = std::make_shared<Request>(std::move(request));
+  }
+  const Request& sent = redirect_request ? *redirect_request : request;
+
   // Create response builder
   auto response_builder = std::make_shared<Response>();
   auto body_buffer = std::make_shared<std::vector<uint8_t>>();
 
+  // Connect and TLS happen inside the QUIC pool and are not attributed
+  core::RequestTiming quic_timing;
+  quic_timing.sent_us = NowUs(ctx);
+
   // Set up stream callbacks
   http2::H2StreamCallbacks stream_callbacks;
 
   stream_callbacks.on_headers =
-      [this, response_builder, request_url, origin_host, origin_port](
-          int /*stream_id*/, const http2::PackedHeaders& packed) {
+      [this, ctx, response_builder, request_url, origin_host, origin_port,
+       sent_us = quic_timing.sent_us](int /*stream_id*/,
+                                      const http2::PackedHeaders& packed) {
+        if (response_builder->status_code == 0) {
+          response_builder->timing.ttfb =
+              std::chrono::microseconds(Elapsed(sent_us, NowUs(ctx)));
+        }
+
         // Get status code from PackedHeaders (set via SetStatus in H3Session)
         response_builder->status_code = packed.status_code();
+        response_builder->headers = packed;
 
-        // Extract regular headers
-        for (size_t i = 0; i < packed.size(); ++i) {
-          std::string_view name = packed.name(i);
-          std::string_view value = packed.value(i);
-          if (!name.empty() && name[0] != ':') {
-            // Regular header (skip pseudo-headers)
-            response_builder->headers.push_back(
-                {std::string(name), std::string(value)});
-
-            // Process Set-Cookie headers if cookie jar is available
-            if (cookie_jar_ && name == "set-cookie") {
-              cookie_jar_->ProcessSetCookie(request_url, value);
-            }
-
-            // Process Alt-Svc headers (even over H3, server may advertise)
-            if (alt_svc_cache_ && alt_svc_enabled_ && name == "alt-svc") {
-              alt_svc_cache_->ProcessAltSvc(origin_host, origin_port, value);
-            }
-          }
-        }
+        // Alt-Svc is processed even over H3 (server may re-advertise)
+        ProcessResponseHeaders(packed, request_url, origin_host, origin_port);
       };
 
   stream_callbacks.on_data = [body_buffer](int /*stream_id*/,
@@ -673,7 +1550,8 @@ void HttpClient::SendOnQuicConnection(core::ReactorContext* ctx,
 
   stream_callbacks.on_close =
       [this, ctx, quic_conn, shared_cb, response_builder, body_buffer,
-       origin_host, origin_port](int /*stream_id*/, uint32_t error_code) {
+       redirect_request, origin_host, origin_port, clock,
+       quic_timing](int /*stream_id*/, uint32_t error_code) {
         if (error_code == 0) {
           // Success - clear any H3 failure flag
           if (alt_svc_cache_) {
@@ -681,8 +1559,19 @@ void HttpClient::SendOnQuicConnection(core::ReactorContext* ctx,
           }
 
           response_builder->body = std::move(*body_buffer);
+          auto ttfb = response_builder->timing.ttfb;
+          response_builder->timing =
+              MakeTiming(clock.start_us, clock.hop_start_us, clock.dns_us,
+                         quic_timing, NowUs(ctx));
+          response_builder->timing.ttfb = ttfb;
           ctx->connection_pool->ReleaseQuicConnection(quic_conn);
-          requests_completed_.fetch_add(1, std::memory_order_relaxed);
+          ctx->stats->requests_completed.Add();
+
+          if (redirect_request &&
+              FollowRedirect(ctx, redirect_request.get(),
+                             response_builder.get(), shared_cb.get(), clock)) {
+            return;
+          }
 
           if (*shared_cb) {
             (*shared_cb)(std::move(*response_builder), Error{});
@@ -694,7 +1583,7 @@ void HttpClient::SendOnQuicConnection(core::ReactorContext* ctx,
           }
 
           ctx->connection_pool->RemoveQuicConnection(quic_conn);
-          requests_failed_.fetch_add(1, std::memory_order_relaxed);
+          ctx->stats->requests_failed.Add();
 
           if (*shared_cb) {
             (*shared_cb)(Response{}, Error{ErrorCode::kConnection,
@@ -705,16 +1594,15 @@ void HttpClient::SendOnQuicConnection(core::ReactorContext* ctx,
       };
 
   // Submit request using H3Session
-  const uint8_t* body_data =
-      request.body.empty() ? nullptr : request.body.data();
-  size_t body_len = request.body.size();
+  const uint8_t* body_data = sent.body.empty() ? nullptr : sent.body.data();
+  size_t body_len = sent.body.size();
 
   int64_t stream_id = quic_conn->SubmitRequest(h2_headers, stream_callbacks,
                                                body_data, body_len);
 
   if (stream_id < 0) {
     ctx->connection_pool->RemoveQuicConnection(quic_conn);
-    requests_failed_.fetch_add(1, std::memory_order_relaxed);
+    ctx->stats->requests_failed.Add();
 
     if (*shared_cb) {
       (*shared_cb)(Response{}, Error{ErrorCode::kConnection,
@@ -0,0 +1,94 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/client/request_coalescer.h"
+
+#include <memory>
+#include <utility>
+
+#include "holytls/util/sv_helpers.h"
+
+namespace holytls {
+
+RequestCoalescer::RequestCoalescer(
+    const std::vector<std::string>& key_headers) {
+  key_headers_.reserve(key_headers.size());
+  for (const auto& name : key_headers) {
+    key_headers_.push_back(util::ToLower(name));
+  }
+}
+
+std::string RequestCoalescer::Key(const Request& request) const {
+  if ((request.method != Method::kGet && request.method != Method::kHead) ||
+      !request.body.empty()) {
+    return {};
+  }
+
+  std::string_view url = request.url;
+  url = url.substr(0, url.find('#'));
+
+  // Method, URL, fetch context, then each key header as sent by the caller
+  std::string key;
+  key.reserve(url.size() + 32);
+  key.append(MethodToString(request.method));
+  key.push_back(' ');
+  key.append(url);
+  key.push_back('\n');
+  key.push_back(static_cast<char>('0' + static_cast<int>(request.fetch.type)));
+  key.push_back(static_cast<char>('0' + static_cast<int>(request.fetch.site)));
+  key.push_back(static_cast<char>('0' + static_cast<int>(request.fetch.mode)));
+  key.push_back(static_cast<char>('0' + static_cast<int>(request.fetch.dest)));
+  key.push_back(request.fetch.user_activated ? '1' : '0');
+  for (const auto& name : key_headers_) {
+    key.push_back('\n');
+    for (const auto& header : request.headers) {
+      if (util::EqualsIgnoreCase(header.name, name)) {
+        // Repeated headers are kept in order; absent ones add nothing
+        key.push_back('=');
+        key.append(header.value);
+      }
+    }
+  }
+  return key;
+}
+
+void RequestCoalescer::Join(const std::string& key,
+                            ResponseCallback callback) {
+  joined_[key].push_back(std::move(callback));
+}
+
+void RequestCoalescer::Lead(const std::string& key,
+                            ResponseCallback* callback) {
+  joined_.try_emplace(key);
+  *callback = [this, key, leader = std::move(*callback)](Response response,
+                                                         Error error) {
+    Complete(key, leader, std::move(response), std::move(error));
+  };
+}
+
+void RequestCoalescer::Complete(const std::string& key,
+                                const ResponseCallback& leader,
+                                Response response, Error error) {
+  // Taken out first: a request issued from a callback starts a new exchange
+  std::vector<ResponseCallback> joined;
+  if (auto it = joined_.find(key); it != joined_.end()) {
+    joined = std::move(it->second);
+    joined_.erase(it);
+  }
+
+  if (!joined.empty() && !response.body.empty()) {
+    response.shared_body =
+        std::make_shared<const std::vector<uint8_t>>(std::move(response.body));
+    response.body.clear();
+  }
+  for (auto& callback : joined) {
+    if (callback) {
+      callback(response, error);
+    }
+  }
+  if (leader) {
+    leader(std::move(response), std::move(error));
+  }
+}
+
+}  // namespace holytls
@@ -0,0 +1,65 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// RequestCoalescer - collapses identical in-flight requests.
+//
+// One per reactor, used only on its thread. The first request for a key
+// leads: it goes out normally and its callback is wrapped. Identical
+// requests arriving while it is in flight join it instead of being sent,
+// and receive a copy of its response whose body is one shared buffer
+// (Response::shared_body) rather than a copy per caller.
+
+#ifndef HOLYTLS_CLIENT_REQUEST_COALESCER_H_
+#define HOLYTLS_CLIENT_REQUEST_COALESCER_H_
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "holytls/client.h"
+
+namespace holytls {
+
+class RequestCoalescer {
+ public:
+  // `key_headers` are the request header names (any case) that must match
+  // besides the method, URL and fetch context
+  explicit RequestCoalescer(const std::vector<std::string>& key_headers);
+
+  // Non-copyable, non-movable (leader callbacks point back at it)
+  RequestCoalescer(const RequestCoalescer&) = delete;
+  RequestCoalescer& operator=(const RequestCoalescer&) = delete;
+
+  // Key of requests that may share a response; empty when `request` must be
+  // sent on its own (not GET or HEAD, or it has a body)
+  std::string Key(const Request& request) const;
+
+  // Whether a request with `key` is in flight
+  bool InFlight(const std::string& key) const {
+    return joined_.contains(key);
+  }
+
+  // Invoke `callback` with the response of the in-flight request with `key`
+  void Join(const std::string& key, ResponseCallback callback);
+
+  // Make the request with `key` the one later requests join. Wraps
+  // `callback` to hand its response to them once it completes.
+  void Lead(const std::string& key, ResponseCallback* callback);
+
+  // Keys with a request in flight
+  size_t leaders() const { return joined_.size(); }
+
+ private:
+  void Complete(const std::string& key, const ResponseCallback& leader,
+                Response response, Error error);
+
+  std::vector<std::string> key_headers_;  // Lowercase
+
+  // Callbacks joined to each in-flight key, in arrival order
+  std::unordered_map<std::string, std::vector<ResponseCallback>> joined_;
+};
+
+}  // namespace holytls
+
+#endif  // HOLYTLS_CLIENT_REQUEST_COALESCER_H_
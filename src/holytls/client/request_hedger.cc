@@ -0,0 +1,54 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/client/request_hedger.h"
+
+#include <algorithm>
+
+namespace holytls {
+
+RequestHedger::RequestHedger(const HedgeConfig& config) : config_(config) {
+  config_.percentile = std::clamp(config_.percentile, 0.0, 100.0);
+  config_.budget = std::clamp(config_.budget, 0.0, 1.0);
+}
+
+bool RequestHedger::Eligible(const Request& request) {
+  return (request.method == Method::kGet || request.method == Method::kHead) &&
+         request.body.empty();
+}
+
+uint64_t RequestHedger::DelayUs(const core::LatencyHistogram& ttfb,
+                                uint64_t now_us) {
+  if (refreshed_ && now_us - refreshed_us_ < kRefreshUs) {
+    return delay_us_;
+  }
+  refreshed_ = true;
+  refreshed_us_ = now_us;
+
+  core::HistogramSnapshot snapshot;
+  snapshot.Merge(ttfb);
+  if (snapshot.count() < std::max<size_t>(config_.min_samples, 1)) {
+    delay_us_ = 0;
+    return 0;
+  }
+  auto min_delay_us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(config_.min_delay)
+          .count());
+  delay_us_ = std::max<uint64_t>(
+      {snapshot.Percentile(config_.percentile), min_delay_us, 1});
+  return delay_us_;
+}
+
+void RequestHedger::OnRequest() {
+  tokens_ = std::min(tokens_ + config_.budget, kMaxTokens);
+}
+
+bool RequestHedger::TryHedge() {
+  if (tokens_ < 1.0) {
+    return false;
+  }
+  tokens_ -= 1.0;
+  return true;
+}
+
+}  // namespace holytls
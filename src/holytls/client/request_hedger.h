@@ -0,0 +1,60 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// RequestHedger - when and how often to hedge requests.
+//
+// One per reactor, used only on its thread. The hedge delay is a
+// percentile of the reactor's time-to-first-byte histogram, refreshed at
+// most once a second. Hedges are paid from a token budget that every
+// request sent tops up by HedgeConfig::budget, so they never add more
+// than that share of load, however slow the origin gets.
+
+#ifndef HOLYTLS_CLIENT_REQUEST_HEDGER_H_
+#define HOLYTLS_CLIENT_REQUEST_HEDGER_H_
+
+#include <cstdint>
+
+#include "holytls/client.h"
+#include "holytls/config.h"
+#include "holytls/core/stats.h"
+
+namespace holytls {
+
+class RequestHedger {
+ public:
+  explicit RequestHedger(const HedgeConfig& config);
+
+  // Whether `request` may be sent twice: GET or HEAD without a body
+  static bool Eligible(const Request& request);
+
+  // Delay after which a request still waiting for response headers is
+  // hedged (microseconds); 0 while `ttfb` holds too few samples
+  uint64_t DelayUs(const core::LatencyHistogram& ttfb, uint64_t now_us);
+
+  // Count a request sent; each adds HedgeConfig::budget to the budget
+  void OnRequest();
+
+  // Take one hedge from the budget. False when it is spent.
+  bool TryHedge();
+
+  // Hedges currently affordable (fractional)
+  double budget() const { return tokens_; }
+
+  // Most hedges that may be saved up during quiet periods
+  static constexpr double kMaxTokens = 10.0;
+
+  // Delay recomputation interval
+  static constexpr uint64_t kRefreshUs = 1000000;
+
+ private:
+  HedgeConfig config_;
+  double tokens_ = 0.0;
+
+  uint64_t delay_us_ = 0;
+  uint64_t refreshed_us_ = 0;
+  bool refreshed_ = false;
+};
+
+}  // namespace holytls
+
+#endif  // HOLYTLS_CLIENT_REQUEST_HEDGER_H_
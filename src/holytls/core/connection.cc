@@ -3,8 +3,8 @@
 
 #include "holytls/core/connection.h"
 
+#include <algorithm>
 #include <cstring>
-#include <unordered_map>
 
 #include "holytls/http2/chrome_h2_profile.h"
 #include "holytls/http2/header_ids.h"
@@ -17,6 +17,14 @@
 namespace holytls {
 namespace core {
 
+namespace {
+
+// How often a connection holding new streams for memory backpressure
+// re-checks its reactor's account
+constexpr uint64_t kStreamResumePollMs = 10;
+
+}  // namespace
+
 Connection::Connection(Reactor* reactor, tls::TlsContextFactory* tls_factory,
                        const std::string& host, uint16_t port,
                        const ConnectionOptions& options)
@@ -25,9 +33,24 @@ Connection::Connection(Reactor* reactor, tls::TlsContextFactory* tls_factory,
       tls_factory_(tls_factory),
       host_(host),
       port_(port),
-      options_(options) {}
+      options_(options) {
+  charge_.Set(sizeof(Connection));
+}
 
-Connection::~Connection() { Close(); }
+Connection::~Connection() {
+  Close();
+  if (resume_timer_ != nullptr) {
+    uv_close(reinterpret_cast<uv_handle_t*>(resume_timer_),
+             [](uv_handle_t* h) { delete reinterpret_cast<uv_timer_t*>(h); });
+  }
+}
+
+uint64_t Connection::NowUs() const {
+  if (options_.high_resolution_timing) {
+    return uv_hrtime() / 1000;
+  }
+  return reactor_->now_ms() * 1000;
+}
 
 bool Connection::Connect(std::string_view ip, bool ipv6) {
   // Determine connect target: proxy or direct
@@ -41,6 +64,9 @@ bool Connection::Connect(std::string_view ip, bool ipv6) {
     connect_port = options_.proxy.port;
   }
 
+  peer_ip_ = std::string(ip);
+  peer_ipv6_ = ipv6;
+
   // Create socket
   fd_ = util::CreateTcpSocket(ipv6);
   // Update base class fd for Reactor dispatch
@@ -51,9 +77,32 @@ bool Connection::Connect(std::string_view ip, bool ipv6) {
     return false;
   }
 
-  util::ConfigureSocket(fd_);
+  util::ConfigureSocket(fd_, options_.socket);
+  if (!options_.socket.local_address.empty() &&
+      !util::BindLocalAddress(fd_, options_.socket.local_address, ipv6)) {
+    SetError("Bind failed: " + util::GetLastSocketErrorString());
+    util::CloseSocket(fd_);
+    fd_ = util::kInvalidSocket;
+    return false;
+  }
+  // Nothing for kAdaptive to do unless its ceiling is above autotuning's
+  if (options_.socket.buffer_mode == SocketBufferMode::kAdaptive &&
+      options_.socket.max_buffer_size > util::AutotuneReceiveBufferMax()) {
+    rcvbuf_size_ = util::GetReceiveBufferSize(fd_);
+  }
+
+  // TCP Fast Open: connect() returns at once and the ClientHello written
+  // by StartTls() goes out in the SYN. Not used through proxies, where the
+  // first flight is the tunnel request rather than our ClientHello.
+  if (options_.socket.tcp_fast_open && !options_.proxy.IsEnabled()) {
+    fast_open_attempted_ = util::EnableTcpFastOpen(fd_);
+    if (fast_open_attempted_ && options_.stats) {
+      options_.stats->fast_open_attempts.Add();
+    }
+  }
 
   // Start non-blocking connect
+  connect_start_us_ = NowUs();
   int ret = util::ConnectNonBlocking(fd_, connect_ip, connect_port, ipv6);
   if (ret < 0) {
     SetError("Connect failed: " + util::GetLastSocketErrorString());
@@ -63,6 +112,10 @@ bool Connection::Connect(std::string_view ip, bool ipv6) {
   }
 
   state_ = ConnectionState::kConnecting;
+  Trace(options_.trace, TraceEvent::kConnectStart, this);
+  if (options_.stats) {
+    options_.stats->connections_created.Add();
+  }
 
   // Register with reactor - watch for writable to know when connect completes
   // On Windows, AFD_POLL may need both read+write to properly detect connect
@@ -79,7 +132,9 @@ bool Connection::Connect(std::string_view ip, bool ipv6) {
     return false;
   }
 
-  // If connect completed immediately (localhost), handle it
+  // If connect completed immediately (localhost, or TCP Fast Open where the
+  // SYN is deferred to the first write and the TCP round trip is counted in
+  // the TLS phase), handle it
   if (ret == 0) {
     HandleConnecting();
   }
@@ -87,171 +142,252 @@ bool Connection::Connect(std::string_view ip, bool ipv6) {
   return true;
 }
 
-void Connection::SendRequest(
+uint64_t Connection::SendRequest(
     const std::string& method, const std::string& path,
     const std::vector<std::pair<std::string, std::string>>& headers,
     std::span<const std::string_view> header_order,
     ResponseCallback on_response, ErrorCallback on_error) {
-  if (state_ == ConnectionState::kConnected && CanSubmitRequest()) {
-    // Connection ready, submit request immediately
-    http2::H2Headers h2_headers;
-    h2_headers.method = method;
-    h2_headers.scheme = "https";
-    h2_headers.authority = host_;
-    h2_headers.path = path;
-
-    if (!header_order.empty()) {
-      // Full control mode: user specifies exact header order
-      // Build a map for O(1) lookup
-      std::unordered_map<std::string_view, std::string_view> header_map;
-      for (const auto& [name, value] : headers) {
-        header_map[name] = value;
-      }
+  http::RequestHeaders block;
+  block.SetMethod(method);
+  block.SetPath(path);
+  for (const auto& [name, value] : headers) {
+    block.Add(name, value);
+  }
+  return SendRequest(std::move(block), header_order, std::move(on_response),
+                     std::move(on_error));
+}
 
-      // Add headers in specified order
-      for (const auto& name : header_order) {
-        auto it = header_map.find(name);
-        if (it != header_map.end()) {
-          h2_headers.Add(std::string(it->first), std::string(it->second));
-          header_map.erase(it);
-        }
-      }
+uint64_t Connection::SendRequest(http::RequestHeaders headers,
+                                 std::span<const std::string_view> header_order,
+                                 ResponseCallback on_response,
+                                 ErrorCallback on_error) {
+  if (headers.scheme().empty()) {
+    headers.SetSchemeStatic("https");
+  }
+  if (headers.authority().empty()) {
+    headers.SetAuthority(host_);
+  }
 
-      // Append any remaining headers not in order list
-      for (const auto& [name, value] : header_map) {
-        h2_headers.Add(std::string(name), std::string(value));
-      }
-    } else {
-      // No auto headers - pass through user-provided headers only
-      for (const auto& [name, value] : headers) {
-        h2_headers.Add(name, value);
-      }
+  // Full control mode: user specifies exact header order.
+  // Reordered once here so queued requests don't keep the caller's span.
+  bool preserve_order = !header_order.empty();
+  if (preserve_order) {
+    headers.ApplyOrder(header_order);
+  }
+
+  // Requests sent before the handshake finished all waited for the setup
+  // and carry its cost; only those sent on an established connection reuse
+  bool reused = state_ == ConnectionState::kConnected;
+  if (reused && options_.stats) {
+    options_.stats->connections_reused.Add();
+  }
+
+  uint64_t request_id = next_request_id_++;
+  if (state_ == ConnectionState::kConnected && CanSubmitRequest() &&
+      !PauseStreamsIfOverLimit()) {
+    // Connection ready, submit request immediately
+    SubmitRequest(request_id, std::move(headers), preserve_order, reused,
+                  std::move(on_response), std::move(on_error));
+  } else if (IsGoingAway()) {
+    // Going away (GOAWAY received): no new stream will ever open here
+    if (on_error) {
+      on_error("Connection is going away", StreamError::kRefused);
     }
+  } else {
+    // Queue request for when connection is ready
+    pending_requests_.push_back({request_id, std::move(headers),
+                                 preserve_order, reused,
+                                 std::move(on_response), std::move(on_error)});
+  }
+  return request_id;
+}
 
-    http2::H2StreamCallbacks stream_callbacks;
-    int32_t stream_id = -1;
+bool Connection::CancelRequest(uint64_t request_id) {
+  auto pending = std::ranges::find(pending_requests_, request_id,
+                                   &PendingRequest::request_id);
+  if (pending != pending_requests_.end()) {
+    pending_requests_.erase(pending);
+    return true;
+  }
 
-    stream_callbacks.on_headers =
-        [this](int32_t sid, const http2::PackedHeaders& resp_headers) {
-          auto it = active_requests_.find(sid);
-          if (it != active_requests_.end()) {
-            it->second.headers = resp_headers;
-            it->second.status_code = resp_headers.status_code();
-          }
-        };
+  auto active = std::ranges::find_if(active_requests_, [request_id](
+                                                           const auto& entry) {
+    return entry.second.request_id == request_id;
+  });
+  if (active == active_requests_.end() || !h2_) {
+    return false;
+  }
 
-    stream_callbacks.on_data = [this](int32_t sid, const uint8_t* data,
-                                      size_t len) {
-      auto it = active_requests_.find(sid);
-      if (it != active_requests_.end()) {
-        // O(1) amortized append instead of O(n) vector insert
-        it->second.body_buffer.Append(data, len);
-      }
-    };
-
-    stream_callbacks.on_close = [this](int32_t sid, uint32_t error_code) {
-      auto it = active_requests_.find(sid);
-      if (it != active_requests_.end()) {
-        if (error_code == 0 && it->second.on_response) {
-          // Build RawResponse from ActiveRequest
-          RawResponse response;
-          response.status_code = it->second.status_code;
-          response.headers = std::move(it->second.headers);
-
-          // Zero-copy body extraction - moves data from IoBuffer to vector
-          response.body = it->second.body_buffer.TakeContiguous();
-
-          // Decompress response body if enabled and Content-Encoding header is
-          // present
-          if (options_.auto_decompress) {
-            auto encoding_str =
-                response.headers.Get(http2::HeaderId::kContentEncoding);
-            auto encoding = util::ParseContentEncoding(encoding_str);
-
-            if (encoding != util::ContentEncoding::kIdentity &&
-                encoding != util::ContentEncoding::kUnknown &&
-                !response.body.empty()) {
-              // Capture callback and response for async completion
-              auto response_cb = std::move(it->second.on_response);
-              auto resp = std::move(response);
-
-              // Erase request before async work to avoid iterator invalidation
-              active_requests_.erase(it);
-
-              // Check idle state now (before async work)
-              bool should_notify_idle =
-                  active_requests_.empty() && pending_requests_.empty();
-              auto idle_cb = idle_callback;
-              Connection* self = this;
-
-              // Queue async decompression - runs on thread pool
-              // Extract body before creating lambda to avoid move-order issues
-              auto compressed_body = std::move(resp.body);
-              util::DecompressAsync(
-                  reactor_->loop(), encoding, std::move(compressed_body),
-                  [response_cb = std::move(response_cb), resp = std::move(resp),
-                   should_notify_idle, idle_cb,
-                   self](std::vector<uint8_t> result_body, bool /* success */,
-                         const std::string& /* error */) mutable {
-                    // On success: result_body is decompressed data
-                    // On failure: result_body is original compressed data
-                    resp.body = std::move(result_body);
-                    response_cb(resp);
-
-                    // Notify idle after response delivered
-                    if (should_notify_idle && idle_cb) {
-                      idle_cb(self);
-                    }
-                  });
-              return;  // Response delivered async
+  // The stream's close finds no request and reports nothing
+  int32_t stream_id = active->first;
+  Trace(options_.trace, TraceEvent::kStreamEnd, this, stream_id,
+        NGHTTP2_CANCEL);
+  active_requests_.erase(active);
+  h2_->ResetStream(stream_id, NGHTTP2_CANCEL);
+  FlushSendBuffer();
+
+  if (active_requests_.empty() && pending_requests_.empty() &&
+      idle_callback) {
+    idle_callback(this);
+  }
+  return true;
+}
+
+bool Connection::ResponseStarted(uint64_t request_id) const {
+  return std::ranges::any_of(active_requests_, [request_id](const auto& entry) {
+    return entry.second.request_id == request_id &&
+           entry.second.timing.first_byte_us != 0;
+  });
+}
+
+void Connection::SubmitRequest(uint64_t request_id,
+                               http::RequestHeaders headers,
+                               bool preserve_order, bool reused,
+                               ResponseCallback on_response,
+                               ErrorCallback on_error) {
+  http2::H2StreamCallbacks stream_callbacks;
+  int32_t stream_id = -1;
+
+  stream_callbacks.on_headers =
+      [this](int32_t sid, const http2::PackedHeaders& resp_headers) {
+        auto it = active_requests_.find(sid);
+        if (it != active_requests_.end()) {
+          RequestTiming& timing = it->second.timing;
+          if (timing.first_byte_us == 0) {
+            Trace(options_.trace, TraceEvent::kStreamFirstByte, this, sid);
+            timing.first_byte_us = NowUs();
+            if (options_.stats) {
+              options_.stats->ttfb.Record(timing.first_byte_us -
+                                          timing.sent_us);
             }
           }
-
-          it->second.on_response(response);
-        } else if (error_code != 0 && it->second.on_error) {
-          it->second.on_error("Stream error: " + std::to_string(error_code));
+          it->second.headers = resp_headers;
+          it->second.status_code = resp_headers.status_code();
         }
-        active_requests_.erase(it);
+      };
+
+  stream_callbacks.on_data = [this](int32_t sid, const uint8_t* data,
+                                    size_t len) {
+    auto it = active_requests_.find(sid);
+    if (it != active_requests_.end()) {
+      // O(1) amortized append instead of O(n) vector insert
+      it->second.body_buffer.Append(data, len);
+    }
+  };
 
-        // Notify pool/owner that connection is now idle
-        if (active_requests_.empty() && pending_requests_.empty()) {
-          if (idle_callback) {
-            idle_callback(this);
+  stream_callbacks.on_close = [this](int32_t sid, uint32_t error_code) {
+    auto it = active_requests_.find(sid);
+    if (it != active_requests_.end()) {
+      Trace(options_.trace, TraceEvent::kStreamEnd, this, sid, error_code);
+      if (error_code == 0 && it->second.on_response) {
+        // Build RawResponse from ActiveRequest
+        RawResponse response;
+        response.status_code = it->second.status_code;
+        response.headers = std::move(it->second.headers);
+        response.timing = it->second.timing;
+
+        // Zero-copy body extraction - moves data from IoBuffer to vector
+        response.body = it->second.body_buffer.TakeContiguous();
+
+        // Decompress response body if enabled and Content-Encoding header is
+        // present
+        if (options_.auto_decompress) {
+          auto encoding_str =
+              response.headers.Get(http2::HeaderId::kContentEncoding);
+          auto encoding = util::ParseContentEncoding(encoding_str);
+
+          if (encoding != util::ContentEncoding::kIdentity &&
+              encoding != util::ContentEncoding::kUnknown &&
+              !response.body.empty()) {
+            // Capture callback and response for async completion
+            auto response_cb = std::move(it->second.on_response);
+            auto resp = std::move(response);
+
+            // Erase request before async work to avoid iterator invalidation
+            active_requests_.erase(it);
+
+            // Check idle state now (before async work)
+            bool should_notify_idle =
+                active_requests_.empty() && pending_requests_.empty();
+            auto idle_cb = idle_callback;
+            Connection* self = this;
+
+            // Queue async decompression - runs on thread pool
+            // Extract body before creating lambda to avoid move-order issues
+            auto compressed_body = std::move(resp.body);
+            util::DecompressAsync(
+                reactor_->loop(), encoding, std::move(compressed_body),
+                [response_cb = std::move(response_cb), resp = std::move(resp),
+                 should_notify_idle, idle_cb,
+                 self](std::vector<uint8_t> result_body, bool /* success */,
+                       const std::string& /* error */) mutable {
+                  // On success: result_body is decompressed data
+                  // On failure: result_body is original compressed data
+                  resp.body = std::move(result_body);
+                  response_cb(std::move(resp));
+
+                  // Notify idle after response delivered
+                  if (should_notify_idle && idle_cb) {
+                    idle_cb(self);
+                  }
+                });
+            return;  // Response delivered async
           }
         }
+
+        it->second.on_response(std::move(response));
+      } else if (error_code != 0 && it->second.on_error) {
+        // nghttp2 also closes streams above a GOAWAY's last stream id with
+        // REFUSED_STREAM
+        it->second.on_error("Stream error: " + std::to_string(error_code),
+                            error_code == NGHTTP2_REFUSED_STREAM
+                                ? StreamError::kRefused
+                                : StreamError::kFailed);
       }
-    };
-
-    // Submit to appropriate session
-    if (h2_) {
-      stream_id = h2_->SubmitRequest(h2_headers, stream_callbacks);
-    } else if (h1_) {
-      stream_id =
-          h1_->SubmitRequest(h2_headers, stream_callbacks, header_order);
-    }
-    if (stream_id < 0) {
-      if (on_error) {
-        on_error("Failed to submit request");
+      active_requests_.erase(it);
+
+      // Notify pool/owner that connection is now idle
+      if (active_requests_.empty() && pending_requests_.empty()) {
+        if (idle_callback) {
+          idle_callback(this);
+        }
       }
-      return;
     }
+  };
 
-    // Store active request
-    ActiveRequest active;
-    active.on_response = on_response;
-    active.on_error = on_error;
-    active_requests_[stream_id] = std::move(active);
+  // Submit to appropriate session
+  if (h2_) {
+    stream_id = h2_->SubmitRequest(headers, stream_callbacks);
+  } else if (h1_) {
+    stream_id = h1_->SubmitRequest(headers, stream_callbacks, preserve_order);
+  }
+  if (stream_id < 0) {
+    if (on_error) {
+      on_error("Failed to submit request", StreamError::kFailed);
+    }
+    return;
+  }
 
-    // Flush send buffer
-    FlushSendBuffer();
-  } else {
-    // Queue request for when connection is ready
-    // Copy header_order span to vector for storage
-    std::vector<std::string_view> order_copy(header_order.begin(),
-                                             header_order.end());
-    pending_requests_.push_back(
-        {method, path, headers, std::move(order_copy), on_response, on_error});
+  Trace(options_.trace, TraceEvent::kStreamOpen, this, stream_id);
+
+  // Store active request (owns the header block nghttp2 points into)
+  ActiveRequest active;
+  active.request_id = request_id;
+  active.body_buffer.SetMemoryTag(memory::MemoryTag::kResponseBodies);
+  active.on_response = std::move(on_response);
+  active.on_error = std::move(on_error);
+  active.request_headers = std::move(headers);
+  active.timing.sent_us = NowUs();
+  active.timing.reused = reused;
+  active.timing.tls_resumed = tls_resumed_;
+  if (!reused) {
+    active.timing.connect_us = connect_us_;
+    active.timing.tls_us = tls_us_;
   }
+  active_requests_[stream_id] = std::move(active);
+
+  // Flush send buffer
+  FlushSendBuffer();
 }
 
 void Connection::Close() {
@@ -265,6 +401,10 @@ void Connection::Close() {
     this->fd = -1;
   }
   state_ = ConnectionState::kClosed;
+  if (resume_timer_ != nullptr) {
+    uv_timer_stop(resume_timer_);
+  }
+  streams_paused_ = false;
   h2_.reset();
   h1_.reset();
   tls_.reset();
@@ -311,47 +451,80 @@ void Connection::OnWritable() {
 }
 
 void Connection::OnError(int error_code) {
-  SetError("Socket error: " + std::to_string(error_code));
-  state_ = ConnectionState::kError;
+  // A refused or unreachable connect surfaces as a poll error; the
+  // socket's own error says which
+  if (state_ == ConnectionState::kConnecting && !util::IsConnected(fd_)) {
+    Abort("Connection failed: " + util::GetLastSocketErrorString());
+    return;
+  }
+  Abort("Socket error: " + std::to_string(error_code));
+}
+
+void Connection::Abort(const std::string& error) {
+  // Poll events may report the same close more than once
+  bool was_open = fd_ != util::kInvalidSocket;
+  if (!error.empty()) {
+    SetError(error);
+  }
   Close();
+  FailRequests();
+
+  // Other connections share the reactor: it keeps running
+  if (was_open && closed_callback) {
+    closed_callback(this);
+  }
+}
+
+void Connection::FailRequests() {
+  // Taken out first: callbacks may send on, or cancel on, this connection
+  auto active = std::move(active_requests_);
+  active_requests_.clear();
+  RefusePending();
 
-  // Notify pending requests
-  for (auto& req : pending_requests_) {
+  std::string error = last_error_.empty() ? "Connection closed" : last_error_;
+  for (auto& [sid, req] : active) {
+    bool refused = sid > goaway_last_stream_id_;
+    Trace(options_.trace, TraceEvent::kStreamEnd, this, sid,
+          refused ? NGHTTP2_REFUSED_STREAM : NGHTTP2_INTERNAL_ERROR);
     if (req.on_error) {
-      req.on_error(last_error_);
+      req.on_error(error,
+                   refused ? StreamError::kRefused : StreamError::kFailed);
     }
   }
-  pending_requests_.clear();
+}
+
+void Connection::RefusePending() {
+  std::vector<PendingRequest> pending;
+  pending.swap(pending_requests_);
 
-  // Notify active requests
-  for (auto& [sid, req] : active_requests_) {
+  std::string error = last_error_.empty() ? "Connection closed" : last_error_;
+  for (auto& req : pending) {
     if (req.on_error) {
-      req.on_error(last_error_);
+      req.on_error(error, StreamError::kRefused);
     }
   }
-  active_requests_.clear();
-
-  reactor_->Stop();
 }
 
-void Connection::OnClose() {
-  Close();
-  reactor_->Stop();
-}
+void Connection::OnClose() { Abort(); }
 
 void Connection::HandleConnecting() {
   // Check if connect completed
   if (!util::IsConnected(fd_)) {
-    SetError("Connection failed: " + util::GetLastSocketErrorString());
-    state_ = ConnectionState::kError;
-    Close();
-    reactor_->Stop();
+    Abort("Connection failed: " + util::GetLastSocketErrorString());
     return;
   }
 
+  connect_us_ = NowUs() - connect_start_us_;
+  Trace(options_.trace, TraceEvent::kConnectEnd, this, -1, 1);
+  if (options_.stats) {
+    options_.stats->connect.Record(connect_us_);
+  }
+
   // TCP connected - check if we need to establish proxy tunnel first
   if (options_.proxy.IsEnabled()) {
     proxy::TunnelResult result;
+    state_ = ConnectionState::kProxyTunnel;
+    Trace(options_.trace, TraceEvent::kProxyTunnelStart, this);
 
     if (options_.proxy.IsSocks()) {
       // Create SOCKS proxy tunnel handler
@@ -365,10 +538,7 @@ void Connection::HandleConnecting() {
           options_.proxy.username, options_.proxy.password);
       result = socks_proxy_->Start();
       if (result == proxy::TunnelResult::kError) {
-        SetError("SOCKS proxy tunnel failed: " + socks_proxy_->last_error());
-        state_ = ConnectionState::kError;
-        Close();
-        reactor_->Stop();
+        Abort("SOCKS proxy tunnel failed: " + socks_proxy_->last_error());
         return;
       }
     } else {
@@ -377,29 +547,33 @@ void Connection::HandleConnecting() {
           host_, port_, options_.proxy.username, options_.proxy.password);
       result = http_proxy_->Start();
       if (result == proxy::TunnelResult::kError) {
-        SetError("HTTP proxy tunnel failed: " + http_proxy_->last_error());
-        state_ = ConnectionState::kError;
-        Close();
-        reactor_->Stop();
+        Abort("HTTP proxy tunnel failed: " + http_proxy_->last_error());
         return;
       }
     }
 
-    state_ = ConnectionState::kProxyTunnel;
     reactor_->Modify(this, EventType::kReadWrite);
     HandleProxyTunnel();
   } else {
     // No proxy - start TLS handshake directly
-    tls_ =
-        std::make_unique<tls::TlsConnection>(tls_factory_, fd_, host_, port_);
-    state_ = ConnectionState::kTlsHandshake;
+    StartTls();
+  }
+}
 
-    // Update reactor to watch for read and write
-    reactor_->Modify(this, EventType::kReadWrite);
+void Connection::StartTls() {
+  tls_ = std::make_unique<tls::TlsConnection>(tls_factory_, fd_, host_, port_,
+                                              reactor_->AttachStream(this));
+  state_ = ConnectionState::kTlsHandshake;
+  tls_start_us_ = NowUs();
+  Trace(options_.trace, TraceEvent::kTlsStart, this);
+  // Per-request connect time covers the proxy tunnel as well
+  connect_us_ = tls_start_us_ - connect_start_us_;
 
-    // Start handshake
-    HandleTlsHandshake();
-  }
+  // Update reactor to watch for read and write
+  reactor_->Modify(this, EventType::kReadWrite);
+
+  // Start handshake
+  HandleTlsHandshake();
 }
 
 void Connection::HandleProxyTunnel() {
@@ -425,23 +599,17 @@ void Connection::HandleProxyTunnel() {
         break;
     }
   } else {
-    SetError("Proxy tunnel not initialized");
-    state_ = ConnectionState::kError;
-    Close();
-    reactor_->Stop();
+    Abort("Proxy tunnel not initialized");
     return;
   }
 
   switch (result) {
     case proxy::TunnelResult::kOk:
       // Tunnel established - proceed to TLS handshake
+      Trace(options_.trace, TraceEvent::kProxyTunnelEnd, this, -1, 1);
       socks_proxy_.reset();
       http_proxy_.reset();
-      tls_ =
-          std::make_unique<tls::TlsConnection>(tls_factory_, fd_, host_, port_);
-      state_ = ConnectionState::kTlsHandshake;
-      reactor_->Modify(this, EventType::kReadWrite);
-      HandleTlsHandshake();
+      StartTls();
       break;
 
     case proxy::TunnelResult::kWantRead:
@@ -461,10 +629,7 @@ void Connection::HandleProxyTunnel() {
       } else {
         error_msg = "Proxy tunnel failed";
       }
-      SetError(error_msg);
-      state_ = ConnectionState::kError;
-      Close();
-      reactor_->Stop();
+      Abort(error_msg);
       break;
     }
   }
@@ -477,6 +642,20 @@ void Connection::HandleTlsHandshake() {
     case tls::TlsResult::kOk: {
       // Handshake complete
       state_ = ConnectionState::kConnected;
+      tls_us_ = NowUs() - tls_start_us_;
+      tls_resumed_ = tls_->SessionResumed();
+      if (fast_open_attempted_) {
+        fast_open_accepted_ = util::TcpFastOpenAccepted(fd_);
+        if (fast_open_accepted_ && options_.stats) {
+          options_.stats->fast_open_accepted.Add();
+        }
+      }
+      rcv_window_start_us_ = uv_hrtime() / 1000;
+      Trace(options_.trace, TraceEvent::kTlsEnd, this, -1,
+            tls_resumed_ ? 2 : 1);
+      if (options_.stats) {
+        options_.stats->tls.Record(tls_us_);
+      }
 
       // Check ALPN protocol to determine HTTP version
       std::string_view protocol = tls_->AlpnProtocol();
@@ -484,6 +663,7 @@ void Connection::HandleTlsHandshake() {
       // Use HTTP/2 if negotiated, or if ALPN empty and not forcing HTTP/1.1
       bool use_http2 = (protocol == "h2") ||
                        (protocol.empty() && !tls_factory_->force_http1());
+      Trace(options_.trace, TraceEvent::kAlpn, this, -1, use_http2 ? 2 : 1);
       if (use_http2) {
         // HTTP/2 (default if no ALPN or h2 negotiated)
         auto chrome_version = tls_factory_->chrome_version();
@@ -494,17 +674,29 @@ void Connection::HandleTlsHandshake() {
           SetError("H2 error " + std::to_string(code) + ": " + msg);
         };
         session_callbacks.on_goaway = [this](int32_t last_sid, uint32_t code) {
+          Trace(options_.trace, TraceEvent::kH2Goaway, this, last_sid, code);
           if (code != 0) {
             SetError("GOAWAY received with error: " + std::to_string(code));
           }
+          // nghttp2 closes the streams above last_sid with REFUSED_STREAM;
+          // anything still queued here will not be sent either
+          goaway_last_stream_id_ = std::min(goaway_last_stream_id_, last_sid);
+          RefusePending();
         };
+        if (kTracingEnabled && options_.trace) {
+          session_callbacks.on_settings = [this](bool ack) {
+            Trace(options_.trace, TraceEvent::kH2Settings, this, -1,
+                  ack ? 1 : 0);
+          };
+          session_callbacks.on_rst_stream = [this](int32_t sid,
+                                                   uint32_t code) {
+            Trace(options_.trace, TraceEvent::kH2RstStream, this, sid, code);
+          };
+        }
 
         h2_ = std::make_unique<http2::H2Session>(h2_profile, session_callbacks);
         if (!h2_->Initialize()) {
-          SetError("Failed to initialize H2 session");
-          state_ = ConnectionState::kError;
-          Close();
-          reactor_->Stop();
+          Abort("Failed to initialize H2 session");
           return;
         }
       } else {
@@ -516,10 +708,7 @@ void Connection::HandleTlsHandshake() {
 
         h1_ = std::make_unique<http1::H1Session>(session_callbacks);
         if (!h1_->Initialize()) {
-          SetError("Failed to initialize H1 session");
-          state_ = ConnectionState::kError;
-          Close();
-          reactor_->Stop();
+          Abort("Failed to initialize H1 session");
           return;
         }
       }
@@ -527,12 +716,11 @@ void Connection::HandleTlsHandshake() {
       // Flush connection preface (for HTTP/2) or nothing (for HTTP/1.1)
       FlushSendBuffer();
 
-      // Submit pending requests
-      for (auto& req : pending_requests_) {
-        SendRequest(req.method, req.path, req.headers, req.header_order,
-                    req.on_response, req.on_error);
+      if (connected_callback) {
+        connected_callback(this);
       }
-      pending_requests_.clear();
+
+      SubmitPending();
       break;
     }
 
@@ -545,10 +733,7 @@ void Connection::HandleTlsHandshake() {
       break;
 
     case tls::TlsResult::kError:
-      SetError("TLS handshake failed: " + tls_->last_error());
-      state_ = ConnectionState::kError;
-      Close();
-      reactor_->Stop();
+      Abort("TLS handshake failed: " + tls_->last_error());
       break;
 
     default:
@@ -569,6 +754,12 @@ void Connection::HandleConnected() {
 
     if (n > 0) {
       ++reads;
+      if (options_.stats) {
+        options_.stats->bytes_received.Add(static_cast<uint64_t>(n));
+      }
+      if (options_.socket.buffer_mode == SocketBufferMode::kAdaptive) {
+        AdaptReceiveBuffer(static_cast<size_t>(n));
+      }
       // Feed data to HTTP session (h2 or h1)
       ssize_t consumed = -1;
       if (h2_) {
@@ -577,13 +768,16 @@ void Connection::HandleConnected() {
         consumed = h1_->Receive(buf, static_cast<size_t>(n));
       }
       if (consumed < 0) {
-        SetError(h2_ ? "H2 receive error" : "H1 receive error");
-        state_ = ConnectionState::kError;
-        Close();
-        reactor_->Stop();
+        Abort(h2_ ? "H2 receive error" : "H1 receive error");
         return;
       }
 
+      // A completed HTTP/1.1 response frees the connection for the next
+      // queued request (sent here, outside the session's callbacks)
+      if (h1_ && !pending_requests_.empty() && CanSubmitRequest()) {
+        SubmitPending();
+      }
+
       // Send any pending data
       FlushSendBuffer();
     } else if (result == tls::TlsResult::kWantRead) {
@@ -591,14 +785,10 @@ void Connection::HandleConnected() {
       break;
     } else if (result == tls::TlsResult::kEof) {
       // Connection closed
-      Close();
-      reactor_->Stop();
+      Abort();
       return;
     } else if (result == tls::TlsResult::kError) {
-      SetError("TLS read error: " + tls_->last_error());
-      state_ = ConnectionState::kError;
-      Close();
-      reactor_->Stop();
+      Abort("TLS read error: " + tls_->last_error());
       return;
     } else {
       break;
@@ -608,6 +798,92 @@ void Connection::HandleConnected() {
   // again on the next event loop iteration, allowing other connections to run.
 }
 
+void Connection::AdaptReceiveBuffer(size_t n) {
+  rcv_window_bytes_ += n;
+
+  // Re-evaluate once per half buffer of data
+  size_t max_size = options_.socket.max_buffer_size;
+  if (rcvbuf_size_ == 0 || rcvbuf_size_ >= max_size ||
+      rcv_window_bytes_ < rcvbuf_size_ / 2) {
+    return;
+  }
+
+  uint64_t now_us = uv_hrtime() / 1000;
+  uint64_t elapsed_us = now_us - rcv_window_start_us_;
+  uint32_t rtt_us = 0;
+  // Autotuning may have grown the buffer since it was last read. Setting
+  // SO_RCVBUF turns autotuning off, so leave the buffer to it until it
+  // reaches its ceiling, and only ever set a larger size after that.
+  size_t current = util::GetReceiveBufferSize(fd_);
+  if (current != 0) rcvbuf_size_ = current;
+  if (rcvbuf_size_ >= util::AutotuneReceiveBufferMax() && elapsed_us > 0 &&
+      util::GetTcpRtt(fd_, &rtt_us)) {
+    // Bytes in flight at the observed rate; keep twice that in the buffer
+    uint64_t bdp = rcv_window_bytes_ * rtt_us / elapsed_us;
+    size_t target = std::min(rcvbuf_size_ * 2, max_size);
+    if (bdp * 2 > rcvbuf_size_ && target > rcvbuf_size_) {
+      if (util::SetReceiveBufferSize(fd_, target)) {
+        size_t applied = util::GetReceiveBufferSize(fd_);
+        rcvbuf_size_ = applied != 0 ? applied : target;
+      }
+    }
+  }
+  rcv_window_bytes_ = 0;
+  rcv_window_start_us_ = now_us;
+}
+
+void Connection::SubmitPending() {
+  // Swap out first: a request that can't be submitted yet (HTTP/1.1 busy,
+  // or held over the memory cap) is re-queued into pending_requests_
+  std::vector<PendingRequest> pending;
+  pending.swap(pending_requests_);
+  for (auto& req : pending) {
+    if (CanSubmitRequest() && !PauseStreamsIfOverLimit()) {
+      SubmitRequest(req.request_id, std::move(req.headers),
+                    req.preserve_order, req.reused,
+                    std::move(req.on_response), std::move(req.on_error));
+    } else {
+      pending_requests_.push_back(std::move(req));
+    }
+  }
+}
+
+bool Connection::PauseStreamsIfOverLimit() {
+  if (streams_paused_) {
+    return true;
+  }
+  if (options_.memory == nullptr || !options_.memory->OverLimit()) {
+    return false;
+  }
+  // Reads go on: the streams already open finish and release what they
+  // hold. Only new streams wait.
+  streams_paused_ = true;
+  options_.memory->CountStreamPause();
+  if (resume_timer_ == nullptr) {
+    resume_timer_ = new uv_timer_t;
+    uv_timer_init(reactor_->loop(), resume_timer_);
+    resume_timer_->data = this;
+  }
+  uv_timer_start(resume_timer_, OnResumeTimer, kStreamResumePollMs,
+                 kStreamResumePollMs);
+  return true;
+}
+
+void Connection::OnResumeTimer(uv_timer_t* handle) {
+  auto* self = static_cast<Connection*>(handle->data);
+  if (self->options_.memory->BelowResumeMark()) {
+    self->ResumeStreams();
+  }
+}
+
+void Connection::ResumeStreams() {
+  streams_paused_ = false;
+  uv_timer_stop(resume_timer_);
+  if (state_ == ConnectionState::kConnected) {
+    SubmitPending();
+  }
+}
+
 void Connection::FlushSendBuffer() {
   if (!tls_ || (!h2_ && !h1_)) {
     return;
@@ -649,6 +925,9 @@ void Connection::FlushSendBuffer() {
     if (written > 0) {
       data_sent(written);
       ++writes;
+      if (options_.stats) {
+        options_.stats->bytes_sent.Add(written);
+      }
     }
 
     if (result == tls::TlsResult::kWantWrite) {
@@ -667,6 +946,23 @@ void Connection::FlushSendBuffer() {
 }
 
 void Connection::SetError(const std::string& msg) {
+  // Count failures while establishing, not errors on a ready connection
+  bool establishing = state_ == ConnectionState::kConnecting ||
+                      state_ == ConnectionState::kProxyTunnel ||
+                      state_ == ConnectionState::kTlsHandshake;
+  if (establishing) {
+    // Close the trace span of the phase that failed
+    TraceEvent phase_end = state_ == ConnectionState::kConnecting
+                               ? TraceEvent::kConnectEnd
+                           : state_ == ConnectionState::kProxyTunnel
+                               ? TraceEvent::kProxyTunnelEnd
+                               : TraceEvent::kTlsEnd;
+    Trace(options_.trace, phase_end, this, -1, 0);
+    if (options_.stats) {
+      options_.stats->connections_failed.Add();
+    }
+  }
+
   last_error_ = msg;
   state_ = ConnectionState::kError;
 }
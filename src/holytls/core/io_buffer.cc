@@ -23,7 +23,8 @@ IoBuffer::~IoBuffer() = default;
 IoBuffer::IoBuffer(IoBuffer&& other) noexcept
     : chunks_(std::move(other.chunks_)),
       size_(other.size_),
-      capacity_(other.capacity_) {
+      capacity_(other.capacity_),
+      charge_(std::move(other.charge_)) {
   other.size_ = 0;
   other.capacity_ = 0;
 }
@@ -33,6 +34,7 @@ IoBuffer& IoBuffer::operator=(IoBuffer&& other) noexcept {
     chunks_ = std::move(other.chunks_);
     size_ = other.size_;
     capacity_ = other.capacity_;
+    charge_ = std::move(other.charge_);
     other.size_ = 0;
     other.capacity_ = 0;
   }
@@ -90,6 +92,7 @@ uint8_t* IoBuffer::Reserve(size_t len) {
     new_chunk.start = 0;
     new_chunk.end = 0;
     capacity_ += new_chunk.capacity;
+    charge_.Set(capacity_);
     chunks_.push_back(std::move(new_chunk));
     return chunks_.back().data.get();
   }
@@ -133,6 +136,7 @@ size_t IoBuffer::Read(uint8_t* dest, size_t max_len) {
   }
 
   size_ -= total_read;
+  charge_.Set(capacity_);
   return total_read;
 }
 
@@ -171,6 +175,7 @@ void IoBuffer::Skip(size_t len) {
       chunks_.pop_front();
     }
   }
+  charge_.Set(capacity_);
 }
 
 std::vector<iovec_t> IoBuffer::GetReadableIovec() const {
@@ -232,6 +237,7 @@ void IoBuffer::Clear() {
   chunks_.clear();
   size_ = 0;
   capacity_ = 0;
+  charge_.Set(0);
 }
 
 void IoBuffer::ShrinkToFit() {
@@ -239,7 +245,9 @@ void IoBuffer::ShrinkToFit() {
 
   // If we have more than 2 chunks worth of excess capacity, consolidate
   if (capacity_ > size_ + 2 * kDefaultChunkSize) {
-    IoBuffer new_buffer(size_);
+    IoBuffer new_buffer;
+    new_buffer.SetMemoryTag(charge_.tag());
+    new_buffer.EnsureCapacity(size_);
     for (const auto& chunk : chunks_) {
       if (chunk.ReadableSize() > 0) {
         new_buffer.Append(chunk.data.get() + chunk.start, chunk.ReadableSize());
@@ -322,6 +330,7 @@ void IoBuffer::EnsureCapacity(size_t additional) {
   new_chunk.end = 0;
 
   capacity_ += chunk_size;
+  charge_.Set(capacity_);
   chunks_.push_back(std::move(new_chunk));
 }
 
@@ -333,6 +342,7 @@ IoBuffer::Chunk& IoBuffer::GetWriteChunk() {
     new_chunk.start = 0;
     new_chunk.end = 0;
     capacity_ += kDefaultChunkSize;
+    charge_.Set(capacity_);
     chunks_.push_back(std::move(new_chunk));
   }
   return chunks_.back();
@@ -343,6 +353,7 @@ void IoBuffer::RemoveEmptyChunks() {
     capacity_ -= chunks_.front().capacity;
     chunks_.pop_front();
   }
+  charge_.Set(capacity_);
 }
 
 }  // namespace core
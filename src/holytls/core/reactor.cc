@@ -3,6 +3,7 @@
 
 #include "holytls/core/reactor.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <utility>
@@ -10,11 +11,16 @@
 #include "holytls/core/connection.h"
 #include "holytls/memory/slab_allocator.h"
 
+#if defined(HOLYTLS_IO_URING)
+#include "holytls/core/uring.h"
+#endif
+
 namespace holytls {
 namespace core {
 
 namespace {
-// Slab allocator for PollData - avoids per-fd heap allocations
+// Slab allocator for PollData - avoids per-fd heap allocations. Shared by
+// every reactor; each thread works from its own cache of free slots.
 memory::SlabAllocator<PollData, 256> g_poll_data_allocator;
 }  // namespace
 
@@ -72,6 +78,18 @@ bool Reactor::Initialize(const ReactorConfig& config) {
     return false;
   }
 
+#if defined(HOLYTLS_IO_URING)
+  // Sockets go through io_uring; the loop keeps timers, DNS and posts
+  if (config_.backend == ReactorBackend::kIoUring) {
+    uring_ = std::make_unique<UringBackend>(loop_, DispatchEvent);
+    if (!uring_->Initialize()) {
+      last_error_ = "io_uring unavailable, using libuv: " +
+                    std::string(uring_->last_error());
+      uring_.reset();
+    }
+  }
+#endif
+
   // Initialize time
   UpdateTime();
   return true;
@@ -104,10 +122,20 @@ Reactor::~Reactor() {
     uv_close(reinterpret_cast<uv_handle_t*>(async_), nullptr);
   }
 
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    uring_->Close();
+  }
+#endif
+
   // Run the loop one more time to process close callbacks (including PollData
   // deallocation)
   uv_run(loop_, UV_RUN_DEFAULT);
 
+#if defined(HOLYTLS_IO_URING)
+  uring_.reset();
+#endif
+
   // Close and free the loop
   uv_loop_close(loop_);
   delete loop_;
@@ -118,6 +146,11 @@ Reactor::~Reactor() {
 }
 
 bool Reactor::Add(EventHandler* handler, EventType events) {
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    return uring_->Add(handler, events);
+  }
+#endif
   if (handler == nullptr || handler->fd < 0) {
     return false;
   }
@@ -160,6 +193,11 @@ bool Reactor::Add(EventHandler* handler, EventType events) {
 }
 
 bool Reactor::Modify(EventHandler* handler, EventType events) {
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    return uring_->Modify(handler, events);
+  }
+#endif
   if (handler == nullptr || handler->fd < 0) {
     return false;
   }
@@ -181,6 +219,11 @@ bool Reactor::Modify(EventHandler* handler, EventType events) {
 }
 
 bool Reactor::Remove(EventHandler* handler) {
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    return uring_->Remove(handler);
+  }
+#endif
   if (handler == nullptr || handler->fd < 0) {
     return false;
   }
@@ -200,7 +243,41 @@ bool Reactor::Remove(EventHandler* handler) {
   return true;
 }
 
-bool Reactor::Contains(int fd) const { return fd_table_.Contains(fd); }
+bool Reactor::Contains(int fd) const {
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    return uring_->Contains(fd);
+  }
+#endif
+  return fd_table_.Contains(fd);
+}
+
+size_t Reactor::handler_count() const {
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    return uring_->handler_count();
+  }
+#endif
+  return fd_table_.Count();
+}
+
+bio_st* Reactor::AttachStream([[maybe_unused]] EventHandler* handler) {
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    return uring_->AttachStream(handler);
+  }
+#endif
+  return nullptr;
+}
+
+ReactorBackend Reactor::backend() const {
+#if defined(HOLYTLS_IO_URING)
+  if (uring_) {
+    return ReactorBackend::kIoUring;
+  }
+#endif
+  return ReactorBackend::kLibuv;
+}
 
 void Reactor::Run() {
   running_.store(true, std::memory_order_release);
@@ -263,10 +340,15 @@ void Reactor::Stop() {
   uv_async_send(async_);
 }
 
-void Reactor::Post(std::function<void()> callback) {
+void Reactor::Post(std::function<void()> callback, uint8_t urgency) {
   {
     std::lock_guard<std::mutex> lock(posted_mutex_);
-    posted_callbacks_.push_back(std::move(callback));
+    if (posted_callbacks_.empty()) {
+      first_post_ns_ = uv_hrtime();
+    }
+    posted_reorder_ |= urgency != Priority::kDefaultUrgency;
+    posted_callbacks_.push_back({std::move(callback), urgency});
+    posted_depth_.store(posted_callbacks_.size(), std::memory_order_relaxed);
   }
   has_posted_.store(true, std::memory_order_release);
   // Wake up the loop to process the callback
@@ -284,15 +366,33 @@ void Reactor::ProcessPostedCallbacks() {
   }
 
   // Swap under lock, then process without holding lock
+  uint64_t first_post_ns;
+  bool reorder;
   {
     std::lock_guard<std::mutex> lock(posted_mutex_);
     pending_callbacks_.swap(posted_callbacks_);
     posted_callbacks_.clear();
+    reorder = posted_reorder_;
+    posted_reorder_ = false;
     has_posted_.store(false, std::memory_order_release);
+    posted_depth_.store(0, std::memory_order_relaxed);
+    first_post_ns = first_post_ns_;
   }
 
-  for (auto& callback : pending_callbacks_) {
-    callback();
+  // Loop lag: EWMA (1/8) of how long the oldest post waited
+  if (!pending_callbacks_.empty()) {
+    uint64_t sample_us = (uv_hrtime() - first_post_ns) / 1000;
+    uint64_t lag_us = loop_lag_us_.load(std::memory_order_relaxed);
+    loop_lag_us_.store(lag_us - lag_us / 8 + sample_us / 8,
+                       std::memory_order_relaxed);
+  }
+
+  // Only batches holding prioritized posts pay for the sort
+  if (reorder) {
+    std::ranges::stable_sort(pending_callbacks_, {}, &PostedCallback::urgency);
+  }
+  for (auto& posted : pending_callbacks_) {
+    posted.callback();
   }
   pending_callbacks_.clear();
 }
@@ -302,9 +402,10 @@ void Reactor::OnPollEvent(uv_poll_t* handle, int status, int events) {
   if (!poll_data || !poll_data->handler) {
     return;
   }
+  DispatchEvent(poll_data->handler, status, events);
+}
 
-  EventHandler* handler = poll_data->handler;
-
+void Reactor::DispatchEvent(EventHandler* handler, int status, int events) {
   switch (handler->type) {
     case EventHandlerType::kConnection: {
       auto* conn = static_cast<Connection*>(handler);
@@ -4,6 +4,7 @@
 #include "holytls/core/reactor_manager.h"
 
 #include <algorithm>
+#include <cmath>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -31,6 +32,14 @@ uint64_t HashHostPort(std::string_view host, uint16_t port) {
   return hash;
 }
 
+// SplitMix64 finalizer (ring virtual node positions)
+uint64_t Mix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
 // Get number of CPU cores
 size_t GetCpuCount() {
   unsigned int count = std::thread::hardware_concurrency();
@@ -66,8 +75,13 @@ ReactorManager::ReactorManager(const ReactorManagerConfig& config)
   for (size_t i = 0; i < num_reactors; ++i) {
     auto ctx = std::make_unique<ReactorContext>();
     ctx->index = i;
+    ctx->memory.reset(new memory::MemoryAccount);
+    ctx->memory->set_limit(config_.memory_limit_per_reactor);
+    memory::ScopedMemoryAccount account(ctx->memory.get());
     ctx->reactor = std::make_unique<Reactor>();
-    if (!ctx->reactor->Initialize()) {
+    ReactorConfig reactor_config;
+    reactor_config.backend = config_.backend;
+    if (!ctx->reactor->Initialize(reactor_config)) {
       // Initialization failed - subsequent code will check IsInitialized()
       // In practice, libuv initialization rarely fails
     }
@@ -78,10 +92,28 @@ ReactorManager::ReactorManager(const ReactorManagerConfig& config)
     bp_config.medium_count = config_.buffer_pool_medium_count;
     bp_config.large_count = config_.buffer_pool_large_count;
     ctx->buffer_pool = std::make_unique<memory::BufferPool>(bp_config);
+    ctx->stats = std::make_unique<ReactorStats>();
+    if (config_.trace_ring_capacity > 0) {
+      ctx->trace_ring =
+          std::make_unique<TraceRing>(config_.trace_ring_capacity);
+      ctx->trace = ctx->trace_ring.get();
+    } else {
+      ctx->trace = config_.trace_sink;
+    }
 
     // DNS resolver will be created after reactor starts (needs loop)
     contexts_.push_back(std::move(ctx));
   }
+
+  // Hash ring for bounded-load placement
+  ring_.reserve(num_reactors * kVirtualNodes);
+  for (size_t i = 0; i < num_reactors; ++i) {
+    for (size_t v = 0; v < kVirtualNodes; ++v) {
+      ring_.emplace_back(Mix64((static_cast<uint64_t>(i) << 32) | v),
+                         static_cast<uint16_t>(i));
+    }
+  }
+  std::sort(ring_.begin(), ring_.end());
 }
 
 ReactorManager::~ReactorManager() { Stop(); }
@@ -97,11 +129,18 @@ void ReactorManager::Initialize(tls::TlsContextFactory* tls_factory,
 
   // Create per-reactor connection pools and DNS resolvers
   for (auto& ctx : contexts_) {
+    memory::ScopedMemoryAccount account(ctx->memory.get());
     ctx->dns_resolver =
         std::make_unique<util::DnsResolver>(ctx->reactor->loop());
 
+    pool::ConnectionPoolConfig reactor_pool_config = pool_config_;
+    reactor_pool_config.stats = ctx->stats.get();
+    reactor_pool_config.trace = ctx->trace;
+    if (config_.memory_pause_new_streams) {
+      reactor_pool_config.memory = ctx->memory.get();
+    }
     ctx->connection_pool = std::make_unique<pool::ConnectionPool>(
-        pool_config_, ctx->reactor.get(), tls_factory_);
+        reactor_pool_config, ctx->reactor.get(), tls_factory_);
   }
 
   initialized_ = true;
@@ -152,8 +191,33 @@ void ReactorManager::Stop() {
 
 ReactorContext* ReactorManager::GetReactorForHost(std::string_view host,
                                                   uint16_t port) {
-  size_t index = GetReactorIndex(host, port);
-  return contexts_[index].get();
+  if (config_.placement == ReactorPlacement::kHash || contexts_.size() == 1) {
+    return contexts_[GetReactorIndex(host, port)].get();
+  }
+  return contexts_[PlaceBoundedLoad(host, port, false)].get();
+}
+
+ReactorContext* ReactorManager::AcquireReactorForHost(std::string_view host,
+                                                      uint16_t port) {
+  if (config_.placement == ReactorPlacement::kHash || contexts_.size() == 1) {
+    ReactorContext* ctx = contexts_[GetReactorIndex(host, port)].get();
+    ctx->in_flight.fetch_add(1, std::memory_order_relaxed);
+    return ctx;
+  }
+  // Counted under the placement lock so concurrent submitters see it
+  return contexts_[PlaceBoundedLoad(host, port, true)].get();
+}
+
+void ReactorManager::ReleaseReactor(ReactorContext* ctx) {
+  if (ctx) {
+    ctx->in_flight.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+size_t ReactorManager::ReactorLoad(size_t index) const {
+  const auto& ctx = contexts_[index];
+  return ctx->in_flight.load(std::memory_order_relaxed) +
+         ctx->reactor->posted_depth();
 }
 
 ReactorContext* ReactorManager::GetReactor(size_t index) {
@@ -170,14 +234,14 @@ ReactorContext* ReactorManager::GetNextReactor() {
 }
 
 void ReactorManager::Post(size_t reactor_index,
-                          std::function<void()> callback) {
+                          std::function<void()> callback, uint8_t urgency) {
   if (reactor_index >= contexts_.size()) {
     return;
   }
 
   auto& ctx = contexts_[reactor_index];
   if (ctx && ctx->reactor) {
-    ctx->reactor->Post(std::move(callback));
+    ctx->reactor->Post(std::move(callback), urgency);
   }
 }
 
@@ -200,12 +264,56 @@ size_t ReactorManager::TotalConnections() const {
   return total;
 }
 
+size_t ReactorManager::TotalInFlight() const {
+  size_t total = 0;
+  for (const auto& ctx : contexts_) {
+    total += ctx->in_flight.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+StatsSnapshot ReactorManager::SnapshotStats() const {
+  StatsSnapshot snapshot;
+  for (const auto& ctx : contexts_) {
+    snapshot.Merge(*ctx->stats);
+  }
+  return snapshot;
+}
+
+std::vector<TraceRecord> ReactorManager::CollectTrace() const {
+  std::vector<TraceRecord> records;
+  for (const auto& ctx : contexts_) {
+    if (ctx->trace_ring) {
+      auto ring = ctx->trace_ring->Snapshot();
+      records.insert(records.end(), ring.begin(), ring.end());
+    }
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const TraceRecord& a, const TraceRecord& b) {
+                     return a.time_us < b.time_us;
+                   });
+  return records;
+}
+
+std::vector<const memory::MemoryAccount*> ReactorManager::MemoryAccounts()
+    const {
+  std::vector<const memory::MemoryAccount*> accounts;
+  accounts.reserve(contexts_.size());
+  for (const auto& ctx : contexts_) {
+    accounts.push_back(ctx->memory.get());
+  }
+  return accounts;
+}
+
 void ReactorManager::RunReactor(ReactorContext* ctx) {
   // Pin to CPU core if configured
   if (config_.pin_to_cores) {
     PinThreadToCore(ctx->index % GetCpuCount());
   }
 
+  SetTraceReactor(static_cast<uint32_t>(ctx->index));
+  memory::SetMemoryAccount(ctx->memory.get());
+
   // Use Run() which properly blocks on UV_RUN_ONCE waiting for IO
   // This prevents CPU spinning when idle. The reactor's Stop() method
   // will signal it to exit when ReactorManager::Stop() is called.
@@ -218,5 +326,104 @@ size_t ReactorManager::GetReactorIndex(std::string_view host,
   return hash % contexts_.size();
 }
 
+size_t ReactorManager::PlaceBoundedLoad(std::string_view host, uint16_t port,
+                                        bool acquire) {
+  uint64_t hash = HashHostPort(host, port);
+
+  std::lock_guard<std::mutex> lock(placement_mutex_);
+  size_t bound = LoadBound();
+  size_t index;
+
+  auto it = origins_.find(hash);
+  if (it == origins_.end()) {
+    // New origin: first reactor on the ring within the bound
+    if (origins_.size() >= kMaxTrackedOrigins) {
+      // Forget unsplit origins; they re-place (usually identically)
+      std::erase_if(origins_, [](const auto& entry) {
+        return entry.second.reactors.size() == 1;
+      });
+    }
+    index = FindOnRing(hash, {}, bound);
+    if (index == SIZE_MAX) {
+      index = LeastLoaded();
+    }
+    origins_[hash].reactors.push_back(static_cast<uint16_t>(index));
+  } else {
+    // Known origin: least loaded of the reactors it already owns
+    auto& reactors = it->second.reactors;
+    index = reactors[0];
+    for (uint16_t r : reactors) {
+      if (ReactorLoad(r) < ReactorLoad(index)) index = r;
+    }
+
+    // Hot origin: every owned reactor is over the bound, spill onto the
+    // next eligible reactor on the ring
+    size_t max_reactors = config_.max_reactors_per_origin == 0
+                              ? contexts_.size()
+                              : std::min(config_.max_reactors_per_origin,
+                                         contexts_.size());
+    if (IsOverBound(index, bound) && reactors.size() < max_reactors) {
+      size_t spill = FindOnRing(hash, reactors, bound);
+      if (spill != SIZE_MAX) {
+        reactors.push_back(static_cast<uint16_t>(spill));
+        index = spill;
+      }
+    }
+  }
+
+  if (acquire) {
+    contexts_[index]->in_flight.fetch_add(1, std::memory_order_relaxed);
+  }
+  return index;
+}
+
+size_t ReactorManager::FindOnRing(uint64_t hash,
+                                  const std::vector<uint16_t>& exclude,
+                                  size_t bound) const {
+  auto start = std::lower_bound(ring_.begin(), ring_.end(),
+                                std::make_pair(hash, uint16_t{0}));
+  size_t offset = static_cast<size_t>(start - ring_.begin());
+
+  for (size_t i = 0; i < ring_.size(); ++i) {
+    uint16_t reactor = ring_[(offset + i) % ring_.size()].second;
+    if (std::find(exclude.begin(), exclude.end(), reactor) != exclude.end()) {
+      continue;
+    }
+    if (!IsOverBound(reactor, bound)) {
+      return reactor;
+    }
+  }
+  return SIZE_MAX;
+}
+
+size_t ReactorManager::LeastLoaded() const {
+  size_t best = 0;
+  for (size_t i = 1; i < contexts_.size(); ++i) {
+    if (ReactorLoad(i) < ReactorLoad(best)) best = i;
+  }
+  return best;
+}
+
+bool ReactorManager::IsOverBound(size_t index, size_t bound) const {
+  size_t load = ReactorLoad(index);
+  if (load >= bound) {
+    return true;
+  }
+  // A lagging loop is full whatever its counts say (an idle one never is)
+  return load > 0 &&
+         contexts_[index]->reactor->loop_lag_us() > config_.max_loop_lag_us;
+}
+
+size_t ReactorManager::LoadBound() const {
+  // ceil(c * (total + 1) / n): room for the request being placed
+  size_t total = 0;
+  for (size_t i = 0; i < contexts_.size(); ++i) {
+    total += ReactorLoad(i);
+  }
+  double bound = config_.load_factor * static_cast<double>(total + 1) /
+                 static_cast<double>(contexts_.size());
+  return static_cast<size_t>(std::ceil(bound));
+}
+
 }  // namespace core
 }  // namespace holytls
@@ -0,0 +1,97 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/core/stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace holytls {
+namespace core {
+
+void HistogramSnapshot::Merge(const LatencyHistogram& histogram) {
+  // Buckets are summed rather than trusting count_: the writer may be
+  // mid-update, and the buckets are what percentiles are computed from
+  uint64_t merged = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    uint64_t n = histogram.counts_[i].Get();
+    counts_[i] += n;
+    merged += n;
+  }
+  count_ += merged;
+  sum_ += histogram.sum_.Get();
+  max_ = std::max(max_, histogram.max_.Get());
+}
+
+uint64_t HistogramSnapshot::Percentile(double p) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  p = std::clamp(p, 0.0, 100.0);
+
+  // Rank of the requested sample (1-based)
+  uint64_t rank = static_cast<uint64_t>(
+      std::ceil(p / 100.0 * static_cast<double>(count_)));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return std::min(LatencyHistogram::BucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
+void StatsSnapshot::Merge(const ReactorStats& stats) {
+  connections_created += stats.connections_created.Get();
+  connections_reused += stats.connections_reused.Get();
+  connections_failed += stats.connections_failed.Get();
+  fast_open_attempts += stats.fast_open_attempts.Get();
+  fast_open_accepted += stats.fast_open_accepted.Get();
+  requests_sent += stats.requests_sent.Get();
+  requests_completed += stats.requests_completed.Get();
+  requests_failed += stats.requests_failed.Get();
+  requests_timeout += stats.requests_timeout.Get();
+  requests_coalesced += stats.requests_coalesced.Get();
+  requests_hedged += stats.requests_hedged.Get();
+  hedges_won += stats.hedges_won.Get();
+  requests_replayed += stats.requests_replayed.Get();
+  bytes_sent += stats.bytes_sent.Get();
+  bytes_received += stats.bytes_received.Get();
+
+  dns.Merge(stats.dns);
+  connect.Merge(stats.connect);
+  tls.Merge(stats.tls);
+  ttfb.Merge(stats.ttfb);
+  total.Merge(stats.total);
+
+  std::lock_guard<std::mutex> lock(stats.origins_mutex);
+  for (const auto* origin : stats.origins) {
+    OriginLimitSnapshot entry;
+    entry.host = origin->host;
+    entry.port = origin->port;
+    entry.limit = origin->limit.Get();
+    entry.in_flight = origin->in_flight.Get();
+    entry.queued = origin->queued.Get();
+    entry.rtt_us = origin->rtt_us.Get();
+    entry.baseline_rtt_us = origin->baseline_rtt_us.Get();
+    entry.drops = origin->drops.Get();
+    origins.push_back(std::move(entry));
+  }
+}
+
+void ReactorStats::RegisterOrigin(const OriginLimitStats* origin) {
+  std::lock_guard<std::mutex> lock(origins_mutex);
+  origins.push_back(origin);
+}
+
+void ReactorStats::UnregisterOrigin(const OriginLimitStats* origin) {
+  std::lock_guard<std::mutex> lock(origins_mutex);
+  std::erase(origins, origin);
+}
+
+}  // namespace core
+}  // namespace holytls
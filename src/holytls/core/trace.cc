@@ -0,0 +1,247 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/core/trace.h"
+
+#include <uv.h>
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+namespace holytls {
+namespace core {
+
+namespace {
+
+constexpr char kTraceMagic[8] = {'H', 'T', 'L', 'S', 'T', 'R', 'C', '1'};
+
+thread_local uint32_t t_trace_reactor = 0;
+
+// Span a start/end event belongs to, or empty for instant events
+struct SpanInfo {
+  std::string_view name;
+  bool begin = false;
+};
+
+SpanInfo GetSpan(TraceEvent event) {
+  switch (event) {
+    case TraceEvent::kDnsStart:
+      return {"dns", true};
+    case TraceEvent::kDnsEnd:
+      return {"dns", false};
+    case TraceEvent::kConnectStart:
+      return {"connect", true};
+    case TraceEvent::kConnectEnd:
+      return {"connect", false};
+    case TraceEvent::kProxyTunnelStart:
+      return {"proxy_tunnel", true};
+    case TraceEvent::kProxyTunnelEnd:
+      return {"proxy_tunnel", false};
+    case TraceEvent::kTlsStart:
+      return {"tls", true};
+    case TraceEvent::kTlsEnd:
+      return {"tls", false};
+    case TraceEvent::kStreamOpen:
+      return {"stream", true};
+    case TraceEvent::kStreamEnd:
+      return {"stream", false};
+    default:
+      return {};
+  }
+}
+
+void AppendHex(std::string* out, uint64_t value) {
+  char buf[16];
+  auto result = std::to_chars(buf, buf + sizeof(buf), value, 16);
+  out->append(buf, result.ptr);
+}
+
+template <typename T>
+void AppendNumber(std::string* out, T value) {
+  char buf[24];
+  auto result = std::to_chars(buf, buf + sizeof(buf), value);
+  out->append(buf, result.ptr);
+}
+
+// Fields shared by every event: name, category, phase, timestamp, track
+void AppendHeader(std::string* out, std::string_view name, char phase,
+                  const TraceRecord& r) {
+  *out += "{\"name\":\"";
+  *out += name;
+  *out += "\",\"cat\":\"holytls\",\"ph\":\"";
+  *out += phase;
+  *out += "\",\"ts\":";
+  AppendNumber(out, r.time_us);
+  *out += ",\"pid\":1,\"tid\":";
+  AppendNumber(out, r.reactor);
+}
+
+}  // namespace
+
+std::string_view TraceEventName(TraceEvent event) {
+  switch (event) {
+    case TraceEvent::kDnsStart:
+      return "dns_start";
+    case TraceEvent::kDnsEnd:
+      return "dns_end";
+    case TraceEvent::kConnectStart:
+      return "connect_start";
+    case TraceEvent::kConnectEnd:
+      return "connect_end";
+    case TraceEvent::kProxyTunnelStart:
+      return "proxy_tunnel_start";
+    case TraceEvent::kProxyTunnelEnd:
+      return "proxy_tunnel_end";
+    case TraceEvent::kTlsStart:
+      return "tls_start";
+    case TraceEvent::kTlsEnd:
+      return "tls_end";
+    case TraceEvent::kAlpn:
+      return "alpn";
+    case TraceEvent::kH2Settings:
+      return "h2_settings";
+    case TraceEvent::kH2Goaway:
+      return "h2_goaway";
+    case TraceEvent::kH2RstStream:
+      return "h2_rst_stream";
+    case TraceEvent::kStreamOpen:
+      return "stream_open";
+    case TraceEvent::kStreamFirstByte:
+      return "stream_first_byte";
+    case TraceEvent::kStreamEnd:
+      return "stream_end";
+    case TraceEvent::kPoolAcquire:
+      return "pool_acquire";
+    case TraceEvent::kPoolRelease:
+      return "pool_release";
+  }
+  return "unknown";
+}
+
+// TraceRing
+
+TraceRing::TraceRing(size_t capacity)
+    : records_(capacity == 0 ? 1 : capacity) {}
+
+void TraceRing::Record(const TraceRecord& record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  records_[written_ % records_.size()] = record;
+  ++written_;
+}
+
+std::vector<TraceRecord> TraceRing::Snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<TraceRecord> out;
+  size_t count = written_ < records_.size() ? static_cast<size_t>(written_)
+                                            : records_.size();
+  out.reserve(count);
+  for (uint64_t i = written_ - count; i < written_; ++i) {
+    out.push_back(records_[i % records_.size()]);
+  }
+  return out;
+}
+
+// Emission
+
+namespace detail {
+
+void EmitTrace(TraceSink* sink, TraceEvent event, uint64_t id, int64_t stream,
+               uint64_t arg) {
+  TraceRecord record;
+  record.time_us = uv_hrtime() / 1000;
+  record.id = id;
+  record.stream = stream;
+  record.arg = arg;
+  record.reactor = t_trace_reactor;
+  record.event = event;
+  sink->Record(record);
+}
+
+}  // namespace detail
+
+void SetTraceReactor(uint32_t reactor) { t_trace_reactor = reactor; }
+
+// Files
+
+bool WriteTraceFile(const std::string& path,
+                    std::span<const TraceRecord> records) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool ok = std::fwrite(kTraceMagic, sizeof(kTraceMagic), 1, file) == 1;
+  if (ok && !records.empty()) {
+    ok = std::fwrite(records.data(), sizeof(TraceRecord), records.size(),
+                     file) == records.size();
+  }
+  return std::fclose(file) == 0 && ok;
+}
+
+bool ReadTraceFile(const std::string& path, std::vector<TraceRecord>* out) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  char magic[sizeof(kTraceMagic)];
+  if (std::fread(magic, sizeof(magic), 1, file) != 1 ||
+      std::memcmp(magic, kTraceMagic, sizeof(magic)) != 0) {
+    std::fclose(file);
+    return false;
+  }
+
+  out->clear();
+  TraceRecord record;
+  while (std::fread(&record, sizeof(record), 1, file) == 1) {
+    out->push_back(record);
+  }
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  return ok;
+}
+
+// Chrome trace-event JSON
+
+std::string TraceToChromeJson(std::span<const TraceRecord> records) {
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  out.reserve(out.size() + records.size() * 128);
+
+  bool first = true;
+  for (const TraceRecord& r : records) {
+    if (!first) {
+      out += ',';
+    }
+    first = false;
+
+    SpanInfo span = GetSpan(r.event);
+    if (!span.name.empty()) {
+      // Async span; streams get their own id so they nest per connection
+      AppendHeader(&out, span.name, span.begin ? 'b' : 'e', r);
+      out += ",\"id\":\"";
+      AppendHex(&out, r.id);
+      if (r.stream >= 0) {
+        out += ':';
+        AppendNumber(&out, r.stream);
+      }
+      out += "\",\"args\":{\"arg\":";
+      AppendNumber(&out, r.arg);
+      out += "}}";
+    } else {
+      AppendHeader(&out, TraceEventName(r.event), 'i', r);
+      out += ",\"s\":\"t\",\"args\":{\"conn\":\"";
+      AppendHex(&out, r.id);
+      out += "\",\"stream\":";
+      AppendNumber(&out, r.stream);
+      out += ",\"arg\":";
+      AppendNumber(&out, r.arg);
+      out += "}}";
+    }
+  }
+
+  out += "]}";
+  return out;
+}
+
+}  // namespace core
+}  // namespace holytls
@@ -0,0 +1,1058 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/core/uring.h"
+
+#include <linux/io_uring.h>
+#include <openssl/bio.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+namespace holytls {
+namespace core {
+
+namespace {
+
+// user_data: stream pointer | operation tag (streams are slab slots,
+// cache-line aligned)
+constexpr uint64_t kTagMask = 7;
+constexpr uint64_t kTagNone = 0;   // Cancellations
+constexpr uint64_t kTagPoll = 1;
+constexpr uint64_t kTagRecv = 2;
+constexpr uint64_t kTagSend = 3;
+constexpr uint64_t kTagDrain = 4;  // Cancel-all at teardown
+constexpr uint64_t kTagProbe = 5;  // Buffer selection self-test
+
+// Buffer groups: the registered ring, or IORING_OP_PROVIDE_BUFFERS
+constexpr uint16_t kRingBufferGroup = 0;
+constexpr uint16_t kLegacyBufferGroup = 1;
+constexpr int kMaxDrainRounds = 64;
+
+uint64_t UserData(UringStream* stream, uint64_t tag) {
+  return reinterpret_cast<uintptr_t>(stream) | tag;
+}
+
+// No liburing: the three syscalls are all it wraps that we need
+int SysSetup(uint32_t entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int SysEnter(int ring_fd, uint32_t to_submit, uint32_t min_complete,
+             uint32_t flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int SysRegister(int ring_fd, uint32_t opcode, void* arg, uint32_t nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+void* MapRing(size_t size, int fd, uint64_t offset) {
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, static_cast<off_t>(offset));
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+void* MapAnonymous(size_t size) {
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+template <typename T>
+T* RingField(void* base, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+
+uint32_t LoadAcquire(uint32_t* ptr) {
+  return std::atomic_ref<uint32_t>(*ptr).load(std::memory_order_acquire);
+}
+
+void StoreRelease(uint32_t* ptr, uint32_t value) {
+  std::atomic_ref<uint32_t>(*ptr).store(value, std::memory_order_release);
+}
+
+uint32_t PollMask(EventType events) {
+  uint32_t mask = 0;
+  if (HasEvent(events, EventType::kRead)) mask |= POLLIN;
+  if (HasEvent(events, EventType::kWrite)) mask |= POLLOUT;
+  if (HasEvent(events, EventType::kDisconnect)) mask |= POLLRDHUP;
+  if (HasEvent(events, EventType::kPrioritized)) mask |= POLLPRI;
+  return mask;
+}
+
+// As libuv: a hang-up wakes every direction being watched
+int UvEvents(uint32_t revents, EventType interest) {
+  int events = 0;
+  if ((revents & (POLLIN | POLLHUP)) != 0) events |= UV_READABLE;
+  if ((revents & (POLLOUT | POLLHUP)) != 0) events |= UV_WRITABLE;
+  if ((revents & POLLRDHUP) != 0) events |= UV_DISCONNECT;
+  if ((revents & POLLPRI) != 0) events |= UV_PRIORITIZED;
+  return events & static_cast<int>(interest);
+}
+
+void PrepareFd(io_uring_sqe* sqe, int fd, int slot) {
+  if (slot >= 0) {
+    sqe->fd = slot;
+    sqe->flags |= IOSQE_FIXED_FILE;
+  } else {
+    sqe->fd = fd;
+  }
+}
+
+}  // namespace
+
+// Memory BIO over a UringStream. The stream may be freed first; it then
+// clears the BIO's data and reads see EOF, writes an error.
+struct UringBio {
+  static int Write(BIO* bio, const char* data, int len) {
+    BIO_clear_retry_flags(bio);
+    auto* stream = static_cast<UringStream*>(BIO_get_data(bio));
+    if (stream == nullptr) {
+      errno = EPIPE;
+      return -1;
+    }
+    if (len <= 0) {
+      return 0;
+    }
+    size_t n = stream->Write(reinterpret_cast<const uint8_t*>(data),
+                             static_cast<size_t>(len));
+    if (n == 0) {
+      BIO_set_retry_write(bio);
+      return -1;
+    }
+    return static_cast<int>(n);
+  }
+
+  static int Read(BIO* bio, char* out, int len) {
+    BIO_clear_retry_flags(bio);
+    auto* stream = static_cast<UringStream*>(BIO_get_data(bio));
+    if (stream == nullptr || len <= 0) {
+      return 0;
+    }
+    size_t n = stream->Read(reinterpret_cast<uint8_t*>(out),
+                            static_cast<size_t>(len));
+    if (n > 0) {
+      return static_cast<int>(n);
+    }
+    if (stream->eof()) {
+      return 0;
+    }
+    if (stream->error_ != 0) {
+      errno = stream->error_;
+      return -1;
+    }
+    BIO_set_retry_read(bio);
+    return -1;
+  }
+
+  static long Ctrl(BIO* /*bio*/, int cmd, long /*num*/, void* /*ptr*/) {
+    // Sends are flushed once per loop iteration regardless
+    return cmd == BIO_CTRL_FLUSH ? 1 : 0;
+  }
+
+  static int Destroy(BIO* bio) {
+    auto* stream = static_cast<UringStream*>(BIO_get_data(bio));
+    if (stream != nullptr && stream->bio_ == bio) {
+      stream->bio_ = nullptr;
+    }
+    BIO_set_data(bio, nullptr);
+    return 1;
+  }
+
+  static const BIO_METHOD* Method() {
+    static const BIO_METHOD* method = [] {
+      BIO_METHOD* m =
+          BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "uring");
+      BIO_meth_set_write(m, Write);
+      BIO_meth_set_read(m, Read);
+      BIO_meth_set_ctrl(m, Ctrl);
+      BIO_meth_set_destroy(m, Destroy);
+      return m;
+    }();
+    return method;
+  }
+};
+
+UringStream::UringStream(UringBackend* backend, EventHandler* handler)
+    : backend_(backend), handler_(handler), fd_(handler->fd) {}
+
+size_t UringStream::Read(uint8_t* dest, size_t len) {
+  size_t n = std::min(len, Available());
+  if (n == 0) {
+    return 0;
+  }
+  std::memcpy(dest, inbound_.data() + inbound_pos_, n);
+  inbound_pos_ += n;
+  if (inbound_pos_ == inbound_.size()) {
+    inbound_.clear();
+    inbound_pos_ = 0;
+  }
+  // Resume a recv paused on a full inbound buffer
+  if (!recv_armed_ && Available() <= backend_->config_.max_inbound / 2) {
+    backend_->UpdateRecv(this);
+  }
+  return n;
+}
+
+size_t UringStream::Write(const uint8_t* data, size_t len) {
+  // Without a fixed file the fd may already be closed and reused
+  if (error_ != 0 || (handler_ == nullptr && slot_ < 0)) {
+    return len;
+  }
+  if (Pending() >= backend_->config_.max_outbound) {
+    write_blocked_ = true;
+    return 0;
+  }
+  outbound_.insert(outbound_.end(), data, data + len);
+  backend_->MarkFlush(this);
+  return len;
+}
+
+UringBackend::UringBackend(uv_loop_t* loop, DispatchFn dispatch)
+    : loop_(loop), dispatch_(dispatch) {}
+
+UringBackend::~UringBackend() {
+  Close();
+  if (ring_fd_ >= 0 && sqes_ != nullptr) {
+    Drain();
+  }
+
+  while (all_ != nullptr) {
+    UringStream* stream = all_;
+    all_ = stream->next_;
+    if (stream->bio_ != nullptr) {
+      BIO_set_data(static_cast<BIO*>(stream->bio_), nullptr);
+    }
+    delete stream;
+  }
+  streams_.Clear();
+
+  if (buffers_ != nullptr) munmap(buffers_, buffers_size_);
+  if (buf_ring_ != nullptr) munmap(buf_ring_, buf_ring_size_);
+  if (sqes_ != nullptr) munmap(sqes_, sqes_size_);
+  if (cq_map_ != nullptr && cq_map_ != sq_map_) munmap(cq_map_, cq_map_size_);
+  if (sq_map_ != nullptr) munmap(sq_map_, sq_map_size_);
+  if (ring_fd_ >= 0) close(ring_fd_);
+}
+
+bool UringBackend::Initialize(const UringConfig& config) {
+  if (ring_fd_ >= 0) {
+    last_error_ = "io_uring already initialized";
+    return false;
+  }
+  config_ = config;
+  if (config_.buffer_count == 0 || config_.buffer_count > 32768 ||
+      (config_.buffer_count & (config_.buffer_count - 1)) != 0) {
+    last_error_ = "buffer_count must be a power of two up to 32768";
+    return false;
+  }
+
+  // Ring: completions get 4x headroom for multishot recvs
+  io_uring_params params{};
+  params.flags =
+      IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP | IORING_SETUP_SUBMIT_ALL;
+  params.cq_entries = config_.entries * 4;
+  ring_fd_ = SysSetup(config_.entries, &params);
+  if (ring_fd_ < 0 && errno == EINVAL) {
+    params = {};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = config_.entries * 4;
+    ring_fd_ = SysSetup(config_.entries, &params);
+  }
+  if (ring_fd_ < 0) {
+    last_error_ = std::string("io_uring_setup failed: ") + strerror(errno);
+    return false;
+  }
+  if ((params.features & IORING_FEAT_NODROP) == 0) {
+    last_error_ = "io_uring lacks IORING_FEAT_NODROP";
+    return false;
+  }
+
+  sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_map_size_ = cq_map_size_ = std::max(sq_map_size_, cq_map_size_);
+  }
+  sq_map_ = MapRing(sq_map_size_, ring_fd_, IORING_OFF_SQ_RING);
+  cq_map_ = single_mmap ? sq_map_
+                        : MapRing(cq_map_size_, ring_fd_, IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = static_cast<io_uring_sqe*>(
+      MapRing(sqes_size_, ring_fd_, IORING_OFF_SQES));
+  if (sq_map_ == nullptr || cq_map_ == nullptr || sqes_ == nullptr) {
+    last_error_ = "Failed to map io_uring rings";
+    return false;
+  }
+  sq_head_ = RingField<uint32_t>(sq_map_, params.sq_off.head);
+  sq_tail_ = RingField<uint32_t>(sq_map_, params.sq_off.tail);
+  sq_flags_ = RingField<uint32_t>(sq_map_, params.sq_off.flags);
+  sq_mask_ = *RingField<uint32_t>(sq_map_, params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  cq_head_ = RingField<uint32_t>(cq_map_, params.cq_off.head);
+  cq_tail_ = RingField<uint32_t>(cq_map_, params.cq_off.tail);
+  cq_mask_ = *RingField<uint32_t>(cq_map_, params.cq_off.ring_mask);
+  cqes_ = RingField<io_uring_cqe>(cq_map_, params.cq_off.cqes);
+  // SQEs are handed out in ring order, so the index array is the identity
+  auto* sq_array = RingField<uint32_t>(sq_map_, params.sq_off.array);
+  for (uint32_t i = 0; i < sq_entries_; ++i) {
+    sq_array[i] = i;
+  }
+  sqe_tail_ = sqe_submitted_ = *sq_tail_;
+
+  // Sparse fixed file table; sockets fall back to plain fds without it
+  rlimit nofile{};
+  uint32_t max_files = config_.max_files;
+  if (getrlimit(RLIMIT_NOFILE, &nofile) == 0 &&
+      nofile.rlim_cur != RLIM_INFINITY) {
+    max_files = static_cast<uint32_t>(
+        std::min<rlim_t>(max_files, nofile.rlim_cur));
+  }
+  io_uring_rsrc_register files{};
+  files.nr = max_files;
+  files.flags = IORING_RSRC_REGISTER_SPARSE;
+  if (max_files > 0 && SysRegister(ring_fd_, IORING_REGISTER_FILES2, &files,
+                                   sizeof(files)) == 0) {
+    free_slots_.reserve(max_files);
+    for (uint32_t i = max_files; i > 0; --i) {
+      free_slots_.push_back(static_cast<int>(i - 1));
+    }
+  }
+
+  // Provided buffer ring shared by every socket's recv
+  buf_ring_size_ = config_.buffer_count * sizeof(io_uring_buf);
+  buf_ring_ = static_cast<io_uring_buf_ring*>(MapAnonymous(buf_ring_size_));
+  buffers_size_ = size_t{config_.buffer_count} * config_.buffer_size;
+  buffers_ = static_cast<uint8_t*>(MapAnonymous(buffers_size_));
+  if (buf_ring_ == nullptr || buffers_ == nullptr) {
+    last_error_ = "Failed to allocate receive buffers";
+    return false;
+  }
+  io_uring_buf_reg reg{};
+  reg.ring_addr = reinterpret_cast<uintptr_t>(buf_ring_);
+  reg.ring_entries = config_.buffer_count;
+  reg.bgid = kRingBufferGroup;
+  if (SysRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) == 0) {
+    for (uint32_t i = 0; i < config_.buffer_count; ++i) {
+      RecycleBuffer(static_cast<uint16_t>(i));
+    }
+    // Make sure recv actually picks buffers from the ring before relying
+    // on it; fall back to provide-buffers otherwise
+    if (!ProbeBuffers()) {
+      SysRegister(ring_fd_, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+      buf_group_ = kLegacyBufferGroup;
+    }
+  } else {
+    buf_group_ = kLegacyBufferGroup;  // Pre-5.19
+  }
+  if (buf_group_ == kLegacyBufferGroup) {
+    // Same buffers, handed to the kernel one SQE at a time
+    io_uring_sqe* sqe = GetSqe();
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = static_cast<int32_t>(config_.buffer_count);
+    sqe->addr = reinterpret_cast<uintptr_t>(buffers_);
+    sqe->len = config_.buffer_size;
+    sqe->buf_group = kLegacyBufferGroup;
+    sqe->user_data = kTagNone;
+    if (!ProbeBuffers()) {
+      last_error_ = "io_uring provided buffers unsupported";
+      return false;
+    }
+  }
+
+  // Loop hooks: reap when the ring fd is readable, submit before blocking
+  if (uv_poll_init(loop_, &ring_poll_, ring_fd_) != 0) {
+    last_error_ = "Failed to poll io_uring fd";
+    return false;
+  }
+  ring_poll_.data = this;
+  uv_prepare_init(loop_, &prepare_);
+  prepare_.data = this;
+  uv_idle_init(loop_, &idle_);
+  idle_.data = this;
+  hooked_ = true;
+  uv_poll_start(&ring_poll_, UV_READABLE, OnRingReadable);
+  uv_prepare_start(&prepare_, OnPrepare);
+  return true;
+}
+
+void UringBackend::Close() {
+  if (!hooked_) {
+    return;
+  }
+  hooked_ = false;
+  uv_poll_stop(&ring_poll_);
+  uv_close(reinterpret_cast<uv_handle_t*>(&ring_poll_), nullptr);
+  uv_prepare_stop(&prepare_);
+  uv_close(reinterpret_cast<uv_handle_t*>(&prepare_), nullptr);
+  uv_idle_stop(&idle_);
+  uv_close(reinterpret_cast<uv_handle_t*>(&idle_), nullptr);
+  idle_active_ = false;
+}
+
+bool UringBackend::Add(EventHandler* handler, EventType events) {
+  if (handler == nullptr || handler->fd < 0) {
+    return false;
+  }
+  int fd = handler->fd;
+  if (static_cast<size_t>(fd) >= kMaxFds || streams_.Contains(fd)) {
+    return false;
+  }
+
+  auto* stream = new UringStream(this, handler);
+  stream->slot_ = AcquireSlot(fd);
+  stream->interest_ = events;
+  stream->next_ = all_;
+  if (all_ != nullptr) {
+    all_->prev_ = stream;
+  }
+  all_ = stream;
+  streams_.Set(fd, stream);
+
+  if (PollMask(events) != 0) {
+    ArmPoll(stream);
+  }
+  return true;
+}
+
+bool UringBackend::Modify(EventHandler* handler, EventType events) {
+  UringStream* stream = Stream(handler);
+  if (stream == nullptr) {
+    return false;
+  }
+  stream->interest_ = events;
+
+  if (!stream->streaming_) {
+    uint32_t mask = PollMask(events);
+    if (stream->poll_armed_) {
+      // Re-armed with the new mask when the cancellation completes
+      if (mask != stream->poll_mask_) {
+        Cancel(stream, kTagPoll);
+      }
+    } else if (!stream->queued_ready_ && mask != 0) {
+      ArmPoll(stream);
+    }
+    return true;
+  }
+
+  if (HasEvent(events, EventType::kWrite) && !stream->write_blocked_) {
+    stream->writable_ = true;
+    MarkReady(stream);
+  }
+  if (HasEvent(events, EventType::kRead) &&
+      (stream->Available() > 0 || stream->eof_)) {
+    MarkReady(stream);
+  }
+  UpdateRecv(stream);
+  return true;
+}
+
+bool UringBackend::Remove(EventHandler* handler) {
+  UringStream* stream = Stream(handler);
+  if (stream == nullptr) {
+    return false;
+  }
+  streams_.Remove(stream->fd_);
+  stream->handler_ = nullptr;
+
+  // Bytes queued from here on (a TLS close_notify) still go out, without
+  // waiting on the peer; everything else stops
+  if (stream->poll_armed_) {
+    Cancel(stream, kTagPoll);
+  }
+  if (stream->send_armed_) {
+    Cancel(stream, kTagSend);
+  }
+  UpdateRecv(stream);
+  MarkReady(stream);  // Freed once idle
+  return true;
+}
+
+bio_st* UringBackend::AttachStream(EventHandler* handler) {
+  UringStream* stream = Stream(handler);
+  if (stream == nullptr) {
+    return nullptr;
+  }
+  if (!stream->streaming_) {
+    stream->streaming_ = true;
+    stream->poll_events_ = 0;
+    if (stream->poll_armed_) {
+      Cancel(stream, kTagPoll);
+    }
+    UpdateRecv(stream);
+  }
+
+  BIO* bio = BIO_new(UringBio::Method());
+  if (bio == nullptr) {
+    return nullptr;
+  }
+  BIO_set_data(bio, stream);
+  BIO_set_init(bio, 1);
+  if (stream->bio_ != nullptr) {
+    BIO_set_data(static_cast<BIO*>(stream->bio_), nullptr);
+  }
+  stream->bio_ = bio;
+  return bio;
+}
+
+UringStream* UringBackend::Stream(EventHandler* handler) const {
+  if (handler == nullptr) {
+    return nullptr;
+  }
+  UringStream* stream = streams_.Get(handler->fd);
+  return stream != nullptr && stream->handler_ == handler ? stream : nullptr;
+}
+
+io_uring_sqe* UringBackend::GetSqe() {
+  if (sqe_tail_ - LoadAcquire(sq_head_) >= sq_entries_) {
+    Submit();
+    if (sqe_tail_ - LoadAcquire(sq_head_) >= sq_entries_) {
+      return nullptr;  // Kernel refused the batch (EBUSY); retried later
+    }
+  }
+  io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+  std::memset(sqe, 0, sizeof(*sqe));
+  ++sqe_tail_;
+  return sqe;
+}
+
+void UringBackend::Submit() {
+  uint32_t pending = sqe_tail_ - sqe_submitted_;
+  bool overflow = (LoadAcquire(sq_flags_) & IORING_SQ_CQ_OVERFLOW) != 0;
+  if (pending == 0 && !overflow) {
+    return;
+  }
+  StoreRelease(sq_tail_, sqe_tail_);
+  ++enter_calls_;
+  int ret = SysEnter(ring_fd_, pending, 0,
+                     overflow ? IORING_ENTER_GETEVENTS : 0);
+  if (ret > 0) {
+    sqe_submitted_ += static_cast<uint32_t>(ret);
+  }
+}
+
+void UringBackend::Reap() {
+  for (;;) {
+    uint32_t head = *cq_head_;
+    uint32_t tail = LoadAcquire(cq_tail_);
+    while (head != tail) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      uint64_t user_data = cqe.user_data;
+      int32_t res = cqe.res;
+      uint32_t flags = cqe.flags;
+      StoreRelease(cq_head_, ++head);
+      Complete(user_data, res, flags);
+    }
+    // Completions that did not fit the CQ wait in the kernel
+    if ((LoadAcquire(sq_flags_) & IORING_SQ_CQ_OVERFLOW) == 0) {
+      break;
+    }
+    ++enter_calls_;
+    SysEnter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+  }
+}
+
+void UringBackend::Complete(uint64_t user_data, int32_t res, uint32_t flags) {
+  uint64_t tag = user_data & kTagMask;
+  auto* stream = reinterpret_cast<UringStream*>(user_data & ~kTagMask);
+  if (stream == nullptr) {
+    if (tag == kTagDrain && res < 0 && res != -ENOENT) {
+      drain_failed_ = true;
+    } else if (tag == kTagProbe) {
+      probe_result_ = res;
+      if ((flags & IORING_CQE_F_BUFFER) != 0) {
+        RecycleBuffer(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+      }
+    }
+    return;
+  }
+
+  bool final = tag != kTagRecv || (flags & IORING_CQE_F_MORE) == 0;
+  if (final) {
+    --stream->inflight_;
+  }
+  if (closing_) {
+    return;
+  }
+
+  switch (tag) {
+    case kTagPoll:
+      OnPollComplete(stream, res);
+      break;
+    case kTagRecv:
+      OnRecvComplete(stream, res, flags);
+      break;
+    case kTagSend:
+      OnSendComplete(stream, res);
+      break;
+    default:
+      break;
+  }
+  if (stream->handler_ == nullptr) {
+    Collect(stream);
+  }
+}
+
+void UringBackend::ArmPoll(UringStream* stream) {
+  io_uring_sqe* sqe = GetSqe();
+  if (sqe == nullptr) {
+    stream->error_ = EBUSY;
+    MarkReady(stream);
+    return;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  PrepareFd(sqe, stream->fd_, stream->slot_);
+  stream->poll_mask_ = PollMask(stream->interest_);
+  sqe->poll32_events = stream->poll_mask_;
+  sqe->user_data = UserData(stream, kTagPoll);
+  stream->poll_armed_ = true;
+  ++stream->inflight_;
+}
+
+void UringBackend::ArmRecv(UringStream* stream) {
+  io_uring_sqe* sqe = GetSqe();
+  if (sqe == nullptr) {
+    stream->error_ = EBUSY;
+    MarkReady(stream);
+    return;
+  }
+  sqe->opcode = IORING_OP_RECV;
+  PrepareFd(sqe, stream->fd_, stream->slot_);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = buf_group_;
+  if (multishot_) {
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+  } else {
+    sqe->len = config_.buffer_size;
+  }
+  sqe->user_data = UserData(stream, kTagRecv);
+  stream->recv_armed_ = true;
+  ++stream->inflight_;
+}
+
+void UringBackend::StartSend(UringStream* stream) {
+  if (stream->send_armed_) {
+    return;
+  }
+  if (stream->handler_ == nullptr && stream->slot_ < 0) {
+    stream->outbound_.clear();
+    stream->sending_.clear();
+    stream->send_offset_ = 0;
+    return;
+  }
+  if (stream->send_offset_ == stream->sending_.size()) {
+    if (stream->outbound_.empty()) {
+      return;
+    }
+    // Everything written since the last send goes out together
+    stream->sending_.clear();
+    stream->sending_.swap(stream->outbound_);
+    stream->send_offset_ = 0;
+  }
+
+  io_uring_sqe* sqe = GetSqe();
+  if (sqe == nullptr) {
+    MarkFlush(stream);  // Retried before the loop next blocks
+    return;
+  }
+  sqe->opcode = IORING_OP_SEND;
+  PrepareFd(sqe, stream->fd_, stream->slot_);
+  const uint8_t* data = stream->sending_.data() + stream->send_offset_;
+  sqe->addr = reinterpret_cast<uintptr_t>(data);
+  sqe->len = static_cast<uint32_t>(stream->sending_.size() -
+                                   stream->send_offset_);
+  sqe->msg_flags = MSG_NOSIGNAL;
+  if (stream->handler_ == nullptr) {
+    sqe->msg_flags |= MSG_DONTWAIT;
+  }
+  sqe->user_data = UserData(stream, kTagSend);
+  stream->send_armed_ = true;
+  ++stream->inflight_;
+}
+
+void UringBackend::Cancel(UringStream* stream, uint64_t tag) {
+  io_uring_sqe* sqe = GetSqe();
+  if (sqe == nullptr) {
+    return;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = UserData(stream, tag);
+  sqe->user_data = kTagNone;
+}
+
+void UringBackend::OnPollComplete(UringStream* stream, int32_t res) {
+  stream->poll_armed_ = false;
+  if (stream->handler_ == nullptr || stream->streaming_) {
+    return;
+  }
+  if (res == -ECANCELED) {
+    MarkReady(stream);  // Re-armed for the current interest
+    return;
+  }
+  if (res < 0) {
+    stream->error_ = -res;
+  } else if ((res & POLLERR) != 0) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    getsockopt(stream->fd_, SOL_SOCKET, SO_ERROR, &error, &len);
+    stream->error_ = error != 0 ? error : EBADF;
+  } else {
+    stream->poll_events_ |=
+        UvEvents(static_cast<uint32_t>(res), stream->interest_);
+  }
+  MarkReady(stream);
+}
+
+void UringBackend::OnRecvComplete(UringStream* stream, int32_t res,
+                                  uint32_t flags) {
+  bool more = (flags & IORING_CQE_F_MORE) != 0;
+  if ((flags & IORING_CQE_F_BUFFER) != 0) {
+    auto bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+    if (res > 0 && stream->handler_ != nullptr) {
+      const uint8_t* data = buffers_ + size_t{bid} * config_.buffer_size;
+      stream->inbound_.insert(stream->inbound_.end(), data, data + res);
+    }
+    RecycleBuffer(bid);
+  }
+  if (!more) {
+    stream->recv_armed_ = false;
+    stream->recv_cancelled_ = false;
+  }
+  if (stream->handler_ == nullptr) {
+    return;
+  }
+
+  if (res > 0) {
+    MarkReady(stream);
+  } else if (res == 0) {
+    stream->eof_ = true;
+    MarkReady(stream);
+  } else if (res == -EINVAL && multishot_) {
+    multishot_ = false;  // Pre-6.0 kernel: one recv per completion
+  } else if (res != -ENOBUFS && res != -ECANCELED) {
+    stream->error_ = -res;
+    MarkReady(stream);
+  }
+  UpdateRecv(stream);
+}
+
+void UringBackend::OnSendComplete(UringStream* stream, int32_t res) {
+  stream->send_armed_ = false;
+  if (res > 0) {
+    stream->send_offset_ += static_cast<size_t>(res);
+  }
+  bool sent = stream->send_offset_ == stream->sending_.size();
+
+  if (stream->handler_ == nullptr) {
+    // A record cut short leaves nothing worth sending after it
+    if (res <= 0 || !sent) {
+      stream->outbound_.clear();
+      stream->sending_.clear();
+      stream->send_offset_ = 0;
+    }
+    StartSend(stream);
+    return;
+  }
+  if (res < 0 && res != -EAGAIN && res != -EINTR) {
+    stream->error_ = -res;
+    stream->outbound_.clear();
+    MarkReady(stream);
+    return;
+  }
+
+  StartSend(stream);  // The rest, or what was written meanwhile
+  if (stream->write_blocked_ &&
+      stream->Pending() <= config_.max_outbound / 2) {
+    stream->write_blocked_ = false;
+    stream->writable_ = true;
+    MarkReady(stream);
+  }
+}
+
+void UringBackend::UpdateRecv(UringStream* stream) {
+  bool want = stream->handler_ != nullptr && stream->streaming_ &&
+              HasEvent(stream->interest_, EventType::kRead) &&
+              !stream->eof_ && stream->error_ == 0 &&
+              stream->Available() < config_.max_inbound;
+  if (want && !stream->recv_armed_) {
+    ArmRecv(stream);
+  } else if (!want && stream->recv_armed_ && !stream->recv_cancelled_) {
+    // Re-evaluated when the final completion arrives
+    stream->recv_cancelled_ = true;
+    Cancel(stream, kTagRecv);
+  }
+}
+
+void UringBackend::MarkReady(UringStream* stream) {
+  if (!stream->queued_ready_) {
+    stream->queued_ready_ = true;
+    ready_.push_back(stream);
+  }
+  // Keeps the loop from blocking until the ready list is empty
+  if (!idle_active_ && hooked_) {
+    idle_active_ = true;
+    uv_idle_start(&idle_, OnIdle);
+  }
+}
+
+void UringBackend::MarkFlush(UringStream* stream) {
+  if (!stream->queued_flush_) {
+    stream->queued_flush_ = true;
+    flush_.push_back(stream);
+  }
+}
+
+void UringBackend::RunReady() {
+  dispatching_.swap(ready_);
+  for (UringStream* stream : dispatching_) {
+    stream->queued_ready_ = false;
+    if (stream->handler_ == nullptr) {
+      Collect(stream);
+    } else {
+      Dispatch(stream);
+    }
+  }
+  dispatching_.clear();
+
+  if (ready_.empty() && idle_active_) {
+    idle_active_ = false;
+    uv_idle_stop(&idle_);
+  }
+}
+
+void UringBackend::FlushSends() {
+  dispatching_.swap(flush_);
+  for (UringStream* stream : dispatching_) {
+    stream->queued_flush_ = false;
+    StartSend(stream);
+    if (stream->handler_ == nullptr) {
+      Collect(stream);
+    }
+  }
+  dispatching_.clear();
+}
+
+void UringBackend::Dispatch(UringStream* stream) {
+  EventHandler* handler = stream->handler_;
+
+  if (stream->error_ != 0) {
+    if (!stream->error_reported_) {
+      stream->error_reported_ = true;
+      dispatch_(handler, -stream->error_, 0);
+    }
+    return;
+  }
+
+  if (!stream->streaming_) {
+    int events = stream->poll_events_ & static_cast<int>(stream->interest_);
+    stream->poll_events_ = 0;
+    if (events != 0) {
+      dispatch_(handler, 0, events);
+    }
+    // Level-triggered: watch again for whatever is wanted now
+    if (stream->handler_ != nullptr && !stream->streaming_ &&
+        !stream->poll_armed_ && !stream->queued_ready_ &&
+        PollMask(stream->interest_) != 0) {
+      ArmPoll(stream);
+    }
+    return;
+  }
+
+  int events = 0;
+  size_t available = stream->Available();
+  if (HasEvent(stream->interest_, EventType::kRead) &&
+      (available > 0 || stream->eof_)) {
+    events |= UV_READABLE;
+  }
+  if (stream->writable_ && HasEvent(stream->interest_, EventType::kWrite)) {
+    events |= UV_WRITABLE;
+  }
+  stream->writable_ = false;
+  if (events == 0) {
+    return;
+  }
+  dispatch_(handler, 0, events);
+
+  // Level-triggered reads: come back while the handler keeps consuming
+  if (stream->handler_ != nullptr &&
+      HasEvent(stream->interest_, EventType::kRead) &&
+      stream->Available() > 0 && stream->Available() < available) {
+    MarkReady(stream);
+  }
+}
+
+bool UringBackend::Collect(UringStream* stream) {
+  if (stream->handler_ != nullptr || stream->inflight_ > 0 ||
+      stream->queued_ready_ || stream->queued_flush_) {
+    return false;
+  }
+  Destroy(stream);
+  return true;
+}
+
+void UringBackend::Destroy(UringStream* stream) {
+  if (stream->prev_ != nullptr) {
+    stream->prev_->next_ = stream->next_;
+  } else {
+    all_ = stream->next_;
+  }
+  if (stream->next_ != nullptr) {
+    stream->next_->prev_ = stream->prev_;
+  }
+  // Drops the ring's reference to the socket, closing it for good
+  if (stream->slot_ >= 0) {
+    ReleaseSlot(stream->slot_);
+  }
+  if (stream->bio_ != nullptr) {
+    BIO_set_data(static_cast<BIO*>(stream->bio_), nullptr);
+  }
+  delete stream;
+}
+
+void UringBackend::Drain() {
+  // Nothing may still read or fill stream memory once it is freed
+  closing_ = true;
+  auto inflight = [this] {
+    for (UringStream* s = all_; s != nullptr; s = s->next_) {
+      if (s->inflight_ > 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  if (!inflight()) {
+    return;
+  }
+  if (io_uring_sqe* sqe = GetSqe()) {
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+    sqe->user_data = kTagDrain;
+  }
+  for (int round = 0; round < kMaxDrainRounds && !drain_failed_ && inflight();
+       ++round) {
+    uint32_t pending = sqe_tail_ - sqe_submitted_;
+    StoreRelease(sq_tail_, sqe_tail_);
+    int ret = SysEnter(ring_fd_, pending, 1, IORING_ENTER_GETEVENTS);
+    if (ret < 0 && errno != EINTR) {
+      break;
+    }
+    if (ret > 0) {
+      sqe_submitted_ += static_cast<uint32_t>(ret);
+    }
+    Reap();
+  }
+}
+
+int UringBackend::AcquireSlot(int fd) {
+  if (free_slots_.empty()) {
+    return -1;
+  }
+  int slot = free_slots_.back();
+  io_uring_files_update update{};
+  update.offset = static_cast<uint32_t>(slot);
+  update.fds = reinterpret_cast<uintptr_t>(&fd);
+  if (SysRegister(ring_fd_, IORING_REGISTER_FILES_UPDATE, &update, 1) != 1) {
+    return -1;
+  }
+  free_slots_.pop_back();
+  return slot;
+}
+
+void UringBackend::ReleaseSlot(int slot) {
+  int fd = -1;
+  io_uring_files_update update{};
+  update.offset = static_cast<uint32_t>(slot);
+  update.fds = reinterpret_cast<uintptr_t>(&fd);
+  SysRegister(ring_fd_, IORING_REGISTER_FILES_UPDATE, &update, 1);
+  free_slots_.push_back(slot);
+}
+
+bool UringBackend::ProbeBuffers() {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    return false;
+  }
+  bool ok = false;
+  io_uring_sqe* sqe = GetSqe();
+  if (write(fds[1], "x", 1) == 1 && sqe != nullptr) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fds[0];
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = buf_group_;
+    sqe->len = 1;
+    sqe->user_data = kTagProbe;
+    probe_result_ = 0;
+    StoreRelease(sq_tail_, sqe_tail_);
+    int ret = SysEnter(ring_fd_, sqe_tail_ - sqe_submitted_, 1,
+                       IORING_ENTER_GETEVENTS);
+    if (ret > 0) {
+      sqe_submitted_ += static_cast<uint32_t>(ret);
+      Reap();
+      ok = probe_result_ == 1;
+    }
+  }
+  close(fds[0]);
+  close(fds[1]);
+  return ok;
+}
+
+void UringBackend::RecycleBuffer(uint16_t bid) {
+  uint8_t* addr = buffers_ + size_t{bid} * config_.buffer_size;
+  if (buf_group_ == kLegacyBufferGroup) {
+    io_uring_sqe* sqe = GetSqe();
+    if (sqe == nullptr) {
+      return;  // Lost to the pool; recv falls back on the others
+    }
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = 1;
+    sqe->addr = reinterpret_cast<uintptr_t>(addr);
+    sqe->len = config_.buffer_size;
+    sqe->off = bid;
+    sqe->buf_group = kLegacyBufferGroup;
+    sqe->user_data = kTagNone;
+    return;
+  }
+  // The entries overlay the ring header from offset 0. Not through ->bufs:
+  // in C++ the header's __DECLARE_FLEX_ARRAY puts it 8 bytes in (the empty
+  // struct before it has size 1).
+  auto* bufs = reinterpret_cast<io_uring_buf*>(buf_ring_);
+  io_uring_buf& buf = bufs[buf_tail_ & (config_.buffer_count - 1)];
+  buf.addr = reinterpret_cast<uintptr_t>(addr);
+  buf.len = config_.buffer_size;
+  buf.bid = bid;
+  ++buf_tail_;
+  std::atomic_ref<uint16_t>(buf_ring_->tail)
+      .store(buf_tail_, std::memory_order_release);
+}
+
+void UringBackend::OnRingReadable(uv_poll_t* handle, int /*status*/,
+                                  int /*events*/) {
+  auto* self = static_cast<UringBackend*>(handle->data);
+  self->Reap();
+  self->RunReady();
+}
+
+void UringBackend::OnPrepare(uv_prepare_t* handle) {
+  auto* self = static_cast<UringBackend*>(handle->data);
+  self->FlushSends();
+  self->Submit();
+}
+
+void UringBackend::OnIdle(uv_idle_t* handle) {
+  auto* self = static_cast<UringBackend*>(handle->data);
+  self->RunReady();
+}
+
+}  // namespace core
+}  // namespace holytls
@@ -0,0 +1,265 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// UringBackend - io_uring I/O for a Reactor (Linux, HOLYTLS_IO_URING).
+//
+// The libuv loop still runs timers, DNS and posted callbacks; the ring fd
+// is one more uv_poll_t on it. Sockets are registered in a sparse fixed
+// file table, and handlers see the same OnReadable/OnWritable/OnError
+// calls as with uv_poll_t, in two modes:
+//
+//   Poll mode (connect, proxy tunnel): one-shot IORING_OP_POLL_ADD,
+//   re-armed after each dispatch, so readiness is level-triggered.
+//
+//   Stream mode (from AttachStream, i.e. once TLS starts): one multishot
+//   recv per socket fills a shared provided-buffer ring (or, on kernels
+//   without a working one, IORING_OP_PROVIDE_BUFFERS), and the bytes
+//   are copied into the stream's inbound buffer. TLS reads and writes go
+//   through a memory BIO over that stream. Records written during a loop
+//   iteration leave as a single send, and all SQEs queued in an iteration
+//   are submitted with one io_uring_enter() before the loop blocks.
+//   Readable is level-triggered (repeated while inbound bytes are being
+//   consumed); writable is reported once the send queue drains after a
+//   write was refused, or once per Modify() that asks for it.
+//
+// Single-threaded: used only on its reactor's thread.
+
+#ifndef HOLYTLS_CORE_URING_H_
+#define HOLYTLS_CORE_URING_H_
+
+#include <uv.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "holytls/base/types.h"
+#include "holytls/core/reactor.h"
+#include "holytls/memory/slab_allocator.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace holytls {
+namespace core {
+
+class UringBackend;
+struct UringBio;
+
+// Delivers uv_poll_t-style events (status < 0 is a negated errno)
+using DispatchFn = void (*)(EventHandler* handler, int status, int events);
+
+struct UringConfig {
+  uint32_t entries = 4096;         // Submission queue size
+  uint32_t max_files = 16384;      // Fixed file table (capped by NOFILE)
+  uint32_t buffer_count = 1024;    // Provided receive buffers (power of 2)
+  uint32_t buffer_size = 16384;    // One TLS record
+  size_t max_outbound = 262144;    // Per-socket send queue before writes
+                                   // are refused
+  size_t max_inbound = 1048576;    // Per-socket unread bytes before recv
+                                   // is paused
+};
+
+// Per-socket state. Outlives its handler until every operation it
+// started has completed.
+class UringStream : public memory::SlabAllocated<UringStream> {
+ public:
+  // Copy out up to `len` received bytes; 0 when none are buffered
+  size_t Read(uint8_t* dest, size_t len);
+
+  // Queue `len` bytes for sending. Returns `len`, or 0 when the send
+  // queue is full (writable is dispatched once it drains).
+  size_t Write(const uint8_t* data, size_t len);
+
+  // Peer closed its side and every received byte has been read
+  bool eof() const { return eof_ && Available() == 0; }
+
+  size_t Available() const { return inbound_.size() - inbound_pos_; }
+
+ private:
+  friend class UringBackend;
+  friend struct UringBio;
+
+  UringStream(UringBackend* backend, EventHandler* handler);
+
+  size_t Pending() const {
+    return outbound_.size() + sending_.size() - send_offset_;
+  }
+
+  UringBackend* backend_;
+  EventHandler* handler_;  // nullptr once removed
+  int fd_;
+  int slot_ = -1;  // Fixed file index, -1 to use fd_ directly
+  EventType interest_ = EventType::kNone;
+  bool streaming_ = false;
+
+  // Operations in flight; the stream is freed when this drops to 0
+  // after Remove()
+  int inflight_ = 0;
+  bool poll_armed_ = false;
+  uint32_t poll_mask_ = 0;
+  bool recv_armed_ = false;
+  bool recv_cancelled_ = false;
+  bool send_armed_ = false;
+
+  // Received bytes not yet read
+  std::vector<uint8_t> inbound_;
+  size_t inbound_pos_ = 0;
+  bool eof_ = false;
+  int error_ = 0;  // errno of a failed recv/send
+  bool error_reported_ = false;
+
+  // Bytes queued this iteration, and the send in flight
+  std::vector<uint8_t> outbound_;
+  std::vector<uint8_t> sending_;
+  size_t send_offset_ = 0;
+  bool write_blocked_ = false;
+
+  // Dispatch state
+  int poll_events_ = 0;  // From the last poll completion
+  bool writable_ = false;
+  bool queued_ready_ = false;  // In UringBackend::ready_
+  bool queued_flush_ = false;  // In UringBackend::flush_
+
+  void* bio_ = nullptr;  // BIO reading and writing this stream, if any
+
+  UringStream* prev_ = nullptr;
+  UringStream* next_ = nullptr;
+};
+
+class UringBackend {
+ public:
+  UringBackend(uv_loop_t* loop, DispatchFn dispatch);
+  ~UringBackend();
+
+  // Non-copyable, non-movable
+  UringBackend(const UringBackend&) = delete;
+  UringBackend& operator=(const UringBackend&) = delete;
+  UringBackend(UringBackend&&) = delete;
+  UringBackend& operator=(UringBackend&&) = delete;
+
+  // Set up the ring, file table and buffer ring and hook into the loop.
+  // False (see last_error()) when the kernel lacks what is needed.
+  bool Initialize(const UringConfig& config = {});
+
+  std::string_view last_error() const { return last_error_; }
+
+  // Same contract as Reactor::Add/Modify/Remove/Contains
+  bool Add(EventHandler* handler, EventType events);
+  bool Modify(EventHandler* handler, EventType events);
+  bool Remove(EventHandler* handler);
+  bool Contains(int fd) const { return streams_.Contains(fd); }
+  size_t handler_count() const { return streams_.Count(); }
+
+  // Move a registered handler to stream mode. Returns a new BIO over the
+  // stream (caller owns it; for SSL_set_bio), or nullptr if `handler`
+  // is not registered.
+  bio_st* AttachStream(EventHandler* handler);
+
+  // Stream of a registered handler, or nullptr
+  UringStream* Stream(EventHandler* handler) const;
+
+  // Stop the loop handles before the loop is closed. Streams are freed
+  // and the ring torn down in the destructor.
+  void Close();
+
+  // io_uring_enter() calls made so far
+  uint64_t enter_calls() const { return enter_calls_; }
+
+ private:
+  friend class UringStream;
+
+  io_uring_sqe* GetSqe();
+  void Submit();
+  void Reap();
+  void Complete(uint64_t user_data, int32_t res, uint32_t flags);
+
+  void ArmPoll(UringStream* stream);
+  void ArmRecv(UringStream* stream);
+  void StartSend(UringStream* stream);
+  void Cancel(UringStream* stream, uint64_t tag);
+  void OnPollComplete(UringStream* stream, int32_t res);
+  void OnRecvComplete(UringStream* stream, int32_t res, uint32_t flags);
+  void OnSendComplete(UringStream* stream, int32_t res);
+  void UpdateRecv(UringStream* stream);
+
+  void MarkReady(UringStream* stream);
+  void MarkFlush(UringStream* stream);
+  void RunReady();
+  void FlushSends();
+  void Dispatch(UringStream* stream);
+  bool Collect(UringStream* stream);
+  void Destroy(UringStream* stream);
+  void Drain();
+
+  int AcquireSlot(int fd);
+  void ReleaseSlot(int slot);
+  bool ProbeBuffers();
+  void RecycleBuffer(uint16_t bid);
+
+  static void OnRingReadable(uv_poll_t* handle, int status, int events);
+  static void OnPrepare(uv_prepare_t* handle);
+  static void OnIdle(uv_idle_t* handle);
+
+  uv_loop_t* loop_;
+  DispatchFn dispatch_;
+  UringConfig config_;
+  std::string last_error_;
+
+  // Ring
+  int ring_fd_ = -1;
+  void* sq_map_ = nullptr;
+  size_t sq_map_size_ = 0;
+  void* cq_map_ = nullptr;
+  size_t cq_map_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_flags_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  uint32_t sqe_tail_ = 0;     // Next SQE to hand out
+  uint32_t sqe_submitted_ = 0;
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+  uint64_t enter_calls_ = 0;
+
+  // Fixed files
+  std::vector<int> free_slots_;
+
+  // Provided buffers
+  io_uring_buf_ring* buf_ring_ = nullptr;
+  size_t buf_ring_size_ = 0;
+  uint8_t* buffers_ = nullptr;
+  size_t buffers_size_ = 0;
+  uint16_t buf_tail_ = 0;
+  uint16_t buf_group_ = 0;  // Registered ring, or legacy provide-buffers
+  int32_t probe_result_ = 0;
+  bool multishot_ = true;  // Cleared if the kernel rejects multishot recv
+
+  // Loop hooks
+  uv_poll_t ring_poll_{};
+  uv_prepare_t prepare_{};
+  uv_idle_t idle_{};
+  bool hooked_ = false;
+  bool idle_active_ = false;
+  bool closing_ = false;       // Tearing down: completions only counted
+  bool drain_failed_ = false;
+
+  FdTable<UringStream, kMaxFds> streams_;
+  UringStream* all_ = nullptr;  // Every live stream, removed ones included
+  std::vector<UringStream*> ready_;
+  std::vector<UringStream*> dispatching_;
+  std::vector<UringStream*> flush_;
+};
+
+}  // namespace core
+}  // namespace holytls
+
+#endif  // HOLYTLS_CORE_URING_H_
@@ -0,0 +1,136 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/cache_control.h"
+
+#include <algorithm>
+
+#include "holytls/http/http_date.h"
+#include "holytls/util/sv_helpers.h"
+
+namespace holytls {
+namespace http {
+
+namespace {
+
+// delta-seconds (RFC 9111 §1.2.2); -1 when malformed. Values past 2^31
+// are clamped to it, as the RFC asks.
+int64_t ParseDeltaSeconds(std::string_view value) {
+  value = sv::Trim(value);
+  if (!value.empty() && value.front() == '"' && value.size() >= 2 &&
+      value.back() == '"') {
+    value = value.substr(1, value.size() - 2);
+  }
+  if (value.empty()) {
+    return -1;
+  }
+  constexpr int64_t kMaxDelta = int64_t{1} << 31;
+  int64_t seconds = 0;
+  for (char c : value) {
+    if (c < '0' || c > '9') {
+      return -1;
+    }
+    seconds = std::min(seconds * 10 + (c - '0'), kMaxDelta);
+  }
+  return seconds;
+}
+
+}  // namespace
+
+CacheControl ParseCacheControl(std::string_view value) {
+  CacheControl cc;
+  while (!value.empty()) {
+    size_t comma = value.find(',');
+    std::string_view directive = sv::Trim(value.substr(0, comma));
+    value = comma == std::string_view::npos ? "" : value.substr(comma + 1);
+
+    std::string_view name = directive;
+    std::string_view argument;
+    size_t eq = directive.find('=');
+    if (eq != std::string_view::npos) {
+      name = sv::Trim(directive.substr(0, eq));
+      argument = sv::Trim(directive.substr(eq + 1));
+    }
+
+    if (sv::EqualsIgnoreCase(name, "max-age")) {
+      cc.max_age = ParseDeltaSeconds(argument);
+    } else if (sv::EqualsIgnoreCase(name, "no-cache")) {
+      cc.no_cache = true;
+    } else if (sv::EqualsIgnoreCase(name, "no-store")) {
+      cc.no_store = true;
+    } else if (sv::EqualsIgnoreCase(name, "must-revalidate")) {
+      cc.must_revalidate = true;
+    } else if (sv::EqualsIgnoreCase(name, "public")) {
+      cc.is_public = true;
+    } else if (sv::EqualsIgnoreCase(name, "private")) {
+      cc.is_private = true;
+    }
+  }
+  return cc;
+}
+
+bool IsHeuristicallyCacheable(int status_code) {
+  switch (status_code) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+      return true;
+    default:
+      return false;
+  }
+}
+
+Freshness ComputeFreshness(const http2::PackedHeaders& headers,
+                           const CacheControl& cc, uint64_t request_time_ms,
+                           uint64_t response_time_ms) {
+  using http2::HeaderId;
+
+  // Without a usable Date, the arrival time stands in for it
+  uint64_t date_ms = ParseHttpDate(headers.Get(HeaderId::kDate));
+  if (date_ms == 0) {
+    date_ms = response_time_ms;
+  }
+
+  Freshness freshness;
+  std::string_view expires = headers.Get(HeaderId::kExpires);
+  if (cc.max_age >= 0) {
+    freshness.lifetime_ms = static_cast<uint64_t>(cc.max_age) * 1000;
+    freshness.explicit_lifetime = true;
+  } else if (!expires.empty()) {
+    // An unparseable Expires means "already expired"
+    uint64_t expires_ms = ParseHttpDate(expires);
+    freshness.lifetime_ms = expires_ms > date_ms ? expires_ms - date_ms : 0;
+    freshness.explicit_lifetime = true;
+  } else {
+    // Heuristic: 10% of the time since last modification (§4.2.2)
+    uint64_t modified_ms =
+        ParseHttpDate(headers.Get(HeaderId::kLastModified));
+    if (modified_ms != 0 && modified_ms < date_ms) {
+      freshness.lifetime_ms = (date_ms - modified_ms) / 10;
+    }
+  }
+
+  // Age on arrival (§4.2.3)
+  uint64_t apparent_age =
+      response_time_ms > date_ms ? response_time_ms - date_ms : 0;
+  int64_t age_seconds = ParseDeltaSeconds(headers.Get(HeaderId::kAge));
+  uint64_t age_value =
+      age_seconds > 0 ? static_cast<uint64_t>(age_seconds) * 1000 : 0;
+  uint64_t response_delay = response_time_ms > request_time_ms
+                                ? response_time_ms - request_time_ms
+                                : 0;
+  freshness.initial_age_ms =
+      std::max(apparent_age, age_value + response_delay);
+  return freshness;
+}
+
+}  // namespace http
+}  // namespace holytls
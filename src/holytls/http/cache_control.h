@@ -0,0 +1,51 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Cache-Control parsing and freshness calculation (RFC 9111) for the
+// response cache. HolyTLS is a private (single-user) cache, so shared-cache
+// directives such as s-maxage are ignored.
+
+#ifndef HOLYTLS_HTTP_CACHE_CONTROL_H_
+#define HOLYTLS_HTTP_CACHE_CONTROL_H_
+
+#include <cstdint>
+#include <string_view>
+
+#include "holytls/http2/packed_headers.h"
+
+namespace holytls {
+namespace http {
+
+// Directives understood in requests and responses
+struct CacheControl {
+  bool no_store = false;
+  bool no_cache = false;  // Also set by a qualified no-cache="field"
+  bool must_revalidate = false;
+  bool is_public = false;
+  bool is_private = false;
+  int64_t max_age = -1;  // Seconds, -1 when absent or malformed
+};
+
+CacheControl ParseCacheControl(std::string_view value);
+
+// Status codes a cache may store without explicit freshness (RFC 9110
+// §15.1)
+bool IsHeuristicallyCacheable(int status_code);
+
+// Freshness of a response as received (RFC 9111 §4.2), in milliseconds.
+// Times are wall-clock milliseconds since the epoch: `request_time_ms` when
+// the request was sent, `response_time_ms` when the response arrived.
+struct Freshness {
+  uint64_t lifetime_ms = 0;        // How long it is fresh for
+  uint64_t initial_age_ms = 0;     // Corrected age on arrival
+  bool explicit_lifetime = false;  // From max-age or Expires
+};
+
+Freshness ComputeFreshness(const http2::PackedHeaders& headers,
+                           const CacheControl& cc, uint64_t request_time_ms,
+                           uint64_t response_time_ms);
+
+}  // namespace http
+}  // namespace holytls
+
+#endif  // HOLYTLS_HTTP_CACHE_CONTROL_H_
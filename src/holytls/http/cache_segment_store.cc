@@ -0,0 +1,327 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/cache_segment_store.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace holytls {
+namespace http {
+
+namespace {
+
+constexpr uint32_t kRecordMagic = 0x48544331;  // "HTC1"
+constexpr uint32_t kTombstone = 0xFFFFFFFF;    // value_len of a removal
+
+constexpr std::string_view kSegmentPrefix = "segment-";
+constexpr std::string_view kSegmentSuffix = ".seg";
+
+// Precedes every record; written last so a torn append is never indexed
+struct RecordHeader {
+  uint32_t magic;
+  uint32_t key_len;
+  uint32_t value_len;  // kTombstone for removals
+  uint32_t checksum;   // FNV-1a of key and value
+};
+static_assert(sizeof(RecordHeader) == 16);
+
+size_t AlignRecord(size_t n) { return (n + 7) & ~size_t{7}; }
+
+uint32_t Checksum(std::string_view key, std::span<const uint8_t> value) {
+  uint32_t hash = 2166136261u;
+  for (char c : key) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  for (uint8_t b : value) {
+    hash = (hash ^ b) * 16777619u;
+  }
+  return hash;
+}
+
+}  // namespace
+
+CacheSegmentStore::CacheSegmentStore(std::string directory,
+                                     size_t segment_bytes, size_t max_bytes)
+    : directory_(std::move(directory)),
+      segment_bytes_(AlignRecord(segment_bytes)),
+      max_segments_(std::max<size_t>(1, max_bytes / segment_bytes_)) {}
+
+CacheSegmentStore::~CacheSegmentStore() {
+  for (const auto& segment : segments_) {
+    UnmapSegment(segment);
+  }
+}
+
+std::string CacheSegmentStore::SegmentPath(uint32_t id) const {
+  char name[16];
+  std::snprintf(name, sizeof(name), "%08x", id);
+  return directory_ + "/" + std::string(kSegmentPrefix) + name +
+         std::string(kSegmentSuffix);
+}
+
+bool CacheSegmentStore::MapSegment(uint32_t id, bool create,
+                                   Segment* segment) {
+#ifdef _WIN32
+  (void)id;
+  (void)create;
+  (void)segment;
+  return false;
+#else
+  std::string path = SegmentPath(id);
+  int fd = ::open(path.c_str(), O_RDWR | (create ? O_CREAT | O_TRUNC : 0),
+                  0600);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  bool sized =
+      create ? ::ftruncate(fd, static_cast<off_t>(segment_bytes_)) == 0
+             : ::fstat(fd, &st) == 0 &&
+                   static_cast<size_t>(st.st_size) == segment_bytes_;
+  void* base = MAP_FAILED;
+  if (sized) {
+    base = ::mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fd, 0);
+  }
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+  segment->id = id;
+  segment->base = static_cast<uint8_t*>(base);
+  segment->used = 0;
+  return true;
+#endif
+}
+
+void CacheSegmentStore::UnmapSegment(const Segment& segment) {
+#ifndef _WIN32
+  ::munmap(segment.base, segment_bytes_);
+#else
+  (void)segment;
+#endif
+}
+
+bool CacheSegmentStore::Open() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (open_) {
+    return true;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  if (ec) {
+    return false;
+  }
+
+  std::vector<uint32_t> ids;
+  for (std::filesystem::directory_iterator it(directory_, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    std::string name = it->path().filename().string();
+    if (!name.starts_with(kSegmentPrefix) || !name.ends_with(kSegmentSuffix)) {
+      continue;
+    }
+    const char* first = name.data() + kSegmentPrefix.size();
+    const char* last = name.data() + name.size() - kSegmentSuffix.size();
+    uint32_t id = 0;
+    auto [ptr, err] = std::from_chars(first, last, id, 16);
+    if (err == std::errc() && ptr == last) {
+      ids.push_back(id);
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+
+  // Keep the newest run of consecutive ids within budget
+  size_t keep_from = 0;
+  for (size_t i = 1; i < ids.size(); ++i) {
+    if (ids[i] != ids[i - 1] + 1) {
+      keep_from = i;
+    }
+  }
+  keep_from = std::max(keep_from,
+                       ids.size() > max_segments_ ? ids.size() - max_segments_
+                                                  : size_t{0});
+  for (size_t i = 0; i < ids.size(); ++i) {
+    Segment segment;
+    if (i < keep_from || !MapSegment(ids[i], false, &segment)) {
+      std::filesystem::remove(SegmentPath(ids[i]), ec);
+      continue;
+    }
+    IndexSegment(&segment);
+    segments_.push_back(segment);
+  }
+
+  open_ = segments_.empty() ? Roll() : true;
+  return open_;
+}
+
+void CacheSegmentStore::IndexSegment(Segment* segment) {
+  size_t offset = 0;
+  while (offset + sizeof(RecordHeader) <= segment_bytes_) {
+    RecordHeader header;
+    std::memcpy(&header, segment->base + offset, sizeof(header));
+    if (header.magic != kRecordMagic) {
+      break;
+    }
+    bool tombstone = header.value_len == kTombstone;
+    size_t value_len = tombstone ? 0 : header.value_len;
+    size_t record_len =
+        AlignRecord(sizeof(RecordHeader) + header.key_len + value_len);
+    if (record_len > segment_bytes_ - offset) {
+      break;
+    }
+    const uint8_t* key_ptr = segment->base + offset + sizeof(RecordHeader);
+    std::string_view key(reinterpret_cast<const char*>(key_ptr),
+                         header.key_len);
+    std::span<const uint8_t> value(key_ptr + header.key_len, value_len);
+    if (Checksum(key, value) != header.checksum) {
+      break;  // Torn write: everything after it is unreachable
+    }
+    if (tombstone) {
+      index_.erase(std::string(key));
+    } else {
+      index_[std::string(key)] = Location{
+          segment->id,
+          static_cast<uint32_t>(offset + sizeof(RecordHeader) + key.size()),
+          static_cast<uint32_t>(value_len)};
+    }
+    offset += record_len;
+  }
+  segment->used = offset;
+}
+
+bool CacheSegmentStore::Roll() {
+  Segment segment;
+  uint32_t id = segments_.empty() ? 0 : segments_.back().id + 1;
+  if (!MapSegment(id, true, &segment)) {
+    return false;
+  }
+  segments_.push_back(segment);
+
+  while (segments_.size() > max_segments_) {
+    const Segment& oldest = segments_.front();
+    std::erase_if(index_, [&oldest](const auto& entry) {
+      return entry.second.segment == oldest.id;
+    });
+    UnmapSegment(oldest);
+    std::error_code ec;
+    std::filesystem::remove(SegmentPath(oldest.id), ec);
+    segments_.pop_front();
+  }
+  return true;
+}
+
+const CacheSegmentStore::Segment* CacheSegmentStore::FindSegment(
+    uint32_t id) const {
+  // Ids are consecutive, oldest first
+  if (segments_.empty() || id < segments_.front().id) {
+    return nullptr;
+  }
+  size_t index = id - segments_.front().id;
+  return index < segments_.size() ? &segments_[index] : nullptr;
+}
+
+bool CacheSegmentStore::Append(std::string_view key,
+                               std::span<const uint8_t> value,
+                               bool tombstone) {
+  size_t record_len =
+      AlignRecord(sizeof(RecordHeader) + key.size() + value.size());
+  if (!open_ || record_len > segment_bytes_ || value.size() >= kTombstone) {
+    return false;
+  }
+  if (segments_.back().used + record_len > segment_bytes_ && !Roll()) {
+    return false;
+  }
+
+  Segment& segment = segments_.back();
+  uint8_t* record = segment.base + segment.used;
+  std::memcpy(record + sizeof(RecordHeader), key.data(), key.size());
+  if (!value.empty()) {
+    std::memcpy(record + sizeof(RecordHeader) + key.size(), value.data(),
+                value.size());
+  }
+  RecordHeader header{kRecordMagic, static_cast<uint32_t>(key.size()),
+                      tombstone ? kTombstone
+                                : static_cast<uint32_t>(value.size()),
+                      Checksum(key, value)};
+  std::memcpy(record, &header, sizeof(header));
+
+  if (tombstone) {
+    index_.erase(std::string(key));
+  } else {
+    index_[std::string(key)] = Location{
+        segment.id,
+        static_cast<uint32_t>(segment.used + sizeof(RecordHeader) +
+                              key.size()),
+        static_cast<uint32_t>(value.size())};
+  }
+  segment.used += record_len;
+  return true;
+}
+
+bool CacheSegmentStore::Put(std::string_view key,
+                            std::span<const uint8_t> value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Append(key, value, false);
+}
+
+bool CacheSegmentStore::Get(std::string_view key,
+                            std::vector<uint8_t>* value) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(std::string(key));
+  if (it == index_.end()) {
+    return false;
+  }
+  const Segment* segment = FindSegment(it->second.segment);
+  if (segment == nullptr) {
+    return false;
+  }
+  const uint8_t* data = segment->base + it->second.offset;
+  value->assign(data, data + it->second.length);
+  return true;
+}
+
+void CacheSegmentStore::Remove(std::string_view key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (index_.contains(std::string(key))) {
+    Append(key, {}, true);
+  }
+}
+
+void CacheSegmentStore::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::error_code ec;
+  for (const auto& segment : segments_) {
+    UnmapSegment(segment);
+    std::filesystem::remove(SegmentPath(segment.id), ec);
+  }
+  segments_.clear();
+  index_.clear();
+  if (open_) {
+    open_ = Roll();
+  }
+}
+
+size_t CacheSegmentStore::entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return index_.size();
+}
+
+size_t CacheSegmentStore::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return segments_.size() * segment_bytes_;
+}
+
+}  // namespace http
+}  // namespace holytls
@@ -0,0 +1,95 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// CacheSegmentStore - on-disk tier of the response cache.
+//
+// A log of fixed-size segment files, each memory-mapped. Records (key,
+// value) are appended to the newest segment; a key's latest record wins.
+// When the store is over its byte budget the oldest segment is dropped
+// whole, so eviction is FIFO by write time and never compacts. The index is
+// rebuilt by scanning the segments on Open(), so entries survive restarts.
+//
+// Thread-safe (one mutex). POSIX only; Open() fails on Windows.
+
+#ifndef HOLYTLS_HTTP_CACHE_SEGMENT_STORE_H_
+#define HOLYTLS_HTTP_CACHE_SEGMENT_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace holytls {
+namespace http {
+
+class CacheSegmentStore {
+ public:
+  // `segment_bytes` bounds a single record; `max_bytes` is rounded down to
+  // whole segments (at least one)
+  CacheSegmentStore(std::string directory, size_t segment_bytes,
+                    size_t max_bytes);
+  ~CacheSegmentStore();
+
+  // Non-copyable, non-movable
+  CacheSegmentStore(const CacheSegmentStore&) = delete;
+  CacheSegmentStore& operator=(const CacheSegmentStore&) = delete;
+
+  // Create the directory if needed and index the existing segments
+  bool Open();
+
+  // Append a record. Returns false if it does not fit in a segment.
+  bool Put(std::string_view key, std::span<const uint8_t> value);
+
+  // Copy out the latest value for `key`
+  bool Get(std::string_view key, std::vector<uint8_t>* value) const;
+
+  // Append a tombstone for `key`
+  void Remove(std::string_view key);
+
+  // Drop every segment
+  void Clear();
+
+  size_t entries() const;
+  size_t bytes() const;  // Mapped segment bytes on disk
+
+ private:
+  struct Segment {
+    uint32_t id = 0;
+    uint8_t* base = nullptr;
+    size_t used = 0;
+  };
+
+  struct Location {
+    uint32_t segment = 0;
+    uint32_t offset = 0;  // Of the value
+    uint32_t length = 0;
+  };
+
+  std::string SegmentPath(uint32_t id) const;
+  bool MapSegment(uint32_t id, bool create, Segment* segment);
+  void UnmapSegment(const Segment& segment);
+  void IndexSegment(Segment* segment);
+  bool Append(std::string_view key, std::span<const uint8_t> value,
+              bool tombstone);
+  bool Roll();  // Start a new segment, dropping the oldest if over budget
+  const Segment* FindSegment(uint32_t id) const;
+
+  std::string directory_;
+  size_t segment_bytes_;
+  size_t max_segments_;
+  bool open_ = false;
+
+  mutable std::mutex mutex_;
+  std::deque<Segment> segments_;  // Oldest first; back() is written to
+  std::unordered_map<std::string, Location> index_;
+};
+
+}  // namespace http
+}  // namespace holytls
+
+#endif  // HOLYTLS_HTTP_CACHE_SEGMENT_STORE_H_
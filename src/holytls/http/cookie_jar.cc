@@ -8,6 +8,7 @@
 #include <cctype>
 #include <cstring>
 
+#include "holytls/http/http_date.h"
 #include "holytls/util/sv_helpers.h"
 
 namespace holytls {
@@ -18,95 +19,6 @@ using util::EqualsIgnoreCase;
 using util::ToLower;
 using util::Trim;
 
-namespace {
-
-// Parse HTTP date formats (simplified - handles common formats)
-// Returns milliseconds since epoch, or 0 on failure
-uint64_t ParseHttpDate(std::string_view date) {
-  // This is a simplified parser - a full implementation would handle
-  // RFC 1123, RFC 850, and asctime formats
-  // For now, we'll just try to parse the most common format:
-  // "Wed, 09 Jun 2021 10:18:14 GMT"
-
-  static const char* kMonths[] = {"jan", "feb", "mar", "apr", "may", "jun",
-                                  "jul", "aug", "sep", "oct", "nov", "dec"};
-
-  // Skip day name if present
-  size_t pos = date.find(',');
-  if (pos != std::string_view::npos) {
-    date = Trim(date.substr(pos + 1));
-  }
-
-  // Parse: DD Mon YYYY HH:MM:SS
-  int day = 0, year = 0, hour = 0, min = 0, sec = 0;
-  int month = -1;
-
-  // Extract day
-  while (!date.empty() && std::isdigit(static_cast<unsigned char>(date[0]))) {
-    day = day * 10 + (date[0] - '0');
-    date.remove_prefix(1);
-  }
-  date = Trim(date);
-
-  // Extract month name
-  if (date.size() >= 3) {
-    std::string mon_str = ToLower(date.substr(0, 3));
-    for (int i = 0; i < 12; ++i) {
-      if (mon_str == kMonths[i]) {
-        month = i;
-        break;
-      }
-    }
-    date.remove_prefix(3);
-  }
-  date = Trim(date);
-
-  if (month < 0) return 0;
-
-  // Extract year
-  while (!date.empty() && std::isdigit(static_cast<unsigned char>(date[0]))) {
-    year = year * 10 + (date[0] - '0');
-    date.remove_prefix(1);
-  }
-  date = Trim(date);
-
-  // Handle 2-digit years
-  if (year < 100) {
-    year += (year < 70) ? 2000 : 1900;
-  }
-
-  // Extract time HH:MM:SS
-  if (date.size() >= 8) {
-    hour = (date[0] - '0') * 10 + (date[1] - '0');
-    min = (date[3] - '0') * 10 + (date[4] - '0');
-    sec = (date[6] - '0') * 10 + (date[7] - '0');
-  }
-
-  // Convert to timestamp (simplified - doesn't handle all edge cases)
-  // Days since epoch for each month start (non-leap year base)
-  static const int kDaysBeforeMonth[] = {0,   31,  59,  90,  120, 151,
-                                         181, 212, 243, 273, 304, 334};
-
-  // Calculate days since 1970
-  int64_t days = (year - 1970) * 365;
-  // Add leap years
-  days += (year - 1969) / 4;
-  days -= (year - 1901) / 100;
-  days += (year - 1601) / 400;
-  // Add days for months
-  days += kDaysBeforeMonth[month];
-  // Add leap day if applicable
-  if (month > 1 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
-    days += 1;
-  }
-  days += day - 1;
-
-  int64_t timestamp = days * 86400 + hour * 3600 + min * 60 + sec;
-  return static_cast<uint64_t>(timestamp) * 1000;
-}
-
-}  // namespace
-
 void CookieJar::ProcessSetCookie(std::string_view url,
                                  std::string_view header) {
   UrlParts parts;
@@ -230,12 +142,14 @@ void CookieJar::SetCookie(const Cookie& cookie) {
         existing.path == cookie.path) {
       // Update existing cookie
       existing = cookie;
+      UpdateMemoryCharge();
       return;
     }
   }
 
   // Add new cookie
   cookies_.push_back(cookie);
+  UpdateMemoryCharge();
 }
 
 void CookieJar::SetCookie(Cookie&& cookie) {
@@ -247,11 +161,13 @@ void CookieJar::SetCookie(Cookie&& cookie) {
         EqualsIgnoreCase(existing.domain, cookie.domain) &&
         existing.path == cookie.path) {
       existing = std::move(cookie);
+      UpdateMemoryCharge();
       return;
     }
   }
 
   cookies_.push_back(std::move(cookie));
+  UpdateMemoryCharge();
 }
 
 bool CookieJar::RemoveCookie(std::string_view name, std::string_view domain) {
@@ -264,6 +180,7 @@ bool CookieJar::RemoveCookie(std::string_view name, std::string_view domain) {
 
   if (it != cookies_.end()) {
     cookies_.erase(it, cookies_.end());
+    UpdateMemoryCharge();
     return true;
   }
   return false;
@@ -272,6 +189,7 @@ bool CookieJar::RemoveCookie(std::string_view name, std::string_view domain) {
 void CookieJar::ClearAll() {
   std::lock_guard<std::mutex> lock(mutex_);
   cookies_.clear();
+  UpdateMemoryCharge();
 }
 
 size_t CookieJar::ClearExpired() {
@@ -282,6 +200,7 @@ size_t CookieJar::ClearExpired() {
   auto it = std::remove_if(cookies_.begin(), cookies_.end(),
                            [now](const Cookie& c) { return c.IsExpired(now); });
   cookies_.erase(it, cookies_.end());
+  UpdateMemoryCharge();
 
   return before - cookies_.size();
 }
@@ -294,6 +213,7 @@ size_t CookieJar::ClearDomain(std::string_view domain) {
       cookies_.begin(), cookies_.end(),
       [&](const Cookie& c) { return EqualsIgnoreCase(c.domain, domain); });
   cookies_.erase(it, cookies_.end());
+  UpdateMemoryCharge();
 
   return before - cookies_.size();
 }
@@ -313,6 +233,21 @@ std::vector<Cookie> CookieJar::GetAllCookies() const {
   return cookies_;
 }
 
+void CookieJar::UpdateMemoryCharge() {
+  if constexpr (!memory::kMemoryAccountingEnabled) {
+    return;
+  }
+  // Jars are shared across reactors, so they count against the shared
+  // account rather than whichever thread touched them first
+  charge_.Bind(memory::SharedMemoryAccount());
+  size_t bytes = cookies_.capacity() * sizeof(Cookie);
+  for (const Cookie& cookie : cookies_) {
+    bytes += cookie.name.capacity() + cookie.value.capacity() +
+             cookie.domain.capacity() + cookie.path.capacity();
+  }
+  charge_.Set(bytes);
+}
+
 bool CookieJar::ParseUrl(std::string_view url, UrlParts* parts) {
   // Parse scheme
   size_t scheme_end = url.find("://");
@@ -0,0 +1,126 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/http_date.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include "holytls/util/sv_helpers.h"
+
+namespace holytls {
+namespace http {
+
+using util::ToLower;
+using util::Trim;
+
+uint64_t ParseHttpDate(std::string_view date) {
+  // This is a simplified parser - a full implementation would handle
+  // RFC 1123, RFC 850, and asctime formats
+  // For now, we'll just try to parse the most common format:
+  // "Wed, 09 Jun 2021 10:18:14 GMT"
+
+  static const char* kMonths[] = {"jan", "feb", "mar", "apr", "may", "jun",
+                                  "jul", "aug", "sep", "oct", "nov", "dec"};
+
+  // Skip day name if present
+  size_t pos = date.find(',');
+  if (pos != std::string_view::npos) {
+    date = Trim(date.substr(pos + 1));
+  }
+
+  // Parse: DD Mon YYYY HH:MM:SS
+  int day = 0, year = 0, hour = 0, min = 0, sec = 0;
+  int month = -1;
+
+  // Extract day
+  while (!date.empty() && std::isdigit(static_cast<unsigned char>(date[0]))) {
+    day = day * 10 + (date[0] - '0');
+    date.remove_prefix(1);
+  }
+  date = Trim(date);
+
+  // Extract month name
+  if (date.size() >= 3) {
+    std::string mon_str = ToLower(date.substr(0, 3));
+    for (int i = 0; i < 12; ++i) {
+      if (mon_str == kMonths[i]) {
+        month = i;
+        break;
+      }
+    }
+    date.remove_prefix(3);
+  }
+  date = Trim(date);
+
+  if (month < 0) return 0;
+
+  // Extract year
+  while (!date.empty() && std::isdigit(static_cast<unsigned char>(date[0]))) {
+    year = year * 10 + (date[0] - '0');
+    date.remove_prefix(1);
+  }
+  date = Trim(date);
+
+  // Handle 2-digit years
+  if (year < 100) {
+    year += (year < 70) ? 2000 : 1900;
+  }
+
+  // Extract time HH:MM:SS
+  if (date.size() >= 8) {
+    hour = (date[0] - '0') * 10 + (date[1] - '0');
+    min = (date[3] - '0') * 10 + (date[4] - '0');
+    sec = (date[6] - '0') * 10 + (date[7] - '0');
+  }
+
+  // Convert to timestamp (simplified - doesn't handle all edge cases)
+  // Days since epoch for each month start (non-leap year base)
+  static const int kDaysBeforeMonth[] = {0,   31,  59,  90,  120, 151,
+                                         181, 212, 243, 273, 304, 334};
+
+  // Calculate days since 1970
+  int64_t days = (year - 1970) * 365;
+  // Add leap years
+  days += (year - 1969) / 4;
+  days -= (year - 1901) / 100;
+  days += (year - 1601) / 400;
+  // Add days for months
+  days += kDaysBeforeMonth[month];
+  // Add leap day if applicable
+  if (month > 1 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+    days += 1;
+  }
+  days += day - 1;
+
+  int64_t timestamp = days * 86400 + hour * 3600 + min * 60 + sec;
+  return static_cast<uint64_t>(timestamp) * 1000;
+}
+
+uint64_t ParseRetryAfter(std::string_view value, uint64_t now_ms) {
+  value = Trim(value);
+  if (value.empty()) {
+    return 0;
+  }
+
+  if (std::isdigit(static_cast<unsigned char>(value[0]))) {
+    // Capped at a day; anything longer is as good as "not now"
+    constexpr uint64_t kMaxSeconds = 86400;
+    uint64_t seconds = 0;
+    for (char c : value) {
+      if (!std::isdigit(static_cast<unsigned char>(c))) {
+        return 0;
+      }
+      seconds = std::min(seconds * 10 + static_cast<uint64_t>(c - '0'),
+                         kMaxSeconds);
+    }
+    return seconds * 1000;
+  }
+
+  uint64_t at_ms = ParseHttpDate(value);
+  return at_ms > now_ms ? at_ms - now_ms : 0;
+}
+
+}  // namespace http
+}  // namespace holytls
@@ -0,0 +1,28 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// HTTP-date parsing shared by the cookie jar (Expires), the response
+// cache (Date, Expires, Last-Modified) and the client (Retry-After).
+
+#ifndef HOLYTLS_HTTP_HTTP_DATE_H_
+#define HOLYTLS_HTTP_HTTP_DATE_H_
+
+#include <cstdint>
+#include <string_view>
+
+namespace holytls {
+namespace http {
+
+// Parse HTTP date formats (simplified - handles common formats)
+// Returns milliseconds since epoch, or 0 on failure
+uint64_t ParseHttpDate(std::string_view date);
+
+// Delay in milliseconds requested by a Retry-After value (delay-seconds or
+// an HTTP-date, relative to `now_ms` since epoch). 0 when absent, invalid
+// or already past.
+uint64_t ParseRetryAfter(std::string_view value, uint64_t now_ms);
+
+}  // namespace http
+}  // namespace holytls
+
+#endif  // HOLYTLS_HTTP_HTTP_DATE_H_
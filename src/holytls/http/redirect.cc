@@ -0,0 +1,123 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/redirect.h"
+
+#include "holytls/util/sv_helpers.h"
+
+namespace holytls {
+namespace http {
+
+namespace {
+
+// scheme://host[:port] of `url` (port omitted when it is the default)
+std::string Origin(const util::ParsedUrl& url) {
+  std::string out = url.scheme + "://";
+  if (url.host.find(':') != std::string::npos) {
+    out += "[" + url.host + "]";  // IPv6 literal
+  } else {
+    out += url.host;
+  }
+  if (!((url.scheme == "https" && url.port == 443) ||
+        (url.scheme == "http" && url.port == 80))) {
+    out += ":" + std::to_string(url.port);
+  }
+  return out;
+}
+
+// RFC 3986 §5.2.4 on the path part of `ref` (query left untouched)
+std::string RemoveDotSegments(std::string_view ref) {
+  size_t query_start = ref.find('?');
+  std::string_view input = ref.substr(0, query_start);
+  std::string_view query =
+      query_start == std::string_view::npos ? "" : ref.substr(query_start);
+
+  std::string out;
+  while (!input.empty()) {
+    if (sv::StartsWith(input, "../")) {
+      input.remove_prefix(3);
+    } else if (sv::StartsWith(input, "./")) {
+      input.remove_prefix(2);
+    } else if (sv::StartsWith(input, "/./")) {
+      input.remove_prefix(2);
+    } else if (input == "/.") {
+      input = "/";
+    } else if (sv::StartsWith(input, "/../") || input == "/..") {
+      input = input.size() == 3 ? std::string_view("/") : input.substr(3);
+      size_t last = out.rfind('/');
+      out.resize(last == std::string::npos ? 0 : last);
+    } else if (input == "." || input == "..") {
+      input = {};
+    } else {
+      size_t next = input.find('/', 1);
+      out.append(input.substr(0, next));
+      input = next == std::string_view::npos ? "" : input.substr(next);
+    }
+  }
+  if (out.empty() || out.front() != '/') {
+    out.insert(out.begin(), '/');
+  }
+  out.append(query);
+  return out;
+}
+
+}  // namespace
+
+bool IsFollowableRedirect(int status_code) {
+  switch (status_code) {
+    case 301:
+    case 302:
+    case 303:
+    case 307:
+    case 308:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ResolveLocation(const util::ParsedUrl& base, std::string_view location,
+                     std::string* out) {
+  location = sv::Trim(location);
+  location = location.substr(0, location.find('#'));
+  if (location.empty()) {
+    return false;
+  }
+
+  // Absolute: a scheme before any path, query or fragment delimiter
+  size_t scheme_end = location.find("://");
+  if (scheme_end != std::string_view::npos &&
+      location.find_first_of("/?") > scheme_end) {
+    *out = std::string(location);
+    return true;
+  }
+
+  if (sv::StartsWith(location, "//")) {
+    *out = base.scheme + ":" + std::string(location);
+  } else if (location.front() == '/') {
+    *out = Origin(base) + RemoveDotSegments(location);
+  } else if (location.front() == '?') {
+    *out = Origin(base) + base.path + std::string(location);
+  } else {
+    // Relative path: merge with the base path's directory
+    std::string merged = base.path.substr(0, base.path.rfind('/') + 1);
+    merged.append(location);
+    *out = Origin(base) + RemoveDotSegments(merged);
+  }
+  return true;
+}
+
+bool RedirectRewritesToGet(int status_code, std::string_view method) {
+  if (status_code == 303) {
+    return method != "GET" && method != "HEAD";
+  }
+  return (status_code == 301 || status_code == 302) && method == "POST";
+}
+
+bool IsSameOrigin(const util::ParsedUrl& a, const util::ParsedUrl& b) {
+  return a.port == b.port && sv::EqualsIgnoreCase(a.scheme, b.scheme) &&
+         sv::EqualsIgnoreCase(a.host, b.host);
+}
+
+}  // namespace http
+}  // namespace holytls
@@ -0,0 +1,38 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Redirect helpers - Location resolution and method rewriting (RFC 9110
+// §15.4). Used by HttpClient to follow redirects on the reactor.
+
+#ifndef HOLYTLS_HTTP_REDIRECT_H_
+#define HOLYTLS_HTTP_REDIRECT_H_
+
+#include <string>
+#include <string_view>
+
+#include "holytls/util/url_parser.h"
+
+namespace holytls {
+namespace http {
+
+// 301, 302, 303, 307 and 308 (300 and 304 are not followed)
+bool IsFollowableRedirect(int status_code);
+
+// Resolve a Location value against the URL it was received for (RFC 3986
+// §5.2): absolute, scheme-relative, absolute-path, query-only and relative
+// references. The fragment is dropped since it never reaches the wire.
+// Returns false for an empty or unusable reference.
+bool ResolveLocation(const util::ParsedUrl& base, std::string_view location,
+                     std::string* out);
+
+// Whether the next hop switches to GET: 303 for anything but HEAD, and
+// 301/302 for POST (what browsers do, despite the RFC's leniency)
+bool RedirectRewritesToGet(int status_code, std::string_view method);
+
+// Same scheme, host and port
+bool IsSameOrigin(const util::ParsedUrl& a, const util::ParsedUrl& b);
+
+}  // namespace http
+}  // namespace holytls
+
+#endif  // HOLYTLS_HTTP_REDIRECT_H_
@@ -0,0 +1,130 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/request_headers.h"
+
+#include <cstring>
+#include <utility>
+
+#include "holytls/util/sv_helpers.h"
+
+namespace holytls {
+namespace http {
+
+RequestHeaders::~RequestHeaders() { Arena::Destroy(arena_); }
+
+RequestHeaders::RequestHeaders(RequestHeaders&& other) noexcept
+    : arena_(std::exchange(other.arena_, nullptr)),
+      entries_(std::exchange(other.entries_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      failed_(std::exchange(other.failed_, false)),
+      method_(other.method_),
+      scheme_(other.scheme_),
+      authority_(other.authority_),
+      path_(other.path_) {}
+
+RequestHeaders& RequestHeaders::operator=(RequestHeaders&& other) noexcept {
+  if (this != &other) {
+    Arena::Destroy(arena_);
+    arena_ = std::exchange(other.arena_, nullptr);
+    entries_ = std::exchange(other.entries_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+    failed_ = std::exchange(other.failed_, false);
+    method_ = other.method_;
+    scheme_ = other.scheme_;
+    authority_ = other.authority_;
+    path_ = other.path_;
+  }
+  return *this;
+}
+
+void RequestHeaders::Add(std::string_view name, std::string_view value) {
+  AddStatic(Copy(name), Copy(value));
+}
+
+void RequestHeaders::AddStatic(std::string_view name, std::string_view value) {
+  if (HOLYTLS_UNLIKELY(size_ == capacity_)) {
+    Grow();
+    if (size_ == capacity_) {
+      failed_ = true;  // Out of memory
+      return;
+    }
+  }
+  entries_[size_++] = {name, value};
+}
+
+void RequestHeaders::ApplyOrder(std::span<const std::string_view> order) {
+  uint32_t next = 0;
+  for (std::string_view name : order) {
+    for (uint32_t i = next; i < size_; ++i) {
+      if (sv::EqualsIgnoreCase(entries_[i].name, name)) {
+        // Rotate [next, i] right by one to keep the tail stable
+        HeaderView entry = entries_[i];
+        std::memmove(entries_ + next + 1, entries_ + next,
+                     (i - next) * sizeof(HeaderView));
+        entries_[next++] = entry;
+        break;
+      }
+    }
+  }
+}
+
+std::string_view RequestHeaders::Get(std::string_view name) const {
+  for (uint32_t i = 0; i < size_; ++i) {
+    if (sv::EqualsIgnoreCase(entries_[i].name, name)) {
+      return entries_[i].value;
+    }
+  }
+  return {};
+}
+
+bool RequestHeaders::Has(std::string_view name) const {
+  for (uint32_t i = 0; i < size_; ++i) {
+    if (sv::EqualsIgnoreCase(entries_[i].name, name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool RequestHeaders::EnsureArena() {
+  if (HOLYTLS_UNLIKELY(arena_ == nullptr)) {
+    arena_ = Arena::Create(kRequestHeadersBlockSize,
+                           memory::MemoryTag::kStreamBuffers);
+  }
+  return arena_ != nullptr;
+}
+
+std::string_view RequestHeaders::Copy(std::string_view s) {
+  if (s.empty()) {
+    return {};
+  }
+  char* dst = EnsureArena() ? PushArray(arena_, char, s.size()) : nullptr;
+  if (HOLYTLS_UNLIKELY(dst == nullptr)) {
+    failed_ = true;
+    return {};
+  }
+  std::memcpy(dst, s.data(), s.size());
+  return {dst, s.size()};
+}
+
+void RequestHeaders::Grow() {
+  if (!EnsureArena()) return;
+
+  // Old slots are abandoned in the arena; freed with the block
+  uint32_t new_capacity =
+      capacity_ == 0 ? kRequestHeadersInitialSlots : capacity_ * 2;
+  auto* slots = PushArray(arena_, HeaderView, new_capacity);
+  if (HOLYTLS_UNLIKELY(slots == nullptr)) return;
+
+  for (uint32_t i = 0; i < size_; ++i) {
+    slots[i] = entries_[i];
+  }
+  entries_ = slots;
+  capacity_ = new_capacity;
+}
+
+}  // namespace http
+}  // namespace holytls
@@ -0,0 +1,120 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// RequestHeaders - Arena-backed request header block.
+// Built once per request; every name and value is a string_view into the
+// block's arena (or caller-owned static storage), so the block can be handed
+// to H1 serialization and to nghttp2 with NO_COPY flags without re-copying.
+
+#ifndef HOLYTLS_HTTP_REQUEST_HEADERS_H_
+#define HOLYTLS_HTTP_REQUEST_HEADERS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "holytls/base/arena.h"
+
+namespace holytls {
+namespace http {
+
+// Initial arena block size for one request's headers (grows by chaining)
+inline constexpr size_t kRequestHeadersBlockSize = 2048;
+
+// Initial header slot count (grows by doubling inside the arena)
+inline constexpr uint32_t kRequestHeadersInitialSlots = 24;
+
+// Non-owning header entry
+struct HeaderView {
+  std::string_view name;
+  std::string_view value;
+};
+
+// The arena is created on first use, so an empty block costs no allocation.
+class RequestHeaders {
+ public:
+  RequestHeaders() = default;
+  ~RequestHeaders();
+
+  // Non-copyable, movable (views stay valid: arena blocks never move)
+  RequestHeaders(const RequestHeaders&) = delete;
+  RequestHeaders& operator=(const RequestHeaders&) = delete;
+  RequestHeaders(RequestHeaders&& other) noexcept;
+  RequestHeaders& operator=(RequestHeaders&& other) noexcept;
+
+  // Pseudo-headers (copied into the arena)
+  void SetMethod(std::string_view method) { method_ = Copy(method); }
+  void SetScheme(std::string_view scheme) { scheme_ = Copy(scheme); }
+  void SetAuthority(std::string_view authority) {
+    authority_ = Copy(authority);
+  }
+  void SetPath(std::string_view path) { path_ = Copy(path); }
+
+  // Same as above, but the caller guarantees the storage outlives the request
+  // (string literals, profile tables). No copy is made.
+  void SetMethodStatic(std::string_view method) { method_ = method; }
+  void SetSchemeStatic(std::string_view scheme) { scheme_ = scheme; }
+
+  // Append a header, copying name and value into the arena. The name keeps
+  // the caller's case: HTTP/1.1 writes it as given, H2 lowercases it on the
+  // wire (HTTP/2 forbids uppercase field names).
+  void Add(std::string_view name, std::string_view value);
+
+  // Append a header without copying (static storage only). Template names
+  // are lowercase; H2 copies and lowercases any other, H1 writes known
+  // lowercase names in Chrome's Title-Case.
+  void AddStatic(std::string_view name, std::string_view value);
+
+  // Append a header with a static name and a copied value
+  void AddStaticName(std::string_view name, std::string_view value) {
+    AddStatic(name, Copy(value));
+  }
+
+  // Stable in-place reorder: headers named in `order` move to the front in
+  // that order (case-insensitive, first occurrence); the rest keep their
+  // relative order at the end. No allocation.
+  void ApplyOrder(std::span<const std::string_view> order);
+
+  std::string_view method() const { return method_; }
+  std::string_view scheme() const { return scheme_; }
+  std::string_view authority() const { return authority_; }
+  std::string_view path() const { return path_; }
+
+  std::span<const HeaderView> headers() const { return {entries_, size_}; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // An allocation failed and a header or pseudo-header was dropped. The
+  // block must not be sent.
+  bool failed() const { return failed_; }
+
+  // Case-insensitive lookup
+  std::string_view Get(std::string_view name) const;
+  bool Has(std::string_view name) const;
+
+  // Backing arena (created on demand), for callers that want to build
+  // values in place. Returns nullptr on allocation failure.
+  Arena* arena() { return EnsureArena() ? arena_ : nullptr; }
+
+ private:
+  bool EnsureArena();
+  std::string_view Copy(std::string_view s);
+  void Grow();
+
+  Arena* arena_ = nullptr;
+  HeaderView* entries_ = nullptr;
+  uint32_t size_ = 0;
+  uint32_t capacity_ = 0;
+  bool failed_ = false;
+
+  std::string_view method_;
+  std::string_view scheme_;
+  std::string_view authority_;
+  std::string_view path_;
+};
+
+}  // namespace http
+}  // namespace holytls
+
+#endif  // HOLYTLS_HTTP_REQUEST_HEADERS_H_
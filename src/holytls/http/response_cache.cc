@@ -0,0 +1,564 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/response_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "holytls/http/cache_control.h"
+#include "holytls/http/cache_segment_store.h"
+#include "holytls/util/sv_helpers.h"
+
+namespace holytls {
+namespace http {
+
+namespace {
+
+using http2::HeaderId;
+
+constexpr uint32_t kEntryFormat = 1;  // Bumped when the layout changes
+
+// Queued disk writes hold their entries alive; past this many segments'
+// worth, new writes are dropped until the writer catches up
+constexpr size_t kMaxQueuedDiskSegments = 4;
+
+// Flat encoding of a CachedResponse for the disk tier
+class EntryWriter {
+ public:
+  void U8(uint8_t v) { out_.push_back(v); }
+  void U32(uint32_t v) { Raw(&v, sizeof(v)); }
+  void U64(uint64_t v) { Raw(&v, sizeof(v)); }
+  void Str(std::string_view s) {
+    U32(static_cast<uint32_t>(s.size()));
+    Raw(s.data(), s.size());
+  }
+  void Raw(const void* data, size_t len) {
+    auto* p = static_cast<const uint8_t*>(data);
+    out_.insert(out_.end(), p, p + len);
+  }
+  std::vector<uint8_t>& out() { return out_; }
+
+ private:
+  std::vector<uint8_t> out_;
+};
+
+class EntryReader {
+ public:
+  explicit EntryReader(std::span<const uint8_t> in) : in_(in) {}
+
+  bool U8(uint8_t* v) { return Raw(v, sizeof(*v)); }
+  bool U32(uint32_t* v) { return Raw(v, sizeof(*v)); }
+  bool U64(uint64_t* v) { return Raw(v, sizeof(*v)); }
+  bool Str(std::string_view* s) {
+    uint32_t len = 0;
+    if (!U32(&len) || len > in_.size() - pos_) {
+      return false;
+    }
+    *s = std::string_view(reinterpret_cast<const char*>(in_.data()) + pos_,
+                          len);
+    pos_ += len;
+    return true;
+  }
+  bool Bytes(size_t len, std::vector<uint8_t>* out) {
+    if (len > in_.size() - pos_) {
+      return false;
+    }
+    out->assign(in_.data() + pos_, in_.data() + pos_ + len);
+    pos_ += len;
+    return true;
+  }
+
+ private:
+  bool Raw(void* out, size_t len) {
+    if (len > in_.size() - pos_) {
+      return false;
+    }
+    std::memcpy(out, in_.data() + pos_, len);
+    pos_ += len;
+    return true;
+  }
+
+  std::span<const uint8_t> in_;
+  size_t pos_ = 0;
+};
+
+std::vector<uint8_t> Serialize(const CachedResponse& entry) {
+  EntryWriter w;
+  w.U32(kEntryFormat);
+  w.U32(static_cast<uint32_t>(entry.status_code));
+  w.U64(entry.response_time_ms);
+  w.U64(entry.initial_age_ms);
+  w.U64(entry.lifetime_ms);
+  w.U8(entry.no_cache ? 1 : 0);
+  w.U32(static_cast<uint32_t>(entry.vary.size()));
+  for (const auto& h : entry.vary) {
+    w.Str(h.name);
+    w.Str(h.value);
+  }
+  w.U32(static_cast<uint32_t>(entry.headers.size()));
+  for (auto [name, value] : entry.headers) {
+    w.Str(name);
+    w.Str(value);
+  }
+  w.U64(entry.body.size());
+  w.Raw(entry.body.data(), entry.body.size());
+  return std::move(w.out());
+}
+
+std::shared_ptr<CachedResponse> Deserialize(std::span<const uint8_t> blob) {
+  EntryReader r(blob);
+  auto entry = std::make_shared<CachedResponse>();
+  uint32_t format = 0;
+  uint32_t status = 0;
+  uint8_t no_cache = 0;
+  uint32_t count = 0;
+  if (!r.U32(&format) || format != kEntryFormat || !r.U32(&status) ||
+      !r.U64(&entry->response_time_ms) || !r.U64(&entry->initial_age_ms) ||
+      !r.U64(&entry->lifetime_ms) || !r.U8(&no_cache) || !r.U32(&count)) {
+    return nullptr;
+  }
+  entry->status_code = static_cast<int>(status);
+  entry->no_cache = no_cache != 0;
+
+  std::string_view name;
+  std::string_view value;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (!r.Str(&name) || !r.Str(&value)) {
+      return nullptr;
+    }
+    entry->vary.push_back({std::string(name), std::string(value)});
+  }
+
+  if (!r.U32(&count)) {
+    return nullptr;
+  }
+  http2::PackedHeadersBuilder builder;
+  builder.SetStatus(std::to_string(status));
+  for (uint32_t i = 0; i < count; ++i) {
+    if (!r.Str(&name) || !r.Str(&value)) {
+      return nullptr;
+    }
+    builder.Add(name, value);
+  }
+  entry->headers = builder.Build();
+
+  uint64_t body_len = 0;
+  if (!r.U64(&body_len) || !r.Bytes(body_len, &entry->body)) {
+    return nullptr;
+  }
+  return entry;
+}
+
+// Request Cache-Control, with Pragma: no-cache when it is absent
+CacheControl RequestCacheControl(const RequestHeaderLookup& request_header) {
+  std::string_view value = request_header("cache-control");
+  if (!value.empty()) {
+    return ParseCacheControl(value);
+  }
+  CacheControl cc;
+  cc.no_cache = request_header("pragma").find("no-cache") !=
+                std::string_view::npos;
+  return cc;
+}
+
+CacheControl ResponseCacheControl(const http2::PackedHeaders& headers) {
+  std::string_view value = headers.Get(HeaderId::kCacheControl);
+  if (!value.empty()) {
+    return ParseCacheControl(value);
+  }
+  CacheControl cc;
+  cc.no_cache = headers.Get(HeaderId::kPragma).find("no-cache") !=
+                std::string_view::npos;
+  return cc;
+}
+
+// Fill the freshness fields of `entry` from its headers
+Freshness SetFreshness(CachedResponse* entry, const CacheControl& cc,
+                       uint64_t request_time_ms, uint64_t response_time_ms) {
+  Freshness freshness =
+      ComputeFreshness(entry->headers, cc, request_time_ms, response_time_ms);
+  entry->response_time_ms = response_time_ms;
+  entry->initial_age_ms = freshness.initial_age_ms;
+  entry->lifetime_ms = freshness.lifetime_ms;
+  entry->no_cache = cc.no_cache;
+  return freshness;
+}
+
+}  // namespace
+
+size_t CachedResponse::ByteSize() const {
+  size_t bytes = sizeof(CachedResponse) + body.size();
+  for (auto [name, value] : headers) {
+    bytes += name.size() + value.size() + sizeof(http2::PackedEntry);
+  }
+  for (const auto& h : vary) {
+    bytes += sizeof(Header) + h.name.size() + h.value.size();
+  }
+  return bytes;
+}
+
+ResponseCache::ResponseCache(const ResponseCacheConfig& config)
+    : config_(config),
+      shard_budget_(config.max_memory_bytes /
+                    std::max<size_t>(1, config.shards)),
+      shards_(std::make_unique<Shard[]>(std::max<size_t>(1, config.shards))) {
+  config_.shards = std::max<size_t>(1, config.shards);
+  if (!config_.disk_path.empty()) {
+    disk_ = std::make_unique<CacheSegmentStore>(config_.disk_path,
+                                                config_.disk_segment_bytes,
+                                                config_.max_disk_bytes);
+    if (!disk_->Open()) {
+      disk_.reset();
+    } else {
+      disk_writer_ = std::thread(&ResponseCache::RunDiskWriter, this);
+    }
+  }
+}
+
+ResponseCache::~ResponseCache() {
+  // The writer drains the queue first, so stored entries survive a restart
+  if (disk_writer_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(disk_queue_mutex_);
+      disk_writer_stop_ = true;
+    }
+    disk_queue_cv_.notify_one();
+    disk_writer_.join();
+  }
+}
+
+bool ResponseCache::IsCacheableMethod(std::string_view method) {
+  return method == "GET";
+}
+
+uint64_t ResponseCache::NowMs() {
+  // Wall clock: freshness is compared against Date and Expires
+  auto now = std::chrono::system_clock::now();
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          now.time_since_epoch())
+          .count());
+}
+
+std::string ResponseCache::MakeKey(std::string_view method,
+                                   std::string_view url) {
+  url = url.substr(0, url.find('#'));
+  std::string key;
+  key.reserve(method.size() + 1 + url.size());
+  key.append(method);
+  key.push_back(' ');
+  key.append(url);
+  return key;
+}
+
+ResponseCache::Shard& ResponseCache::ShardFor(std::string_view key) {
+  return shards_[std::hash<std::string_view>{}(key) % config_.shards];
+}
+
+CacheLookup ResponseCache::Lookup(std::string_view method,
+                                  std::string_view url,
+                                  const RequestHeaderLookup& request_header) {
+  CacheControl request_cc = RequestCacheControl(request_header);
+  if (!IsCacheableMethod(method) || request_cc.no_store) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return {};
+  }
+
+  std::string key = MakeKey(method, url);
+  std::shared_ptr<const CachedResponse> entry;
+  {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      entry = it->second->entry;
+    }
+  }
+
+  // Memory miss: promote from disk
+  if (entry == nullptr && disk_ != nullptr) {
+    std::vector<uint8_t> blob;
+    if (disk_->Get(key, &blob)) {
+      entry = Deserialize(blob);
+      if (entry != nullptr) {
+        Insert(key, entry, false);
+      }
+    }
+  }
+
+  bool vary_matches =
+      entry != nullptr &&
+      std::ranges::all_of(entry->vary, [&request_header](const Header& h) {
+        return request_header(h.name) == h.value;
+      });
+  if (!vary_matches) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return {};
+  }
+
+  uint64_t now_ms = NowMs();
+  bool fresh = entry->IsFresh(now_ms) && !request_cc.no_cache;
+  if (request_cc.max_age >= 0 &&
+      entry->AgeMs(now_ms) > static_cast<uint64_t>(request_cc.max_age) * 1000) {
+    fresh = false;
+  }
+  (fresh ? hits_ : stale_).fetch_add(1, std::memory_order_relaxed);
+  return CacheLookup{std::move(entry), fresh};
+}
+
+bool ResponseCache::Store(std::string_view method, std::string_view url,
+                          const RequestHeaderLookup& request_header,
+                          int status_code,
+                          const http2::PackedHeaders& headers,
+                          std::span<const uint8_t> body,
+                          uint64_t request_time_ms) {
+  // Final, complete responses only (no 1xx, 206 or 304)
+  if (!IsCacheableMethod(method) || status_code < 200 || status_code == 206 ||
+      status_code == 304) {
+    return false;
+  }
+
+  std::string key = MakeKey(method, url);
+  CacheControl cc = ResponseCacheControl(headers);
+  if (cc.no_store || RequestCacheControl(request_header).no_store) {
+    Remove(key);
+    return false;
+  }
+
+  // Vary: * never matches a later request
+  std::string_view vary = headers.Get(HeaderId::kVary);
+  if (vary.find('*') != std::string_view::npos) {
+    return false;
+  }
+
+  // Authenticated responses only when explicitly allowed (§3.5)
+  if (!request_header("authorization").empty() && !cc.is_public &&
+      !cc.must_revalidate) {
+    return false;
+  }
+
+  auto entry = std::make_shared<CachedResponse>();
+  entry->status_code = status_code;
+  entry->headers = headers;
+  Freshness freshness =
+      SetFreshness(entry.get(), cc, request_time_ms, NowMs());
+  if (!freshness.explicit_lifetime && !cc.is_public && !cc.is_private &&
+      !IsHeuristicallyCacheable(status_code)) {
+    return false;
+  }
+
+  // Never fresh and nothing to revalidate with: storing it is pointless
+  if (!entry->HasValidator() && !entry->IsFresh(entry->response_time_ms)) {
+    return false;
+  }
+  if (body.size() > config_.max_entry_bytes) {
+    return false;
+  }
+
+  while (!vary.empty()) {
+    size_t comma = vary.find(',');
+    std::string name = util::ToLower(util::Trim(vary.substr(0, comma)));
+    vary = comma == std::string_view::npos ? "" : vary.substr(comma + 1);
+    if (!name.empty()) {
+      std::string value(request_header(name));
+      entry->vary.push_back({std::move(name), std::move(value)});
+    }
+  }
+  entry->body.assign(body.begin(), body.end());
+
+  Insert(key, std::move(entry), true);
+  stores_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+std::shared_ptr<const CachedResponse> ResponseCache::Revalidated(
+    std::string_view method, std::string_view url,
+    const std::shared_ptr<const CachedResponse>& entry,
+    const http2::PackedHeaders& headers, uint64_t request_time_ms) {
+  // Stored headers updated by those in the 304, except framing (§3.2)
+  auto updated_by_304 = [&headers](std::string_view name) {
+    for (auto [fresh_name, value] : headers) {
+      if (util::EqualsIgnoreCase(fresh_name, name)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  auto is_framing = [](std::string_view name) {
+    return util::EqualsIgnoreCase(name, "content-length");
+  };
+
+  http2::PackedHeadersBuilder builder;
+  builder.SetStatus(std::to_string(entry->status_code));
+  for (auto [name, value] : entry->headers) {
+    if (is_framing(name) || !updated_by_304(name)) {
+      builder.Add(name, value);
+    }
+  }
+  for (auto [name, value] : headers) {
+    if (!is_framing(name)) {
+      builder.Add(name, value);
+    }
+  }
+
+  auto updated = std::make_shared<CachedResponse>();
+  updated->status_code = entry->status_code;
+  updated->headers = builder.Build();
+  updated->body = entry->body;
+  updated->vary = entry->vary;
+  SetFreshness(updated.get(), ResponseCacheControl(updated->headers),
+               request_time_ms, NowMs());
+
+  Insert(MakeKey(method, url), updated, true);
+  revalidations_.fetch_add(1, std::memory_order_relaxed);
+  return updated;
+}
+
+void ResponseCache::Insert(const std::string& key,
+                           std::shared_ptr<const CachedResponse> entry,
+                           bool persist) {
+  size_t bytes = key.size() + entry->ByteSize();
+  if (persist && disk_ != nullptr) {
+    if (bytes <= config_.disk_segment_bytes) {
+      QueueDiskWrite(key, entry);
+    } else {
+      QueueDiskWrite(key, nullptr);  // Drop the older version it replaces
+    }
+  }
+
+  Shard& shard = ShardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    auto node = it->second;
+    shard.index.erase(it);
+    shard.bytes -= node->bytes;
+    shard.lru.erase(node);
+  }
+  if (bytes > shard_budget_) {
+    return;  // Too big for memory; the disk tier may still hold it
+  }
+
+  shard.lru.push_front(Node{key, std::move(entry), bytes});
+  shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+  shard.bytes += bytes;
+
+  // Evicted entries stay on disk (queued above)
+  while (shard.bytes > shard_budget_) {
+    Node& victim = shard.lru.back();
+    shard.index.erase(victim.key);
+    shard.bytes -= victim.bytes;
+    shard.lru.pop_back();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void ResponseCache::Remove(const std::string& key) {
+  {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      auto node = it->second;
+      shard.index.erase(it);
+      shard.bytes -= node->bytes;
+      shard.lru.erase(node);
+    }
+  }
+  if (disk_ != nullptr) {
+    QueueDiskWrite(key, nullptr);
+  }
+}
+
+void ResponseCache::QueueDiskWrite(
+    const std::string& key, std::shared_ptr<const CachedResponse> entry) {
+  size_t bytes = key.size() + (entry != nullptr ? entry->ByteSize() : 0);
+  {
+    std::lock_guard<std::mutex> lock(disk_queue_mutex_);
+    // Removals are always queued: dropping one could resurrect an entry
+    if (entry != nullptr &&
+        disk_queue_bytes_ + bytes >
+            kMaxQueuedDiskSegments * config_.disk_segment_bytes) {
+      disk_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    disk_queue_.push_back(DiskWrite{key, std::move(entry), bytes});
+    disk_queue_bytes_ += bytes;
+  }
+  disk_queue_cv_.notify_one();
+}
+
+void ResponseCache::RunDiskWriter() {
+  for (;;) {
+    DiskWrite write;
+    std::unique_lock<std::mutex> write_lock;
+    {
+      std::unique_lock<std::mutex> lock(disk_queue_mutex_);
+      disk_queue_cv_.wait(lock, [this] {
+        return disk_writer_stop_ || !disk_queue_.empty();
+      });
+      if (disk_queue_.empty()) {
+        return;  // Stopping, and drained
+      }
+      write = std::move(disk_queue_.front());
+      disk_queue_.pop_front();
+      disk_queue_bytes_ -= write.bytes;
+      write_lock = std::unique_lock<std::mutex>(disk_write_mutex_);
+    }
+
+    if (write.entry != nullptr) {
+      disk_->Put(write.key, Serialize(*write.entry));
+    } else {
+      disk_->Remove(write.key);
+    }
+  }
+}
+
+void ResponseCache::Invalidate(std::string_view url) {
+  Remove(MakeKey("GET", url));
+}
+
+void ResponseCache::Clear() {
+  for (size_t i = 0; i < config_.shards; ++i) {
+    Shard& shard = shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.lru.clear();
+    shard.bytes = 0;
+  }
+  if (disk_ != nullptr) {
+    std::lock_guard<std::mutex> lock(disk_queue_mutex_);
+    disk_queue_.clear();
+    disk_queue_bytes_ = 0;
+    std::lock_guard<std::mutex> write_lock(disk_write_mutex_);
+    disk_->Clear();
+  }
+}
+
+ResponseCacheStats ResponseCache::GetStats() const {
+  ResponseCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.stale = stale_.load(std::memory_order_relaxed);
+  stats.revalidations = revalidations_.load(std::memory_order_relaxed);
+  stats.stores = stores_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  stats.disk_dropped = disk_dropped_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < config_.shards; ++i) {
+    Shard& shard = shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.memory_entries += shard.index.size();
+    stats.memory_bytes += shard.bytes;
+  }
+  if (disk_ != nullptr) {
+    stats.disk_entries = disk_->entries();
+    stats.disk_bytes = disk_->bytes();
+  }
+  return stats;
+}
+
+}  // namespace http
+}  // namespace holytls
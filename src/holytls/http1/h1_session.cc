@@ -6,8 +6,12 @@
 #include <picohttpparser.h>
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 
+#include "holytls/base/arena.h"
+#include "holytls/http2/header_ids.h"
+
 namespace holytls {
 namespace http1 {
 
@@ -15,44 +19,55 @@ namespace {
 
 // Chrome's HTTP/1.1 header order (differs from HTTP/2)
 // These are the headers that come before user-specified headers
-constexpr std::string_view kChromeHeaderOrder[] = {
-    "Host",
-    "Connection",
-    "sec-ch-ua",
-    "sec-ch-ua-mobile",
-    "sec-ch-ua-platform",
-    "Upgrade-Insecure-Requests",
-    "User-Agent",
-    "Accept",
-    "Sec-Fetch-Site",
-    "Sec-Fetch-Mode",
-    "Sec-Fetch-User",
-    "Sec-Fetch-Dest",
-    "Accept-Encoding",
-    "Accept-Language",
+constexpr http2::HeaderId kChromeHeaderOrder[] = {
+    http2::HeaderId::kHost,
+    http2::HeaderId::kConnection,
+    http2::HeaderId::kSecChUa,
+    http2::HeaderId::kSecChUaMobile,
+    http2::HeaderId::kSecChUaPlatform,
+    http2::HeaderId::kUpgradeInsecureRequests,
+    http2::HeaderId::kUserAgent,
+    http2::HeaderId::kAccept,
+    http2::HeaderId::kSecFetchSite,
+    http2::HeaderId::kSecFetchMode,
+    http2::HeaderId::kSecFetchUser,
+    http2::HeaderId::kSecFetchDest,
+    http2::HeaderId::kAcceptEncoding,
+    http2::HeaderId::kAcceptLanguage,
 };
 
-// Case-insensitive header name comparison
-bool HeaderNameEquals(std::string_view a, std::string_view b) {
-  if (a.size() != b.size()) return false;
-  for (size_t i = 0; i < a.size(); ++i) {
-    char ca = a[i];
-    char cb = b[i];
-    if (ca >= 'A' && ca <= 'Z') ca += 32;
-    if (cb >= 'A' && cb <= 'Z') cb += 32;
-    if (ca != cb) return false;
+// Position in kChromeHeaderOrder by HeaderId (-1 if not Chrome-ordered)
+constexpr auto kChromeHeaderRank = [] {
+  std::array<int8_t, static_cast<size_t>(http2::HeaderId::kKnownCount)> rank{};
+  rank.fill(-1);
+  for (size_t i = 0; i < std::size(kChromeHeaderOrder); ++i) {
+    rank[static_cast<size_t>(kChromeHeaderOrder[i])] = static_cast<int8_t>(i);
   }
-  return true;
-}
+  return rank;
+}();
 
 // Find header order index (-1 if not in Chrome order)
-int HeaderOrderIndex(std::string_view name) {
-  for (size_t i = 0; i < std::size(kChromeHeaderOrder); ++i) {
-    if (HeaderNameEquals(name, kChromeHeaderOrder[i])) {
-      return static_cast<int>(i);
-    }
+int HeaderOrderIndex(http2::HeaderId id) {
+  auto index = static_cast<size_t>(id);
+  return index < kChromeHeaderRank.size() ? kChromeHeaderRank[index] : -1;
+}
+
+// Longest known header name (access-control-allow-credentials)
+constexpr size_t kMaxKnownNameLen = 32;
+
+// Template headers carry the lowercase names HTTP/2 needs. On HTTP/1.1
+// Chrome writes known headers in Title-Case, except the client hints, which
+// it sends lowercase. Names with any uppercase came from the caller and are
+// written as given.
+bool UseChromeCase(http2::HeaderId id, std::string_view name) {
+  if (id == http2::HeaderId::kCustom || id == http2::HeaderId::kSecChUa ||
+      id == http2::HeaderId::kSecChUaMobile ||
+      id == http2::HeaderId::kSecChUaPlatform ||
+      name.size() > kMaxKnownNameLen) {
+    return false;
   }
-  return -1;
+  return std::none_of(name.begin(), name.end(),
+                      [](char c) { return c >= 'A' && c <= 'Z'; });
 }
 
 }  // namespace
@@ -73,9 +88,42 @@ int32_t H1Session::SubmitRequest(const http2::H2Headers& headers,
                                  http2::H2StreamCallbacks stream_callbacks,
                                  std::span<const std::string_view> header_order,
                                  const uint8_t* body, size_t body_len) {
+  // Legacy entry point: view the owned strings without copying them again
+  Scratch scratch = ScratchBegin();
+  auto* views = PushArray(scratch.get(), http::HeaderView,
+                          headers.headers.size() + 1);
+  for (size_t i = 0; i < headers.headers.size(); ++i) {
+    views[i] = {headers.headers[i].name, headers.headers[i].value};
+  }
+
+  if (!BeginRequest(std::move(stream_callbacks))) {
+    return -1;
+  }
+  BuildRequest(headers.method, headers.authority, headers.path,
+               {views, headers.headers.size()}, !header_order.empty(), body,
+               body_len);
+  return current_stream_id_;
+}
+
+int32_t H1Session::SubmitRequest(const http::RequestHeaders& headers,
+                                 http2::H2StreamCallbacks stream_callbacks,
+                                 bool preserve_order, const uint8_t* body,
+                                 size_t body_len) {
+  if (headers.failed()) {
+    return -1;  // A header was dropped on allocation failure
+  }
+  if (!BeginRequest(std::move(stream_callbacks))) {
+    return -1;
+  }
+  BuildRequest(headers.method(), headers.authority(), headers.path(),
+               headers.headers(), preserve_order, body, body_len);
+  return current_stream_id_;
+}
+
+bool H1Session::BeginRequest(http2::H2StreamCallbacks stream_callbacks) {
   if (parse_state_ != ParseState::kIdle) {
     SetError("Cannot submit request while another is in flight");
-    return -1;
+    return false;
   }
 
   current_stream_id_++;
@@ -91,15 +139,14 @@ int32_t H1Session::SubmitRequest(const http2::H2Headers& headers,
   std::memset(&chunked_decoder_, 0, sizeof(chunked_decoder_));
   chunked_decoder_.consume_trailer = 1;
   recv_buffer_.clear();
-
-  BuildRequest(headers, header_order, body, body_len);
-
-  return current_stream_id_;
+  return true;
 }
 
-void H1Session::BuildRequest(const http2::H2Headers& headers,
-                             std::span<const std::string_view> header_order,
-                             const uint8_t* body, size_t body_len) {
+void H1Session::BuildRequest(std::string_view method,
+                             std::string_view authority, std::string_view path,
+                             std::span<const http::HeaderView> headers,
+                             bool preserve_order, const uint8_t* body,
+                             size_t body_len) {
   send_buffer_.Clear();
   send_offset_ = 0;
 
@@ -112,32 +159,32 @@ void H1Session::BuildRequest(const http2::H2Headers& headers,
   };
 
   // Request line: METHOD PATH HTTP/1.1\r\n
-  append_sv(headers.method);
+  append_sv(method);
   append_str(" ", 1);
-  append_sv(headers.path);
+  append_sv(path);
   append_str(" HTTP/1.1\r\n", 11);
 
-  if (!header_order.empty()) {
-    // Custom header order mode: use headers in order from h2_headers.headers
-    // The caller has already ordered them according to header_order
+  if (preserve_order) {
+    // Custom header order mode: headers arrive already ordered by the caller.
     // We just need to add Host if not present and Connection
     bool has_host = false;
     bool has_connection = false;
 
-    for (const auto& [name, value] : headers.headers) {
-      if (HeaderNameEquals(name, "host")) has_host = true;
-      if (HeaderNameEquals(name, "connection")) has_connection = true;
+    for (const auto& [name, value] : headers) {
+      http2::HeaderId id = http2::LookupHeaderId(name);
+      if (id == http2::HeaderId::kHost) has_host = true;
+      if (id == http2::HeaderId::kConnection) has_connection = true;
     }
 
     // Add Host first if not in headers (required for HTTP/1.1)
     if (!has_host) {
       append_str("Host: ", 6);
-      append_sv(headers.authority);
+      append_sv(authority);
       append_str("\r\n", 2);
     }
 
     // Write headers in the order they appear (caller's order)
-    for (const auto& [name, value] : headers.headers) {
+    for (const auto& [name, value] : headers) {
       append_sv(name);
       append_str(": ", 2);
       append_sv(value);
@@ -154,42 +201,70 @@ void H1Session::BuildRequest(const http2::H2Headers& headers,
       std::string_view name;
       std::string_view value;
       int order;
+      bool chrome_case;
     };
-    std::vector<HeaderEntry> sorted_headers;
+    Scratch scratch = ScratchBegin();
+    auto* sorted_headers =
+        PushArray(scratch.get(), HeaderEntry, headers.size() + 2);
+    size_t count = 0;
 
     // Add Host header (from authority)
-    sorted_headers.push_back(
-        {"Host", headers.authority, HeaderOrderIndex("Host")});
+    sorted_headers[count++] = {"Host", authority,
+                               HeaderOrderIndex(http2::HeaderId::kHost), false};
 
     // Add Connection header
-    sorted_headers.push_back(
-        {"Connection", "keep-alive", HeaderOrderIndex("Connection")});
+    sorted_headers[count++] = {
+        "Connection", "keep-alive",
+        HeaderOrderIndex(http2::HeaderId::kConnection), false};
 
     // Add all headers from the request
-    for (const auto& [name, value] : headers.headers) {
+    for (const auto& [name, value] : headers) {
+      http2::HeaderId id = http2::LookupHeaderId(name);
       // Skip host and connection as we already added them
-      if (HeaderNameEquals(name, "host") ||
-          HeaderNameEquals(name, "connection")) {
+      if (id == http2::HeaderId::kHost || id == http2::HeaderId::kConnection) {
         continue;
       }
-      sorted_headers.push_back({name, value, HeaderOrderIndex(name)});
+      sorted_headers[count++] = {name, value, HeaderOrderIndex(id),
+                                 UseChromeCase(id, name)};
     }
 
     // Sort: Chrome-ordered headers first (by order index), then others
-    // (order=-1) at end
-    std::stable_sort(sorted_headers.begin(), sorted_headers.end(),
-                     [](const HeaderEntry& a, const HeaderEntry& b) {
-                       if (a.order == -1 && b.order == -1) return false;
-                       if (a.order == -1) return false;
-                       if (b.order == -1) return true;
-                       return a.order < b.order;
-                     });
+    // (order=-1) at end. Insertion sort is stable and, unlike
+    // std::stable_sort, never allocates a temporary buffer.
+    auto before = [](const HeaderEntry& a, const HeaderEntry& b) {
+      if (a.order == -1) return false;
+      if (b.order == -1) return true;
+      return a.order < b.order;
+    };
+    for (size_t i = 1; i < count; ++i) {
+      HeaderEntry entry = sorted_headers[i];
+      size_t j = i;
+      while (j > 0 && before(entry, sorted_headers[j - 1])) {
+        sorted_headers[j] = sorted_headers[j - 1];
+        --j;
+      }
+      sorted_headers[j] = entry;
+    }
 
     // Write headers
-    for (const auto& entry : sorted_headers) {
-      append_sv(entry.name);
+    for (size_t i = 0; i < count; ++i) {
+      const HeaderEntry& entry = sorted_headers[i];
+      if (entry.chrome_case) {
+        char title[kMaxKnownNameLen];
+        bool word_start = true;
+        for (size_t c = 0; c < entry.name.size(); ++c) {
+          char ch = entry.name[c];
+          title[c] = word_start && ch >= 'a' && ch <= 'z'
+                         ? static_cast<char>(ch - 'a' + 'A')
+                         : ch;
+          word_start = ch == '-';
+        }
+        append_str(title, entry.name.size());
+      } else {
+        append_sv(entry.name);
+      }
       append_str(": ", 2);
-      append_sv(entry.value);
+      append_sv(sorted_headers[i].value);
       append_str("\r\n", 2);
     }
   }
@@ -270,12 +345,13 @@ int H1Session::ParseHeaders() {
     std::string_view name(headers[i].name, headers[i].name_len);
     std::string_view value(headers[i].value, headers[i].value_len);
 
-    headers_builder_.Add(name, value);
+    http2::HeaderId id = http2::LookupHeaderId(name);
+    headers_builder_.Add(id, name, value);
 
     // Check for Content-Length or Transfer-Encoding
-    if (HeaderNameEquals(name, "content-length")) {
+    if (id == http2::HeaderId::kContentLength) {
       content_length_ = std::stoull(std::string(value));
-    } else if (HeaderNameEquals(name, "transfer-encoding")) {
+    } else if (id == http2::HeaderId::kTransferEncoding) {
       if (value.find("chunked") != std::string_view::npos) {
         chunked_ = true;
       }
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "holytls/core/io_buffer.h"
+#include "holytls/http/request_headers.h"
 #include "holytls/http2/h2_stream.h"  // For H2Headers, H2StreamCallbacks
 #include "holytls/http2/packed_headers.h"
 
@@ -52,6 +53,14 @@ class H1Session {
                         std::span<const std::string_view> header_order = {},
                         const uint8_t* body = nullptr, size_t body_len = 0);
 
+  // Submit a request from an arena-backed header block.
+  // If preserve_order is set, headers are sent as ordered in the block.
+  // The request is serialized immediately; `headers` need not outlive the call.
+  int32_t SubmitRequest(const http::RequestHeaders& headers,
+                        http2::H2StreamCallbacks stream_callbacks,
+                        bool preserve_order = false,
+                        const uint8_t* body = nullptr, size_t body_len = 0);
+
   // Feed received data into the session (from TLS layer).
   // Returns bytes consumed, or -1 on error.
   ssize_t Receive(const uint8_t* data, size_t len);
@@ -76,10 +85,16 @@ class H1Session {
     kParsingChunked,  // Reading chunked body
   };
 
-  // Build HTTP/1.1 request string
-  void BuildRequest(const http2::H2Headers& headers,
-                    std::span<const std::string_view> header_order,
-                    const uint8_t* body, size_t body_len);
+  // Reset per-request parse state. Returns false if a request is in flight.
+  bool BeginRequest(http2::H2StreamCallbacks stream_callbacks);
+
+  // Build HTTP/1.1 request string.
+  // If preserve_order is set, headers are written as given; otherwise they
+  // are sorted into Chrome's HTTP/1.1 order.
+  void BuildRequest(std::string_view method, std::string_view authority,
+                    std::string_view path,
+                    std::span<const http::HeaderView> headers,
+                    bool preserve_order, const uint8_t* body, size_t body_len);
 
   // Parse response headers, returns bytes consumed or -1 on error, -2 if
   // incomplete
@@ -54,6 +54,33 @@ enum class FetchDest {
   kEmpty,     // fetch(), XHR
 };
 
+// Fetch metadata for one request - selects the Chrome header template
+struct FetchContext {
+  RequestType type = RequestType::kNavigation;
+  FetchSite site = FetchSite::kNone;
+  FetchMode mode = FetchMode::kNavigate;
+  FetchDest dest = FetchDest::kDocument;
+  bool user_activated = true;  // Adds sec-fetch-user for navigations
+
+  // Top-level document navigation (typed URL, link click)
+  static FetchContext Navigation(FetchSite site = FetchSite::kNone) {
+    return {RequestType::kNavigation, site, FetchMode::kNavigate,
+            FetchDest::kDocument, true};
+  }
+
+  // fetch() / XMLHttpRequest
+  static FetchContext Xhr(FetchSite site = FetchSite::kSameOrigin) {
+    return {RequestType::kXhr, site, FetchMode::kCors, FetchDest::kEmpty,
+            false};
+  }
+
+  // Script, stylesheet, image, font, ...
+  static FetchContext Subresource(FetchDest dest,
+                                  FetchSite site = FetchSite::kSameOrigin) {
+    return {RequestType::kSubresource, site, FetchMode::kNoCors, dest, false};
+  }
+};
+
 // Chrome header profile - defines default headers and their order
 struct ChromeHeaderProfile {
   ChromeVersion version;
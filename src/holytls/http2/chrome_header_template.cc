@@ -0,0 +1,141 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http2/chrome_header_template.h"
+
+#include <array>
+
+namespace holytls {
+namespace http2 {
+
+namespace {
+
+// Only the first 64 user headers can override template slots
+constexpr size_t kMaxOverridable = 64;
+
+size_t TemplateIndex(RequestType type) {
+  return static_cast<size_t>(type);
+}
+
+}  // namespace
+
+ChromeHeaderTemplates::ChromeHeaderTemplates(const ChromeHeaderProfile& profile,
+                                             std::string_view user_agent)
+    : sec_ch_ua_(static_cast<int>(profile.version)),
+      sec_ch_ua_mobile_(SecChUaGenerator::GetMobile(profile.sec_ch_ua_mobile)),
+      sec_ch_ua_platform_(profile.sec_ch_ua_platform),
+      user_agent_(user_agent.empty() ? std::string_view(profile.user_agent)
+                                     : user_agent),
+      accept_navigation_(profile.accept_navigation),
+      accept_xhr_(profile.accept_xhr),
+      accept_encoding_(profile.accept_encoding),
+      accept_language_(profile.accept_language) {
+  BuildTemplate(RequestType::kNavigation,
+                &templates_[TemplateIndex(RequestType::kNavigation)]);
+  BuildTemplate(RequestType::kSubresource,
+                &templates_[TemplateIndex(RequestType::kSubresource)]);
+  BuildTemplate(RequestType::kXhr,
+                &templates_[TemplateIndex(RequestType::kXhr)]);
+  BuildTemplate(RequestType::kWebSocket,
+                &templates_[TemplateIndex(RequestType::kWebSocket)]);
+}
+
+void ChromeHeaderTemplates::BuildTemplate(RequestType type,
+                                          Template* tmpl) const {
+  // Same wire order as BuildChromeHeaders / ChromeHeaderBuilder
+  bool navigation = type == RequestType::kNavigation;
+
+  tmpl->Push("sec-ch-ua", sec_ch_ua_.Get());
+  tmpl->Push("sec-ch-ua-mobile", sec_ch_ua_mobile_);
+  tmpl->Push("sec-ch-ua-platform", sec_ch_ua_platform_);
+  if (navigation) {
+    tmpl->Push("upgrade-insecure-requests", "1");
+  }
+  tmpl->Push("user-agent", user_agent_);
+  tmpl->Push("accept", navigation ? accept_navigation_ : accept_xhr_);
+  tmpl->Push("sec-fetch-site", {}, SlotKind::kFetchSite);
+  tmpl->Push("sec-fetch-mode", {}, SlotKind::kFetchMode);
+  if (navigation) {
+    tmpl->Push("sec-fetch-user", "?1", SlotKind::kFetchUser);
+  }
+  tmpl->Push("sec-fetch-dest", {}, SlotKind::kFetchDest);
+  tmpl->Push("referer", {}, SlotKind::kDynamic);
+  tmpl->Push("accept-encoding", accept_encoding_);
+  tmpl->Push("accept-language", accept_language_);
+  tmpl->Push("cookie", {}, SlotKind::kDynamic);
+}
+
+void ChromeHeaderTemplates::Apply(const FetchContext& ctx,
+                                  std::span<const Header> user_headers,
+                                  std::string_view cookie,
+                                  http::RequestHeaders* out) const {
+  const Template& tmpl = templates_[TemplateIndex(ctx.type)];
+  uint64_t consumed = 0;
+
+  // Intern user header names once; slots then match by id
+  size_t overridable = user_headers.size() < kMaxOverridable
+                           ? user_headers.size()
+                           : kMaxOverridable;
+  std::array<HeaderId, kMaxOverridable> user_ids;
+  for (size_t i = 0; i < overridable; ++i) {
+    user_ids[i] = LookupHeaderId(user_headers[i].name);
+  }
+
+  // Index of the first unconsumed user header with `id`, or `overridable`
+  auto find_user = [&](HeaderId id) -> size_t {
+    for (size_t i = 0; i < overridable; ++i) {
+      if (user_ids[i] == id && (consumed & (uint64_t{1} << i)) == 0) {
+        return i;
+      }
+    }
+    return overridable;
+  };
+
+  for (size_t s = 0; s < tmpl.size; ++s) {
+    const Slot& slot = tmpl.slots[s];
+
+    size_t user = overridable == 0 ? overridable : find_user(slot.id);
+    if (user < overridable) {
+      consumed |= uint64_t{1} << user;
+      out->AddStaticName(slot.name, user_headers[user].value);
+      continue;
+    }
+
+    switch (slot.kind) {
+      case SlotKind::kStatic:
+        out->AddStatic(slot.name, slot.value);
+        break;
+      case SlotKind::kFetchSite:
+        out->AddStatic(slot.name, FetchSiteToString(ctx.site));
+        break;
+      case SlotKind::kFetchMode:
+        out->AddStatic(slot.name, FetchModeToString(ctx.mode));
+        break;
+      case SlotKind::kFetchUser:
+        if (ctx.user_activated) {
+          out->AddStatic(slot.name, slot.value);
+        }
+        break;
+      case SlotKind::kFetchDest:
+        out->AddStatic(slot.name, FetchDestToString(ctx.dest));
+        break;
+      case SlotKind::kDynamic:
+        if (slot.id == HeaderId::kCookie && !cookie.empty()) {
+          out->AddStaticName(slot.name, cookie);
+        }
+        break;
+    }
+  }
+
+  // Remaining user headers go after the Chrome headers, in caller order
+  // (names keep the caller's case)
+  for (size_t i = 0; i < user_headers.size(); ++i) {
+    if (i < kMaxOverridable && (consumed & (uint64_t{1} << i)) != 0) {
+      continue;
+    }
+    out->Add(user_headers[i].name, user_headers[i].value);
+  }
+}
+
+}  // namespace http2
+}  // namespace holytls
@@ -0,0 +1,108 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#ifndef HOLYTLS_HTTP2_CHROME_HEADER_TEMPLATE_H_
+#define HOLYTLS_HTTP2_CHROME_HEADER_TEMPLATE_H_
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "holytls/http/request_headers.h"
+#include "holytls/http2/chrome_header_profile.h"
+#include "holytls/http2/header_ids.h"
+#include "holytls/http2/sec_ch_ua.h"
+#include "holytls/types.h"
+
+namespace holytls {
+namespace http2 {
+
+// Precomputed, immutable Chrome request header templates.
+//
+// Built once per client: every static value (user-agent, sec-ch-ua with a
+// session-stable GREASE brand, accept, accept-encoding, ...) is formatted at
+// construction and laid out in Chrome's wire order for each RequestType.
+// Per request, Apply() only copies views into a RequestHeaders block and
+// fills the dynamic slots (sec-fetch-* from static literals, referer, cookie,
+// user overrides). Identical static name/value bytes on every request keep
+// them in the HPACK dynamic table after the first request on a connection.
+//
+// Thread-safe after construction (read-only). Must outlive every
+// RequestHeaders it has been applied to: entries are referenced, not copied.
+class ChromeHeaderTemplates {
+ public:
+  // user_agent overrides the profile's User-Agent when non-empty
+  explicit ChromeHeaderTemplates(const ChromeHeaderProfile& profile,
+                                 std::string_view user_agent = {});
+
+  // Non-copyable, non-movable (RequestHeaders point into this object)
+  ChromeHeaderTemplates(const ChromeHeaderTemplates&) = delete;
+  ChromeHeaderTemplates& operator=(const ChromeHeaderTemplates&) = delete;
+  ChromeHeaderTemplates(ChromeHeaderTemplates&&) = delete;
+  ChromeHeaderTemplates& operator=(ChromeHeaderTemplates&&) = delete;
+
+  // Append Chrome headers for `ctx` to `out`, merged with user headers.
+  // A user header whose name matches a template slot (case-insensitive)
+  // replaces that slot's value in place, keeping Chrome's position; the
+  // remaining user headers follow in their original order. `cookie` fills
+  // the cookie slot when the user did not provide one.
+  void Apply(const FetchContext& ctx, std::span<const Header> user_headers,
+             std::string_view cookie, http::RequestHeaders* out) const;
+
+  const SecChUaGenerator& sec_ch_ua() const { return sec_ch_ua_; }
+
+ private:
+  // Where a slot's value comes from
+  enum class SlotKind : uint8_t {
+    kStatic,     // Fixed value formatted at construction
+    kFetchSite,  // FetchSiteToString(ctx.site)
+    kFetchMode,  // FetchModeToString(ctx.mode)
+    kFetchUser,  // "?1" when ctx.user_activated (navigation only)
+    kFetchDest,  // FetchDestToString(ctx.dest)
+    kDynamic,    // Only sent when the request provides a value
+  };
+
+  struct Slot {
+    std::string_view name;
+    std::string_view value;
+    SlotKind kind;
+    HeaderId id;  // For matching user overrides
+  };
+
+  // Upper bound on slots in one template
+  static constexpr size_t kMaxSlots = 16;
+
+  struct Template {
+    std::array<Slot, kMaxSlots> slots;
+    size_t size = 0;
+
+    void Push(std::string_view name, std::string_view value,
+              SlotKind kind = SlotKind::kStatic) {
+      slots[size++] = {name, value, kind, LookupHeaderId(name)};
+    }
+  };
+
+  static constexpr size_t kRequestTypeCount = 4;
+
+  void BuildTemplate(RequestType type, Template* tmpl) const;
+
+  SecChUaGenerator sec_ch_ua_;
+
+  // Owned static values (templates hold views into these)
+  std::string sec_ch_ua_mobile_;
+  std::string sec_ch_ua_platform_;
+  std::string user_agent_;
+  std::string accept_navigation_;
+  std::string accept_xhr_;
+  std::string accept_encoding_;
+  std::string accept_language_;
+
+  std::array<Template, kRequestTypeCount> templates_;
+};
+
+}  // namespace http2
+}  // namespace holytls
+
+#endif  // HOLYTLS_HTTP2_CHROME_HEADER_TEMPLATE_H_
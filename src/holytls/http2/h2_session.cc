@@ -5,6 +5,9 @@
 
 #include <cstring>
 
+#include "holytls/base/arena.h"
+#include "holytls/memory/memory_accounting.h"
+
 namespace holytls {
 namespace http2 {
 
@@ -42,11 +45,60 @@ nghttp2_nv MakeNvStatic(const char* name, size_t namelen,
   return nv;
 }
 
+bool HasUppercase(std::string_view s) {
+  for (char c : s) {
+    if (c >= 'A' && c <= 'Z') return true;
+  }
+  return false;
+}
+
+// Helper for views that outlive the submitted HEADERS frame (arena-backed
+// request headers). nghttp2 references both in place, except a name with
+// uppercase letters (AddStatic of a caller's name), which nghttp2 copies and
+// lowercases.
+nghttp2_nv MakeNvView(std::string_view name, std::string_view value) {
+  if (value.data() == nullptr) value = "";
+  nghttp2_nv nv;
+  nv.name = reinterpret_cast<uint8_t*>(const_cast<char*>(name.data()));
+  nv.namelen = name.size();
+  nv.value = reinterpret_cast<uint8_t*>(const_cast<char*>(value.data()));
+  nv.valuelen = value.size();
+  nv.flags = static_cast<uint8_t>(
+      HasUppercase(name)
+          ? NGHTTP2_NV_FLAG_NO_COPY_VALUE
+          : NGHTTP2_NV_FLAG_NO_COPY_NAME | NGHTTP2_NV_FLAG_NO_COPY_VALUE);
+  return nv;
+}
+
+// nghttp2 allocator charging session state and HPACK tables to the
+// reactor's memory account (memory accounting builds only)
+void* H2Malloc(size_t size, void*) {
+  return memory::TaggedAlloc(size, memory::MemoryTag::kH2Session);
+}
+
+void H2Free(void* ptr, void*) { memory::TaggedFree(ptr); }
+
+void* H2Calloc(size_t nmemb, size_t size, void*) {
+  void* ptr = memory::TaggedAlloc(nmemb * size, memory::MemoryTag::kH2Session);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, nmemb * size);
+  }
+  return ptr;
+}
+
+void* H2Realloc(void* ptr, size_t size, void*) {
+  return memory::TaggedRealloc(ptr, size, memory::MemoryTag::kH2Session);
+}
+
+nghttp2_mem kH2Mem = {nullptr, H2Malloc, H2Free, H2Calloc, H2Realloc};
+
 }  // namespace
 
 H2Session::H2Session(const ChromeH2Profile& profile,
                      H2SessionCallbacks callbacks)
-    : profile_(profile), callbacks_(std::move(callbacks)) {}
+    : profile_(profile), callbacks_(std::move(callbacks)) {
+  send_buffer_.SetMemoryTag(memory::MemoryTag::kH2Session);
+}
 
 H2Session::~H2Session() = default;
 
@@ -72,7 +124,9 @@ bool H2Session::Initialize() {
 
   // Create client session
   nghttp2_session* session_raw;
-  int rv = nghttp2_session_client_new(&session_raw, callbacks, this);
+  nghttp2_mem* mem = memory::kMemoryAccountingEnabled ? &kH2Mem : nullptr;
+  int rv = nghttp2_session_client_new3(&session_raw, callbacks, this, nullptr,
+                                       mem);
   nghttp2_session_callbacks_del(callbacks);
 
   if (rv != 0) {
@@ -133,6 +187,44 @@ int32_t H2Session::SubmitRequest(const H2Headers& headers,
   return stream_id;
 }
 
+int32_t H2Session::SubmitRequest(const http::RequestHeaders& headers,
+                                 H2StreamCallbacks stream_callbacks) {
+  if (!session_ || fatal_error_) {
+    return -1;
+  }
+  if (headers.failed()) {
+    // Not a session error: only this request lost headers
+    return -1;
+  }
+
+  // The nv array only has to live for the nghttp2_submit_request call
+  // (nghttp2 copies the array itself), so it comes from scratch memory.
+  Scratch scratch = ScratchBegin();
+  size_t nvlen = headers.size() + 4;
+  nghttp2_nv* nva = PushArray(scratch.get(), nghttp2_nv, nvlen);
+  if (nva == nullptr) {
+    SetError("Failed to allocate header array");
+    return -1;
+  }
+  BuildHeaderNvArray(headers, nva);
+
+  int32_t stream_id = nghttp2_submit_request(session_.get(), nullptr, nva,
+                                             nvlen, nullptr, nullptr);
+
+  if (stream_id < 0) {
+    SetError(std::string("Failed to submit request: ") +
+             nghttp2_strerror(stream_id));
+    return -1;
+  }
+
+  auto stream =
+      std::make_unique<H2Stream>(stream_id, std::move(stream_callbacks));
+  stream->MarkLocalClosed();
+  streams_[stream_id] = std::move(stream);
+
+  return stream_id;
+}
+
 ssize_t H2Session::Receive(const uint8_t* data, size_t len) {
   if (!session_ || fatal_error_) {
     return -1;
@@ -186,6 +278,14 @@ bool H2Session::WantsWrite() const {
          nghttp2_session_want_write(session_.get()) != 0;
 }
 
+bool H2Session::ResetStream(int32_t stream_id, uint32_t error_code) {
+  if (!session_) {
+    return false;
+  }
+  return nghttp2_submit_rst_stream(session_.get(), NGHTTP2_FLAG_NONE,
+                                   stream_id, error_code) == 0;
+}
+
 bool H2Session::CanSubmitRequest() const {
   if (!session_ || fatal_error_) {
     return false;
@@ -282,6 +382,19 @@ int H2Session::HandleFrameRecv(const nghttp2_frame* frame) {
       }
       break;
 
+    case NGHTTP2_SETTINGS:
+      if (callbacks_.on_settings) {
+        callbacks_.on_settings((frame->hd.flags & NGHTTP2_FLAG_ACK) != 0);
+      }
+      break;
+
+    case NGHTTP2_RST_STREAM:
+      if (callbacks_.on_rst_stream) {
+        callbacks_.on_rst_stream(frame->hd.stream_id,
+                                 frame->rst_stream.error_code);
+      }
+      break;
+
     default:
       break;
   }
@@ -431,6 +544,44 @@ std::vector<nghttp2_nv> H2Session::BuildHeaderNvArray(
   return nva;
 }
 
+void H2Session::BuildHeaderNvArray(const http::RequestHeaders& headers,
+                                   nghttp2_nv* out) {
+  // Same pseudo-header orders as above; all entries are zero-copy because
+  // the caller keeps the RequestHeaders arena alive until the stream closes.
+  nghttp2_nv method = MakeNvView(":method", headers.method());
+  nghttp2_nv authority = MakeNvView(":authority", headers.authority());
+  nghttp2_nv scheme = MakeNvView(":scheme", headers.scheme());
+  nghttp2_nv path = MakeNvView(":path", headers.path());
+
+  switch (profile_.pseudo_header_order) {
+    case ChromeH2Profile::PseudoHeaderOrder::kMASP:
+      out[0] = method;
+      out[1] = authority;
+      out[2] = scheme;
+      out[3] = path;
+      break;
+
+    case ChromeH2Profile::PseudoHeaderOrder::kMPAS:
+      out[0] = method;
+      out[1] = path;
+      out[2] = authority;
+      out[3] = scheme;
+      break;
+
+    case ChromeH2Profile::PseudoHeaderOrder::kMSPA:
+      out[0] = method;
+      out[1] = scheme;
+      out[2] = path;
+      out[3] = authority;
+      break;
+  }
+
+  size_t i = 4;
+  for (const auto& header : headers.headers()) {
+    out[i++] = MakeNvView(header.name, header.value);
+  }
+}
+
 void H2Session::SetError(const std::string& msg) {
   fatal_error_ = true;
   last_error_ = msg;
@@ -16,6 +16,7 @@
 #include <unordered_map>
 
 #include "holytls/core/io_buffer.h"
+#include "holytls/http/request_headers.h"
 #include "holytls/http2/chrome_h2_profile.h"
 #include "holytls/http2/h2_stream.h"
 #include "holytls/http2/packed_headers.h"
@@ -41,6 +42,12 @@ struct H2SessionCallbacks {
 
   // Called when GOAWAY is received
   std::function<void(int32_t last_stream_id, uint32_t error_code)> on_goaway;
+
+  // Called when SETTINGS (or its ACK) is received (optional, for tracing)
+  std::function<void(bool ack)> on_settings;
+
+  // Called when the peer resets a stream (optional, for tracing)
+  std::function<void(int32_t stream_id, uint32_t error_code)> on_rst_stream;
 };
 
 // HTTP/2 session wrapper with Chrome fingerprint impersonation.
@@ -67,6 +74,17 @@ class H2Session {
                         H2StreamCallbacks stream_callbacks,
                         const uint8_t* body = nullptr, size_t body_len = 0);
 
+  // Submit a request from an arena-backed header block (zero-copy).
+  // `headers` must stay alive until the stream closes: nghttp2 references
+  // the names and values in place.
+  // Returns stream ID on success, -1 on error.
+  int32_t SubmitRequest(const http::RequestHeaders& headers,
+                        H2StreamCallbacks stream_callbacks);
+
+  // Reset a stream (RST_STREAM with `error_code`). Its close callback
+  // still runs once the frame is written. Returns false on error.
+  bool ResetStream(int32_t stream_id, uint32_t error_code);
+
   // Feed received data into the session (from TLS layer).
   // Returns bytes consumed, or -1 on error.
   ssize_t Receive(const uint8_t* data, size_t len);
@@ -129,6 +147,9 @@ class H2Session {
   // Build nghttp2_nv array with Chrome's pseudo-header ordering
   std::vector<nghttp2_nv> BuildHeaderNvArray(const H2Headers& headers);
 
+  // Zero-copy variant; `out` must hold headers.size() + 4 entries
+  void BuildHeaderNvArray(const http::RequestHeaders& headers, nghttp2_nv* out);
+
   // Set error state
   void SetError(const std::string& msg);
 
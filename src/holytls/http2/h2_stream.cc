@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <cstdlib>
 
+#include "holytls/memory/memory_accounting.h"
+
 namespace holytls {
 namespace http2 {
 
@@ -72,6 +74,7 @@ bool H2Headers::Has(std::string_view name) const {
 H2Stream::H2Stream(int32_t id, H2StreamCallbacks callbacks)
     : stream_id(id), callbacks_(std::move(callbacks)) {
   state_ = H2StreamState::kOpen;
+  response_body_.SetMemoryTag(memory::MemoryTag::kResponseBodies);
 }
 
 H2Stream::~H2Stream() = default;
@@ -12,6 +12,7 @@
 #include "holytls/types.h"
 #include "holytls/core/io_buffer.h"
 #include "holytls/http2/packed_headers.h"
+#include "holytls/memory/slab_allocator.h"
 
 namespace holytls {
 namespace http2 {
@@ -64,7 +65,7 @@ struct H2StreamCallbacks {
 };
 
 // HTTP/2 stream - represents a single request/response pair
-class H2Stream {
+class H2Stream : public memory::SlabAllocated<H2Stream> {
  public:
   const int32_t stream_id;
 
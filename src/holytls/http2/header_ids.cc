@@ -3,8 +3,8 @@
 
 #include "holytls/http2/header_ids.h"
 
-#include <algorithm>
-#include <cctype>
+#include <array>
+#include <cstring>
 
 namespace holytls {
 namespace http2 {
@@ -72,176 +72,139 @@ constexpr std::string_view kHeaderNames[] = {
     "alt-svc",
     "link",
     "pragma",
+    "sec-ch-ua",
+    "sec-ch-ua-mobile",
+    "sec-ch-ua-platform",
+    "upgrade-insecure-requests",
+    "sec-fetch-site",
+    "sec-fetch-mode",
+    "sec-fetch-user",
+    "sec-fetch-dest",
+    "priority",
 };
 
 static_assert(sizeof(kHeaderNames) / sizeof(kHeaderNames[0]) ==
                   static_cast<size_t>(HeaderId::kKnownCount),
               "Header name table size mismatch");
 
-// Case-insensitive comparison
-bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
-  if (a.size() != b.size()) return false;
-  for (size_t i = 0; i < a.size(); ++i) {
-    if (std::tolower(static_cast<unsigned char>(a[i])) !=
-        std::tolower(static_cast<unsigned char>(b[i]))) {
-      return false;
-    }
-  }
-  return true;
+// Perfect hash over kHeaderNames, generated at compile time.
+//
+// The key is the name length plus four bytes (first, middle, fourth from
+// last, last), each folded with | 0x20 so case doesn't matter. The seed is
+// searched at compile time until every known name lands in its own slot;
+// a candidate is then confirmed with one case-folded compare.
+
+constexpr size_t kHashBits = 9;
+constexpr size_t kHashSlots = size_t{1} << kHashBits;
+constexpr uint8_t kEmptySlot = 0xFF;
+
+static_assert(static_cast<size_t>(HeaderId::kKnownCount) < kEmptySlot,
+              "Header ids must fit in a slot byte");
+
+constexpr uint32_t HashName(std::string_view name, uint32_t seed) {
+  constexpr uint32_t kPrime = 0x01000193;  // FNV-1a
+  size_t n = name.size();
+  auto byte = [&](size_t i) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(name[i]) | 0x20);
+  };
+  uint32_t h = seed ^ (static_cast<uint32_t>(n) * 0x9E3779B1u);
+  h = (h ^ byte(0)) * kPrime;
+  h = (h ^ byte(n / 2)) * kPrime;
+  h = (h ^ byte(n > 4 ? n - 4 : 0)) * kPrime;
+  h = (h ^ byte(n - 1)) * kPrime;
+  return h >> (32 - kHashBits);
 }
 
-}  // namespace
-
-HeaderId LookupHeaderId(std::string_view name) {
-  if (name.empty()) return HeaderId::kCustom;
-
-  // Fast path: dispatch on first character (lowercase)
-  int first = std::tolower(static_cast<unsigned char>(name[0]));
-
-  switch (first) {
-    case 'a':
-      if (EqualsIgnoreCase(name, "accept")) return HeaderId::kAccept;
-      if (EqualsIgnoreCase(name, "accept-charset"))
-        return HeaderId::kAcceptCharset;
-      if (EqualsIgnoreCase(name, "accept-encoding"))
-        return HeaderId::kAcceptEncoding;
-      if (EqualsIgnoreCase(name, "accept-language"))
-        return HeaderId::kAcceptLanguage;
-      if (EqualsIgnoreCase(name, "accept-ranges"))
-        return HeaderId::kAcceptRanges;
-      if (EqualsIgnoreCase(name, "access-control-allow-credentials"))
-        return HeaderId::kAccessControlAllowCredentials;
-      if (EqualsIgnoreCase(name, "access-control-allow-headers"))
-        return HeaderId::kAccessControlAllowHeaders;
-      if (EqualsIgnoreCase(name, "access-control-allow-methods"))
-        return HeaderId::kAccessControlAllowMethods;
-      if (EqualsIgnoreCase(name, "access-control-allow-origin"))
-        return HeaderId::kAccessControlAllowOrigin;
-      if (EqualsIgnoreCase(name, "access-control-expose-headers"))
-        return HeaderId::kAccessControlExposeHeaders;
-      if (EqualsIgnoreCase(name, "access-control-max-age"))
-        return HeaderId::kAccessControlMaxAge;
-      if (EqualsIgnoreCase(name, "access-control-request-headers"))
-        return HeaderId::kAccessControlRequestHeaders;
-      if (EqualsIgnoreCase(name, "access-control-request-method"))
-        return HeaderId::kAccessControlRequestMethod;
-      if (EqualsIgnoreCase(name, "age")) return HeaderId::kAge;
-      if (EqualsIgnoreCase(name, "allow")) return HeaderId::kAllow;
-      if (EqualsIgnoreCase(name, "alt-svc")) return HeaderId::kAltSvc;
-      if (EqualsIgnoreCase(name, "authorization"))
-        return HeaderId::kAuthorization;
-      break;
-
-    case 'c':
-      if (EqualsIgnoreCase(name, "cache-control"))
-        return HeaderId::kCacheControl;
-      if (EqualsIgnoreCase(name, "connection")) return HeaderId::kConnection;
-      if (EqualsIgnoreCase(name, "content-disposition"))
-        return HeaderId::kContentDisposition;
-      if (EqualsIgnoreCase(name, "content-encoding"))
-        return HeaderId::kContentEncoding;
-      if (EqualsIgnoreCase(name, "content-language"))
-        return HeaderId::kContentLanguage;
-      if (EqualsIgnoreCase(name, "content-length"))
-        return HeaderId::kContentLength;
-      if (EqualsIgnoreCase(name, "content-location"))
-        return HeaderId::kContentLocation;
-      if (EqualsIgnoreCase(name, "content-range"))
-        return HeaderId::kContentRange;
-      if (EqualsIgnoreCase(name, "content-security-policy"))
-        return HeaderId::kContentSecurityPolicy;
-      if (EqualsIgnoreCase(name, "content-type")) return HeaderId::kContentType;
-      if (EqualsIgnoreCase(name, "cookie")) return HeaderId::kCookie;
-      break;
-
-    case 'd':
-      if (EqualsIgnoreCase(name, "date")) return HeaderId::kDate;
-      break;
-
-    case 'e':
-      if (EqualsIgnoreCase(name, "etag")) return HeaderId::kEtag;
-      if (EqualsIgnoreCase(name, "expires")) return HeaderId::kExpires;
-      break;
-
-    case 'h':
-      if (EqualsIgnoreCase(name, "host")) return HeaderId::kHost;
-      break;
-
-    case 'i':
-      if (EqualsIgnoreCase(name, "if-match")) return HeaderId::kIfMatch;
-      if (EqualsIgnoreCase(name, "if-modified-since"))
-        return HeaderId::kIfModifiedSince;
-      if (EqualsIgnoreCase(name, "if-none-match"))
-        return HeaderId::kIfNoneMatch;
-      if (EqualsIgnoreCase(name, "if-range")) return HeaderId::kIfRange;
-      if (EqualsIgnoreCase(name, "if-unmodified-since"))
-        return HeaderId::kIfUnmodifiedSince;
-      break;
-
-    case 'k':
-      if (EqualsIgnoreCase(name, "keep-alive")) return HeaderId::kKeepAlive;
-      break;
+struct HashTable {
+  uint32_t seed = 0;
+  std::array<uint8_t, kHashSlots> slots{};
+};
 
-    case 'l':
-      if (EqualsIgnoreCase(name, "last-modified"))
-        return HeaderId::kLastModified;
-      if (EqualsIgnoreCase(name, "link")) return HeaderId::kLink;
-      if (EqualsIgnoreCase(name, "location")) return HeaderId::kLocation;
-      break;
+consteval HashTable BuildHashTable() {
+  // claimed[slot] == seed marks a slot taken under the current seed, so a
+  // failed seed costs no table reset
+  std::array<uint32_t, kHashSlots> claimed{};
+  for (uint32_t seed = 1; seed != 0; ++seed) {
+    bool ok = true;
+    for (size_t i = 0; i < std::size(kHeaderNames) && ok; ++i) {
+      uint32_t& owner = claimed[HashName(kHeaderNames[i], seed)];
+      ok = owner != seed;
+      owner = seed;
+    }
+    if (!ok) continue;
 
-    case 'o':
-      if (EqualsIgnoreCase(name, "origin")) return HeaderId::kOrigin;
-      break;
+    HashTable table;
+    table.seed = seed;
+    table.slots.fill(kEmptySlot);
+    for (size_t i = 0; i < std::size(kHeaderNames); ++i) {
+      table.slots[HashName(kHeaderNames[i], seed)] = static_cast<uint8_t>(i);
+    }
+    return table;
+  }
+  return {};
+}
 
-    case 'p':
-      if (EqualsIgnoreCase(name, "pragma")) return HeaderId::kPragma;
-      break;
+constexpr HashTable kHashTable = BuildHashTable();
 
-    case 'r':
-      if (EqualsIgnoreCase(name, "range")) return HeaderId::kRange;
-      if (EqualsIgnoreCase(name, "referer")) return HeaderId::kReferer;
-      if (EqualsIgnoreCase(name, "retry-after")) return HeaderId::kRetryAfter;
-      break;
+static_assert(kHashTable.seed != 0, "No perfect hash seed for header names");
 
-    case 's':
-      if (EqualsIgnoreCase(name, "server")) return HeaderId::kServer;
-      if (EqualsIgnoreCase(name, "set-cookie")) return HeaderId::kSetCookie;
-      if (EqualsIgnoreCase(name, "strict-transport-security"))
-        return HeaderId::kStrictTransportSecurity;
-      break;
+// Longest known name; anything longer is custom without hashing
+constexpr size_t kMaxKnownNameLen = [] {
+  size_t max = 0;
+  for (std::string_view name : kHeaderNames) {
+    max = name.size() > max ? name.size() : max;
+  }
+  return max;
+}();
+
+// Lowercase ASCII A-Z in all 8 bytes at once; other bytes pass through
+inline uint64_t FoldAscii(uint64_t x) {
+  constexpr uint64_t kOnes = 0x0101010101010101ULL;
+  constexpr uint64_t kHigh = 0x8080808080808080ULL;
+  uint64_t low7 = x & ~kHigh;
+  uint64_t ge_a = low7 + kOnes * (0x80 - 'A');      // high bit if >= 'A'
+  uint64_t gt_z = low7 + kOnes * (0x80 - 'Z' - 1);  // high bit if > 'Z'
+  uint64_t upper = ge_a & ~gt_z & ~x & kHigh;       // ASCII uppercase only
+  return x | (upper >> 2);                          // 0x80 >> 2 == 0x20
+}
 
-    case 't':
-      if (EqualsIgnoreCase(name, "transfer-encoding"))
-        return HeaderId::kTransferEncoding;
-      break;
+// Case-insensitive compare against a lowercase name of the same length,
+// 8 bytes per step
+inline bool EqualsLowercase(const char* a, const char* lower, size_t n) {
+  while (n >= 8) {
+    uint64_t va;
+    uint64_t vb;
+    std::memcpy(&va, a, 8);
+    std::memcpy(&vb, lower, 8);
+    if (FoldAscii(va) != vb) return false;
+    a += 8;
+    lower += 8;
+    n -= 8;
+  }
+  if (n == 0) return true;
+  uint64_t va = 0;
+  uint64_t vb = 0;
+  std::memcpy(&va, a, n);
+  std::memcpy(&vb, lower, n);
+  return FoldAscii(va) == vb;
+}
 
-    case 'u':
-      if (EqualsIgnoreCase(name, "upgrade")) return HeaderId::kUpgrade;
-      if (EqualsIgnoreCase(name, "user-agent")) return HeaderId::kUserAgent;
-      break;
+}  // namespace
 
-    case 'v':
-      if (EqualsIgnoreCase(name, "vary")) return HeaderId::kVary;
-      if (EqualsIgnoreCase(name, "via")) return HeaderId::kVia;
-      break;
+HeaderId LookupHeaderId(std::string_view name) {
+  if (name.empty() || name.size() > kMaxKnownNameLen) {
+    return HeaderId::kCustom;
+  }
 
-    case 'w':
-      if (EqualsIgnoreCase(name, "warning")) return HeaderId::kWarning;
-      if (EqualsIgnoreCase(name, "www-authenticate"))
-        return HeaderId::kWwwAuthenticate;
-      break;
+  uint8_t index = kHashTable.slots[HashName(name, kHashTable.seed)];
+  if (index == kEmptySlot) return HeaderId::kCustom;
 
-    case 'x':
-      if (EqualsIgnoreCase(name, "x-content-type-options"))
-        return HeaderId::kXContentTypeOptions;
-      if (EqualsIgnoreCase(name, "x-frame-options"))
-        return HeaderId::kXFrameOptions;
-      if (EqualsIgnoreCase(name, "x-xss-protection"))
-        return HeaderId::kXXssProtection;
-      break;
+  std::string_view known = kHeaderNames[index];
+  if (known.size() != name.size() ||
+      !EqualsLowercase(name.data(), known.data(), name.size())) {
+    return HeaderId::kCustom;
   }
-
-  return HeaderId::kCustom;
+  return static_cast<HeaderId>(index);
 }
 
 std::string_view HeaderIdToName(HeaderId id) {
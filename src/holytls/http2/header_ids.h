@@ -87,6 +87,17 @@ enum class HeaderId : uint8_t {
   kLink,              // link
   kPragma,            // pragma
 
+  // Client hints and fetch metadata (Chrome request headers)
+  kSecChUa,                  // sec-ch-ua
+  kSecChUaMobile,            // sec-ch-ua-mobile
+  kSecChUaPlatform,          // sec-ch-ua-platform
+  kUpgradeInsecureRequests,  // upgrade-insecure-requests
+  kSecFetchSite,             // sec-fetch-site
+  kSecFetchMode,             // sec-fetch-mode
+  kSecFetchUser,             // sec-fetch-user
+  kSecFetchDest,             // sec-fetch-dest
+  kPriority,                 // priority
+
   // Total count of known headers
   kKnownCount,
 
@@ -95,7 +106,9 @@ enum class HeaderId : uint8_t {
 };
 
 // Lookup header ID from name (case-insensitive).
-// Returns kCustom if not a known header.
+// Returns kCustom if not a known header. Shared by the HTTP/1.1, HTTP/2 and
+// HTTP/3 response parsers and by request header ordering: one perfect-hash
+// probe keyed on length and a few bytes, then one case-folded compare.
 HeaderId LookupHeaderId(std::string_view name);
 
 // Get canonical header name from ID.
@@ -141,11 +141,10 @@ std::string_view PackedHeaders::value(size_t index) const {
 
 // PackedHeadersBuilder implementation
 
-void PackedHeadersBuilder::Add(std::string_view name, std::string_view value) {
+void PackedHeadersBuilder::Add(HeaderId id, std::string_view name,
+                               std::string_view value) {
   if (pending_.size() >= kMaxPackedHeaders) return;
 
-  HeaderId id = LookupHeaderId(name);
-
   PendingEntry entry;
   entry.id = id;
   entry.value = value;
@@ -118,7 +118,12 @@ class PackedHeadersBuilder {
   PackedHeadersBuilder() = default;
 
   // Add a header (name will be interned if known)
-  void Add(std::string_view name, std::string_view value);
+  void Add(std::string_view name, std::string_view value) {
+    Add(LookupHeaderId(name), name, value);
+  }
+
+  // Add a header whose id the caller already looked up
+  void Add(HeaderId id, std::string_view name, std::string_view value);
 
   // Set status pseudo-header
   void SetStatus(std::string_view status);
@@ -29,7 +29,13 @@ BufferPool::BufferPool(const Config& config) {
   InitializeSizeClass(large_, kLargeBufferSize, config.large_count);
 }
 
-BufferPool::~BufferPool() = default;
+BufferPool::~BufferPool() {
+  for (SizeClass* sc : {&small_, &medium_, &large_}) {
+    for (auto& buffer : sc->free_list) {
+      FreeBuffer(buffer.release(), sc->buffer_size);
+    }
+  }
+}
 
 void BufferPool::InitializeSizeClass(SizeClass& sc, size_t buffer_size,
                                      size_t count) {
@@ -38,8 +44,24 @@ void BufferPool::InitializeSizeClass(SizeClass& sc, size_t buffer_size,
   sc.free_list.reserve(count);
 
   for (size_t i = 0; i < count; ++i) {
-    sc.free_list.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    sc.free_list.emplace_back(AllocateBuffer(buffer_size));
+  }
+}
+
+uint8_t* BufferPool::AllocateBuffer(size_t size) {
+  bytes_allocated_.fetch_add(size, std::memory_order_relaxed);
+  if constexpr (kMemoryAccountingEnabled) {
+    account_->Add(MemoryTag::kPoolMetadata, size);
   }
+  return new uint8_t[size];
+}
+
+void BufferPool::FreeBuffer(uint8_t* buffer, size_t size) {
+  bytes_allocated_.fetch_sub(size, std::memory_order_relaxed);
+  if constexpr (kMemoryAccountingEnabled) {
+    account_->Sub(MemoryTag::kPoolMetadata, size);
+  }
+  delete[] buffer;
 }
 
 PooledBuffer BufferPool::Acquire(size_t min_size) {
@@ -74,10 +96,12 @@ PooledBuffer BufferPool::Acquire(size_t min_size) {
   pool_misses_.fetch_add(1, std::memory_order_relaxed);
 
   size_t actual_size = std::max(min_size, kLargeBufferSize);
-  uint8_t* raw = new uint8_t[actual_size];
+  uint8_t* raw = AllocateBuffer(actual_size);
 
+  // Released through the pool so its byte count stays exact; sizes outside
+  // the classes are deleted there rather than kept
   BufferDeleter deleter;
-  deleter.pool = nullptr;  // Will be deleted, not returned to pool
+  deleter.pool = this;
   deleter.size = actual_size;
 
   return PooledBuffer(raw, deleter);
@@ -119,7 +143,7 @@ void BufferPool::Release(uint8_t* buffer, size_t size) {
     sc = &large_;
   } else {
     // Unknown size, just delete
-    delete[] buffer;
+    FreeBuffer(buffer, size);
     return;
   }
 
@@ -130,7 +154,7 @@ void BufferPool::Release(uint8_t* buffer, size_t size) {
     sc->free_list.push_back(std::unique_ptr<uint8_t[]>(buffer));
   } else {
     // Pool is oversized, just delete
-    delete[] buffer;
+    FreeBuffer(buffer, sc->buffer_size);
   }
 }
 
@@ -168,6 +192,7 @@ BufferPool::Stats BufferPool::GetStats() const {
   stats.pool_misses = pool_misses_.load(std::memory_order_relaxed);
   stats.fallback_allocations =
       fallback_allocations_.load(std::memory_order_relaxed);
+  stats.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
 
   return stats;
 }
@@ -11,6 +11,8 @@
 #include <mutex>
 #include <vector>
 
+#include "holytls/memory/memory_accounting.h"
+
 namespace holytls {
 namespace memory {
 
@@ -36,6 +38,8 @@ using PooledBuffer = std::unique_ptr<uint8_t[], BufferDeleter>;
 
 // Thread-safe buffer pool for network I/O operations.
 // Pre-allocates buffers of common sizes to reduce allocation overhead.
+// With memory accounting, every byte the pool owns (free or handed out) is
+// charged as pool metadata to the account current at construction.
 class BufferPool {
  public:
   // Configuration for pool sizes
@@ -75,6 +79,7 @@ class BufferPool {
     uint64_t pool_hits;
     uint64_t pool_misses;
     uint64_t fallback_allocations;  // Requests larger than kLargeBufferSize
+    uint64_t bytes_allocated;       // Owned by the pool, free or in use
   };
   Stats GetStats() const;
 
@@ -89,6 +94,8 @@ class BufferPool {
 
   void InitializeSizeClass(SizeClass& sc, size_t buffer_size, size_t count);
   PooledBuffer AcquireFromClass(SizeClass& sc);
+  uint8_t* AllocateBuffer(size_t size);
+  void FreeBuffer(uint8_t* buffer, size_t size);
 
   SizeClass small_;
   SizeClass medium_;
@@ -99,6 +106,9 @@ class BufferPool {
   std::atomic<uint64_t> pool_hits_{0};
   std::atomic<uint64_t> pool_misses_{0};
   std::atomic<uint64_t> fallback_allocations_{0};
+  std::atomic<uint64_t> bytes_allocated_{0};
+
+  MemoryAccount* account_ = CurrentMemoryAccount();
 };
 
 }  // namespace memory
@@ -0,0 +1,187 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/memory/memory_accounting.h"
+
+#include <cstdlib>
+
+#if HOLYTLS_MEMORY_ACCOUNTING
+#include <openssl/crypto.h>
+#endif
+
+namespace holytls {
+namespace memory {
+
+namespace {
+
+MemoryAccount g_shared_account;
+
+thread_local MemoryAccount* t_current_account = nullptr;
+
+// Prefix of every TaggedAlloc block; 16 bytes keeps malloc's alignment
+struct alignas(16) TaggedHeader {
+  MemoryAccount* account;
+  uint64_t size : 56;
+  uint64_t tag : 8;
+
+  MemoryTag memory_tag() const { return static_cast<MemoryTag>(tag); }
+};
+static_assert(sizeof(TaggedHeader) == 16);
+
+// Largest size the header records; no allocation can come near it
+constexpr uint64_t kMaxTaggedSize = (uint64_t{1} << 56) - 1;
+
+TaggedHeader* HeaderOf(void* ptr) {
+  return static_cast<TaggedHeader*>(ptr) - 1;
+}
+
+}  // namespace
+
+const char* MemoryTagName(MemoryTag tag) {
+  switch (tag) {
+    case MemoryTag::kTls:
+      return "tls";
+    case MemoryTag::kH2Session:
+      return "h2_session";
+    case MemoryTag::kStreamBuffers:
+      return "stream_buffers";
+    case MemoryTag::kResponseBodies:
+      return "response_bodies";
+    case MemoryTag::kDecompression:
+      return "decompression";
+    case MemoryTag::kDnsCache:
+      return "dns_cache";
+    case MemoryTag::kCookieJar:
+      return "cookie_jar";
+    case MemoryTag::kPoolMetadata:
+      return "pool_metadata";
+    case MemoryTag::kOther:
+    case MemoryTag::kCount:
+      break;
+  }
+  return "other";
+}
+
+void MemoryAccount::RaisePeak(std::atomic<size_t>& peak, size_t value) {
+  size_t seen = peak.load(std::memory_order_relaxed);
+  while (value > seen &&
+         !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryAccount::Add(MemoryTag tag, size_t bytes) {
+  Counter& counter = tags_[Index(tag)];
+  RaisePeak(counter.peak, counter.current.fetch_add(bytes, kRelaxed) + bytes);
+  RaisePeak(total_peak_, total_.fetch_add(bytes, kRelaxed) + bytes);
+}
+
+void MemoryAccount::Sub(MemoryTag tag, size_t bytes) {
+  tags_[Index(tag)].current.fetch_sub(bytes, kRelaxed);
+  total_.fetch_sub(bytes, kRelaxed);
+}
+
+MemoryAccount* SharedMemoryAccount() { return &g_shared_account; }
+
+MemoryAccount* CurrentMemoryAccount() {
+  return t_current_account != nullptr ? t_current_account : &g_shared_account;
+}
+
+void SetMemoryAccount(MemoryAccount* account) { t_current_account = account; }
+
+void* TaggedAlloc(size_t size, MemoryTag tag) {
+  if constexpr (!kMemoryAccountingEnabled) {
+    (void)tag;
+    return std::malloc(size);
+  }
+  if (size > kMaxTaggedSize) {
+    return nullptr;
+  }
+  auto* header =
+      static_cast<TaggedHeader*>(std::malloc(sizeof(TaggedHeader) + size));
+  if (header == nullptr) {
+    return nullptr;
+  }
+  header->account = CurrentMemoryAccount();
+  header->size = size & kMaxTaggedSize;
+  header->tag = static_cast<uint8_t>(tag);
+  header->account->Ref();
+  header->account->Add(tag, size);
+  return header + 1;
+}
+
+void* TaggedRealloc(void* ptr, size_t size, MemoryTag tag) {
+  if constexpr (!kMemoryAccountingEnabled) {
+    (void)tag;
+    return std::realloc(ptr, size);
+  }
+  if (ptr == nullptr) {
+    return TaggedAlloc(size, tag);
+  }
+  if (size > kMaxTaggedSize) {
+    return nullptr;
+  }
+  TaggedHeader* header = HeaderOf(ptr);
+  MemoryAccount* account = header->account;
+  size_t old_size = header->size;
+  MemoryTag old_tag = header->memory_tag();
+  auto* grown = static_cast<TaggedHeader*>(
+      std::realloc(header, sizeof(TaggedHeader) + size));
+  if (grown == nullptr) {
+    return nullptr;  // Original block (and its charge) untouched
+  }
+  // The block keeps the account and tag it was first charged to
+  account->Sub(old_tag, old_size);
+  account->Add(old_tag, size);
+  grown->size = size & kMaxTaggedSize;
+  return grown + 1;
+}
+
+void TaggedFree(void* ptr) {
+  if constexpr (!kMemoryAccountingEnabled) {
+    std::free(ptr);
+    return;
+  }
+  if (ptr == nullptr) {
+    return;
+  }
+  TaggedHeader* header = HeaderOf(ptr);
+  MemoryAccount* account = header->account;
+  account->Sub(header->memory_tag(), header->size);
+  std::free(header);
+  account->Unref();
+}
+
+size_t TaggedSize(void* ptr) {
+  if constexpr (!kMemoryAccountingEnabled) {
+    (void)ptr;
+    return 0;
+  }
+  return ptr != nullptr ? HeaderOf(ptr)->size : 0;
+}
+
+}  // namespace memory
+}  // namespace holytls
+
+#if HOLYTLS_MEMORY_ACCOUNTING
+// BoringSSL allocation hooks (see <openssl/mem.h>): all of its heap use is
+// charged as TLS to the account of the thread that allocated it. BoringSSL
+// only zeroes freed memory in its default allocator, so do it here.
+extern "C" {
+
+void* OPENSSL_memory_alloc(size_t size) {
+  return holytls::memory::TaggedAlloc(size, holytls::memory::MemoryTag::kTls);
+}
+
+size_t OPENSSL_memory_get_size(void* ptr) {
+  return holytls::memory::TaggedSize(ptr);
+}
+
+void OPENSSL_memory_free(void* ptr) {
+  if (ptr != nullptr) {
+    OPENSSL_cleanse(ptr, holytls::memory::TaggedSize(ptr));
+  }
+  holytls::memory::TaggedFree(ptr);
+}
+
+}  // extern "C"
+#endif
@@ -0,0 +1,280 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Optional memory accounting.
+//
+// When the library is built with HOLYTLS_MEMORY_ACCOUNTING=ON, long-lived
+// allocations are charged to a MemoryAccount under a subsystem tag. Each
+// reactor owns an account (installed as the thread's current account while
+// it runs), so usage, high-water marks and caps are per reactor. Objects
+// remember the account they were charged to, so a buffer created on one
+// thread and freed on another is still credited back correctly, and keep
+// it alive: an account outlives its owner until the last charge against it
+// is gone.
+//
+// Without the option, MemoryCharge is an empty type and TaggedAlloc is
+// plain malloc, so the instrumented code compiles to what it was before.
+
+#ifndef HOLYTLS_MEMORY_MEMORY_ACCOUNTING_H_
+#define HOLYTLS_MEMORY_MEMORY_ACCOUNTING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace holytls {
+namespace memory {
+
+#if defined(HOLYTLS_MEMORY_ACCOUNTING) && HOLYTLS_MEMORY_ACCOUNTING
+inline constexpr bool kMemoryAccountingEnabled = true;
+#else
+inline constexpr bool kMemoryAccountingEnabled = false;
+#endif
+
+// Subsystem an allocation is charged to
+enum class MemoryTag : uint8_t {
+  kTls,              // BoringSSL contexts, sessions and record buffers
+  kH2Session,        // nghttp2 session state and HPACK tables
+  kStreamBuffers,    // Request headers, HTTP/1.1 send buffers
+  kResponseBodies,   // Response bodies being received
+  kDecompression,    // zlib/brotli decoder state
+  kDnsCache,         // Resolver cache
+  kCookieJar,        // Stored cookies
+  kPoolMetadata,     // Connections, slabs, pooled I/O buffers
+  kOther,            // Arenas and anything untagged
+  kCount,
+};
+
+inline constexpr size_t kMemoryTagCount =
+    static_cast<size_t>(MemoryTag::kCount);
+
+const char* MemoryTagName(MemoryTag tag);
+
+// Usage counters for one owner (a reactor, or the shared account).
+// Charges may come from any thread; all counters are relaxed atomics.
+class alignas(64) MemoryAccount {
+ public:
+  MemoryAccount() = default;
+  MemoryAccount(const MemoryAccount&) = delete;
+  MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+  void Add(MemoryTag tag, size_t bytes);
+  void Sub(MemoryTag tag, size_t bytes);
+
+  // Charges can outlive the account's owner (the SSL_CTX is freed after
+  // the reactors, sessions sit in caches), so every tagged block and bound
+  // MemoryCharge holds a reference. The owner holds the first one; a heap
+  // account is deleted when its owner and all charges have dropped theirs
+  // (see MemoryAccountPtr). Accounts never released are never deleted.
+  void Ref() { refs_.fetch_add(1, kRelaxed); }
+  void Unref() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  size_t current(MemoryTag tag) const {
+    return tags_[Index(tag)].current.load(std::memory_order_relaxed);
+  }
+  size_t peak(MemoryTag tag) const {
+    return tags_[Index(tag)].peak.load(std::memory_order_relaxed);
+  }
+  size_t total() const { return total_.load(std::memory_order_relaxed); }
+  size_t total_peak() const {
+    return total_peak_.load(std::memory_order_relaxed);
+  }
+
+  // Hard cap in bytes (0 = unlimited). Checked by the backpressure points
+  // (new streams, request admission), never by the allocators.
+  void set_limit(size_t bytes) {
+    limit_.store(bytes, std::memory_order_relaxed);
+  }
+  size_t limit() const { return limit_.load(std::memory_order_relaxed); }
+
+  bool OverLimit() const {
+    size_t cap = limit();
+    return cap != 0 && total() >= cap;
+  }
+
+  // Held streams are opened once usage drops below 7/8 of the cap, so a
+  // connection does not flap around the limit
+  bool BelowResumeMark() const {
+    size_t cap = limit();
+    return cap == 0 || total() < cap - cap / 8;
+  }
+
+  // Backpressure events
+  void CountStreamPause() { streams_paused_.fetch_add(1, kRelaxed); }
+  void CountRejectedRequest() { requests_rejected_.fetch_add(1, kRelaxed); }
+  uint64_t streams_paused() const { return streams_paused_.load(kRelaxed); }
+  uint64_t requests_rejected() const {
+    return requests_rejected_.load(kRelaxed);
+  }
+
+ private:
+  static constexpr auto kRelaxed = std::memory_order_relaxed;
+
+  struct Counter {
+    std::atomic<size_t> current{0};
+    std::atomic<size_t> peak{0};
+  };
+
+  static size_t Index(MemoryTag tag) { return static_cast<size_t>(tag); }
+  static void RaisePeak(std::atomic<size_t>& peak, size_t value);
+
+  Counter tags_[kMemoryTagCount];
+  std::atomic<size_t> total_{0};
+  std::atomic<size_t> total_peak_{0};
+  std::atomic<size_t> limit_{0};
+  std::atomic<uint64_t> streams_paused_{0};
+  std::atomic<uint64_t> requests_rejected_{0};
+  std::atomic<size_t> refs_{1};
+};
+
+// Owner's reference to a heap-allocated account
+struct MemoryAccountUnref {
+  void operator()(MemoryAccount* account) const { account->Unref(); }
+};
+using MemoryAccountPtr = std::unique_ptr<MemoryAccount, MemoryAccountUnref>;
+
+// Account for allocations made outside any reactor (user threads, the
+// cookie jar, process-wide caches)
+MemoryAccount* SharedMemoryAccount();
+
+// Account charged by allocations on this thread. Defaults to the shared
+// account; reactor threads install their own.
+MemoryAccount* CurrentMemoryAccount();
+void SetMemoryAccount(MemoryAccount* account);
+
+// Installs an account for the current scope (e.g. while building
+// per-reactor objects on the main thread)
+class ScopedMemoryAccount {
+ public:
+  explicit ScopedMemoryAccount(MemoryAccount* account)
+      : saved_(CurrentMemoryAccount()) {
+    SetMemoryAccount(account);
+  }
+  ~ScopedMemoryAccount() { SetMemoryAccount(saved_); }
+  ScopedMemoryAccount(const ScopedMemoryAccount&) = delete;
+  ScopedMemoryAccount& operator=(const ScopedMemoryAccount&) = delete;
+
+ private:
+  MemoryAccount* saved_;
+};
+
+namespace detail {
+
+// A running charge held by an object: Set() moves the charged amount to
+// the object's current footprint. Bound to the thread's current account on
+// first use unless bound explicitly; holds a reference to it while bound.
+class TrackedCharge {
+ public:
+  TrackedCharge() = default;
+  explicit TrackedCharge(MemoryTag tag) : tag_(tag) {}
+  ~TrackedCharge() { Reset(); }
+
+  TrackedCharge(TrackedCharge&& other) noexcept
+      : account_(other.account_), bytes_(other.bytes_), tag_(other.tag_) {
+    other.account_ = nullptr;
+    other.bytes_ = 0;
+  }
+  TrackedCharge& operator=(TrackedCharge&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      account_ = other.account_;
+      bytes_ = other.bytes_;
+      tag_ = other.tag_;
+      other.account_ = nullptr;
+      other.bytes_ = 0;
+    }
+    return *this;
+  }
+  TrackedCharge(const TrackedCharge&) = delete;
+  TrackedCharge& operator=(const TrackedCharge&) = delete;
+
+  void Bind(MemoryAccount* account) {
+    if (bytes_ == 0 && account != account_) {
+      Reset();
+      account_ = account;
+      account_->Ref();
+    }
+  }
+
+  void Set(size_t bytes) {
+    if (bytes == bytes_) {
+      return;
+    }
+    if (account_ == nullptr) {
+      account_ = CurrentMemoryAccount();
+      account_->Ref();
+    }
+    if (bytes > bytes_) {
+      account_->Add(tag_, bytes - bytes_);
+    } else {
+      account_->Sub(tag_, bytes_ - bytes);
+    }
+    bytes_ = bytes;
+  }
+
+  // Re-tag, moving anything already charged to the new tag
+  void SetTag(MemoryTag tag) {
+    if (tag == tag_) {
+      return;
+    }
+    size_t bytes = bytes_;
+    Set(0);
+    tag_ = tag;
+    Set(bytes);
+  }
+
+  MemoryTag tag() const { return tag_; }
+  size_t bytes() const { return bytes_; }
+
+ private:
+  // Drop the charge and the account
+  void Reset() {
+    Set(0);
+    if (account_ != nullptr) {
+      account_->Unref();
+      account_ = nullptr;
+    }
+  }
+
+  MemoryAccount* account_ = nullptr;
+  size_t bytes_ = 0;
+  MemoryTag tag_ = MemoryTag::kOther;
+};
+
+class NullCharge {
+ public:
+  NullCharge() = default;
+  explicit NullCharge(MemoryTag) {}
+  void Bind(MemoryAccount*) {}
+  void Set(size_t) {}
+  void SetTag(MemoryTag) {}
+  MemoryTag tag() const { return MemoryTag::kOther; }
+  size_t bytes() const { return 0; }
+};
+
+}  // namespace detail
+
+using MemoryCharge = std::conditional_t<kMemoryAccountingEnabled,
+                                        detail::TrackedCharge,
+                                        detail::NullCharge>;
+
+// malloc/realloc/free that charge the current account under `tag`. The
+// size and account are kept in a small header, so C libraries whose free
+// callbacks do not pass a size (zlib, brotli, nghttp2) can use them.
+void* TaggedAlloc(size_t size, MemoryTag tag);
+void* TaggedRealloc(void* ptr, size_t size, MemoryTag tag);
+void TaggedFree(void* ptr);
+
+// Requested size of a TaggedAlloc block (0 when accounting is disabled)
+size_t TaggedSize(void* ptr);
+
+}  // namespace memory
+}  // namespace holytls
+
+#endif  // HOLYTLS_MEMORY_MEMORY_ACCOUNTING_H_
@@ -3,14 +3,39 @@
 
 #include "holytls/memory/slab_allocator.h"
 
-// Template implementations are in header.
-// This file exists for build system consistency and potential future
-// non-template utility functions.
+#include <atomic>
 
 namespace holytls {
 namespace memory {
+namespace detail {
+namespace {
 
-// Placeholder for any non-template utilities
+// Set once this thread's table is being destroyed. Trivially destructible,
+// so still readable from destructors that run after the table's.
+thread_local bool g_caches_gone = false;
 
+struct CacheTable {
+  std::vector<std::unique_ptr<SlabThreadCacheBase>> caches;
+
+  // Flagged before the caches go: objects they free meanwhile bypass them
+  ~CacheTable() { g_caches_gone = true; }
+};
+
+}  // namespace
+
+std::vector<std::unique_ptr<SlabThreadCacheBase>>* SlabThreadCaches() {
+  if (g_caches_gone) {
+    return nullptr;
+  }
+  thread_local CacheTable table;
+  return &table.caches;
+}
+
+size_t NextSlabAllocatorId() {
+  static std::atomic<size_t> next_id{0};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace detail
 }  // namespace memory
 }  // namespace holytls
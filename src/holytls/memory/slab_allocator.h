@@ -4,21 +4,52 @@
 #ifndef HOLYTLS_MEMORY_SLAB_ALLOCATOR_H_
 #define HOLYTLS_MEMORY_SLAB_ALLOCATOR_H_
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <mutex>
 #include <new>
-#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "holytls/base/arena.h"
+#include "holytls/memory/memory_accounting.h"
+
 namespace holytls {
 namespace memory {
 
+namespace detail {
+
+// One thread's cache for one allocator. Type-erased so a single
+// thread_local table serves every allocator.
+class SlabThreadCacheBase {
+ public:
+  virtual ~SlabThreadCacheBase() = default;
+};
+
+// This thread's caches, indexed by allocator id. Destroyed at thread exit,
+// which hands cached objects back to their allocators; nullptr from then
+// on (objects freed by later thread_local or static destructors).
+std::vector<std::unique_ptr<SlabThreadCacheBase>>* SlabThreadCaches();
+
+// Process-unique allocator id (never reused)
+size_t NextSlabAllocatorId();
+
+}  // namespace detail
+
 // Fixed-size slab allocator for efficient allocation of same-sized objects.
 // Reduces memory fragmentation and allocation overhead for hot paths.
 //
+// Thread-caching: each thread allocates from and frees to two magazines
+// of its own (arrays of kMagazineSize free slots), without locks or
+// atomic read-modify-writes. Only when both are empty (or both full) does
+// it trade one, whole, with the shared depot under a mutex. Objects may be
+// freed on a thread other than the one that allocated them. Slots are
+// rounded up to whole cache lines so objects never share one.
+//
 // Usage:
 //   SlabAllocator<Connection, 64> alloc;
 //   Connection* conn = alloc.Allocate();
@@ -27,11 +58,21 @@ namespace memory {
 template <typename T, size_t SlabSize = 64>
 class SlabAllocator {
  public:
-  SlabAllocator() { AllocateSlab(); }
+  // Free slots per magazine; a thread caches at most two magazines
+  static constexpr size_t kMagazineSize = 32;
+
+  SlabAllocator()
+      : depot_(std::make_shared<Depot>()),
+        id_(detail::NextSlabAllocatorId()) {}
 
   ~SlabAllocator() {
     // Note: Destructors are NOT called for objects still in slabs
-    // User must ensure all objects are deallocated before destruction
+    // User must ensure all objects are deallocated before destruction.
+    // Slabs are freed once every thread's cache has been handed back.
+    auto* caches = detail::SlabThreadCaches();
+    if (caches != nullptr && id_ < caches->size()) {
+      (*caches)[id_].reset();
+    }
   }
 
   // Non-copyable, non-movable (owns memory)
@@ -41,28 +82,37 @@ class SlabAllocator {
   SlabAllocator& operator=(SlabAllocator&&) = delete;
 
   // Allocate raw memory for one object (does not construct)
-  // Thread-safe: protected by mutex
+  // Thread-safe: lock-free unless this thread's cache is empty
   T* Allocate() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (free_list_.empty()) {
-      AllocateSlab();
+    ThreadCache* cache = LocalCache();
+    if (HOLYTLS_UNLIKELY(cache == nullptr)) {
+      return static_cast<T*>(depot_->TakeOne());
     }
-
-    T* ptr = free_list_.back();
-    free_list_.pop_back();
-    ++allocated_count_;
-    return ptr;
+    if (HOLYTLS_UNLIKELY(cache->loaded->count == 0)) {
+      cache->Refill();
+    }
+    cache->Count(1);
+    Magazine& magazine = *cache->loaded;
+    return static_cast<T*>(magazine.slots[--magazine.count]);
   }
 
   // Deallocate memory (does not destruct)
-  // Thread-safe: protected by mutex
+  // Thread-safe: lock-free unless this thread's cache is full
   void Deallocate(T* ptr) {
     if (ptr == nullptr) {
       return;
     }
-    std::lock_guard<std::mutex> lock(mutex_);
-    free_list_.push_back(ptr);
-    --allocated_count_;
+    ThreadCache* cache = LocalCache();
+    if (HOLYTLS_UNLIKELY(cache == nullptr)) {
+      depot_->GiveOne(ptr);
+      return;
+    }
+    if (HOLYTLS_UNLIKELY(cache->loaded->count == kMagazineSize)) {
+      cache->Drain();
+    }
+    cache->Count(-1);
+    Magazine& magazine = *cache->loaded;
+    magazine.slots[magazine.count++] = ptr;
   }
 
   // Construct object in-place
@@ -82,32 +132,255 @@ class SlabAllocator {
     Deallocate(ptr);
   }
 
-  // Statistics
-  size_t allocated_count() const { return allocated_count_; }
-  size_t free_count() const { return free_list_.size(); }
-  size_t slab_count() const { return slabs_.size(); }
-  size_t total_capacity() const { return slabs_.size() * SlabSize; }
+  // Statistics (take the depot lock; not for hot paths)
+  size_t allocated_count() const { return depot_->allocated_count(); }
+  size_t free_count() const { return total_capacity() - allocated_count(); }
+  size_t slab_count() const { return depot_->slab_count(); }
+  size_t total_capacity() const { return slab_count() * SlabSize; }
+
+  // Bytes one object occupies (sizeof(T) rounded up to cache lines)
+  static constexpr size_t slot_size() { return sizeof(Slot); }
 
  private:
-  // Storage type with proper alignment
-  using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
-  using SlabArray = std::array<Storage, SlabSize>;
+  // Storage for one object, padded to whole cache lines
+  struct alignas(std::max(kCacheLineSize, alignof(T))) Slot {
+    alignas(T) std::byte bytes[sizeof(T)];
+  };
+  using SlabArray = std::array<Slot, SlabSize>;
+
+  struct Magazine {
+    std::array<void*, kMagazineSize> slots;
+    size_t count = 0;
+  };
+
+  class ThreadCache;
+
+  // Shared store of magazines and the slabs behind them. Outlives the
+  // allocator while any thread's cache still refers to it.
+  class Depot {
+   public:
+    // Slabs serve every thread and outlive any one client (the typed
+    // allocators are process-wide), so they are charged to the shared
+    // account rather than whichever reactor first grows the depot
+    Depot() { charge_.Bind(SharedMemoryAccount()); }
+
+    // Trade an empty magazine for one holding free slots
+    std::unique_ptr<Magazine> TakeFull(std::unique_ptr<Magazine> empty) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!full_.empty()) {
+        empty_.push_back(std::move(empty));
+        std::unique_ptr<Magazine> full = std::move(full_.back());
+        full_.pop_back();
+        return full;
+      }
+
+      // None cached: carve fresh slots
+      while (empty->count < kMagazineSize) {
+        empty->slots[empty->count++] = Carve();
+      }
+      return empty;
+    }
+
+    // Trade a full magazine for an empty one
+    std::unique_ptr<Magazine> TakeEmpty(std::unique_ptr<Magazine> full) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      full_.push_back(std::move(full));
+      if (empty_.empty()) {
+        return std::make_unique<Magazine>();
+      }
+      std::unique_ptr<Magazine> empty = std::move(empty_.back());
+      empty_.pop_back();
+      return empty;
+    }
+
+    // One slot for a thread whose cache is gone (thread exit)
+    void* TakeOne() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      retired_allocated_++;
+      if (loose_.empty() && !full_.empty()) {
+        std::unique_ptr<Magazine> full = std::move(full_.back());
+        full_.pop_back();
+        loose_.insert(loose_.end(), full->slots.begin(),
+                      full->slots.begin() + full->count);
+        full->count = 0;
+        empty_.push_back(std::move(full));
+      }
+      if (loose_.empty()) {
+        return Carve();
+      }
+      void* slot = loose_.back();
+      loose_.pop_back();
+      return slot;
+    }
+
+    void GiveOne(void* slot) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      retired_allocated_--;
+      loose_.push_back(slot);
+    }
+
+    void Register(const ThreadCache* cache) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      caches_.push_back(cache);
+    }
+
+    // Take back a departing thread's magazines (partly full ones are
+    // fine for allocation) and its allocation count
+    void Unregister(const ThreadCache* cache,
+                    std::unique_ptr<Magazine> magazines[2]) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::erase(caches_, cache);
+      retired_allocated_ += cache->allocated();
+      for (int i = 0; i < 2; ++i) {
+        auto& list = magazines[i]->count > 0 ? full_ : empty_;
+        list.push_back(std::move(magazines[i]));
+      }
+    }
+
+    size_t allocated_count() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      int64_t allocated = retired_allocated_;
+      for (const ThreadCache* cache : caches_) {
+        allocated += cache->allocated();
+      }
+      return static_cast<size_t>(std::max<int64_t>(allocated, 0));
+    }
 
-  void AllocateSlab() {
-    auto slab = std::make_unique<SlabArray>();
+    size_t slab_count() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return slabs_.size();
+    }
+
+   private:
+    // Next never-used slot, from a new slab when the last is used up
+    void* Carve() {
+      if (carved_ == SlabSize) {
+        slabs_.push_back(std::make_unique<SlabArray>());
+        charge_.Set(slabs_.size() * sizeof(SlabArray));
+        carved_ = 0;
+      }
+      return &(*slabs_.back())[carved_++];
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Magazine>> full_;
+    std::vector<std::unique_ptr<Magazine>> empty_;
+    std::vector<std::unique_ptr<SlabArray>> slabs_;
+    size_t carved_ = SlabSize;  // Slots handed out of slabs_.back()
+    std::vector<void*> loose_;  // Freed without a thread cache
+
+    // Live thread caches, for allocated_count()
+    std::vector<const ThreadCache*> caches_;
+    int64_t retired_allocated_ = 0;
+
+    MemoryCharge charge_{MemoryTag::kPoolMetadata};
+  };
+
+  class ThreadCache : public detail::SlabThreadCacheBase {
+   public:
+    explicit ThreadCache(std::shared_ptr<Depot> depot)
+        : loaded(std::make_unique<Magazine>()),
+          previous(std::make_unique<Magazine>()),
+          depot_(std::move(depot)) {
+      depot_->Register(this);
+    }
+
+    ~ThreadCache() override {
+      std::unique_ptr<Magazine> magazines[2] = {std::move(loaded),
+                                                std::move(previous)};
+      depot_->Unregister(this, magazines);
+    }
+
+    // `loaded` is empty: switch to `previous`, or trade with the depot
+    void Refill() {
+      if (previous->count > 0) {
+        std::swap(loaded, previous);
+      } else {
+        loaded = depot_->TakeFull(std::move(loaded));
+      }
+    }
+
+    // `loaded` is full: switch to `previous`, or trade with the depot
+    void Drain() {
+      if (previous->count == 0) {
+        std::swap(loaded, previous);
+      } else {
+        previous = depot_->TakeEmpty(std::move(previous));
+        std::swap(loaded, previous);
+      }
+    }
+
+    // Only this thread writes; stats readers load it
+    void Count(int64_t delta) {
+      allocated_.store(allocated_.load(std::memory_order_relaxed) + delta,
+                       std::memory_order_relaxed);
+    }
+    int64_t allocated() const {
+      return allocated_.load(std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<Magazine> loaded;
+    std::unique_ptr<Magazine> previous;
 
-    // Add all slots to free list
-    for (size_t i = 0; i < SlabSize; ++i) {
-      free_list_.push_back(reinterpret_cast<T*>(&(*slab)[i]));
+   private:
+    std::shared_ptr<Depot> depot_;
+
+    // Allocations minus frees on this thread (negative when it frees
+    // objects allocated elsewhere)
+    std::atomic<int64_t> allocated_{0};
+  };
+
+  // This thread's cache, created on first use; nullptr after thread exit
+  ThreadCache* LocalCache() {
+    auto* caches = detail::SlabThreadCaches();
+    if (HOLYTLS_LIKELY(caches != nullptr && id_ < caches->size() &&
+                       (*caches)[id_])) {
+      return static_cast<ThreadCache*>((*caches)[id_].get());
+    }
+    if (caches == nullptr) {
+      return nullptr;
+    }
+    if (id_ >= caches->size()) {
+      caches->resize(id_ + 1);
+    }
+    (*caches)[id_] = std::make_unique<ThreadCache>(depot_);
+    return static_cast<ThreadCache*>((*caches)[id_].get());
+  }
+
+  std::shared_ptr<Depot> depot_;
+  size_t id_;
+};
+
+// Routes a type's new/delete through a process-wide SlabAllocator, so
+// std::make_unique and plain new keep working:
+//
+//   struct DnsRequest : memory::SlabAllocated<DnsRequest> { ... };
+//
+template <typename T, size_t SlabSize = 64>
+class SlabAllocated {
+ public:
+  static void* operator new(size_t size) {
+    // A derived type larger than T does not fit a slot
+    if (size != sizeof(T)) {
+      return ::operator new(size);
     }
+    return Slab().Allocate();
+  }
 
-    slabs_.push_back(std::move(slab));
+  static void operator delete(void* ptr, size_t size) {
+    if (size != sizeof(T)) {
+      ::operator delete(ptr);
+      return;
+    }
+    Slab().Deallocate(static_cast<T*>(ptr));
   }
 
-  mutable std::mutex mutex_;
-  std::vector<std::unique_ptr<SlabArray>> slabs_;
-  std::vector<T*> free_list_;
-  size_t allocated_count_ = 0;
+ private:
+  static SlabAllocator<T, SlabSize>& Slab() {
+    // Never destroyed: objects may be freed during static destruction
+    static auto* slab = new SlabAllocator<T, SlabSize>();
+    return *slab;
+  }
 };
 
 }  // namespace memory
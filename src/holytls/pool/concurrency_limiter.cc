@@ -0,0 +1,88 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/pool/concurrency_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace holytls {
+namespace pool {
+
+namespace {
+
+// Bounds on the latency gradient: at worst the limit halves per sample
+constexpr double kMinGradient = 0.5;
+constexpr double kMaxGradient = 1.0;
+
+// Baseline more than this many times the sample means the latency has come
+// back down after an overload; the baseline is pulled after it
+constexpr double kBaselineRecoveryRatio = 2.0;
+constexpr double kBaselineRecoveryDecay = 0.95;
+
+}  // namespace
+
+ConcurrencyLimiter::ConcurrencyLimiter(const ConcurrencyLimitConfig& config)
+    : config_(config) {
+  config_.min_limit = std::max<size_t>(config_.min_limit, 1);
+  config_.max_limit = std::max(config_.max_limit, config_.min_limit);
+  config_.smoothing = std::clamp(config_.smoothing, 0.01, 1.0);
+  config_.backoff_ratio = std::clamp(config_.backoff_ratio, 0.1, 1.0);
+  limit_ = static_cast<double>(std::clamp(
+      config_.initial_limit, config_.min_limit, config_.max_limit));
+}
+
+void ConcurrencyLimiter::OnSample(uint64_t now_ms, uint64_t rtt_us,
+                                  size_t in_flight) {
+  if (rtt_us == 0) {
+    return;
+  }
+  last_rtt_us_ = rtt_us;
+
+  // Plain mean over the first samples, then a slow EWMA
+  auto sample = static_cast<double>(rtt_us);
+  ++samples_;
+  double window = samples_ <= kWarmupSamples ? static_cast<double>(samples_)
+                                             : kLongWindow;
+  long_rtt_us_ += (sample - long_rtt_us_) / window;
+  if (long_rtt_us_ > sample * kBaselineRecoveryRatio) {
+    long_rtt_us_ *= kBaselineRecoveryDecay;
+  }
+
+  // Too few requests in flight to tell anything about the origin
+  if (static_cast<double>(in_flight) * 2 < limit_) {
+    return;
+  }
+
+  double gradient = std::clamp(config_.rtt_tolerance * long_rtt_us_ / sample,
+                               kMinGradient, kMaxGradient);
+  double estimate = limit_ * gradient + std::sqrt(limit_);
+  estimate = limit_ * (1.0 - config_.smoothing) + estimate * config_.smoothing;
+  if (Held(now_ms)) {
+    estimate = std::min(estimate, limit_);
+  }
+  limit_ = std::clamp(estimate, static_cast<double>(config_.min_limit),
+                      static_cast<double>(config_.max_limit));
+}
+
+void ConcurrencyLimiter::OnDrop(uint64_t now_ms, uint64_t retry_after_ms) {
+  if (retry_after_ms > 0) {
+    hold_until_ms_ = std::max(hold_until_ms_, now_ms + retry_after_ms);
+  }
+
+  // Requests shed in one burst were all sent before the first cut took
+  // effect; count them as one
+  uint64_t window_ms = std::max<uint64_t>(baseline_rtt_us() / 1000, 1);
+  if (dropped_ && now_ms - last_drop_ms_ < window_ms) {
+    return;
+  }
+  dropped_ = true;
+  last_drop_ms_ = now_ms;
+  ++drops_;
+
+  limit_ = std::max(limit_ * config_.backoff_ratio,
+                    static_cast<double>(config_.min_limit));
+}
+
+}  // namespace pool
+}  // namespace holytls
@@ -64,7 +64,7 @@ bool ConnectionPool::IsQuicEnabled() const {
 
 // Protocol-agnostic connection acquisition
 AnyPooledConnection ConnectionPool::AcquireAnyConnection(
-    const std::string& host, uint16_t port) {
+    const std::string& host, uint16_t port, uint8_t urgency) {
   switch (config_.protocol) {
     case ProtocolPreference::kHttp3Only:
 #if HOLYTLS_QUIC_AVAILABLE
@@ -83,12 +83,12 @@ AnyPooledConnection ConnectionPool::AcquireAnyConnection(
       }
 #endif
       // Fall through to TCP
-      return AcquireTcpConnection(host, port);
+      return AcquireTcpConnection(host, port, urgency);
 
     case ProtocolPreference::kHttp2Preferred:
     case ProtocolPreference::kHttp1Only:
     default:
-      return AcquireTcpConnection(host, port);
+      return AcquireTcpConnection(host, port, urgency);
   }
 }
 
@@ -124,13 +124,14 @@ void ConnectionPool::RemoveAnyConnection(AnyPooledConnection conn) {
 
 // TCP connection methods
 PooledConnection* ConnectionPool::AcquireTcpConnection(const std::string& host,
-                                                       uint16_t port) {
+                                                       uint16_t port,
+                                                       uint8_t urgency) {
   HostPool* pool = GetOrCreateHostPool(host, port);
   if (!pool) {
     return nullptr;
   }
 
-  return pool->AcquireConnection();
+  return pool->AcquireConnection(urgency);
 }
 
 void ConnectionPool::ReleaseTcpConnection(PooledConnection* conn) {
@@ -192,7 +193,8 @@ void ConnectionPool::CleanupIdle(uint64_t now_ms) {
 
   // Remove empty TCP host pools
   for (auto it = host_pools_.begin(); it != host_pools_.end();) {
-    if (it->second && it->second->TotalConnections() == 0) {
+    if (it->second && it->second->TotalConnections() == 0 &&
+        it->second->PendingRequests() == 0) {
       it = host_pools_.erase(it);
     } else {
       ++it;
@@ -266,6 +268,12 @@ HostPool* ConnectionPool::GetOrCreateHostPool(const std::string& host,
   host_config.idle_timeout_ms = config_.idle_timeout_ms;
   host_config.connect_timeout_ms = config_.connect_timeout_ms;
   host_config.proxy = config_.proxy;
+  host_config.socket = config_.socket;
+  host_config.stats = config_.stats;
+  host_config.high_resolution_timing = config_.high_resolution_timing;
+  host_config.trace = config_.trace;
+  host_config.memory = config_.memory;
+  host_config.concurrency_limit = config_.concurrency_limit;
 
   auto pool = std::make_unique<HostPool>(host, port, host_config, reactor_,
                                          tls_factory_);
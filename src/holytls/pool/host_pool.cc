@@ -15,9 +15,23 @@ HostPool::HostPool(const std::string& h, uint16_t p,
       port(p),
       config_(config),
       reactor_(reactor),
-      tls_factory_(tls_factory) {}
+      tls_factory_(tls_factory) {
+  if (config_.concurrency_limit.enabled) {
+    limiter_ = std::make_unique<ConcurrencyLimiter>(config_.concurrency_limit);
+    limit_stats_.host = host;
+    limit_stats_.port = port;
+    PublishLimit();
+    if (config_.stats) {
+      config_.stats->RegisterOrigin(&limit_stats_);
+    }
+  }
+}
 
 HostPool::~HostPool() {
+  if (limiter_ && config_.stats) {
+    config_.stats->UnregisterOrigin(&limit_stats_);
+  }
+
   // Close all connections
   for (auto& pc : connections_) {
     if (pc && pc->connection) {
@@ -27,17 +41,206 @@ HostPool::~HostPool() {
   connections_.clear();
 }
 
-PooledConnection* HostPool::AcquireConnection() {
+PooledConnection* HostPool::AcquireConnection(uint8_t urgency) {
+  // Queued requests at least as urgent are served first
+  if (!pending_.empty() && pending_.begin()->first.first <= urgency) {
+    return nullptr;
+  }
+  return TryAcquire(urgency);
+}
+
+PooledConnection* HostPool::TryAcquire(uint8_t urgency) {
+  if (AtConcurrencyLimit()) {
+    return nullptr;
+  }
+
   // First, try to find an existing connection with capacity
   PooledConnection* conn = FindConnectionWithCapacity();
-  if (conn) {
-    conn->active_stream_count++;
-    conn->last_used_ms = reactor_->now_ms();
-    return conn;
+  if (!conn) {
+    // No connection with capacity available
+    return nullptr;
   }
 
-  // No connection with capacity available
-  return nullptr;
+  // Background requests leave the last free stream to interactive ones
+  // once no more connections can be opened
+  if (urgency > Priority::kDefaultUrgency &&
+      connections_.size() >= config_.max_connections) {
+    size_t free_streams = 0;
+    size_t busy_streams = 0;
+    for (const auto& pc : connections_) {
+      if (!pc || !pc->connection) {
+        continue;
+      }
+      busy_streams += pc->active_stream_count;
+      if (pc->connection->IsConnected() &&
+          pc->connection->CanSubmitRequest() && pc->HasCapacity()) {
+        free_streams += pc->StreamLimit() - pc->active_stream_count;
+      }
+    }
+    if (free_streams <= 1 && busy_streams > 0) {
+      return nullptr;
+    }
+  }
+
+  conn->active_stream_count++;
+  conn->last_used_ms = reactor_->now_ms();
+  core::Trace(config_.trace, core::TraceEvent::kPoolAcquire,
+              conn->connection.get(), -1, conn->active_stream_count);
+  PublishLimit();
+  return conn;
+}
+
+PooledConnection* HostPool::AcquireAlternate(const PooledConnection* avoid) {
+  if (AtConcurrencyLimit()) {
+    return nullptr;
+  }
+
+  const std::string* avoid_ip =
+      avoid && avoid->connection ? &avoid->connection->peer_ip() : nullptr;
+  PooledConnection* best = nullptr;
+  bool best_elsewhere = false;
+  for (auto& pc : connections_) {
+    if (!pc || pc.get() == avoid || !pc->connection || !pc->HasCapacity()) {
+      continue;
+    }
+    using core::ConnectionState;
+    ConnectionState state = pc->connection->state();
+    bool usable = state == ConnectionState::kConnected
+                      ? pc->connection->CanSubmitRequest()
+                      : state == ConnectionState::kConnecting ||
+                            state == ConnectionState::kProxyTunnel ||
+                            state == ConnectionState::kTlsHandshake;
+    if (!usable) {
+      continue;
+    }
+    bool elsewhere = avoid_ip && pc->connection->peer_ip() != *avoid_ip;
+    if (best == nullptr || (elsewhere && !best_elsewhere) ||
+        (elsewhere == best_elsewhere &&
+         pc->active_stream_count < best->active_stream_count)) {
+      best = pc.get();
+      best_elsewhere = elsewhere;
+    }
+  }
+  if (!best) {
+    return nullptr;
+  }
+
+  best->active_stream_count++;
+  best->last_used_ms = reactor_->now_ms();
+  core::Trace(config_.trace, core::TraceEvent::kPoolAcquire,
+              best->connection.get(), -1, best->active_stream_count);
+  PublishLimit();
+  return best;
+}
+
+uint64_t HostPool::Enqueue(uint8_t urgency, SlotCallback on_slot) {
+  uint64_t id = next_pending_id_++;
+  urgency = std::min(urgency, Priority::kLowestUrgency);
+  pending_.emplace(std::make_pair(urgency, id), std::move(on_slot));
+  PublishLimit();
+  return id;
+}
+
+bool HostPool::Cancel(uint64_t id) {
+  auto it = std::ranges::find_if(
+      pending_, [id](const auto& entry) { return entry.first.second == id; });
+  if (it == pending_.end()) {
+    return false;
+  }
+  SlotCallback on_slot = std::move(it->second);
+  pending_.erase(it);
+  PublishLimit();
+  if (on_slot) {
+    on_slot(nullptr, {});
+  }
+  return true;
+}
+
+void HostPool::FailPending(std::string_view error) {
+  // Taken out first: callbacks may queue again
+  std::map<std::pair<uint8_t, uint64_t>, SlotCallback> pending;
+  pending.swap(pending_);
+  PublishLimit();
+  for (auto& [key, on_slot] : pending) {
+    if (on_slot) {
+      on_slot(nullptr, error);
+    }
+  }
+}
+
+void HostPool::ScheduleDispatch() {
+  if (pending_.empty() || dispatch_posted_) {
+    return;
+  }
+  dispatch_posted_ = true;
+  reactor_->Post([this, alive = std::weak_ptr<bool>(alive_)] {
+    if (alive.expired()) {
+      return;
+    }
+    dispatch_posted_ = false;
+    DispatchPending();
+  });
+}
+
+void HostPool::DispatchPending() {
+  // Sends that fail at once release their stream again; the loop below
+  // picks that up
+  if (dispatching_) {
+    return;
+  }
+  dispatching_ = true;
+  while (!pending_.empty()) {
+    auto it = pending_.begin();
+    PooledConnection* conn = TryAcquire(it->first.first);
+    if (!conn) {
+      break;
+    }
+    SlotCallback on_slot = std::move(it->second);
+    pending_.erase(it);
+    PublishLimit();
+    if (on_slot) {
+      on_slot(conn, {});
+    }
+  }
+  dispatching_ = false;
+}
+
+size_t HostPool::InFlight() const {
+  size_t in_flight = 0;
+  for (const auto& pc : connections_) {
+    if (pc) {
+      in_flight += pc->active_stream_count;
+    }
+  }
+  return in_flight;
+}
+
+void HostPool::RecordSample(uint64_t rtt_us) {
+  if (!limiter_) {
+    return;
+  }
+  limiter_->OnSample(reactor_->now_ms(), rtt_us, InFlight());
+  PublishLimit();
+}
+
+void HostPool::RecordDrop(uint64_t retry_after_ms) {
+  if (!limiter_) {
+    return;
+  }
+  limiter_->OnDrop(reactor_->now_ms(), retry_after_ms);
+  PublishLimit();
+}
+
+void HostPool::PublishLimit() {
+  if (!limiter_) {
+    return;
+  }
+  limit_stats_.limit.Set(limiter_->limit());
+  limit_stats_.in_flight.Set(InFlight());
+  limit_stats_.queued.Set(pending_.size());
+  limit_stats_.rtt_us.Set(limiter_->rtt_us());
+  limit_stats_.baseline_rtt_us.Set(limiter_->baseline_rtt_us());
+  limit_stats_.drops.Set(limiter_->drops());
 }
 
 void HostPool::ReleaseConnection(PooledConnection* conn) {
@@ -48,13 +251,24 @@ void HostPool::ReleaseConnection(PooledConnection* conn) {
   if (conn->active_stream_count > 0) {
     conn->active_stream_count--;
   }
+  core::Trace(config_.trace, core::TraceEvent::kPoolRelease,
+              conn->connection.get(), -1, conn->active_stream_count);
 
   conn->last_used_ms = reactor_->now_ms();
+  PublishLimit();
+
+  // Closed under the request, or draining after GOAWAY
+  if (conn->IsRetiring()) {
+    conn->marked_for_removal = true;
+  }
 
-  // If connection has errors or is marked for removal, close it
-  if (conn->marked_for_removal || conn->consecutive_errors > 3) {
+  // Close a connection marked for removal once its last stream is done
+  if ((conn->marked_for_removal || conn->consecutive_errors > 3) &&
+      conn->IsIdle()) {
     RemoveConnection(conn);
   }
+
+  ScheduleDispatch();
 }
 
 void HostPool::FailConnection(PooledConnection* conn) {
@@ -62,13 +276,20 @@ void HostPool::FailConnection(PooledConnection* conn) {
     return;
   }
 
+  if (conn->active_stream_count > 0) {
+    conn->active_stream_count--;
+  }
   conn->consecutive_errors++;
   conn->marked_for_removal = true;
+  PublishLimit();
 
   // If connection is idle, remove it immediately
   if (conn->IsIdle()) {
     RemoveConnection(conn);
   }
+
+  // A replacement may be needed for queued requests
+  ScheduleDispatch();
 }
 
 bool HostPool::CreateConnection(const std::string& resolved_ip, bool ipv6) {
@@ -80,6 +301,14 @@ bool HostPool::CreateConnection(const std::string& resolved_ip, bool ipv6) {
   // Build connection options with proxy config
   core::ConnectionOptions conn_options;
   conn_options.proxy = config_.proxy;
+  conn_options.socket = config_.socket;
+  if (fast_open_.disabled) {
+    conn_options.socket.tcp_fast_open = false;
+  }
+  conn_options.stats = config_.stats;
+  conn_options.high_resolution_timing = config_.high_resolution_timing;
+  conn_options.trace = config_.trace;
+  conn_options.memory = config_.memory;
 
   // Create the connection
   auto connection = std::make_unique<core::Connection>(
@@ -99,6 +328,14 @@ bool HostPool::CreateConnection(const std::string& resolved_ip, bool ipv6) {
     // Connection is now idle - update last used time
     raw_ptr->last_used_ms = reactor_->now_ms();
   };
+  pooled->connection->connected_callback = [this,
+                                           raw_ptr](core::Connection* c) {
+    raw_ptr->established = true;
+    OnConnectionEstablished(c);
+  };
+  pooled->connection->closed_callback = [this, raw_ptr](core::Connection*) {
+    OnConnectionClosed(raw_ptr);
+  };
 
   // Start the connection
   if (!pooled->connection->Connect(resolved_ip, ipv6)) {
@@ -152,6 +389,24 @@ size_t HostPool::IdleConnections() const {
   return count;
 }
 
+void HostPool::OnConnectionEstablished(core::Connection* conn) {
+  ScheduleDispatch();
+
+  if (!conn->FastOpenAttempted()) {
+    return;
+  }
+
+  fast_open_.attempts++;
+  if (conn->FastOpenAccepted()) {
+    fast_open_.accepted++;
+    fast_open_.consecutive_misses = 0;
+  } else if (++fast_open_.consecutive_misses >= kMaxFastOpenMisses) {
+    // Kernel falls back to a plain handshake each time, but the cookie
+    // request still costs a SYN option and may upset middleboxes
+    fast_open_.disabled = true;
+  }
+}
+
 void HostPool::OnConnectionIdle(core::Connection* conn) {
   // Find the pooled connection for this raw connection
   for (auto& pc : connections_) {
@@ -162,6 +417,33 @@ void HostPool::OnConnectionIdle(core::Connection* conn) {
   }
 }
 
+void HostPool::OnConnectionClosed(PooledConnection* conn) {
+  // Its requests were failed first; one releasing the last stream has
+  // removed it already (it is destroyed on the next loop iteration)
+  conn->marked_for_removal = true;
+  if (conn->host_pool == this && conn->IsIdle()) {
+    RemoveConnection(conn);
+  }
+
+  // Queued requests only wait for existing connections. One that never
+  // came up is not replaced here, or a dead address would be dialed in a
+  // loop; if nothing else is left, its error is theirs.
+  if (conn->established && !pending_.empty()) {
+    CreateConnection(conn->connection->peer_ip(),
+                     conn->connection->peer_ipv6());
+  } else if (!conn->established && !pending_.empty()) {
+    bool others = std::ranges::any_of(connections_, [conn](const auto& pc) {
+      return pc && pc.get() != conn && !pc->marked_for_removal &&
+             !pc->IsRetiring();
+    });
+    if (!others) {
+      const std::string& error = conn->connection->last_error();
+      FailPending(error.empty() ? "Connection closed" : error);
+    }
+  }
+  ScheduleDispatch();
+}
+
 void HostPool::RemoveConnection(PooledConnection* conn) {
   auto it = std::find_if(connections_.begin(), connections_.end(),
                          [conn](const std::unique_ptr<PooledConnection>& pc) {
@@ -169,10 +451,9 @@ void HostPool::RemoveConnection(PooledConnection* conn) {
                          });
 
   if (it != connections_.end()) {
-    if ((*it)->connection) {
-      (*it)->connection->Close();
-    }
+    std::unique_ptr<PooledConnection> removed = std::move(*it);
     connections_.erase(it);
+    Retire(std::move(removed));
   }
 }
 
@@ -182,16 +463,34 @@ void HostPool::CleanupMarkedConnections() {
   while (it != connections_.end()) {
     auto& pc = *it;
     if (pc && pc->marked_for_removal && pc->IsIdle()) {
-      if (pc->connection) {
-        pc->connection->Close();
-      }
+      std::unique_ptr<PooledConnection> removed = std::move(pc);
       it = connections_.erase(it);
+      Retire(std::move(removed));
     } else {
       ++it;
     }
   }
 }
 
+void HostPool::Retire(std::unique_ptr<PooledConnection> conn) {
+  if (!conn) {
+    return;
+  }
+  conn->host_pool = nullptr;
+  retired_.push_back(std::move(conn));
+  if (retired_.size() > 1) {
+    return;  // Already scheduled
+  }
+  reactor_->Post([this, alive = std::weak_ptr<bool>(alive_)] {
+    if (alive.expired()) {
+      return;
+    }
+    // Destructors close the sockets
+    std::vector<std::unique_ptr<PooledConnection>> retired;
+    retired.swap(retired_);
+  });
+}
+
 PooledConnection* HostPool::FindConnectionWithCapacity() {
   PooledConnection* best = nullptr;
   size_t min_streams = SIZE_MAX;
@@ -203,9 +502,9 @@ PooledConnection* HostPool::FindConnectionWithCapacity() {
       continue;
     }
 
-    // If connection is connected but can't submit requests (e.g., received
-    // GOAWAY), mark it for removal so a new connection can be created
-    if (pc->connection->IsConnected() && !pc->connection->CanSubmitRequest()) {
+    // Closed, failed, or received GOAWAY: mark it for removal so a new
+    // connection can be created
+    if (pc->IsRetiring()) {
       pc->marked_for_removal = true;
       continue;
     }
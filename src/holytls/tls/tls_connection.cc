@@ -16,17 +16,20 @@ namespace holytls {
 namespace tls {
 
 TlsConnection::TlsConnection(TlsContextFactory* factory, int socket_fd,
-                             std::string_view host, uint16_t p)
+                             std::string_view host, uint16_t p, BIO* bio)
     : fd(socket_fd), port(p), hostname(host) {
   // Create SSL object
   ssl_.reset(factory->CreateSsl());
   if (!ssl_) {
+    BIO_free(bio);
     SetError("Failed to create SSL object");
     return;
   }
 
-  // Attach to socket
-  if (SSL_set_fd(ssl_.get(), fd) != 1) {
+  // Attach to the caller's BIO, or to the socket
+  if (bio != nullptr) {
+    SSL_set_bio(ssl_.get(), bio, bio);
+  } else if (SSL_set_fd(ssl_.get(), fd) != 1) {
     SetError("Failed to set SSL fd");
     return;
   }
@@ -11,6 +11,7 @@ namespace {
 // Runs on libuv thread pool worker thread
 void WorkCallback(uv_work_t* req) {
   auto* work = static_cast<DecompressWork*>(req->data);
+  memory::ScopedMemoryAccount account(work->memory);
 
   work->success =
       Decompress(work->encoding, work->compressed.data(),
@@ -57,6 +58,7 @@ void DecompressAsync(uv_loop_t* loop, ContentEncoding encoding,
   work->encoding = encoding;
   work->compressed = std::move(compressed);
   work->callback = std::move(callback);
+  work->memory = memory::CurrentMemoryAccount();
 
   int ret = uv_queue_work(loop, &work->work, WorkCallback, AfterWorkCallback);
   if (ret != 0) {
@@ -10,6 +10,8 @@
 
 #include <uv.h>
 
+#include "holytls/memory/memory_accounting.h"
+#include "holytls/memory/slab_allocator.h"
 #include "holytls/util/decompressor.h"
 
 namespace holytls {
@@ -21,8 +23,8 @@ using DecompressCallback = std::function<void(
     std::vector<uint8_t> decompressed, bool success, const std::string& error)>;
 
 // Async decompression work request
-// Allocated on heap, owned by libuv during work execution
-struct DecompressWork {
+// Allocated from a slab, owned by libuv during work execution
+struct DecompressWork : memory::SlabAllocated<DecompressWork> {
   uv_work_t work;
 
   // Input
@@ -36,6 +38,9 @@ struct DecompressWork {
 
   // Completion callback
   DecompressCallback callback;
+
+  // Account of the queuing reactor, charged for decoder state on the worker
+  memory::MemoryAccount* memory = nullptr;
 };
 
 // Queue decompression work to libuv's thread pool.
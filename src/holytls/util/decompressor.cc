@@ -10,6 +10,8 @@
 #include <zlib.h>
 #include <zstd.h>
 
+#include "holytls/memory/memory_accounting.h"
+
 namespace holytls {
 namespace util {
 
@@ -36,6 +38,31 @@ std::string NormalizeEncoding(std::string_view value) {
   return result;
 }
 
+// Decoder state is charged to the current thread's memory account. zstd
+// (one-shot, transient context) is left on its default allocator.
+void* ZlibAlloc(void*, uInt items, uInt size) {
+  return memory::TaggedAlloc(size_t{items} * size,
+                             memory::MemoryTag::kDecompression);
+}
+
+void ZlibFree(void*, void* ptr) { memory::TaggedFree(ptr); }
+
+void* BrotliAlloc(void*, size_t size) {
+  return memory::TaggedAlloc(size, memory::MemoryTag::kDecompression);
+}
+
+void BrotliFree(void*, void* ptr) { memory::TaggedFree(ptr); }
+
+// Fresh z_stream, using the tagged allocator in accounting builds
+z_stream NewZStream() {
+  z_stream strm = {};
+  if constexpr (memory::kMemoryAccountingEnabled) {
+    strm.zalloc = ZlibAlloc;
+    strm.zfree = ZlibFree;
+  }
+  return strm;
+}
+
 }  // namespace
 
 ContentEncoding ParseContentEncoding(std::string_view value) {
@@ -101,7 +128,9 @@ bool DecompressBrotli(const uint8_t* data, size_t len,
   size_t total_out = 0;
 
   BrotliDecoderState* state =
-      BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+      memory::kMemoryAccountingEnabled
+          ? BrotliDecoderCreateInstance(BrotliAlloc, BrotliFree, nullptr)
+          : BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
   if (!state) {
     if (error_msg) *error_msg = "Failed to create Brotli decoder";
     return false;
@@ -186,7 +215,7 @@ bool DecompressGzip(const uint8_t* data, size_t len,
     return true;
   }
 
-  z_stream strm = {};
+  z_stream strm = NewZStream();
   // 16 + MAX_WBITS enables gzip decoding
   int ret = inflateInit2(&strm, 16 + MAX_WBITS);
   if (ret != Z_OK) {
@@ -248,7 +277,7 @@ bool DecompressDeflate(const uint8_t* data, size_t len,
     return true;
   }
 
-  z_stream strm = {};
+  z_stream strm = NewZStream();
   // -MAX_WBITS for raw deflate (no zlib/gzip header)
   // Try raw deflate first, fall back to zlib wrapper
   int ret = inflateInit2(&strm, -MAX_WBITS);
@@ -272,7 +301,7 @@ bool DecompressDeflate(const uint8_t* data, size_t len,
   if (ret == Z_DATA_ERROR) {
     inflateEnd(&strm);
 
-    strm = {};
+    strm = NewZStream();
     ret = inflateInit(&strm);  // Default: zlib wrapper
     if (ret != Z_OK) {
       if (error_msg) *error_msg = "Failed to initialize zlib";
@@ -12,11 +12,13 @@
 #include <algorithm>
 #include <cstring>
 
+#include "holytls/memory/slab_allocator.h"
+
 namespace holytls {
 namespace util {
 
-// Request context for async resolution
-struct DnsRequest {
+// Request context for async resolution (slab-allocated: one per lookup)
+struct DnsRequest : memory::SlabAllocated<DnsRequest> {
   uv_getaddrinfo_t req;
   DnsCallback callback;
   DnsResolver* resolver;
@@ -28,6 +30,7 @@ DnsResolver::DnsResolver(uv_loop_t* loop) : loop_(loop) {
   for (auto& entry : cache_) {
     entry.valid = false;
   }
+  cache_charge_.Set(sizeof(cache_));
 }
 
 DnsResolver::~DnsResolver() {
@@ -3,6 +3,8 @@
 
 #include "holytls/util/socket_utils.h"
 
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
 
 namespace holytls {
@@ -51,24 +53,192 @@ socket_t CreateTcpSocket(bool ipv6) {
   return sock;
 }
 
-void ConfigureSocket(socket_t sock) {
+namespace {
+
+void SetIntOption(socket_t sock, int level, int name, int value) {
+  setsockopt(sock, level, name, reinterpret_cast<const char*>(&value),
+             sizeof(value));
+}
+
+}  // namespace
+
+void ConfigureSocket(socket_t sock, const SocketConfig& config) {
   // Disable Nagle's algorithm for lower latency
-  int flag = 1;
-  setsockopt(sock, IPPROTO_TCP, TCP_NODELAY,
-             reinterpret_cast<const char*>(&flag), sizeof(flag));
+  SetIntOption(sock, IPPROTO_TCP, TCP_NODELAY, 1);
 
   // Enable keep-alive
-  setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE,
-             reinterpret_cast<const char*>(&flag), sizeof(flag));
+  SetIntOption(sock, SOL_SOCKET, SO_KEEPALIVE, 1);
+
+  // Fixed buffers pin kernel memory per socket and turn off Linux receive
+  // autotuning, so they are opt-in. kAdaptive only sets them once
+  // autotuning has reached its ceiling.
+  if (config.buffer_mode == SocketBufferMode::kFixed) {
+    int bufsize = static_cast<int>(config.buffer_size);
+    SetIntOption(sock, SOL_SOCKET, SO_RCVBUF, bufsize);
+    SetIntOption(sock, SOL_SOCKET, SO_SNDBUF, bufsize);
+  }
+
+#ifdef __linux__
+  // Cap unsent data queued in the kernel so HTTP/2 priorities and
+  // cancellations stay effective
+  if (config.notsent_lowat > 0) {
+    SetIntOption(sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT,
+                 static_cast<int>(config.notsent_lowat));
+  }
+  if (config.quickack) {
+    SetIntOption(sock, IPPROTO_TCP, TCP_QUICKACK, 1);
+  }
+  if (config.user_timeout.count() > 0) {
+    SetIntOption(sock, IPPROTO_TCP, TCP_USER_TIMEOUT,
+                 static_cast<int>(config.user_timeout.count()));
+  }
+  if (config.busy_poll.count() > 0) {
+    SetIntOption(sock, SOL_SOCKET, SO_BUSY_POLL,
+                 static_cast<int>(config.busy_poll.count()));
+  }
+#ifdef IP_BIND_ADDRESS_NO_PORT
+  if (config.bind_address_no_port) {
+    SetIntOption(sock, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, 1);
+  }
+#endif
+#endif
+}
 
-  // Set receive buffer size (256KB)
-  int bufsize = 256 * 1024;
-  setsockopt(sock, SOL_SOCKET, SO_RCVBUF,
-             reinterpret_cast<const char*>(&bufsize), sizeof(bufsize));
+bool BindLocalAddress(socket_t sock, std::string_view ip, bool ipv6) {
+  char ip_buf[46];
+  if (ip.size() >= sizeof(ip_buf)) return false;
+  std::memcpy(ip_buf, ip.data(), ip.size());
+  ip_buf[ip.size()] = '\0';
 
-  // Set send buffer size (256KB)
-  setsockopt(sock, SOL_SOCKET, SO_SNDBUF,
-             reinterpret_cast<const char*>(&bufsize), sizeof(bufsize));
+  int ret;
+  if (ipv6) {
+    struct sockaddr_in6 addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    if (inet_pton(AF_INET6, ip_buf, &addr.sin6_addr) != 1) {
+      return false;
+    }
+    ret = bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+  } else {
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    if (inet_pton(AF_INET, ip_buf, &addr.sin_addr) != 1) {
+      return false;
+    }
+    ret = bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+  }
+  return ret == 0;
+}
+
+size_t GetReceiveBufferSize(socket_t sock) {
+  int size = 0;
+  socklen_t len = sizeof(size);
+  if (getsockopt(sock, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char*>(&size),
+                 &len) < 0 ||
+      size < 0) {
+    return 0;
+  }
+  return static_cast<size_t>(size);
+}
+
+bool SetReceiveBufferSize(socket_t sock, size_t bytes) {
+#ifdef __linux__
+  int size = static_cast<int>(bytes / 2);  // The kernel doubles it
+  // SO_RCVBUFFORCE ignores rmem_max but needs CAP_NET_ADMIN
+  if (setsockopt(sock, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) == 0) {
+    return true;
+  }
+  if (bytes > MaxReceiveBufferSize()) {
+    return false;  // SO_RCVBUF would be clamped (and still pin the size)
+  }
+#else
+  int size = static_cast<int>(bytes);
+#endif
+  return setsockopt(sock, SOL_SOCKET, SO_RCVBUF,
+                    reinterpret_cast<const char*>(&size), sizeof(size)) == 0;
+}
+
+size_t MaxReceiveBufferSize() {
+#ifdef __linux__
+  static const size_t max_size = [] {
+    size_t value = SIZE_MAX;
+    if (FILE* f = std::fopen("/proc/sys/net/core/rmem_max", "r")) {
+      unsigned long rmem_max = 0;
+      if (std::fscanf(f, "%lu", &rmem_max) == 1 && rmem_max > 0) {
+        value = static_cast<size_t>(rmem_max) * 2;
+      }
+      std::fclose(f);
+    }
+    return value;
+  }();
+  return max_size;
+#else
+  return SIZE_MAX;
+#endif
+}
+
+size_t AutotuneReceiveBufferMax() {
+#ifdef __linux__
+  static const size_t max_size = [] {
+    size_t value = SIZE_MAX;
+    if (FILE* f = std::fopen("/proc/sys/net/ipv4/tcp_rmem", "r")) {
+      unsigned long min = 0;
+      unsigned long def = 0;
+      unsigned long max = 0;
+      if (std::fscanf(f, "%lu %lu %lu", &min, &def, &max) == 3 && max > 0) {
+        value = static_cast<size_t>(max);
+      }
+      std::fclose(f);
+    }
+    return value;
+  }();
+  return max_size;
+#else
+  return SIZE_MAX;
+#endif
+}
+
+bool GetTcpRtt(socket_t sock, uint32_t* rtt_us) {
+#ifdef __linux__
+  struct tcp_info info;
+  socklen_t len = sizeof(info);
+  if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &len) < 0 ||
+      info.tcpi_rtt == 0) {
+    return false;
+  }
+  *rtt_us = info.tcpi_rtt;
+  return true;
+#else
+  (void)sock;
+  (void)rtt_us;
+  return false;
+#endif
+}
+
+bool EnableTcpFastOpen(socket_t sock) {
+#if defined(__linux__) && defined(TCP_FASTOPEN_CONNECT)
+  int on = 1;
+  return setsockopt(sock, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &on,
+                    sizeof(on)) == 0;
+#else
+  (void)sock;
+  return false;
+#endif
+}
+
+bool TcpFastOpenAccepted(socket_t sock) {
+#if defined(__linux__) && defined(TCPI_OPT_SYN_DATA)
+  struct tcp_info info;
+  socklen_t len = sizeof(info);
+  if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &len) < 0) {
+    return false;
+  }
+  return (info.tcpi_options & TCPI_OPT_SYN_DATA) != 0;
+#else
+  (void)sock;
+  return false;
+#endif
 }
 
 int ConnectNonBlocking(socket_t sock, std::string_view ip, uint16_t port,
@@ -148,7 +318,8 @@ ssize_t SendNonBlocking(socket_t sock, const void* data, size_t len) {
 #else
   ssize_t ret = send(sock, data, len, MSG_NOSIGNAL);
   if (ret < 0) {
-    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+    // EINPROGRESS: TCP Fast Open socket whose SYN went out without data
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS) {
       return -1;  // Would block
     }
     return -2;  // Real error
@@ -0,0 +1,831 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "bench_server.h"
+
+#include <nghttp2/nghttp2.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <picohttpparser.h>
+#include <uv.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "holytls/tls/tls_connection.h"
+#include "holytls/util/platform.h"
+
+namespace holytls {
+namespace bench {
+
+namespace {
+
+constexpr size_t kDefaultBodySize = 64;
+constexpr size_t kMaxBodySize = 64 * 1024 * 1024;
+constexpr size_t kReadBufferSize = 64 * 1024;
+
+using Body = std::shared_ptr<const std::string>;
+
+// Compressible text: a repeated line, like typical HTML/JSON payloads
+std::string MakeText(size_t size) {
+  constexpr std::string_view kLine =
+      "holytls benchmark payload 0123456789 abcdefghijklmnopqrstuvwxyz\n";
+  std::string text;
+  text.reserve(size);
+  while (text.size() < size) {
+    text.append(kLine.substr(0, std::min(kLine.size(), size - text.size())));
+  }
+  return text;
+}
+
+std::string Gzip(const std::string& input) {
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  // 15 + 16: gzip wrapper instead of zlib
+  if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return {};
+  }
+  std::string out(deflateBound(&zs, static_cast<uLong>(input.size())), '\0');
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  zs.avail_in = static_cast<uInt>(input.size());
+  zs.next_out = reinterpret_cast<Bytef*>(out.data());
+  zs.avail_out = static_cast<uInt>(out.size());
+  int rv = deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return rv == Z_STREAM_END ? out : std::string();
+}
+
+// Parse the size in "<prefix><n>"; false if the path does not match
+bool ParseSizePath(std::string_view path, std::string_view prefix,
+                   size_t* size) {
+  if (!path.starts_with(prefix)) {
+    return false;
+  }
+  std::string_view digits = path.substr(prefix.size());
+  size_t value = 0;
+  auto [ptr, ec] =
+      std::from_chars(digits.data(), digits.data() + digits.size(), value);
+  if (ec != std::errc() || value > kMaxBodySize) {
+    return false;
+  }
+  *size = value;
+  return true;
+}
+
+// Self-signed P-256 certificate for CN=localhost
+bool UseSelfSignedCertificate(SSL_CTX* ctx) {
+  EVP_PKEY* pkey = nullptr;
+  EVP_PKEY_CTX* kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+  bool ok = kctx != nullptr && EVP_PKEY_keygen_init(kctx) == 1 &&
+            EVP_PKEY_CTX_set_ec_paramgen_curve_nid(
+                kctx, NID_X9_62_prime256v1) == 1 &&
+            EVP_PKEY_keygen(kctx, &pkey) == 1;
+  EVP_PKEY_CTX_free(kctx);
+  if (!ok) {
+    return false;
+  }
+
+  X509* cert = X509_new();
+  X509_NAME* name = nullptr;
+  ok = cert != nullptr && X509_set_version(cert, 2) == 1 &&
+       ASN1_INTEGER_set(X509_get_serialNumber(cert), 1) == 1 &&
+       X509_gmtime_adj(X509_getm_notBefore(cert), -3600) != nullptr &&
+       X509_gmtime_adj(X509_getm_notAfter(cert), 86400) != nullptr &&
+       X509_set_pubkey(cert, pkey) == 1;
+  if (ok) {
+    name = X509_get_subject_name(cert);
+    ok = X509_NAME_add_entry_by_txt(
+             name, "CN", MBSTRING_ASC,
+             reinterpret_cast<const unsigned char*>("localhost"), -1, -1,
+             0) == 1 &&
+         X509_set_issuer_name(cert, name) == 1 &&
+         X509_sign(cert, pkey, EVP_sha256()) > 0 &&
+         SSL_CTX_use_certificate(ctx, cert) == 1 &&
+         SSL_CTX_use_PrivateKey(ctx, pkey) == 1;
+  }
+
+  X509_free(cert);
+  EVP_PKEY_free(pkey);
+  return ok;
+}
+
+int SelectAlpn(SSL* /*ssl*/, const unsigned char** out, unsigned char* outlen,
+               const unsigned char* in, unsigned int inlen, void* arg) {
+  static constexpr unsigned char kH2[] = "\x02h2\x08http/1.1";
+  static constexpr unsigned char kH1[] = "\x08http/1.1";
+  bool http1_only = *static_cast<bool*>(arg);
+  const unsigned char* prefs = http1_only ? kH1 : kH2;
+  unsigned int prefs_len =
+      http1_only ? sizeof(kH1) - 1 : sizeof(kH2) - 1;
+
+  unsigned char* selected = nullptr;
+  if (SSL_select_next_proto(&selected, outlen, prefs, prefs_len, in, inlen) !=
+      OPENSSL_NPN_NEGOTIATED) {
+    return SSL_TLSEXT_ERR_NOACK;
+  }
+  *out = selected;
+  return SSL_TLSEXT_ERR_OK;
+}
+
+// Listening socket for `port` (0 = ephemeral) that other workers can share
+util::socket_t Listen(uint16_t port) {
+  util::socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock == util::kInvalidSocket) {
+    return util::kInvalidSocket;
+  }
+  int on = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+#ifdef SO_REUSEPORT
+  setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#endif
+
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(sock, 1024) != 0) {
+    util::CloseSocket(sock);
+    return util::kInvalidSocket;
+  }
+  return sock;
+}
+
+uint16_t LocalPort(util::socket_t sock) {
+  sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  if (getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    return 0;
+  }
+  return ntohs(addr.sin_port);
+}
+
+}  // namespace
+
+// ============================================================================
+// Worker: one event loop, one listener per port, the sessions it accepted
+// ============================================================================
+
+namespace {
+struct Session;
+}  // namespace
+
+struct BenchServer::Worker {
+  BenchServer* server = nullptr;
+  uv_loop_t loop;
+  uv_async_t stop_async;
+  std::vector<std::unique_ptr<uv_tcp_t>> listeners;
+  std::vector<Session*> sessions;
+
+  // Response bodies by size, built on first use
+  std::unordered_map<size_t, Body> text_bodies;
+  std::unordered_map<size_t, Body> gzip_bodies;
+
+  char read_buffer[kReadBufferSize];
+
+  void CountRequest() {
+    server->requests_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void CountConnection() {
+    server->connections_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Whether this connection is the one goaway_first_connection applies to
+  bool ClaimGoaway() {
+    return server->config_.goaway_first_connection &&
+           !server->goaway_claimed_.exchange(true);
+  }
+
+  Body TextBody(size_t size) {
+    Body& body = text_bodies[size];
+    if (!body) {
+      body = std::make_shared<const std::string>(MakeText(size));
+    }
+    return body;
+  }
+
+  Body GzipBody(size_t size) {
+    Body& body = gzip_bodies[size];
+    if (!body) {
+      body = std::make_shared<const std::string>(Gzip(MakeText(size)));
+    }
+    return body;
+  }
+};
+
+namespace {
+
+using Worker = BenchServer::Worker;
+
+struct Reply {
+  Body body;
+  bool gzip = false;
+  std::string location;  // Set for a 302
+};
+
+struct H2Stream {
+  std::string path;
+  Reply reply;
+  size_t offset = 0;
+};
+
+struct Session {
+  uv_tcp_t handle;
+  Worker* worker = nullptr;
+  const BenchServerConfig* config = nullptr;
+
+  tls::SslPtr ssl;
+  BIO* rbio = nullptr;  // Owned by ssl
+  BIO* wbio = nullptr;  // Owned by ssl
+  bool handshake_done = false;
+
+  size_t responses = 0;
+  size_t pending_writes = 0;
+  bool closing = false;  // Close once pending writes complete
+  bool closed = false;   // uv_close issued
+
+  // HTTP/1.1
+  std::string h1_input;
+
+  // HTTP/2
+  nghttp2_session* h2 = nullptr;
+  std::unordered_map<int32_t, H2Stream> streams;
+  bool shutting_down = false;  // Graceful GOAWAY in progress
+
+  // goaway_first_connection: only stream `single_stream_id` is answered
+  bool single_stream = false;
+  int32_t single_stream_id = 0;
+
+  ~Session() {
+    if (h2 != nullptr) {
+      nghttp2_session_del(h2);
+    }
+  }
+};
+
+struct WriteRequest {
+  uv_write_t req;
+  Session* session;
+  std::string data;
+};
+
+Reply MakeReply(Worker* worker, std::string_view path) {
+  if (path.starts_with("/redirect/")) {
+    return {worker->TextBody(0), false,
+            std::string(path.substr(sizeof("/redirect") - 1))};
+  }
+  if (path == "/loop") {
+    return {worker->TextBody(0), false, std::string(path)};
+  }
+  size_t size = kDefaultBodySize;
+  if (ParseSizePath(path, "/gzip/", &size)) {
+    return {worker->GzipBody(size), true, {}};
+  }
+  if (!ParseSizePath(path, "/bytes/", &size)) {
+    size = kDefaultBodySize;
+  }
+  return {worker->TextBody(size), false, {}};
+}
+
+void OnSessionClosed(uv_handle_t* handle) {
+  auto* session = static_cast<Session*>(handle->data);
+  auto& sessions = session->worker->sessions;
+  std::erase(sessions, session);
+  delete session;
+}
+
+void CloseSession(Session* session) {
+  if (session->closed) {
+    return;
+  }
+  session->closed = true;
+  uv_close(reinterpret_cast<uv_handle_t*>(&session->handle), OnSessionClosed);
+}
+
+void OnWrite(uv_write_t* req, int status) {
+  auto* write = static_cast<WriteRequest*>(req->data);
+  Session* session = write->session;
+  delete write;
+
+  session->pending_writes--;
+  if (status < 0 || (session->closing && session->pending_writes == 0)) {
+    CloseSession(session);
+  }
+}
+
+// Move TLS records produced so far onto the socket
+void Flush(Session* session) {
+  size_t pending = BIO_pending(session->wbio);
+  if (pending > 0 && !session->closed) {
+    auto* write = new WriteRequest;
+    write->session = session;
+    write->req.data = write;
+    write->data.resize(pending);
+    BIO_read(session->wbio, write->data.data(), static_cast<int>(pending));
+
+    uv_buf_t buf = uv_buf_init(write->data.data(),
+                               static_cast<unsigned int>(pending));
+    if (uv_write(&write->req,
+                 reinterpret_cast<uv_stream_t*>(&session->handle), &buf, 1,
+                 OnWrite) != 0) {
+      delete write;
+      CloseSession(session);
+      return;
+    }
+    session->pending_writes++;
+  }
+
+  if (session->closing && session->pending_writes == 0) {
+    CloseSession(session);
+  }
+}
+
+void WriteTls(Session* session, const void* data, size_t len) {
+  // Memory BIO: SSL_write always takes everything
+  SSL_write(session->ssl.get(), data, static_cast<int>(len));
+}
+
+// Count a response and report whether the connection should end after it
+bool CountResponse(Session* session) {
+  session->worker->CountRequest();
+  session->responses++;
+  size_t limit = session->config->max_requests_per_connection;
+  return limit > 0 && session->responses >= limit;
+}
+
+// ----------------------------------------------------------------------------
+// HTTP/1.1
+// ----------------------------------------------------------------------------
+
+void HandleH1(Session* session) {
+  while (!session->closing) {
+    const char* method;
+    size_t method_len;
+    const char* path;
+    size_t path_len;
+    int minor_version;
+    struct phr_header headers[64];
+    size_t num_headers = 64;
+    int pret = phr_parse_request(
+        session->h1_input.data(), session->h1_input.size(), &method,
+        &method_len, &path, &path_len, &minor_version, headers, &num_headers,
+        0);
+    if (pret == -2) {
+      return;  // Incomplete
+    }
+    if (pret < 0) {
+      session->closing = true;
+      return;
+    }
+
+    // Benchmark requests carry no body
+    Reply reply = MakeReply(session->worker, std::string_view(path, path_len));
+    session->h1_input.erase(0, static_cast<size_t>(pret));
+    bool last = CountResponse(session);
+
+    std::string head = reply.location.empty()
+                           ? "HTTP/1.1 200 OK\r\n"
+                           : "HTTP/1.1 302 Found\r\nlocation: " +
+                                 reply.location + "\r\n";
+    head += "content-type: text/plain\r\n";
+    if (reply.gzip) {
+      head += "content-encoding: gzip\r\n";
+    }
+    if (last) {
+      head += "connection: close\r\n";
+    }
+    head += "content-length: ";
+    head += std::to_string(reply.body->size());
+    head += "\r\n\r\n";
+    WriteTls(session, head.data(), head.size());
+    WriteTls(session, reply.body->data(), reply.body->size());
+
+    if (last) {
+      session->closing = true;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// HTTP/2
+// ----------------------------------------------------------------------------
+
+ssize_t ReadBody(nghttp2_session* /*h2*/, int32_t stream_id, uint8_t* buf,
+                 size_t length, uint32_t* data_flags,
+                 nghttp2_data_source* /*source*/, void* user_data) {
+  auto* session = static_cast<Session*>(user_data);
+  auto it = session->streams.find(stream_id);
+  if (it == session->streams.end()) {
+    return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+  }
+  H2Stream& stream = it->second;
+  const std::string& body = *stream.reply.body;
+  size_t n = std::min(length, body.size() - stream.offset);
+  std::memcpy(buf, body.data() + stream.offset, n);
+  stream.offset += n;
+  if (stream.offset == body.size()) {
+    *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+  }
+  return static_cast<ssize_t>(n);
+}
+
+nghttp2_nv MakeNv(std::string_view name, std::string_view value) {
+  return {reinterpret_cast<uint8_t*>(const_cast<char*>(name.data())),
+          reinterpret_cast<uint8_t*>(const_cast<char*>(value.data())),
+          name.size(), value.size(), NGHTTP2_NV_FLAG_NONE};
+}
+
+void RespondH2(Session* session, int32_t stream_id) {
+  auto it = session->streams.find(stream_id);
+  if (it == session->streams.end()) {
+    return;
+  }
+  H2Stream& stream = it->second;
+  stream.reply = MakeReply(session->worker, stream.path);
+
+  // Copied by nghttp2 on submit
+  std::string length = std::to_string(stream.reply.body->size());
+  nghttp2_nv nva[5];
+  size_t nvlen = 0;
+  bool redirect = !stream.reply.location.empty();
+  nva[nvlen++] = MakeNv(":status", redirect ? "302" : "200");
+  nva[nvlen++] = MakeNv("content-type", "text/plain");
+  nva[nvlen++] = MakeNv("content-length", length);
+  if (stream.reply.gzip) {
+    nva[nvlen++] = MakeNv("content-encoding", "gzip");
+  }
+  if (redirect) {
+    nva[nvlen++] = MakeNv("location", stream.reply.location);
+  }
+
+  nghttp2_data_provider provider;
+  provider.source.ptr = nullptr;
+  provider.read_callback = ReadBody;
+  nghttp2_submit_response(session->h2, stream_id, nva, nvlen, &provider);
+
+  if (CountResponse(session) && !session->shutting_down) {
+    // Graceful shutdown: GOAWAY(2^31-1) plus a PING. Once the PING is
+    // acknowledged the client has seen the GOAWAY, so every stream it will
+    // open is already here and the final GOAWAY refuses none of them.
+    session->shutting_down = true;
+    nghttp2_submit_shutdown_notice(session->h2);
+    nghttp2_submit_ping(session->h2, NGHTTP2_FLAG_NONE, nullptr);
+  }
+}
+
+int OnBeginHeaders(nghttp2_session* /*h2*/, const nghttp2_frame* frame,
+                   void* user_data) {
+  if (frame->hd.type == NGHTTP2_HEADERS &&
+      frame->headers.cat == NGHTTP2_HCAT_REQUEST) {
+    static_cast<Session*>(user_data)->streams.try_emplace(
+        frame->hd.stream_id);
+  }
+  return 0;
+}
+
+int OnHeader(nghttp2_session* /*h2*/, const nghttp2_frame* frame,
+             const uint8_t* name, size_t namelen, const uint8_t* value,
+             size_t valuelen, uint8_t /*flags*/, void* user_data) {
+  std::string_view header(reinterpret_cast<const char*>(name), namelen);
+  if (frame->hd.type == NGHTTP2_HEADERS && header == ":path") {
+    auto* session = static_cast<Session*>(user_data);
+    auto it = session->streams.find(frame->hd.stream_id);
+    if (it != session->streams.end()) {
+      it->second.path.assign(reinterpret_cast<const char*>(value), valuelen);
+    }
+  }
+  return 0;
+}
+
+int OnFrameRecv(nghttp2_session* h2, const nghttp2_frame* frame,
+                void* user_data) {
+  auto* session = static_cast<Session*>(user_data);
+  if (frame->hd.type == NGHTTP2_PING &&
+      (frame->hd.flags & NGHTTP2_FLAG_ACK) != 0 && session->shutting_down) {
+    nghttp2_submit_goaway(h2, NGHTTP2_FLAG_NONE,
+                          nghttp2_session_get_last_proc_stream_id(h2),
+                          NGHTTP2_NO_ERROR, nullptr, 0);
+    return 0;
+  }
+  if ((frame->hd.type == NGHTTP2_HEADERS || frame->hd.type == NGHTTP2_DATA) &&
+      (frame->hd.flags & NGHTTP2_FLAG_END_STREAM) != 0) {
+    if (session->single_stream) {
+      if (session->single_stream_id != 0) {
+        return 0;  // Above the GOAWAY's last stream id: never answered
+      }
+      session->single_stream_id = frame->hd.stream_id;
+      nghttp2_submit_goaway(h2, NGHTTP2_FLAG_NONE, frame->hd.stream_id,
+                            NGHTTP2_NO_ERROR, nullptr, 0);
+    }
+    RespondH2(session, frame->hd.stream_id);
+  }
+  return 0;
+}
+
+int OnStreamClose(nghttp2_session* /*h2*/, int32_t stream_id,
+                  uint32_t /*error_code*/, void* user_data) {
+  auto* session = static_cast<Session*>(user_data);
+  session->streams.erase(stream_id);
+  if (session->single_stream && stream_id == session->single_stream_id) {
+    session->closing = true;  // After the response is flushed
+  }
+  return 0;
+}
+
+bool StartH2(Session* session) {
+  nghttp2_session_callbacks* callbacks;
+  if (nghttp2_session_callbacks_new(&callbacks) != 0) {
+    return false;
+  }
+  nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks,
+                                                          OnBeginHeaders);
+  nghttp2_session_callbacks_set_on_header_callback(callbacks, OnHeader);
+  nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks,
+                                                       OnFrameRecv);
+  nghttp2_session_callbacks_set_on_stream_close_callback(callbacks,
+                                                         OnStreamClose);
+  int rv = nghttp2_session_server_new(&session->h2, callbacks, session);
+  nghttp2_session_callbacks_del(callbacks);
+  if (rv != 0) {
+    return false;
+  }
+
+  nghttp2_settings_entry settings[] = {
+      {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, 1000},
+      {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, 16 * 1024 * 1024},
+  };
+  nghttp2_submit_settings(session->h2, NGHTTP2_FLAG_NONE, settings,
+                          std::size(settings));
+  session->single_stream = session->worker->ClaimGoaway();
+  return true;
+}
+
+void SendH2(Session* session) {
+  const uint8_t* data;
+  ssize_t n;
+  while ((n = nghttp2_session_mem_send(session->h2, &data)) > 0) {
+    WriteTls(session, data, static_cast<size_t>(n));
+  }
+  if (n < 0 || (!nghttp2_session_want_read(session->h2) &&
+                !nghttp2_session_want_write(session->h2))) {
+    session->closing = true;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// TLS and socket I/O
+// ----------------------------------------------------------------------------
+
+void Drive(Session* session) {
+  SSL* ssl = session->ssl.get();
+
+  if (!session->handshake_done) {
+    int rv = SSL_do_handshake(ssl);
+    if (rv != 1) {
+      int err = SSL_get_error(ssl, rv);
+      if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+        session->closing = true;  // Flush the alert, then close
+      }
+      Flush(session);
+      return;
+    }
+    session->handshake_done = true;
+
+    const unsigned char* alpn = nullptr;
+    unsigned int alpn_len = 0;
+    SSL_get0_alpn_selected(ssl, &alpn, &alpn_len);
+    if (std::string_view(reinterpret_cast<const char*>(alpn), alpn_len) ==
+            "h2" &&
+        !StartH2(session)) {
+      session->closing = true;
+      Flush(session);
+      return;
+    }
+  }
+
+  char buf[16384];
+  int n;
+  while (!session->closing && (n = SSL_read(ssl, buf, sizeof(buf))) > 0) {
+    if (session->h2 != nullptr) {
+      ssize_t consumed = nghttp2_session_mem_recv(
+          session->h2, reinterpret_cast<const uint8_t*>(buf),
+          static_cast<size_t>(n));
+      if (consumed < 0) {
+        session->closing = true;
+      }
+    } else {
+      session->h1_input.append(buf, static_cast<size_t>(n));
+      HandleH1(session);
+    }
+  }
+  if (!session->closing && n <= 0) {
+    int err = SSL_get_error(ssl, n);
+    if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+      session->closing = true;  // close_notify or a TLS error
+    }
+  }
+
+  if (session->h2 != nullptr) {
+    SendH2(session);
+  }
+  Flush(session);
+}
+
+void OnAlloc(uv_handle_t* handle, size_t /*suggested_size*/, uv_buf_t* buf) {
+  // One read at a time per loop: the worker's buffer is reused
+  auto* session = static_cast<Session*>(handle->data);
+  *buf = uv_buf_init(session->worker->read_buffer, kReadBufferSize);
+}
+
+void OnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+  auto* session = static_cast<Session*>(stream->data);
+  if (nread < 0) {
+    CloseSession(session);
+    return;
+  }
+  if (nread == 0 || session->closing) {
+    return;
+  }
+  BIO_write(session->rbio, buf->base, static_cast<int>(nread));
+  Drive(session);
+}
+
+}  // namespace
+
+// ============================================================================
+// BenchServer
+// ============================================================================
+
+namespace {
+
+struct ListenerContext {
+  Worker* worker;
+  SSL_CTX* ssl_ctx;
+  const BenchServerConfig* config;
+};
+
+void OnConnection(uv_stream_t* listener, int status) {
+  if (status < 0) {
+    return;
+  }
+  auto* ctx = static_cast<ListenerContext*>(listener->data);
+
+  auto* session = new Session;
+  session->worker = ctx->worker;
+  session->config = ctx->config;
+  uv_tcp_init(&ctx->worker->loop, &session->handle);
+  session->handle.data = session;
+  ctx->worker->sessions.push_back(session);
+
+  if (uv_accept(listener, reinterpret_cast<uv_stream_t*>(&session->handle)) !=
+      0) {
+    CloseSession(session);
+    return;
+  }
+  uv_tcp_nodelay(&session->handle, 1);
+
+  session->ssl.reset(SSL_new(ctx->ssl_ctx));
+  session->rbio = BIO_new(BIO_s_mem());
+  session->wbio = BIO_new(BIO_s_mem());
+  if (!session->ssl || session->rbio == nullptr ||
+      session->wbio == nullptr) {
+    BIO_free(session->rbio);
+    BIO_free(session->wbio);
+    session->rbio = session->wbio = nullptr;
+    CloseSession(session);
+    return;
+  }
+  SSL_set_bio(session->ssl.get(), session->rbio, session->wbio);
+  SSL_set_accept_state(session->ssl.get());
+
+  ctx->worker->CountConnection();
+  uv_read_start(reinterpret_cast<uv_stream_t*>(&session->handle), OnAlloc,
+                OnRead);
+}
+
+void OnStop(uv_async_t* async) {
+  auto* worker = static_cast<Worker*>(async->data);
+  for (auto& listener : worker->listeners) {
+    delete static_cast<ListenerContext*>(listener->data);
+    uv_close(reinterpret_cast<uv_handle_t*>(listener.get()), nullptr);
+  }
+  // Copy: closing a session erases it from the list in its close callback
+  std::vector<Session*> sessions = worker->sessions;
+  for (Session* session : sessions) {
+    CloseSession(session);
+  }
+  uv_close(reinterpret_cast<uv_handle_t*>(async), nullptr);
+}
+
+}  // namespace
+
+BenchServer::BenchServer(const BenchServerConfig& config) : config_(config) {
+  if (config_.threads == 0) {
+    config_.threads = 1;
+  }
+  if (config_.listeners == 0) {
+    config_.listeners = 1;
+  }
+}
+
+BenchServer::~BenchServer() { Stop(); }
+
+bool BenchServer::CreateSslContext() {
+  ssl_ctx_.reset(SSL_CTX_new(TLS_method()));
+  if (!ssl_ctx_) {
+    return false;
+  }
+  SSL_CTX_set_min_proto_version(ssl_ctx_.get(), TLS1_2_VERSION);
+  SSL_CTX_set_alpn_select_cb(ssl_ctx_.get(), SelectAlpn, &config_.http1_only);
+  return UseSelfSignedCertificate(ssl_ctx_.get());
+}
+
+bool BenchServer::Start() {
+  if (!workers_.empty()) {
+    return true;
+  }
+  if (!CreateSslContext()) {
+    return false;
+  }
+
+  // Bind every worker's listeners first; the first worker picks the ports
+  ports_.assign(config_.listeners, 0);
+  for (size_t w = 0; w < config_.threads; ++w) {
+    auto worker = std::make_unique<Worker>();
+    worker->server = this;
+    uv_loop_init(&worker->loop);
+    uv_async_init(&worker->loop, &worker->stop_async, OnStop);
+    worker->stop_async.data = worker.get();
+
+    for (size_t l = 0; l < config_.listeners; ++l) {
+      util::socket_t sock = Listen(ports_[l]);
+      if (sock == util::kInvalidSocket) {
+        workers_.push_back(std::move(worker));
+        Stop();
+        return false;
+      }
+      ports_[l] = LocalPort(sock);
+
+      auto listener = std::make_unique<uv_tcp_t>();
+      uv_tcp_init(&worker->loop, listener.get());
+      uv_tcp_open(listener.get(), sock);
+      listener->data =
+          new ListenerContext{worker.get(), ssl_ctx_.get(), &config_};
+      uv_listen(reinterpret_cast<uv_stream_t*>(listener.get()), 1024,
+                OnConnection);
+      worker->listeners.push_back(std::move(listener));
+    }
+    workers_.push_back(std::move(worker));
+  }
+
+  for (auto& worker : workers_) {
+    threads_.emplace_back([w = worker.get()] {
+      uv_run(&w->loop, UV_RUN_DEFAULT);
+    });
+  }
+  return true;
+}
+
+void BenchServer::Stop() {
+  if (workers_.empty()) {
+    return;
+  }
+
+  if (threads_.empty()) {
+    // Start() failed before the loops ran: close handles here
+    for (auto& worker : workers_) {
+      OnStop(&worker->stop_async);
+      uv_run(&worker->loop, UV_RUN_DEFAULT);
+    }
+  } else {
+    for (auto& worker : workers_) {
+      uv_async_send(&worker->stop_async);
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+  }
+
+  for (auto& worker : workers_) {
+    uv_loop_close(&worker->loop);
+  }
+  workers_.clear();
+  ports_.clear();
+}
+
+}  // namespace bench
+}  // namespace holytls
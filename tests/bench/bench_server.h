@@ -0,0 +1,104 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// In-process HTTPS server for local benchmarks and client tests.
+//
+// Serves HTTP/1.1 and HTTP/2 (ALPN) over TLS on loopback with a self-signed
+// certificate, so the client runs its real TLS, session and framing code
+// without any external deployment. Each worker thread runs its own libuv
+// loop and accepts on a SO_REUSEPORT listener per port.
+//
+// Responses are chosen by path:
+//   /bytes/<n>        n bytes of text
+//   /gzip/<n>         n bytes of text, gzip-encoded (Content-Encoding: gzip)
+//   /redirect/<path>  302 to /<path>
+//   /loop             302 to itself
+//   otherwise         a 64-byte body
+
+#ifndef HOLYTLS_TESTS_BENCH_BENCH_SERVER_H_
+#define HOLYTLS_TESTS_BENCH_BENCH_SERVER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "holytls/tls/tls_context.h"
+
+namespace holytls {
+namespace bench {
+
+struct BenchServerConfig {
+  // Worker threads (each with its own event loop)
+  size_t threads = 2;
+
+  // Listening ports; each is a distinct origin to the client
+  size_t listeners = 1;
+
+  // Close a connection after this many responses (0 = keep-alive).
+  // HTTP/2 starts a graceful GOAWAY, so streams the client opened in the
+  // meantime are still served; HTTP/1.1 answers with Connection: close.
+  size_t max_requests_per_connection = 0;
+
+  // Only offer http/1.1 in ALPN
+  bool http1_only = false;
+
+  // The first HTTP/2 connection answers only its first stream: a GOAWAY
+  // naming it as the last stream goes out as soon as its request arrives,
+  // later streams are never answered, and the connection closes once the
+  // response is sent. Later connections behave normally.
+  bool goaway_first_connection = false;
+};
+
+class BenchServer {
+ public:
+  explicit BenchServer(const BenchServerConfig& config);
+  ~BenchServer();
+
+  // Non-copyable, non-movable
+  BenchServer(const BenchServer&) = delete;
+  BenchServer& operator=(const BenchServer&) = delete;
+  BenchServer(BenchServer&&) = delete;
+  BenchServer& operator=(BenchServer&&) = delete;
+
+  // Generate the certificate, bind the listeners and start the workers.
+  // Returns false if any step fails.
+  bool Start();
+
+  // Stop the workers and close every connection
+  void Stop();
+
+  // Bound loopback ports, one per listener
+  const std::vector<uint16_t>& ports() const { return ports_; }
+
+  // Totals across workers
+  uint64_t RequestCount() const {
+    return requests_.load(std::memory_order_relaxed);
+  }
+  uint64_t ConnectionCount() const {
+    return connections_.load(std::memory_order_relaxed);
+  }
+
+  // Per-thread event loop and sessions (defined in bench_server.cc)
+  struct Worker;
+
+ private:
+  bool CreateSslContext();
+
+  BenchServerConfig config_;
+  tls::SslCtxPtr ssl_ctx_;
+  std::vector<uint16_t> ports_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> connections_{0};
+  std::atomic<bool> goaway_claimed_{false};
+};
+
+}  // namespace bench
+}  // namespace holytls
+
+#endif  // HOLYTLS_TESTS_BENCH_BENCH_SERVER_H_
@@ -0,0 +1,368 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+//
+// Reproducible local benchmark suite.
+//
+// Runs each scenario against an in-process TLS server on loopback (see
+// bench_server.h), so results depend only on the machine and the commit.
+// Prints one JSON document with throughput and latency percentiles per
+// scenario; progress goes to stderr.
+//
+// Usage: ./holytls_bench [--scenario a,b] [--requests N] [--output FILE]
+
+#include <holytls/client.h>
+#include <holytls/config.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_server.h"
+
+using namespace holytls;
+
+namespace {
+
+struct BenchOptions {
+  size_t requests = 20000;  // Per scenario, before requests_divisor
+  size_t concurrency = 64;  // Requests in flight
+  size_t server_threads = 2;
+  size_t client_threads = 2;
+  std::vector<std::string> scenarios;  // Empty = all
+  std::string output;                  // Empty = stdout
+};
+
+struct Scenario {
+  std::string_view name;
+  std::string_view description;
+  std::string_view path;
+  bool http1 = false;
+  size_t origins = 1;
+  size_t max_requests_per_connection = 0;
+  size_t requests_divisor = 1;  // Heavier scenarios run fewer requests
+};
+
+constexpr Scenario kScenarios[] = {
+    {"small_get_h2", "64-byte GETs multiplexed over HTTP/2", "/bytes/64"},
+    {"small_get_h1", "64-byte GETs over HTTP/1.1 keep-alive", "/bytes/64",
+     true},
+    {"large_body", "1 MiB bodies over HTTP/2", "/bytes/1048576", false, 1, 0,
+     50},
+    {"handshake", "Server ends each connection after one response",
+     "/bytes/64", false, 1, 1, 20},
+    {"churn", "HTTP/2 connections recycled every 16 requests", "/bytes/64",
+     false, 1, 16, 2},
+    {"fanout", "64-byte GETs spread across 32 origins", "/bytes/64", false,
+     32},
+    {"decompress", "64 KiB gzip bodies decoded by the client", "/gzip/65536",
+     false, 1, 0, 10},
+};
+
+struct ScenarioResult {
+  const Scenario* scenario = nullptr;
+  size_t requests = 0;
+  size_t failed = 0;
+  double seconds = 0.0;
+  uint64_t body_bytes = 0;
+  uint64_t server_connections = 0;
+  ClientStats stats;
+};
+
+// Keeps `concurrency` requests in flight until `total` have been issued
+class Driver {
+ public:
+  Driver(HttpClient* client, std::vector<std::string> urls, size_t total)
+      : client_(client), urls_(std::move(urls)), total_(total) {}
+
+  void Issue() {
+    size_t n = issued_.fetch_add(1, std::memory_order_relaxed);
+    if (n >= total_) {
+      return;
+    }
+    Request request;
+    request.SetUrl(urls_[n % urls_.size()]);
+    client_->SendAsync(std::move(request), [this](Response response,
+                                                  Error error) {
+      if (error || response.status_code != 200) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        body_bytes_.fetch_add(response.body.size(), std::memory_order_relaxed);
+      }
+      Issue();
+    });
+  }
+
+  size_t failed() const { return failed_.load(std::memory_order_relaxed); }
+  uint64_t body_bytes() const {
+    return body_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  HttpClient* client_;
+  std::vector<std::string> urls_;
+  size_t total_;
+  std::atomic<size_t> issued_{0};
+  std::atomic<size_t> failed_{0};
+  std::atomic<uint64_t> body_bytes_{0};
+};
+
+bool RunScenario(const Scenario& scenario, const BenchOptions& options,
+                 ScenarioResult* result) {
+  bench::BenchServerConfig server_config;
+  server_config.threads = options.server_threads;
+  server_config.listeners = scenario.origins;
+  server_config.max_requests_per_connection =
+      scenario.max_requests_per_connection;
+  server_config.http1_only = scenario.http1;
+
+  bench::BenchServer server(server_config);
+  if (!server.Start()) {
+    std::println(stderr, "{}: failed to start server", scenario.name);
+    return false;
+  }
+
+  std::vector<std::string> urls;
+  for (uint16_t port : server.ports()) {
+    urls.push_back("https://127.0.0.1:" + std::to_string(port) +
+                   std::string(scenario.path));
+  }
+
+  ClientConfig config = ClientConfig::ChromeLatest();
+  config.tls.verify_certificates = false;  // Self-signed server certificate
+  config.threads.num_workers = options.client_threads;
+  config.high_resolution_timing = true;
+  config.follow_redirects = false;
+
+  size_t total = options.requests / scenario.requests_divisor;
+  if (total == 0) {
+    total = 1;
+  }
+
+  HttpClient client(config);
+  client.Start();
+
+  Driver driver(&client, std::move(urls), total);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < options.concurrency && i < total; ++i) {
+    driver.Issue();
+  }
+  client.WaitIdle();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  result->scenario = &scenario;
+  result->requests = total;
+  result->failed = driver.failed();
+  result->seconds = std::chrono::duration<double>(elapsed).count();
+  result->body_bytes = driver.body_bytes();
+  result->stats = client.GetStats();
+
+  client.Stop();
+  server.Stop();
+  result->server_connections = server.ConnectionCount();
+  return true;
+}
+
+// ============================================================================
+// JSON output
+// ============================================================================
+
+void PrintLatency(std::FILE* out, std::string_view name,
+                  const LatencyStats& latency) {
+  std::print(out,
+             "\"{}\":{{\"count\":{},\"mean\":{:.3f},\"p50\":{:.3f},"
+             "\"p90\":{:.3f},\"p99\":{:.3f},\"p999\":{:.3f},\"max\":{:.3f}}}",
+             name, latency.count, latency.mean_ms, latency.p50_ms,
+             latency.p90_ms, latency.p99_ms, latency.p999_ms, latency.max_ms);
+}
+
+void PrintResult(std::FILE* out, const ScenarioResult& r) {
+  const Scenario& s = *r.scenario;
+  double seconds = r.seconds > 0.0 ? r.seconds : 1e-9;
+  size_t completed = r.requests - r.failed;
+
+  std::print(out,
+             "{{\"name\":\"{}\",\"description\":\"{}\",\"protocol\":\"{}\","
+             "\"origins\":{},\"requests\":{},\"failed\":{},\"seconds\":{:.3f},"
+             "\"requests_per_second\":{:.1f},\"body_mib_per_second\":{:.2f},"
+             "\"connections_created\":{},\"server_connections\":{},",
+             s.name, s.description, s.http1 ? "http/1.1" : "h2", s.origins,
+             r.requests, r.failed, r.seconds,
+             static_cast<double>(completed) / seconds,
+             static_cast<double>(r.body_bytes) / (1024.0 * 1024.0) / seconds,
+             r.stats.connections_created, r.server_connections);
+  PrintLatency(out, "latency_ms", r.stats.total);
+  std::print(out, ",");
+  PrintLatency(out, "ttfb_ms", r.stats.ttfb);
+  std::print(out, ",");
+  PrintLatency(out, "tls_ms", r.stats.tls);
+  std::print(out, "}}");
+}
+
+void PrintReport(std::FILE* out, const BenchOptions& options,
+                 const std::vector<ScenarioResult>& results) {
+  std::print(out,
+             "{{\"benchmark\":\"holytls_bench\",\"config\":{{\"requests\":{},"
+             "\"concurrency\":{},\"server_threads\":{},"
+             "\"client_threads\":{}}},\"scenarios\":[",
+             options.requests, options.concurrency, options.server_threads,
+             options.client_threads);
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (i > 0) {
+      std::print(out, ",");
+    }
+    PrintResult(out, results[i]);
+  }
+  std::println(out, "]}}");
+}
+
+// ============================================================================
+// Command line
+// ============================================================================
+
+void PrintUsage(const char* program) {
+  std::println(
+      "Usage: {} [options]\n"
+      "\n"
+      "Options:\n"
+      "  --scenario A,B     Scenarios to run (default: all)\n"
+      "  --requests N       Requests per scenario (default: 20000; heavier\n"
+      "                     scenarios run a fraction)\n"
+      "  --concurrency N    Requests in flight (default: 64)\n"
+      "  --server-threads N Server worker threads (default: 2)\n"
+      "  --client-threads N Client reactor threads (default: 2)\n"
+      "  --output FILE      Write JSON to FILE instead of stdout\n"
+      "  --list             List scenarios\n"
+      "  --help             Show this help",
+      program);
+}
+
+std::vector<std::string> SplitList(std::string_view list) {
+  std::vector<std::string> items;
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t comma = list.find(',', start);
+    if (comma == std::string_view::npos) {
+      comma = list.size();
+    }
+    if (comma > start) {
+      items.emplace_back(list.substr(start, comma - start));
+    }
+    start = comma + 1;
+  }
+  return items;
+}
+
+// Returns 0 to run, 1 on error, 2 when done (help/list)
+int ParseArgs(int argc, char* argv[], BenchOptions* options) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--help") == 0 ||
+        std::strcmp(argv[i], "-h") == 0) {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+    if (std::strcmp(argv[i], "--list") == 0) {
+      for (const Scenario& s : kScenarios) {
+        std::println("{:<14} {}", s.name, s.description);
+      }
+      return 2;
+    }
+    if (std::strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+      options->scenarios = SplitList(argv[++i]);
+    } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+      options->requests = std::stoul(argv[++i]);
+    } else if (std::strcmp(argv[i], "--concurrency") == 0 && i + 1 < argc) {
+      options->concurrency = std::stoul(argv[++i]);
+    } else if (std::strcmp(argv[i], "--server-threads") == 0 &&
+               i + 1 < argc) {
+      options->server_threads = std::stoul(argv[++i]);
+    } else if (std::strcmp(argv[i], "--client-threads") == 0 &&
+               i + 1 < argc) {
+      options->client_threads = std::stoul(argv[++i]);
+    } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      options->output = argv[++i];
+    } else {
+      std::println(stderr, "Unknown option: {}", argv[i]);
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  for (const std::string& name : options->scenarios) {
+    bool known = false;
+    for (const Scenario& s : kScenarios) {
+      known = known || s.name == name;
+    }
+    if (!known) {
+      std::println(stderr, "Unknown scenario: {} (see --list)", name);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+bool Selected(const BenchOptions& options, std::string_view name) {
+  if (options.scenarios.empty()) {
+    return true;
+  }
+  for (const std::string& s : options.scenarios) {
+    if (s == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  BenchOptions options;
+  int parsed = ParseArgs(argc, argv, &options);
+  if (parsed != 0) {
+    return parsed == 2 ? 0 : 1;
+  }
+
+  std::vector<ScenarioResult> results;
+  for (const Scenario& scenario : kScenarios) {
+    if (!Selected(options, scenario.name)) {
+      continue;
+    }
+    std::print(stderr, "{:<14} ", scenario.name);
+    ScenarioResult result;
+    if (!RunScenario(scenario, options, &result)) {
+      return 1;
+    }
+    std::println(stderr, "{:>10.1f} req/s  p50 {:.3f} ms  p99 {:.3f} ms  {} "
+                 "failed",
+                 static_cast<double>(result.requests - result.failed) /
+                     result.seconds,
+                 result.stats.total.p50_ms, result.stats.total.p99_ms,
+                 result.failed);
+    results.push_back(result);
+  }
+
+  std::FILE* out = stdout;
+  if (!options.output.empty()) {
+    out = std::fopen(options.output.c_str(), "w");
+    if (out == nullptr) {
+      std::println(stderr, "Cannot open {}", options.output);
+      return 1;
+    }
+  }
+  PrintReport(out, options, results);
+  if (out != stdout) {
+    std::fclose(out);
+  }
+
+  // Failed requests make the run unusable as a baseline
+  for (const ScenarioResult& r : results) {
+    if (r.failed > 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -60,6 +60,12 @@ int MakeRequest(holytls::core::Reactor& reactor,
         conn = std::make_unique<holytls::core::Connection>(
             &reactor, &tls_factory, host, 443);
 
+        // Connections leave the loop running when they fail; this test
+        // runs one at a time, so a closed connection ends the run
+        conn->closed_callback = [&reactor](holytls::core::Connection*) {
+          reactor.Stop();
+        };
+
         if (!conn->Connect(addresses[0].ip, addresses[0].is_ipv6)) {
           error = "Connect failed";
           reactor.Stop();
@@ -81,7 +87,8 @@ int MakeRequest(holytls::core::Reactor& reactor,
               }
               reactor.Stop();
             },
-            [&error, &reactor, verbose, &host](const std::string& err) {
+            [&error, &reactor, verbose, &host](
+                const std::string& err, holytls::core::StreamError) {
               error = err;
               if (verbose) {
                 std::println("[DEBUG] Error from {}: {}", host, err);
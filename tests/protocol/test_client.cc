@@ -0,0 +1,263 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// HttpClient end to end against the in-process HTTPS server from
+// tests/bench: real TLS, HTTP/1.1 and HTTP/2 framing, pooling and the
+// reactor paths that unit tests cannot reach.
+
+#include <cassert>
+#include <print>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_server.h"
+#include "holytls/client.h"
+#include "holytls/config.h"
+#include "holytls/core/connection.h"
+#include "holytls/core/reactor.h"
+#include "holytls/core/trace.h"
+#include "holytls/tls/tls_context.h"
+
+using namespace holytls;
+
+namespace {
+
+bench::BenchServerConfig MakeServerConfig() {
+  bench::BenchServerConfig config;
+  config.threads = 1;
+  return config;
+}
+
+ClientConfig MakeConfig() {
+  ClientConfig config = ClientConfig::ChromeLatest();
+  config.tls.verify_certificates = false;  // Self-signed server certificate
+  config.threads.num_workers = 1;
+  return config;
+}
+
+Request MakeRequest(uint16_t port, const std::string& path) {
+  Request request;
+  request.method = Method::kGet;
+  request.url = "https://localhost:" + std::to_string(port) + path;
+  return request;
+}
+
+}  // namespace
+
+void TestCoalescedRedirectLoop() {
+  std::print("Testing coalesced redirect back to the same URL... ");
+
+  bench::BenchServer server(MakeServerConfig());
+  assert(server.Start());
+  uint16_t port = server.ports()[0];
+
+  ClientConfig config = MakeConfig();
+  config.coalesce.enabled = true;
+  config.max_redirects = 3;
+  HttpClient client(config);
+
+  // Every hop is the URL the chain started from: none may join it
+  ResponseResult self = client.SendAsync(MakeRequest(port, "/loop")).get();
+  assert(self.ok());
+  assert(self.response.status_code == 302);
+  assert(self.response.redirects.size() == 3);
+
+  // A -> B -> A -> ...
+  ResponseResult back =
+      client.SendAsync(MakeRequest(port, "/redirect/loop")).get();
+  assert(back.ok());
+  assert(back.response.status_code == 302);
+  assert(back.response.redirects.size() == 3);
+
+  assert(client.GetStats().requests_coalesced == 0);
+  std::println("PASSED");
+}
+
+void TestMemoryCapMidBody() {
+  std::print("Testing memory cap reached mid-body... ");
+
+  bench::BenchServer server(MakeServerConfig());
+  assert(server.Start());
+  uint16_t port = server.ports()[0];
+
+  // Each body alone is over the cap: open streams must keep reading
+  constexpr size_t kCap = 1024 * 1024;
+  constexpr size_t kBodySize = 2 * kCap;
+  ClientConfig config = MakeConfig();
+  config.memory.max_bytes_per_reactor = kCap;
+  config.memory.reject_requests = false;
+  HttpClient client(config);
+
+  std::vector<std::future<ResponseResult>> futures;
+  for (int i = 0; i < 8; ++i) {
+    futures.push_back(client.SendAsync(
+        MakeRequest(port, "/bytes/" + std::to_string(kBodySize))));
+  }
+  for (auto& future : futures) {
+    ResponseResult result = future.get();
+    assert(result.ok());
+    assert(result.response.body_view().size() == kBodySize);
+  }
+
+  MemoryStats stats = client.GetMemoryStats();
+  if (stats.enabled) {
+    assert(stats.total.peak_bytes >= kCap);
+  }
+  std::println("PASSED");
+}
+
+void TestHttp1QueuedBeforeHandshake() {
+  std::print("Testing HTTP/1.1 requests queued before the handshake... ");
+
+  bench::BenchServerConfig server_config = MakeServerConfig();
+  server_config.http1_only = true;
+  bench::BenchServer server(server_config);
+  assert(server.Start());
+
+  core::Reactor reactor;
+  assert(reactor.Initialize());
+  TlsConfig tls_config;
+  tls_config.verify_certificates = false;
+  tls::TlsContextFactory tls_factory;
+  assert(tls_factory.Initialize(tls_config));
+
+  core::Connection conn(&reactor, &tls_factory, "localhost",
+                        server.ports()[0]);
+  assert(conn.Connect("127.0.0.1"));
+
+  // Both wait for the handshake; the second goes once the first completes
+  std::vector<size_t> sizes;
+  for (const char* path : {"/bytes/100", "/bytes/200"}) {
+    conn.SendRequest(
+        "GET", path, {},
+        [&sizes](core::RawResponse response) {
+          assert(response.status_code == 200);
+          sizes.push_back(response.body.size());
+        },
+        [](const std::string&, core::StreamError) { assert(false); });
+  }
+
+  for (int i = 0; i < 500 && sizes.size() < 2; ++i) {
+    reactor.RunFor(10);
+  }
+  assert(sizes.size() == 2);
+  assert(sizes[0] == 100 && sizes[1] == 200);
+  assert(server.ConnectionCount() == 1);
+
+  std::println("PASSED");
+}
+
+void TestGoawayReplaysRefusedStreams() {
+  std::print("Testing GOAWAY below in-flight streams... ");
+
+  bench::BenchServerConfig server_config = MakeServerConfig();
+  server_config.goaway_first_connection = true;
+  bench::BenchServer server(server_config);
+  assert(server.Start());
+  uint16_t port = server.ports()[0];
+
+  // One connection per host: every request shares the first connection,
+  // whose GOAWAY names only the first stream
+  ClientConfig config = MakeConfig();
+  config.pool.max_connections_per_host = 1;
+  HttpClient client(config);
+
+  std::vector<std::future<ResponseResult>> futures;
+  for (int i = 0; i < 4; ++i) {
+    futures.push_back(client.SendAsync(MakeRequest(port, "/bytes/100")));
+  }
+  for (auto& future : futures) {
+    ResponseResult result = future.get();
+    assert(result.ok());
+    assert(result.response.status_code == 200);
+    assert(result.response.body_view().size() == 100);
+  }
+
+  // The refused streams were never processed: sent again, not failed
+  ClientStats stats = client.GetStats();
+  assert(stats.requests_replayed > 0);
+  assert(stats.requests_failed == 0);
+  assert(server.ConnectionCount() >= 2);
+
+  std::println("PASSED");
+}
+
+void TestDroppedStreamsTraced() {
+  std::print("Testing stream end traced for dropped streams... ");
+  if constexpr (!core::kTracingEnabled) {
+    std::println("SKIPPED (built without HOLYTLS_TRACING)");
+    return;
+  }
+
+  bench::BenchServer server(MakeServerConfig());
+  assert(server.Start());
+
+  core::Reactor reactor;
+  assert(reactor.Initialize());
+  TlsConfig tls_config;
+  tls_config.verify_certificates = false;
+  tls::TlsContextFactory tls_factory;
+  assert(tls_factory.Initialize(tls_config));
+
+  core::TraceRing ring(1024);
+  core::ConnectionOptions options;
+  options.trace = &ring;
+  core::Connection conn(&reactor, &tls_factory, "localhost",
+                        server.ports()[0], options);
+  assert(conn.Connect("127.0.0.1"));
+
+  // Bodies far larger than the flow-control windows stay in flight
+  const std::string path = "/bytes/" + std::to_string(32 * 1024 * 1024);
+  int failed = 0;
+  auto on_response = [](core::RawResponse) { assert(false); };
+  auto on_error = [&failed](const std::string&, core::StreamError) {
+    ++failed;
+  };
+  uint64_t cancelled = conn.SendRequest("GET", path, {}, on_response);
+  conn.SendRequest("GET", path, {}, on_response, on_error);
+  for (int i = 0; i < 500 && !conn.ResponseStarted(cancelled); ++i) {
+    reactor.RunFor(10);
+  }
+  assert(conn.ResponseStarted(cancelled));
+  assert(conn.CancelRequest(cancelled));
+
+  // Losing the connection drops the other stream
+  server.Stop();
+  for (int i = 0; i < 500 && failed == 0; ++i) {
+    reactor.RunFor(10);
+  }
+  assert(failed == 1);
+
+  constexpr uint64_t kInternalError = 0x2;  // NGHTTP2_INTERNAL_ERROR
+  constexpr uint64_t kCancel = 0x8;         // NGHTTP2_CANCEL
+  std::vector<int64_t> opened;
+  std::vector<std::pair<int64_t, uint64_t>> ended;
+  for (const core::TraceRecord& record : ring.Snapshot()) {
+    if (record.event == core::TraceEvent::kStreamOpen) {
+      opened.push_back(record.stream);
+    } else if (record.event == core::TraceEvent::kStreamEnd) {
+      ended.emplace_back(record.stream, record.arg);
+    }
+  }
+  assert(opened.size() == 2);
+  assert(ended.size() == 2);
+  assert(ended[0] == std::make_pair(opened[0], kCancel));
+  assert(ended[1] == std::make_pair(opened[1], kInternalError));
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== HttpClient End-to-End Tests ===\n");
+
+  TestCoalescedRedirectLoop();
+  TestMemoryCapMidBody();
+  TestHttp1QueuedBeforeHandshake();
+  TestGoawayReplaysRefusedStreams();
+  TestDroppedStreamsTraced();
+
+  std::println("\nAll client tests passed!");
+  return 0;
+}
@@ -12,6 +12,7 @@
 #include <string_view>
 #include <vector>
 
+#include "holytls/http/request_headers.h"
 #include "holytls/http1/h1_session.h"
 #include "holytls/http2/h2_stream.h"
 #include "holytls/http2/packed_headers.h"
@@ -521,6 +522,61 @@ void TestHttp1CustomHeaders() {
   std::println("PASSED");
 }
 
+// ============================================================================
+// Test: Header name case on the wire
+// ============================================================================
+
+void TestHttp1HeaderCase() {
+  std::print("Testing HTTP/1.1 header name case... ");
+
+  http1::H1Session::SessionCallbacks callbacks;
+  http1::H1Session session(callbacks);
+  assert(session.Initialize());
+
+  http2::H2StreamCallbacks stream_callbacks;
+  stream_callbacks.on_headers = [](int32_t, const http2::PackedHeaders&) {};
+  stream_callbacks.on_close = [](int32_t, uint32_t) {};
+
+  // Template names are lowercase; caller names keep their case
+  http::RequestHeaders headers;
+  headers.SetMethodStatic("GET");
+  headers.SetAuthority("example.com");
+  headers.SetPath("/");
+  headers.AddStatic("sec-ch-ua-mobile", "?0");
+  headers.AddStatic("user-agent", "HolyTLS/1.0");
+  headers.AddStatic("accept-encoding", "gzip");
+  headers.Add("X-Api-Key", "secret");
+  headers.Add("x-lower", "1");
+
+  assert(session.SubmitRequest(headers, stream_callbacks, false) == 1);
+  auto [data, len] = session.GetPendingData();
+  std::string request(reinterpret_cast<const char*>(data), len);
+
+  // Chrome's HTTP/1.1 spelling: Title-Case, client hints lowercase
+  assert(request.find("Host: example.com\r\n") != std::string::npos);
+  assert(request.find("sec-ch-ua-mobile: ?0\r\n") != std::string::npos);
+  assert(request.find("User-Agent: HolyTLS/1.0\r\n") != std::string::npos);
+  assert(request.find("Accept-Encoding: gzip\r\n") != std::string::npos);
+  assert(request.find("X-Api-Key: secret\r\n") != std::string::npos);
+  assert(request.find("x-lower: 1\r\n") != std::string::npos);
+
+  // Custom order writes every name exactly as given
+  session.DataSent(len);
+  constexpr std::string_view response =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 0\r\n"
+      "\r\n";
+  session.Receive(reinterpret_cast<const uint8_t*>(response.data()),
+                  response.size());
+  assert(session.SubmitRequest(headers, stream_callbacks, true) == 2);
+  auto [data2, len2] = session.GetPendingData();
+  std::string ordered(reinterpret_cast<const char*>(data2), len2);
+  assert(ordered.find("user-agent: HolyTLS/1.0\r\n") != std::string::npos);
+  assert(ordered.find("X-Api-Key: secret\r\n") != std::string::npos);
+
+  std::println("PASSED");
+}
+
 // ============================================================================
 // Test: Cannot submit while request in flight
 // ============================================================================
@@ -584,6 +640,7 @@ int main() {
   TestHttp1LargeBody();
   TestHttp1KeepAlive();
   TestHttp1CustomHeaders();
+  TestHttp1HeaderCase();
   TestHttp1NoMultiplexing();
 
   std::println("\n=== All HTTP/1.1 tests passed! ===");
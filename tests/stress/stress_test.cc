@@ -12,6 +12,7 @@
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <mutex>
 #include <print>
 #include <string>
@@ -33,6 +34,9 @@ struct StressConfig {
   bool single_threaded = false;  // Run like Node.js (single event loop)
   bool insecure = false;         // Skip TLS certificate verification
   bool verbose = false;
+  holytls::SocketBufferMode socket_mode =
+      holytls::SocketBufferMode::kAutotune;
+  size_t socket_buffer_kb = 256;  // For --socket-mode fixed
 };
 
 // Latency histogram buckets (microseconds)
@@ -153,6 +157,9 @@ void PrintUsage(const char* prog) {
       "  --single-threaded  Run with single reactor thread (like Node.js)\n"
       "  --insecure         Skip TLS certificate verification (for self-signed "
       "certs)\n"
+      "  --socket-mode M    Socket buffers: autotune, fixed, adaptive "
+      "(default: autotune)\n"
+      "  --socket-buffer N  Buffer size in KB for fixed mode (default: 256)\n"
       "  --verbose          Print verbose output\n"
       "  --help             Show this help\n"
       "\n"
@@ -204,6 +211,20 @@ bool ParseArgs(int argc, char* argv[], StressConfig* config) {
       config->insecure = true;
     } else if (std::strcmp(argv[i], "--verbose") == 0) {
       config->verbose = true;
+    } else if (std::strcmp(argv[i], "--socket-mode") == 0 && i + 1 < argc) {
+      const char* mode = argv[++i];
+      if (std::strcmp(mode, "autotune") == 0) {
+        config->socket_mode = holytls::SocketBufferMode::kAutotune;
+      } else if (std::strcmp(mode, "fixed") == 0) {
+        config->socket_mode = holytls::SocketBufferMode::kFixed;
+      } else if (std::strcmp(mode, "adaptive") == 0) {
+        config->socket_mode = holytls::SocketBufferMode::kAdaptive;
+      } else {
+        std::println(stderr, "Unknown socket mode: {}", mode);
+        return false;
+      }
+    } else if (std::strcmp(argv[i], "--socket-buffer") == 0 && i + 1 < argc) {
+      config->socket_buffer_kb = std::stoul(argv[++i]);
     } else {
       std::println(stderr, "Unknown option: {}", argv[i]);
       PrintUsage(argv[0]);
@@ -277,6 +298,44 @@ double CalculatePercentile(std::vector<uint64_t>& samples, double percentile) {
   return static_cast<double>(samples[idx]) / 1000.0;  // Convert to ms
 }
 
+const char* SocketModeName(holytls::SocketBufferMode mode) {
+  switch (mode) {
+    case holytls::SocketBufferMode::kAutotune:
+      return "autotune";
+    case holytls::SocketBufferMode::kFixed:
+      return "fixed";
+    case holytls::SocketBufferMode::kAdaptive:
+      return "adaptive";
+  }
+  return "unknown";
+}
+
+// Process peak RSS and kernel TCP buffer memory (Linux only). Socket
+// buffers live in the kernel, so they show up in sockstat, not in RSS.
+void PrintMemoryUsage() {
+#ifdef __linux__
+  std::println("");
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.starts_with("VmHWM:")) {
+      std::println("Peak RSS:       {}", line.substr(6));
+    }
+  }
+
+  // "TCP: inuse N orphan N tw N alloc N mem N" (mem in pages)
+  std::ifstream sockstat("/proc/net/sockstat");
+  while (std::getline(sockstat, line)) {
+    size_t pos = line.find(" mem ");
+    if (line.starts_with("TCP:") && pos != std::string::npos) {
+      uint64_t pages = std::stoull(line.substr(pos + 5));
+      std::println("Kernel TCP mem: {:.1f} MB (system-wide)",
+                   static_cast<double>(pages) * 4096 / (1024.0 * 1024.0));
+    }
+  }
+#endif
+}
+
 void PrintFinalReport(const StressConfig& config, const StressMetrics& metrics,
                       std::chrono::steady_clock::duration test_duration) {
   double duration_sec = std::chrono::duration<double>(test_duration).count();
@@ -327,6 +386,8 @@ void PrintFinalReport(const StressConfig& config, const StressMetrics& metrics,
   std::println("Peak RPS:        {}", peak_rps);
   std::println("Bytes Received:  {} ({:.2f} MB)", bytes,
                static_cast<double>(bytes) / (1024.0 * 1024.0));
+  std::println("Throughput:      {:.2f} MB/s",
+               static_cast<double>(bytes) / (1024.0 * 1024.0) / duration_sec);
   std::println("");
   std::println("Latency P50:     {:.2f} ms", p50);
   std::println("Latency P95:     {:.2f} ms", p95);
@@ -349,6 +410,8 @@ void PrintFinalReport(const StressConfig& config, const StressMetrics& metrics,
     std::string bar(bar_len, '#');
     std::println("  {}: {:>8} ({:>5.1f}%) {}", labels[i], count, pct, bar);
   }
+
+  PrintMemoryUsage();
 }
 
 class StressTest {
@@ -375,6 +438,7 @@ class StressTest {
     if (config_.insecure) {
       std::println("TLS Verify:  DISABLED (insecure mode)");
     }
+    std::println("Socket mode: {}", SocketModeName(config_.socket_mode));
     std::println("");
 
     // Configure client
@@ -384,6 +448,8 @@ class StressTest {
     if (config_.insecure) {
       client_config.tls.verify_certificates = false;
     }
+    client_config.socket.buffer_mode = config_.socket_mode;
+    client_config.socket.buffer_size = config_.socket_buffer_kb * 1024;
     if (config_.single_threaded) {
       client_config.threads.num_workers = 1;
     } else if (config_.num_threads > 0) {
@@ -408,9 +474,8 @@ class StressTest {
     // Run warmup
     auto warmup_end = warmup_start + std::chrono::seconds(config_.warmup_sec);
     while (std::chrono::steady_clock::now() < warmup_end) {
+      // Blocks until a response arrives (at most 10ms)
       client_->RunOnce();
-      // Yield CPU during warmup - IO bound, no need to spin
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
     uint64_t warmup_sent = metrics_.requests_sent.load();
@@ -476,9 +541,6 @@ class StressTest {
             }
           }
         }
-      } else {
-        // At target concurrency - yield CPU instead of spinning
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
       }
 
       // Live reporting every second
@@ -505,8 +567,6 @@ class StressTest {
         std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
     while (std::chrono::steady_clock::now() < drain_end) {
       client_->RunOnce();
-      // Yield CPU during drain
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
     PrintFinalReport(config_, metrics_, test_duration);
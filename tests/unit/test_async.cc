@@ -0,0 +1,205 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/async.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace holytls;
+
+namespace {
+
+std::atomic<int> g_pending_threads{0};
+
+// Resumes the awaiting coroutine on a new thread after `delay_ms`, standing
+// in for a reactor thread completing I/O
+struct ResumeOnThread {
+  int delay_ms;
+
+  bool await_ready() noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> h) {
+    g_pending_threads.fetch_add(1);
+    std::thread([h, delay = delay_ms] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+      h.resume();
+      g_pending_threads.fetch_sub(1);
+    }).detach();
+  }
+
+  void await_resume() noexcept {}
+};
+
+void WaitForThreads() {
+  while (g_pending_threads.load() != 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+Task<int> Delayed(int value, int delay_ms) {
+  co_await ResumeOnThread{delay_ms};
+  co_return value;
+}
+
+Task<int> Immediate(int value) { co_return value; }
+
+Task<std::string> DelayedString(std::string value, int delay_ms) {
+  co_await ResumeOnThread{delay_ms};
+  co_return value;
+}
+
+}  // namespace
+
+void TestFrameCacheRecycles() {
+  std::print("Testing frame cache recycles frames... ");
+
+  auto& cache = detail::FrameCache::Local();
+  void* a = cache.Allocate(200);
+  cache.Deallocate(a, 200);
+  void* b = cache.Allocate(200);
+  assert(a == b);  // Same size class, reused
+  cache.Deallocate(b, 200);
+
+  // Oversized frames bypass the cache
+  void* big = cache.Allocate(64 * 1024);
+  cache.Deallocate(big, 64 * 1024);
+
+  std::println("PASSED");
+}
+
+void TestSyncWait() {
+  std::print("Testing sync_wait... ");
+
+  assert(Immediate(7).sync_wait() == 7);
+  assert(Delayed(42, 5).sync_wait() == 42);
+  WaitForThreads();
+
+  std::println("PASSED");
+}
+
+void TestWhenAllTuple() {
+  std::print("Testing WhenAll (tuple)... ");
+
+  auto run = []() -> Task<int> {
+    auto [a, b, c] = co_await WhenAll(Delayed(1, 10), Immediate(2),
+                                      DelayedString("three", 5));
+    assert(a == 1);
+    assert(b == 2);
+    assert(c == "three");
+    co_return a + b;
+  };
+  assert(run().sync_wait() == 3);
+  WaitForThreads();
+
+  std::println("PASSED");
+}
+
+void TestWhenAllVector() {
+  std::print("Testing WhenAll (vector)... ");
+
+  auto run = []() -> Task<std::vector<int>> {
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 16; ++i) {
+      // Later tasks finish first; results stay in input order
+      tasks.push_back(Delayed(i, 16 - i));
+    }
+    co_return co_await WhenAll(std::move(tasks));
+  };
+  std::vector<int> values = run().sync_wait();
+  assert(values.size() == 16);
+  for (int i = 0; i < 16; ++i) {
+    assert(values[i] == i);
+  }
+
+  auto empty = []() -> Task<void> {
+    co_await WhenAll(std::vector<Task<void>>{});
+  };
+  empty().sync_wait();
+  WaitForThreads();
+
+  std::println("PASSED");
+}
+
+void TestWhenAny() {
+  std::print("Testing WhenAny... ");
+
+  auto run = []() -> Task<WhenAnyResult<int>> {
+    std::vector<Task<int>> tasks;
+    tasks.push_back(Delayed(10, 50));
+    tasks.push_back(Delayed(20, 1));
+    tasks.push_back(Delayed(30, 50));
+    co_return co_await WhenAny(std::move(tasks));
+  };
+  WhenAnyResult<int> result = run().sync_wait();
+  assert(result.index == 1);
+  assert(result.value == 20);
+
+  // A task that completes while the others are being started
+  auto sync_winner = []() -> Task<WhenAnyResult<int>> {
+    std::vector<Task<int>> tasks;
+    tasks.push_back(Delayed(1, 20));
+    tasks.push_back(Immediate(2));
+    co_return co_await WhenAny(std::move(tasks));
+  };
+  result = sync_winner().sync_wait();
+  assert(result.index == 1);
+  assert(result.value == 2);
+
+  // Losers finish in the background
+  WaitForThreads();
+
+  std::println("PASSED");
+}
+
+void TestForEachConcurrent() {
+  std::print("Testing ForEachConcurrent... ");
+
+  std::vector<int> items(50);
+  for (int i = 0; i < 50; ++i) items[i] = i;
+
+  std::atomic<int> active{0};
+  std::atomic<int> max_active{0};
+  std::atomic<int> sum{0};
+
+  auto visit = [&](int item) -> Task<void> {
+    int now = active.fetch_add(1) + 1;
+    int prev = max_active.load();
+    while (now > prev && !max_active.compare_exchange_weak(prev, now)) {
+    }
+    co_await ResumeOnThread{1};
+    sum.fetch_add(item);
+    active.fetch_sub(1);
+  };
+
+  ForEachConcurrent(items, 4, visit).sync_wait();
+  assert(sum.load() == 49 * 50 / 2);
+  assert(max_active.load() <= 4);
+  assert(max_active.load() >= 1);
+
+  std::vector<int> none;
+  ForEachConcurrent(none, 4, visit).sync_wait();
+  WaitForThreads();
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Async Unit Tests ===\n");
+
+  TestFrameCacheRecycles();
+  TestSyncWait();
+  TestWhenAllTuple();
+  TestWhenAllVector();
+  TestWhenAny();
+  TestForEachConcurrent();
+
+  std::println("\nAll async tests passed!");
+  return 0;
+}
@@ -0,0 +1,155 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http2/chrome_header_template.h"
+
+#include <cassert>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "holytls/config.h"
+#include "holytls/http2/chrome_header_profile.h"
+
+using namespace holytls;
+using namespace holytls::http2;
+
+namespace {
+
+// Position of `name` in the block, or -1
+int Position(const http::RequestHeaders& headers, std::string_view name) {
+  auto h = headers.headers();
+  for (size_t i = 0; i < h.size(); ++i) {
+    if (h[i].name == name) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+}  // namespace
+
+void TestMatchesBuildChromeHeaders() {
+  std::print("Testing template matches BuildChromeHeaders... ");
+
+  const auto& profile = GetChromeHeaderProfile(ChromeVersion::kChrome143);
+  ChromeHeaderTemplates templates(profile);
+
+  http::RequestHeaders out;
+  templates.Apply(FetchContext::Navigation(), {}, {}, &out);
+
+  auto expected = BuildChromeHeaders(profile, RequestType::kNavigation,
+                                     FetchSite::kNone, FetchMode::kNavigate,
+                                     FetchDest::kDocument, true);
+  assert(out.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    assert(out.headers()[i].name == expected[i].name);
+    // sec-ch-ua GREASE is randomized per generator
+    if (expected[i].name != "sec-ch-ua") {
+      assert(out.headers()[i].value == expected[i].value);
+    }
+  }
+
+  std::println("PASSED");
+}
+
+void TestFetchContextValues() {
+  std::print("Testing fetch context values... ");
+
+  const auto& profile = GetChromeHeaderProfile(ChromeVersion::kChrome143);
+  ChromeHeaderTemplates templates(profile);
+
+  http::RequestHeaders xhr;
+  templates.Apply(FetchContext::Xhr(), {}, {}, &xhr);
+  assert(xhr.Get("accept") == profile.accept_xhr);
+  assert(xhr.Get("sec-fetch-site") == "same-origin");
+  assert(xhr.Get("sec-fetch-mode") == "cors");
+  assert(xhr.Get("sec-fetch-dest") == "empty");
+  assert(!xhr.Has("sec-fetch-user"));
+  assert(!xhr.Has("upgrade-insecure-requests"));
+
+  http::RequestHeaders script;
+  templates.Apply(FetchContext::Subresource(FetchDest::kScript,
+                                            FetchSite::kCrossSite),
+                  {}, {}, &script);
+  assert(script.Get("sec-fetch-site") == "cross-site");
+  assert(script.Get("sec-fetch-mode") == "no-cors");
+  assert(script.Get("sec-fetch-dest") == "script");
+
+  FetchContext scripted = FetchContext::Navigation(FetchSite::kSameOrigin);
+  scripted.user_activated = false;
+  http::RequestHeaders nav;
+  templates.Apply(scripted, {}, {}, &nav);
+  assert(nav.Get("sec-fetch-site") == "same-origin");
+  assert(!nav.Has("sec-fetch-user"));
+
+  std::println("PASSED");
+}
+
+void TestUserOverridesInPlace() {
+  std::print("Testing user header overrides... ");
+
+  const auto& profile = GetChromeHeaderProfile(ChromeVersion::kChrome143);
+  ChromeHeaderTemplates templates(profile);
+
+  std::vector<Header> user = {
+      {"X-Custom", "1"},
+      {"User-Agent", "Custom/1.0"},
+      {"referer", "https://example.com/"},
+  };
+
+  http::RequestHeaders out;
+  templates.Apply(FetchContext::Navigation(), user, "a=b", &out);
+
+  // Override keeps Chrome's position, with the lowercase template name
+  assert(out.Get("user-agent") == "Custom/1.0");
+  assert(Position(out, "user-agent") < Position(out, "accept"));
+  assert(Position(out, "User-Agent") == -1);
+
+  // Referer and cookie fill their slots
+  assert(Position(out, "referer") == Position(out, "sec-fetch-dest") + 1);
+  assert(Position(out, "cookie") == Position(out, "accept-language") + 1);
+  assert(out.Get("cookie") == "a=b");
+
+  // Unknown user headers go last, in the caller's case
+  assert(Position(out, "X-Custom") == static_cast<int>(out.size()) - 1);
+
+  // A user cookie replaces the cookie-jar value
+  std::vector<Header> user_cookie = {{"cookie", "mine=1"}};
+  http::RequestHeaders out2;
+  templates.Apply(FetchContext::Navigation(), user_cookie, "jar=1", &out2);
+  assert(out2.Get("cookie") == "mine=1");
+  assert(Position(out2, "cookie") == static_cast<int>(out2.size()) - 1);
+
+  std::println("PASSED");
+}
+
+void TestStableAcrossRequests() {
+  std::print("Testing stable static entries... ");
+
+  const auto& profile = GetChromeHeaderProfile(ChromeVersion::kChrome143);
+  ChromeHeaderTemplates templates(profile, "Override/2.0");
+
+  http::RequestHeaders a;
+  http::RequestHeaders b;
+  templates.Apply(FetchContext::Navigation(), {}, {}, &a);
+  templates.Apply(FetchContext::Navigation(), {}, {}, &b);
+
+  // Same bytes every request (HPACK dynamic table hits), referenced in place
+  assert(a.Get("sec-ch-ua") == templates.sec_ch_ua().Get());
+  assert(a.Get("sec-ch-ua").data() == b.Get("sec-ch-ua").data());
+  assert(a.Get("user-agent") == "Override/2.0");
+  assert(a.Get("user-agent").data() == b.Get("user-agent").data());
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== ChromeHeaderTemplates Unit Tests ===\n");
+
+  TestMatchesBuildChromeHeaders();
+  TestFetchContextValues();
+  TestUserOverridesInPlace();
+  TestStableAcrossRequests();
+
+  std::println("\nAll ChromeHeaderTemplates tests passed!");
+  return 0;
+}
@@ -0,0 +1,125 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// Blocking waits on HttpClient. Requests go to a closed local port so they
+// complete (with an error) through the reactors without network access.
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <print>
+#include <thread>
+
+#include "holytls/client.h"
+#include "holytls/config.h"
+
+using namespace holytls;
+
+namespace {
+
+constexpr const char* kRefusedUrl = "https://127.0.0.1:1/";
+
+ClientConfig MakeConfig() {
+  ClientConfig config = ClientConfig::ChromeLatest();
+  config.threads.num_workers = 2;
+  return config;
+}
+
+Request MakeRequest(const char* url) {
+  Request request;
+  request.method = Method::kGet;
+  request.url = url;
+  return request;
+}
+
+}  // namespace
+
+void TestFuture() {
+  std::print("Testing SendAsync future... ");
+
+  HttpClient client(MakeConfig());
+
+  // Rejected before reaching a reactor
+  ResponseResult invalid = client.SendAsync(MakeRequest("not a url")).get();
+  assert(!invalid.ok());
+  assert(invalid.error.code == ErrorCode::kInvalidUrl);
+
+  // Completed on a reactor thread
+  auto future = client.SendAsync(MakeRequest(kRefusedUrl));
+  ResponseResult refused = future.get();
+  assert(!refused.ok());
+
+  std::println("PASSED");
+}
+
+void TestWaitIdle() {
+  std::print("Testing WaitIdle drains requests... ");
+
+  HttpClient client(MakeConfig());
+
+  // Idle client returns immediately
+  client.WaitIdle();
+  assert(client.InFlight() == 0);
+
+  std::atomic<int> done{0};
+  std::atomic<int> chained{0};
+  for (int i = 0; i < 8; ++i) {
+    client.SendAsync(MakeRequest(kRefusedUrl), [&](Response, Error error) {
+      assert(error);
+      // Requests issued from callbacks are waited for as well
+      if (done.fetch_add(1) == 0) {
+        client.SendAsync(MakeRequest(kRefusedUrl),
+                         [&](Response, Error) { chained.fetch_add(1); });
+      }
+    });
+  }
+
+  client.WaitIdle();
+  assert(done.load() == 8);
+  assert(chained.load() == 1);
+  assert(client.InFlight() == 0);
+
+  std::println("PASSED");
+}
+
+void TestRunUntil() {
+  std::print("Testing RunUntil and RunOnce... ");
+
+  HttpClient client(MakeConfig());
+
+  std::atomic<int> done{0};
+  for (int i = 0; i < 4; ++i) {
+    client.SendAsync(MakeRequest(kRefusedUrl),
+                     [&](Response, Error) { done.fetch_add(1); });
+  }
+  client.RunUntil([&] { return done.load() == 4; });
+  assert(done.load() == 4);
+
+  // Nothing in flight: RunOnce must not sleep
+  auto start = std::chrono::steady_clock::now();
+  client.RunOnce();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  assert(elapsed < std::chrono::milliseconds(5));
+
+  // Stop releases a blocked Run()
+  std::thread stopper([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    client.Stop();
+  });
+  client.Run();
+  stopper.join();
+  assert(!client.IsRunning());
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== HttpClient Wait Unit Tests ===\n");
+
+  TestFuture();
+  TestWaitIdle();
+  TestRunUntil();
+
+  std::println("\nAll HttpClient wait tests passed!");
+  return 0;
+}
@@ -0,0 +1,144 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/pool/concurrency_limiter.h"
+
+#include <cassert>
+#include <print>
+
+#include "holytls/http/http_date.h"
+
+using namespace holytls;
+using holytls::pool::ConcurrencyLimiter;
+
+namespace {
+
+ConcurrencyLimitConfig MakeConfig() {
+  ConcurrencyLimitConfig config;
+  config.enabled = true;
+  config.initial_limit = 10;
+  config.min_limit = 2;
+  config.max_limit = 100;
+  return config;
+}
+
+// Samples at `rtt_us` with the limit fully used
+void Saturate(ConcurrencyLimiter* limiter, uint64_t rtt_us, int samples,
+              uint64_t now_ms = 0) {
+  for (int i = 0; i < samples; ++i) {
+    limiter->OnSample(now_ms, rtt_us, limiter->limit());
+  }
+}
+
+}  // namespace
+
+void TestGrowsWhileLatencyIsFlat() {
+  std::print("Testing growth at steady latency... ");
+
+  ConcurrencyLimiter limiter(MakeConfig());
+  assert(limiter.limit() == 10);
+
+  Saturate(&limiter, 10000, 50);
+  assert(limiter.limit() > 10);
+  assert(limiter.baseline_rtt_us() == 10000);
+
+  // Never past the ceiling
+  Saturate(&limiter, 10000, 5000);
+  assert(limiter.limit() == 100);
+
+  std::println("PASSED");
+}
+
+void TestShrinksWhenLatencyRises() {
+  std::print("Testing backoff on queueing latency... ");
+
+  ConcurrencyLimiter limiter(MakeConfig());
+  Saturate(&limiter, 10000, 200);
+  size_t grown = limiter.limit();
+
+  // Four times the baseline is well past the tolerance
+  Saturate(&limiter, 40000, 20);
+  assert(limiter.limit() < grown);
+
+  // ...and never below the floor
+  Saturate(&limiter, 400000, 500);
+  assert(limiter.limit() >= 2);
+
+  std::println("PASSED");
+}
+
+void TestIgnoresAppLimitedSamples() {
+  std::print("Testing samples with the limit mostly unused... ");
+
+  ConcurrencyLimiter limiter(MakeConfig());
+  for (int i = 0; i < 100; ++i) {
+    limiter.OnSample(0, 10000, 1);
+  }
+  assert(limiter.limit() == 10);
+  assert(limiter.rtt_us() == 10000);
+
+  std::println("PASSED");
+}
+
+void TestDrops() {
+  std::print("Testing shed requests and Retry-After... ");
+
+  ConcurrencyLimiter limiter(MakeConfig());
+  Saturate(&limiter, 10000, 10);
+  size_t before = limiter.limit();
+
+  limiter.OnDrop(1000);
+  assert(limiter.drops() == 1);
+  assert(limiter.limit() < before);
+
+  // The rest of the burst, within one RTT (10 ms), cuts nothing more
+  size_t after = limiter.limit();
+  limiter.OnDrop(1005);
+  assert(limiter.drops() == 1);
+  assert(limiter.limit() == after);
+
+  // A Retry-After holds the limit from growing until it expires
+  limiter.OnDrop(2000, 5000);
+  size_t held = limiter.limit();
+  assert(limiter.Held(6999));
+  Saturate(&limiter, 10000, 50, 3000);
+  assert(limiter.limit() == held);
+
+  assert(!limiter.Held(7000));
+  Saturate(&limiter, 10000, 50, 7000);
+  assert(limiter.limit() > held);
+
+  std::println("PASSED");
+}
+
+void TestParseRetryAfter() {
+  std::print("Testing Retry-After parsing... ");
+
+  assert(http::ParseRetryAfter("120", 0) == 120000);
+  assert(http::ParseRetryAfter(" 0 ", 0) == 0);
+  assert(http::ParseRetryAfter("", 0) == 0);
+  assert(http::ParseRetryAfter("12x", 0) == 0);
+  assert(http::ParseRetryAfter("999999999999", 0) == 86400000);
+
+  uint64_t date_ms = http::ParseHttpDate("Wed, 21 Oct 2015 07:28:00 GMT");
+  assert(date_ms != 0);
+  assert(http::ParseRetryAfter("Wed, 21 Oct 2015 07:28:00 GMT",
+                               date_ms - 3000) == 3000);
+  assert(http::ParseRetryAfter("Wed, 21 Oct 2015 07:28:00 GMT",
+                               date_ms + 1) == 0);
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Concurrency Limiter Unit Tests ===\n");
+
+  TestGrowsWhileLatencyIsFlat();
+  TestShrinksWhenLatencyRises();
+  TestIgnoresAppLimitedSamples();
+  TestDrops();
+  TestParseRetryAfter();
+
+  std::println("\nAll concurrency limiter tests passed!");
+  return 0;
+}
@@ -0,0 +1,136 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// TCP Fast Open against a local listener. Server-side TFO needs
+// net.ipv4.tcp_fastopen & 2; without it the client must still fall back to
+// a normal handshake and deliver its data.
+
+#include "holytls/util/socket_utils.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <print>
+
+using namespace holytls;
+using namespace holytls::util;
+
+#ifdef __linux__
+
+namespace {
+
+int ReadFastOpenSysctl() {
+  std::FILE* file = std::fopen("/proc/sys/net/ipv4/tcp_fastopen", "r");
+  if (file == nullptr) {
+    return 0;
+  }
+  int value = 0;
+  if (std::fscanf(file, "%d", &value) != 1) {
+    value = 0;
+  }
+  std::fclose(file);
+  return value;
+}
+
+// Loopback listener with a TFO queue; returns the bound port
+socket_t Listen(uint16_t* port) {
+  socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+  assert(sock >= 0);
+  int qlen = 16;
+  setsockopt(sock, IPPROTO_TCP, TCP_FASTOPEN, &qlen, sizeof(qlen));
+
+  struct sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  assert(bind(sock, reinterpret_cast<struct sockaddr*>(&addr),
+              sizeof(addr)) == 0);
+  assert(listen(sock, 16) == 0);
+
+  socklen_t len = sizeof(addr);
+  getsockname(sock, reinterpret_cast<struct sockaddr*>(&addr), &len);
+  *port = ntohs(addr.sin_port);
+  return sock;
+}
+
+// One client connection: TFO connect, write, server reads it back.
+// Returns whether the SYN data was accepted.
+bool ConnectAndSend(socket_t listener, uint16_t port) {
+  socket_t client = CreateTcpSocket(false);
+  assert(client != kInvalidSocket);
+  bool enabled = EnableTcpFastOpen(client);
+
+  // With a cached cookie connect() returns 0 and the SYN waits for the
+  // first write; otherwise a plain SYN (with a cookie request) goes out
+  int ret = ConnectNonBlocking(client, "127.0.0.1", port, false);
+  assert(ret >= 0);
+
+  // Data in the SYN, or would-block while a plain handshake runs
+  const char kHello[] = "hello";
+  ssize_t sent = SendNonBlocking(client, kHello, sizeof(kHello));
+  assert(sent != -2);
+
+  socket_t server = accept(listener, nullptr, nullptr);
+  assert(server >= 0);
+  if (sent < 0) {
+    // Connected once accept() returned; send the data normally now
+    sent = SendNonBlocking(client, kHello, sizeof(kHello));
+    assert(sent == static_cast<ssize_t>(sizeof(kHello)));
+  }
+
+  char buf[sizeof(kHello)];
+  size_t got = 0;
+  while (got < sizeof(buf)) {
+    ssize_t n = recv(server, buf + got, sizeof(buf) - got, 0);
+    assert(n > 0);
+    got += static_cast<size_t>(n);
+  }
+  assert(std::memcmp(buf, kHello, sizeof(kHello)) == 0);
+
+  bool accepted = enabled && TcpFastOpenAccepted(client);
+  CloseSocket(server);
+  CloseSocket(client);
+  return accepted;
+}
+
+}  // namespace
+
+void TestFastOpenLoopback() {
+  std::print("Testing TCP Fast Open on loopback... ");
+
+  uint16_t port = 0;
+  socket_t listener = Listen(&port);
+
+  // First connection fetches the cookie. The kernel caches cookies per
+  // destination across processes, so an earlier run may already have one
+  // and this connection can carry data in the SYN too.
+  ConnectAndSend(listener, port);
+
+  // Second connection carries data in the SYN when both sides allow TFO
+  bool second = ConnectAndSend(listener, port);
+  int sysctl = ReadFastOpenSysctl();
+  if ((sysctl & 3) == 3) {
+    assert(second);
+    std::println("PASSED");
+  } else {
+    assert(!second);
+    std::println("PASSED (tcp_fastopen={}, fallback only)", sysctl);
+  }
+
+  CloseSocket(listener);
+}
+
+#endif  // __linux__
+
+int main() {
+  std::println("=== Fast Open Unit Tests ===\n");
+
+#ifdef __linux__
+  TestFastOpenLoopback();
+#else
+  std::println("TCP Fast Open is Linux-only, skipping");
+#endif
+
+  std::println("\nAll fast open tests passed!");
+  return 0;
+}
@@ -0,0 +1,193 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http2/header_ids.h"
+
+#include <array>
+#include <cassert>
+#include <cctype>
+#include <chrono>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace holytls::http2;
+
+namespace {
+
+constexpr size_t kKnownCount = static_cast<size_t>(HeaderId::kKnownCount);
+
+// Previous implementation: dispatch on the first character, then a chain of
+// tolower() compares against every name in that bucket
+HeaderId LegacyLookupHeaderId(std::string_view name) {
+  if (name.empty()) return HeaderId::kCustom;
+
+  auto equals_ignore_case = [](std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (std::tolower(static_cast<unsigned char>(a[i])) !=
+          std::tolower(static_cast<unsigned char>(b[i]))) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Same buckets as the old switch statement
+  static const auto buckets = [] {
+    std::array<std::vector<HeaderId>, 256> b;
+    for (size_t i = 0; i < kKnownCount; ++i) {
+      auto id = static_cast<HeaderId>(i);
+      b[static_cast<unsigned char>(HeaderIdToName(id)[0])].push_back(id);
+    }
+    return b;
+  }();
+
+  int first = std::tolower(static_cast<unsigned char>(name[0]));
+  for (HeaderId id : buckets[first]) {
+    if (equals_ignore_case(name, HeaderIdToName(id))) return id;
+  }
+  return HeaderId::kCustom;
+}
+
+std::string ToUpper(std::string_view s) {
+  std::string out(s);
+  for (char& c : out) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  }
+  return out;
+}
+
+}  // namespace
+
+void TestEveryKnownName() {
+  std::print("Testing every known name round-trips... ");
+
+  for (size_t i = 0; i < kKnownCount; ++i) {
+    auto id = static_cast<HeaderId>(i);
+    std::string_view name = HeaderIdToName(id);
+    assert(!name.empty());
+    assert(LookupHeaderId(name) == id);
+    assert(LookupHeaderId(ToUpper(name)) == id);
+  }
+
+  std::println("PASSED");
+}
+
+void TestNearMisses() {
+  std::print("Testing near misses are custom... ");
+
+  for (size_t i = 0; i < kKnownCount; ++i) {
+    std::string name(HeaderIdToName(static_cast<HeaderId>(i)));
+
+    // Same hash key bytes, different interior byte
+    if (name.size() > 5) {
+      std::string changed = name;
+      changed[1] = changed[1] == 'q' ? 'z' : 'q';
+      assert(LookupHeaderId(changed) == HeaderId::kCustom);
+    }
+
+    // Prefixes and extensions
+    assert(LookupHeaderId(name.substr(0, name.size() - 1)) !=
+           static_cast<HeaderId>(i));
+    assert(LookupHeaderId(name + "x") == HeaderId::kCustom);
+  }
+
+  // Case folding must not map punctuation onto letters or '-'
+  assert(LookupHeaderId("content\rtype") == HeaderId::kCustom);
+  assert(LookupHeaderId("content_type") == HeaderId::kCustom);
+  assert(LookupHeaderId("cont\xc5nt-type") == HeaderId::kCustom);
+  assert(LookupHeaderId("") == HeaderId::kCustom);
+  assert(LookupHeaderId(std::string(200, 'a')) == HeaderId::kCustom);
+
+  std::println("PASSED");
+}
+
+void TestMatchesLegacyLookup() {
+  std::print("Testing agreement with legacy lookup... ");
+
+  std::vector<std::string> names = {"x-request-id", "cf-ray", "nel",
+                                    "report-to", "server-timing", "a", "-"};
+  for (size_t i = 0; i < kKnownCount; ++i) {
+    std::string name(HeaderIdToName(static_cast<HeaderId>(i)));
+    names.push_back(name);
+    names.push_back(ToUpper(name));
+  }
+  for (const auto& name : names) {
+    assert(LookupHeaderId(name) == LegacyLookupHeaderId(name));
+  }
+
+  std::println("PASSED");
+}
+
+// Typical response header mix (mostly known, some custom, mixed case as
+// HTTP/1.1 servers send them)
+void BenchmarkLookup() {
+  std::println("Benchmarking HeaderId lookup:");
+
+  const std::vector<std::string> names = {
+      "content-type",
+      "Content-Length",
+      "date",
+      "server",
+      "cache-control",
+      "set-cookie",
+      "Set-Cookie",
+      "etag",
+      "last-modified",
+      "vary",
+      "accept-ranges",
+      "alt-svc",
+      "x-request-id",
+      "cf-ray",
+      "access-control-allow-origin",
+      "strict-transport-security",
+      "x-content-type-options",
+      "content-encoding",
+      "expires",
+      "report-to",
+  };
+
+  constexpr int kIterations = 200000;
+  size_t sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (const auto& name : names) {
+      sink += static_cast<size_t>(LegacyLookupHeaderId(name));
+    }
+  }
+  auto legacy_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (const auto& name : names) {
+      sink -= static_cast<size_t>(LookupHeaderId(name));
+    }
+  }
+  auto hash_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+  double lookups = static_cast<double>(kIterations) * names.size();
+  std::println("  legacy:       {:.1f} ns/lookup", legacy_ns / lookups);
+  std::println("  perfect hash: {:.1f} ns/lookup", hash_ns / lookups);
+
+  // Both loops saw the same ids
+  assert(sink == 0);
+}
+
+int main() {
+  std::println("=== HeaderId Unit Tests ===\n");
+
+  TestEveryKnownName();
+  TestNearMisses();
+  TestMatchesLegacyLookup();
+  BenchmarkLookup();
+
+  std::println("\nAll HeaderId tests passed!");
+  return 0;
+}
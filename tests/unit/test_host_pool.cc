@@ -0,0 +1,98 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+// HostPool request queue. Connections go to a closed local port, so they
+// fail while connecting without network access.
+
+#include "holytls/pool/host_pool.h"
+
+#include <cassert>
+#include <print>
+#include <string>
+
+#include "holytls/core/reactor.h"
+#include "holytls/tls/tls_context.h"
+
+using namespace holytls;
+
+namespace {
+
+struct Outcome {
+  bool called = false;
+  pool::PooledConnection* conn = nullptr;
+  std::string error;
+};
+
+pool::SlotCallback Record(Outcome* outcome) {
+  return [outcome](pool::PooledConnection* conn, std::string_view error) {
+    outcome->called = true;
+    outcome->conn = conn;
+    outcome->error = std::string(error);
+  };
+}
+
+}  // namespace
+
+void TestQueueFailsWithConnectError() {
+  std::print("Testing queue failed by its only connection... ");
+
+  core::Reactor reactor;
+  assert(reactor.Initialize());
+  tls::TlsContextFactory tls_factory;
+  assert(tls_factory.Initialize(TlsConfig{}));
+
+  pool::HostPool host_pool("127.0.0.1", 1, pool::HostPoolConfig{}, &reactor,
+                           &tls_factory);
+  assert(host_pool.CreateConnection("127.0.0.1"));
+
+  // Nothing to acquire until the connection is up
+  assert(host_pool.AcquireConnection() == nullptr);
+  Outcome first;
+  Outcome second;
+  host_pool.Enqueue(Priority::kDefaultUrgency, Record(&first));
+  host_pool.Enqueue(Priority::kDefaultUrgency, Record(&second));
+
+  // The refused connect fails both with its own error, not a timeout
+  for (int i = 0; i < 100 && !second.called; ++i) {
+    reactor.RunFor(10);
+  }
+  assert(first.called && second.called);
+  assert(first.conn == nullptr && second.conn == nullptr);
+  assert(first.error.starts_with("Connection failed"));
+  assert(second.error == first.error);
+  assert(host_pool.PendingRequests() == 0);
+
+  std::println("PASSED");
+}
+
+void TestCancelHasNoError() {
+  std::print("Testing cancelled queue entry... ");
+
+  core::Reactor reactor;
+  assert(reactor.Initialize());
+  tls::TlsContextFactory tls_factory;
+  assert(tls_factory.Initialize(TlsConfig{}));
+
+  pool::HostPool host_pool("127.0.0.1", 1, pool::HostPoolConfig{}, &reactor,
+                           &tls_factory);
+  Outcome outcome;
+  uint64_t id =
+      host_pool.Enqueue(Priority::kDefaultUrgency, Record(&outcome));
+  assert(host_pool.Cancel(id));
+  assert(outcome.called);
+  assert(outcome.conn == nullptr);
+  assert(outcome.error.empty());
+  assert(!host_pool.Cancel(id));
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== HostPool Unit Tests ===\n");
+
+  TestQueueFailsWithConnectError();
+  TestCancelHasNoError();
+
+  std::println("\nAll host pool tests passed!");
+  return 0;
+}
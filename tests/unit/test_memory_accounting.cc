@@ -0,0 +1,225 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/memory/memory_accounting.h"
+
+#include <cassert>
+#include <cstdio>
+#include <print>
+#include <string_view>
+#include <utility>
+
+#include "holytls/base/arena.h"
+#include "holytls/core/io_buffer.h"
+#include "holytls/memory/buffer_pool.h"
+
+using namespace holytls;
+using namespace holytls::memory;
+
+void TestAccountPeaks() {
+  std::print("Testing account totals and high-water marks... ");
+
+  MemoryAccount account;
+  account.Add(MemoryTag::kTls, 1000);
+  account.Add(MemoryTag::kDnsCache, 500);
+  account.Sub(MemoryTag::kTls, 800);
+  account.Add(MemoryTag::kTls, 100);
+
+  assert(account.current(MemoryTag::kTls) == 300);
+  assert(account.peak(MemoryTag::kTls) == 1000);
+  assert(account.current(MemoryTag::kDnsCache) == 500);
+  assert(account.total() == 800);
+  assert(account.total_peak() == 1500);
+
+  std::println("PASSED");
+}
+
+void TestLimitAndResumeMark() {
+  std::print("Testing limit and resume mark... ");
+
+  MemoryAccount account;
+  account.Add(MemoryTag::kOther, 1000);
+  assert(!account.OverLimit());  // No cap
+  assert(account.BelowResumeMark());
+
+  account.set_limit(800);
+  assert(account.OverLimit());
+  assert(!account.BelowResumeMark());
+
+  // Under the cap but above 7/8 of it: not over, not resumed yet
+  account.Sub(MemoryTag::kOther, 250);
+  assert(!account.OverLimit());
+  assert(!account.BelowResumeMark());
+
+  account.Sub(MemoryTag::kOther, 100);
+  assert(account.BelowResumeMark());
+
+  account.CountStreamPause();
+  account.CountRejectedRequest();
+  account.CountRejectedRequest();
+  assert(account.streams_paused() == 1);
+  assert(account.requests_rejected() == 2);
+
+  std::println("PASSED");
+}
+
+void TestScopedAccount() {
+  std::print("Testing scoped current account... ");
+
+  assert(CurrentMemoryAccount() == SharedMemoryAccount());
+  MemoryAccount outer;
+  MemoryAccount inner;
+  {
+    ScopedMemoryAccount a(&outer);
+    assert(CurrentMemoryAccount() == &outer);
+    {
+      ScopedMemoryAccount b(&inner);
+      assert(CurrentMemoryAccount() == &inner);
+    }
+    assert(CurrentMemoryAccount() == &outer);
+  }
+  assert(CurrentMemoryAccount() == SharedMemoryAccount());
+
+  std::println("PASSED");
+}
+
+void TestCharge() {
+  std::print("Testing MemoryCharge... ");
+
+  MemoryAccount account;
+  {
+    ScopedMemoryAccount scope(&account);
+    MemoryCharge charge(MemoryTag::kCookieJar);
+    charge.Set(4096);
+    charge.Set(1024);
+
+    // Moving keeps the charge on the account it was bound to
+    MemoryCharge moved = std::move(charge);
+    charge.Set(0);
+
+    if constexpr (kMemoryAccountingEnabled) {
+      assert(account.current(MemoryTag::kCookieJar) == 1024);
+      assert(account.peak(MemoryTag::kCookieJar) == 4096);
+      moved.SetTag(MemoryTag::kOther);
+      assert(account.current(MemoryTag::kCookieJar) == 0);
+      assert(account.current(MemoryTag::kOther) == 1024);
+    } else {
+      assert(moved.bytes() == 0);
+    }
+  }
+  // Released when the holder goes away
+  assert(account.total() == 0);
+
+  std::println("PASSED");
+}
+
+void TestTaggedAlloc() {
+  std::print("Testing TaggedAlloc/TaggedRealloc... ");
+
+  MemoryAccount account;
+  {
+    ScopedMemoryAccount scope(&account);
+    void* ptr = TaggedAlloc(100, MemoryTag::kDecompression);
+    assert(ptr != nullptr);
+    ptr = TaggedRealloc(ptr, 300, MemoryTag::kDecompression);
+    assert(ptr != nullptr);
+    if constexpr (kMemoryAccountingEnabled) {
+      assert(TaggedSize(ptr) == 300);
+      assert(account.current(MemoryTag::kDecompression) == 300);
+    }
+
+    // Freed on another account's thread: still credited to the original
+    ScopedMemoryAccount other(SharedMemoryAccount());
+    TaggedFree(ptr);
+  }
+  assert(account.total() == 0);
+
+  std::println("PASSED");
+}
+
+void TestAccountOutlivesOwner() {
+  std::print("Testing charges outliving the account owner... ");
+
+  // Like an SSL_CTX freed after the reactor whose account it was charged to
+  MemoryAccountPtr owner(new MemoryAccount);
+  void* block = nullptr;
+  MemoryCharge charge(MemoryTag::kTls);
+  {
+    ScopedMemoryAccount scope(owner.get());
+    block = TaggedAlloc(64, MemoryTag::kTls);
+    charge.Set(128);
+  }
+  owner.reset();
+
+  // Credited back to the released account, which goes with the last charge
+  TaggedFree(block);
+  charge.Set(0);
+
+  std::println("PASSED");
+}
+
+void TestInstrumentedContainers() {
+  std::print("Testing IoBuffer, Arena and BufferPool charges... ");
+
+  MemoryAccount account;
+  {
+    ScopedMemoryAccount scope(&account);
+
+    core::IoBuffer buffer;
+    buffer.SetMemoryTag(MemoryTag::kResponseBodies);
+    buffer.Append(std::string_view(std::string(40000, 'x')));
+    if constexpr (kMemoryAccountingEnabled) {
+      assert(account.current(MemoryTag::kResponseBodies) ==
+             buffer.Capacity());
+    }
+    buffer.Skip(buffer.Size());
+    assert(account.current(MemoryTag::kResponseBodies) == 0);
+
+    Arena* arena = Arena::Create(1024, MemoryTag::kStreamBuffers);
+    ArenaPush(arena, 4096);  // Chains a second block
+    if constexpr (kMemoryAccountingEnabled) {
+      assert(account.current(MemoryTag::kStreamBuffers) >= 1024 + 4096);
+    }
+    Arena::Destroy(arena);
+    assert(account.current(MemoryTag::kStreamBuffers) == 0);
+
+    BufferPool::Config config;
+    config.small_count = 2;
+    config.medium_count = 1;
+    config.large_count = 0;
+    {
+      BufferPool pool(config);
+      size_t held = 2 * kSmallBufferSize + kMediumBufferSize;
+      assert(pool.GetStats().bytes_allocated == held);
+      {
+        auto big = pool.Acquire(kLargeBufferSize * 2);  // Fallback
+        assert(pool.GetStats().bytes_allocated ==
+               held + kLargeBufferSize * 2);
+        if constexpr (kMemoryAccountingEnabled) {
+          assert(account.current(MemoryTag::kPoolMetadata) ==
+                 held + kLargeBufferSize * 2);
+        }
+      }
+      assert(pool.GetStats().bytes_allocated == held);
+    }
+  }
+  assert(account.total() == 0);
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Memory Accounting Unit Tests ({}) ===\n",
+               kMemoryAccountingEnabled ? "enabled" : "disabled");
+
+  TestAccountPeaks();
+  TestLimitAndResumeMark();
+  TestScopedAccount();
+  TestCharge();
+  TestTaggedAlloc();
+  TestAccountOutlivesOwner();
+  TestInstrumentedContainers();
+
+  std::println("\nAll memory accounting tests passed!");
+  return 0;
+}
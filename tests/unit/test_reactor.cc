@@ -4,7 +4,9 @@
 #include "holytls/core/reactor.h"
 
 #include <cassert>
+#include <memory>
 #include <print>
+#include <vector>
 
 void TestReactorCreation() {
   std::print("Testing reactor creation... ");
@@ -42,11 +44,38 @@ void TestReactorTime() {
   std::println("PASSED");
 }
 
+void TestPostUrgency() {
+  std::print("Testing posted callback urgency... ");
+
+  auto reactor = std::make_unique<holytls::core::Reactor>();
+  assert(reactor->Initialize());
+
+  // Same iteration: most urgent first, posting order within an urgency
+  std::vector<int> order;
+  reactor->Post([&order] { order.push_back(1); });
+  reactor->Post([&order] { order.push_back(2); }, 6);
+  reactor->Post([&order] { order.push_back(3); }, 0);
+  reactor->Post([&order] { order.push_back(4); });
+  reactor->Post([&order] { order.push_back(5); }, 0);
+  reactor->RunOnce();
+  assert((order == std::vector<int>{3, 5, 1, 4, 2}));
+
+  // Default-urgency batches keep FIFO order
+  order.clear();
+  reactor->Post([&order] { order.push_back(1); });
+  reactor->Post([&order] { order.push_back(2); });
+  reactor->RunOnce();
+  assert((order == std::vector<int>{1, 2}));
+
+  std::println("PASSED");
+}
+
 int main() {
   std::println("=== Reactor Unit Tests ===");
 
   TestReactorCreation();
   TestReactorTime();
+  TestPostUrgency();
 
   std::println("\nAll reactor tests passed!");
   return 0;
@@ -0,0 +1,126 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cassert>
+#include <print>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "holytls/core/reactor_manager.h"
+
+using namespace holytls;
+using namespace holytls::core;
+
+namespace {
+
+ReactorManagerConfig MakeConfig(ReactorPlacement placement) {
+  ReactorManagerConfig config;
+  config.num_reactors = 4;
+  config.placement = placement;
+  config.max_reactors_per_origin = 4;
+  return config;
+}
+
+}  // namespace
+
+void TestHashPlacementIsStatic() {
+  std::print("Testing hash placement is static... ");
+
+  ReactorManager manager(MakeConfig(ReactorPlacement::kHash));
+  ReactorContext* first = manager.AcquireReactorForHost("example.com", 443);
+  for (int i = 0; i < 100; ++i) {
+    assert(manager.AcquireReactorForHost("example.com", 443) == first);
+  }
+  assert(first->in_flight.load() == 101);
+
+  std::println("PASSED");
+}
+
+void TestOriginAffinity() {
+  std::print("Testing origin affinity under light load... ");
+
+  ReactorManager manager(MakeConfig(ReactorPlacement::kBoundedLoad));
+
+  // Sequential requests (each completes before the next) stay put
+  ReactorContext* first = manager.AcquireReactorForHost("example.com", 443);
+  manager.ReleaseReactor(first);
+  for (int i = 0; i < 100; ++i) {
+    ReactorContext* ctx = manager.AcquireReactorForHost("example.com", 443);
+    assert(ctx == first);
+    manager.ReleaseReactor(ctx);
+  }
+
+  std::println("PASSED");
+}
+
+void TestHotOriginSplits() {
+  std::print("Testing hot origin spreads across reactors... ");
+
+  ReactorManager manager(MakeConfig(ReactorPlacement::kBoundedLoad));
+
+  std::set<size_t> used;
+  for (int i = 0; i < 400; ++i) {
+    used.insert(manager.AcquireReactorForHost("hot.example", 443)->index);
+  }
+  assert(used.size() == 4);
+
+  // Loads stay within the bound of each other
+  size_t min_load = manager.ReactorLoad(0);
+  size_t max_load = min_load;
+  for (size_t i = 1; i < manager.NumReactors(); ++i) {
+    min_load = std::min(min_load, manager.ReactorLoad(i));
+    max_load = std::max(max_load, manager.ReactorLoad(i));
+  }
+  assert(max_load <= min_load * 5 / 4 + 2);
+
+  std::println("PASSED");
+}
+
+void TestSplitLimit() {
+  std::print("Testing max reactors per origin... ");
+
+  ReactorManagerConfig config = MakeConfig(ReactorPlacement::kBoundedLoad);
+  config.max_reactors_per_origin = 2;
+  ReactorManager manager(config);
+
+  std::set<size_t> used;
+  for (int i = 0; i < 400; ++i) {
+    used.insert(manager.AcquireReactorForHost("hot.example", 443)->index);
+  }
+  assert(used.size() == 2);
+
+  std::println("PASSED");
+}
+
+void TestNewOriginsAreBounded() {
+  std::print("Testing new origins respect the load bound... ");
+
+  ReactorManager manager(MakeConfig(ReactorPlacement::kBoundedLoad));
+
+  for (int i = 0; i < 1000; ++i) {
+    std::string host = "host" + std::to_string(i) + ".example";
+    manager.AcquireReactorForHost(host, 443);
+  }
+
+  // ceil(1.25 * 1000 / 4) = 313
+  for (size_t i = 0; i < manager.NumReactors(); ++i) {
+    assert(manager.ReactorLoad(i) <= 313);
+  }
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Reactor Placement Unit Tests ===\n");
+
+  TestHashPlacementIsStatic();
+  TestOriginAffinity();
+  TestHotOriginSplits();
+  TestSplitLimit();
+  TestNewOriginsAreBounded();
+
+  std::println("\nAll reactor placement tests passed!");
+  return 0;
+}
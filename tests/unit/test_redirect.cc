@@ -0,0 +1,125 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/redirect.h"
+
+#include <cassert>
+#include <print>
+#include <string>
+#include <string_view>
+
+#include "holytls/util/url_parser.h"
+
+using namespace holytls;
+
+namespace {
+
+std::string Resolve(std::string_view base_url, std::string_view location) {
+  util::ParsedUrl base;
+  bool parsed = util::ParseUrl(base_url, &base);
+  assert(parsed);
+  (void)parsed;
+  std::string out;
+  if (!http::ResolveLocation(base, location, &out)) {
+    return "<none>";
+  }
+  return out;
+}
+
+}  // namespace
+
+void TestFollowableStatus() {
+  std::print("Testing followable redirect statuses... ");
+
+  for (int code : {301, 302, 303, 307, 308}) {
+    assert(http::IsFollowableRedirect(code));
+  }
+  for (int code : {200, 300, 304, 305, 400}) {
+    assert(!http::IsFollowableRedirect(code));
+  }
+
+  std::println("PASSED");
+}
+
+void TestResolveLocation() {
+  std::print("Testing Location resolution... ");
+
+  constexpr std::string_view kBase = "https://example.com/a/b/c?x=1#top";
+
+  // Absolute and scheme-relative
+  assert(Resolve(kBase, "https://other.com/p") == "https://other.com/p");
+  assert(Resolve(kBase, "http://other.com/p") == "http://other.com/p");
+  assert(Resolve(kBase, "//cdn.example.com/x") ==
+         "https://cdn.example.com/x");
+
+  // Absolute path, query only, relative path
+  assert(Resolve(kBase, "/login?next=%2F") ==
+         "https://example.com/login?next=%2F");
+  assert(Resolve(kBase, "?page=2") == "https://example.com/a/b/c?page=2");
+  assert(Resolve(kBase, "d") == "https://example.com/a/b/d");
+  assert(Resolve(kBase, "./d/") == "https://example.com/a/b/d/");
+  assert(Resolve(kBase, "../d") == "https://example.com/a/d");
+  assert(Resolve(kBase, "../../../../d") == "https://example.com/d");
+  assert(Resolve(kBase, "/x/./y/../z") == "https://example.com/x/z");
+
+  // A "://" inside the query is not a scheme
+  assert(Resolve(kBase, "/go?to=https://x.com") ==
+         "https://example.com/go?to=https://x.com");
+
+  // Non-default port and IPv6 literals keep their authority
+  assert(Resolve("https://example.com:8443/a", "/b") ==
+         "https://example.com:8443/b");
+  assert(Resolve("https://[::1]:8443/a", "b") == "https://[::1]:8443/b");
+
+  // Whitespace trimmed, fragment dropped, empty rejected
+  assert(Resolve(kBase, "  /next#frag ") == "https://example.com/next");
+  assert(Resolve(kBase, "") == "<none>");
+  assert(Resolve(kBase, "#only") == "<none>");
+
+  std::println("PASSED");
+}
+
+void TestMethodRewrite() {
+  std::print("Testing redirect method rewriting... ");
+
+  assert(http::RedirectRewritesToGet(303, "POST"));
+  assert(http::RedirectRewritesToGet(303, "PUT"));
+  assert(!http::RedirectRewritesToGet(303, "HEAD"));
+  assert(!http::RedirectRewritesToGet(303, "GET"));
+
+  assert(http::RedirectRewritesToGet(301, "POST"));
+  assert(http::RedirectRewritesToGet(302, "POST"));
+  assert(!http::RedirectRewritesToGet(302, "PUT"));
+
+  assert(!http::RedirectRewritesToGet(307, "POST"));
+  assert(!http::RedirectRewritesToGet(308, "POST"));
+
+  std::println("PASSED");
+}
+
+void TestSameOrigin() {
+  std::print("Testing same-origin checks... ");
+
+  util::ParsedUrl a, b, c, d;
+  util::ParseUrl("https://Example.com/a", &a);
+  util::ParseUrl("https://example.com:443/b?q", &b);
+  util::ParseUrl("https://example.com:8443/a", &c);
+  util::ParseUrl("https://www.example.com/a", &d);
+  assert(http::IsSameOrigin(a, b));
+  assert(!http::IsSameOrigin(a, c));
+  assert(!http::IsSameOrigin(a, d));
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Redirect Unit Tests ===\n");
+
+  TestFollowableStatus();
+  TestResolveLocation();
+  TestMethodRewrite();
+  TestSameOrigin();
+
+  std::println("\nAll redirect tests passed!");
+  return 0;
+}
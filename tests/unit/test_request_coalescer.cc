@@ -0,0 +1,159 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/client/request_coalescer.h"
+
+#include <cassert>
+#include <print>
+#include <string>
+#include <vector>
+
+using namespace holytls;
+
+namespace {
+
+const std::vector<std::string> kKeyHeaders = {"Authorization", "range"};
+
+Request Get(std::string_view url) {
+  Request request;
+  request.SetUrl(url);
+  return request;
+}
+
+}  // namespace
+
+void TestKey() {
+  std::print("Testing coalescing keys... ");
+
+  RequestCoalescer coalescer(kKeyHeaders);
+  std::string key = coalescer.Key(Get("https://example.com/a"));
+  assert(!key.empty());
+
+  // Fragment and unlisted headers are ignored
+  assert(coalescer.Key(Get("https://example.com/a#top")) == key);
+  assert(coalescer.Key(Get("https://example.com/a").SetHeader("x-trace",
+                                                              "1")) == key);
+
+  // Listed headers match case-insensitively by name
+  std::string auth = coalescer.Key(
+      Get("https://example.com/a").SetHeader("authorization", "Bearer a"));
+  assert(auth != key);
+  assert(coalescer.Key(Get("https://example.com/a")
+                           .SetHeader("AUTHORIZATION", "Bearer a")) == auth);
+  assert(coalescer.Key(Get("https://example.com/a")
+                           .SetHeader("authorization", "Bearer b")) != auth);
+
+  // Method, URL and fetch context distinguish
+  assert(coalescer.Key(Get("https://example.com/b")) != key);
+  assert(coalescer.Key(Get("https://example.com/a").SetMethod(Method::kHead)) !=
+         key);
+  assert(coalescer.Key(Get("https://example.com/a")
+                           .SetFetchContext(http2::FetchContext::Xhr())) !=
+         key);
+
+  // Unsafe methods and bodies are never coalesced
+  assert(coalescer.Key(Get("https://example.com/a").SetMethod(Method::kPost))
+             .empty());
+  assert(coalescer.Key(Get("https://example.com/a").SetBody("x")).empty());
+
+  std::println("PASSED");
+}
+
+void TestFanOut() {
+  std::print("Testing shared completion... ");
+
+  RequestCoalescer coalescer(kKeyHeaders);
+  std::string key = coalescer.Key(Get("https://example.com/a"));
+  assert(!coalescer.InFlight(key));
+
+  std::vector<Response> delivered;
+  auto record = [&delivered](Response response, Error error) {
+    assert(!error);
+    delivered.push_back(std::move(response));
+  };
+
+  ResponseCallback leader = record;
+  coalescer.Lead(key, &leader);
+  assert(coalescer.InFlight(key));
+  coalescer.Join(key, record);
+  coalescer.Join(key, record);
+
+  std::string_view payload = "shared payload";
+  leader(Response(200, {}, std::vector<uint8_t>(payload.begin(),
+                                                payload.end())),
+         Error{});
+  assert(!coalescer.InFlight(key));
+  assert(coalescer.leaders() == 0);
+
+  // One buffer, referenced by every response
+  assert(delivered.size() == 3);
+  for (const auto& response : delivered) {
+    assert(response.status_code == 200);
+    assert(response.body.empty());
+    assert(response.shared_body == delivered[0].shared_body);
+    assert(response.body_string() == payload);
+    assert(response.content_length() == payload.size());
+  }
+
+  std::println("PASSED");
+}
+
+void TestAlone() {
+  std::print("Testing a leader nobody joined... ");
+
+  RequestCoalescer coalescer(kKeyHeaders);
+  std::string key = coalescer.Key(Get("https://example.com/a"));
+
+  Response delivered;
+  ResponseCallback leader = [&delivered](Response response, Error) {
+    delivered = std::move(response);
+  };
+  coalescer.Lead(key, &leader);
+  leader(Response(200, {}, {1, 2, 3}), Error{});
+
+  // The body stays where it was; nothing to share
+  assert(delivered.shared_body == nullptr);
+  assert(delivered.body.size() == 3);
+  assert(delivered.body_view().size() == 3);
+
+  std::println("PASSED");
+}
+
+void TestErrorAndReentry() {
+  std::print("Testing errors and requests issued from callbacks... ");
+
+  RequestCoalescer coalescer(kKeyHeaders);
+  std::string key = coalescer.Key(Get("https://example.com/a"));
+
+  int errors = 0;
+  bool reissued_joined = true;
+  ResponseCallback leader = [&](Response, Error error) {
+    assert(error.code == ErrorCode::kTimeout);
+    ++errors;
+    // The exchange is over: the same request now starts a new one
+    reissued_joined = coalescer.InFlight(key);
+  };
+  coalescer.Lead(key, &leader);
+  coalescer.Join(key, [&errors](Response, Error error) {
+    assert(error.code == ErrorCode::kTimeout);
+    ++errors;
+  });
+
+  leader(Response{}, Error{ErrorCode::kTimeout, "timed out"});
+  assert(errors == 2);
+  assert(!reissued_joined);
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Request Coalescer Unit Tests ===\n");
+
+  TestKey();
+  TestFanOut();
+  TestAlone();
+  TestErrorAndReentry();
+
+  std::println("\nAll request coalescer tests passed!");
+  return 0;
+}
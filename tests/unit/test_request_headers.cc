@@ -0,0 +1,376 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/request_headers.h"
+
+#include <nghttp2/nghttp2.h>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <print>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "holytls/http2/h2_session.h"
+
+using namespace holytls;
+using namespace holytls::http;
+
+// Global allocation counter (operator new only; arena blocks are counted by
+// walking the block chain)
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+size_t ArenaBlocks(Arena* arena) {
+  size_t blocks = 0;
+  for (Arena* a = arena; a != nullptr; a = a->prev) ++blocks;
+  return blocks;
+}
+
+// Typical browser-like request header set
+const std::pair<std::string_view, std::string_view> kSampleHeaders[] = {
+    {"sec-ch-ua",
+     "\"Google Chrome\";v=\"143\", \"Chromium\";v=\"143\", "
+     "\"Not A(Brand\";v=\"24\""},
+    {"sec-ch-ua-mobile", "?0"},
+    {"sec-ch-ua-platform", "\"Windows\""},
+    {"upgrade-insecure-requests", "1"},
+    {"user-agent",
+     "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, "
+     "like Gecko) Chrome/143.0.0.0 Safari/537.36"},
+    {"accept",
+     "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,"
+     "image/webp,image/apng,*/*;q=0.8"},
+    {"sec-fetch-site", "none"},
+    {"sec-fetch-mode", "navigate"},
+    {"sec-fetch-user", "?1"},
+    {"sec-fetch-dest", "document"},
+    {"accept-encoding", "gzip, deflate, br, zstd"},
+    {"accept-language", "en-US,en;q=0.9"},
+    {"cookie", "session=abc123; theme=dark"},
+};
+
+}  // namespace
+
+void TestRequestHeadersBasic() {
+  std::print("Testing RequestHeaders basic... ");
+
+  RequestHeaders headers;
+  assert(headers.empty());
+
+  headers.SetMethodStatic("GET");
+  headers.SetSchemeStatic("https");
+  headers.SetAuthority("example.com");
+  headers.SetPath("/index.html");
+  headers.Add("accept", "text/html");
+  headers.Add("user-agent", "HolyTLS/1.0");
+
+  assert(headers.method() == "GET");
+  assert(headers.scheme() == "https");
+  assert(headers.authority() == "example.com");
+  assert(headers.path() == "/index.html");
+  assert(headers.size() == 2);
+  assert(headers.Get("accept") == "text/html");
+  assert(headers.Has("user-agent"));
+  assert(!headers.Has("cookie"));
+  assert(headers.Get("cookie").empty());
+
+  std::println("PASSED");
+}
+
+void TestRequestHeadersCopiesInput() {
+  std::print("Testing RequestHeaders copies input... ");
+
+  RequestHeaders headers;
+  {
+    std::string name = "x-temp";
+    std::string value = "temporary-value";
+    headers.Add(name, value);
+    name.assign("overwritten");
+    value.assign("overwritten-too");
+  }
+
+  assert(headers.headers()[0].name == "x-temp");
+  assert(headers.headers()[0].value == "temporary-value");
+
+  std::println("PASSED");
+}
+
+void TestRequestHeadersGrowth() {
+  std::print("Testing RequestHeaders growth... ");
+
+  RequestHeaders headers;
+  for (int i = 0; i < 200; ++i) {
+    headers.Add("x-header-" + std::to_string(i), std::string(64, 'v'));
+  }
+
+  assert(headers.size() == 200);
+  for (int i = 0; i < 200; ++i) {
+    assert(headers.headers()[i].name == "x-header-" + std::to_string(i));
+    assert(headers.headers()[i].value.size() == 64);
+  }
+
+  std::println("PASSED");
+}
+
+void TestRequestHeadersMove() {
+  std::print("Testing RequestHeaders move... ");
+
+  RequestHeaders a;
+  a.SetPath("/moved");
+  a.Add("accept", "*/*");
+  const char* value_ptr = a.headers()[0].value.data();
+
+  RequestHeaders b = std::move(a);
+  assert(a.empty());
+  assert(b.path() == "/moved");
+  assert(b.Get("accept") == "*/*");
+  // Views still point into the same arena block
+  assert(b.headers()[0].value.data() == value_ptr);
+
+  RequestHeaders c;
+  c.Add("x", "y");
+  c = std::move(b);
+  assert(c.size() == 1);
+  assert(c.Get("accept") == "*/*");
+
+  std::println("PASSED");
+}
+
+void TestRequestHeadersApplyOrder() {
+  std::print("Testing RequestHeaders ApplyOrder... ");
+
+  RequestHeaders headers;
+  headers.Add("x-a", "1");
+  headers.Add("accept", "2");
+  headers.Add("x-b", "3");
+  headers.Add("user-agent", "4");
+  headers.Add("x-c", "5");
+
+  constexpr std::string_view kOrder[] = {"user-agent", "missing", "accept"};
+  headers.ApplyOrder(kOrder);
+
+  auto h = headers.headers();
+  assert(h[0].name == "user-agent");
+  assert(h[1].name == "accept");
+  // Unlisted headers keep their relative order
+  assert(h[2].name == "x-a");
+  assert(h[3].name == "x-b");
+  assert(h[4].name == "x-c");
+
+  std::println("PASSED");
+}
+
+void TestRequestHeadersKeepCase() {
+  std::print("Testing RequestHeaders keeps name case... ");
+
+  RequestHeaders headers;
+  headers.Add("X-Api-Key", "Secret-Value");
+  headers.Add("accept", "*/*");
+  headers.Add("User-Agent", "HolyTLS/1.0");
+
+  // Names and values are copied as given; H2 lowercases on the wire
+  assert(headers.headers()[0].name == "X-Api-Key");
+  assert(headers.headers()[0].value == "Secret-Value");
+  assert(headers.headers()[2].name == "User-Agent");
+
+  // Lookup and ordering match regardless of case
+  assert(headers.Get("X-API-KEY") == "Secret-Value");
+  assert(headers.Has("user-agent"));
+  constexpr std::string_view kOrder[] = {"User-Agent", "X-Api-Key"};
+  headers.ApplyOrder(kOrder);
+  assert(headers.headers()[0].name == "User-Agent");
+  assert(headers.headers()[1].name == "X-Api-Key");
+  assert(headers.headers()[2].name == "accept");
+  assert(!headers.failed());
+
+  std::println("PASSED");
+}
+
+namespace {
+
+// Decode the header names of the first HEADERS frame in `wire`
+std::vector<std::string> DecodeHeaderNames(const uint8_t* wire, size_t len) {
+  // Skip the client preface
+  constexpr size_t kPrefaceLen = 24;
+  size_t pos = kPrefaceLen;
+  std::vector<std::string> names;
+  while (pos + 9 <= len) {
+    size_t frame_len = (size_t{wire[pos]} << 16) |
+                       (size_t{wire[pos + 1]} << 8) | wire[pos + 2];
+    uint8_t type = wire[pos + 3];
+    uint8_t flags = wire[pos + 4];
+    const uint8_t* payload = wire + pos + 9;
+    pos += 9 + frame_len;
+    if (type != NGHTTP2_HEADERS) continue;
+
+    size_t skip = 0;
+    size_t pad = 0;
+    if ((flags & NGHTTP2_FLAG_PADDED) != 0) {
+      pad = payload[0];
+      skip = 1;
+    }
+    if ((flags & NGHTTP2_FLAG_PRIORITY) != 0) skip += 5;
+
+    nghttp2_hd_inflater* inflater = nullptr;
+    int rv = nghttp2_hd_inflate_new(&inflater);
+    assert(rv == 0);
+    const uint8_t* in = payload + skip;
+    size_t in_len = frame_len - skip - pad;
+    for (;;) {
+      nghttp2_nv nv;
+      int inflate_flags = 0;
+      ssize_t n = nghttp2_hd_inflate_hd2(inflater, &nv, &inflate_flags, in,
+                                         in_len, 1);
+      assert(n >= 0);
+      in += n;
+      in_len -= static_cast<size_t>(n);
+      if ((inflate_flags & NGHTTP2_HD_INFLATE_EMIT) != 0) {
+        names.emplace_back(reinterpret_cast<const char*>(nv.name),
+                           nv.namelen);
+      }
+      if ((inflate_flags & NGHTTP2_HD_INFLATE_FINAL) != 0) break;
+      if (n == 0 && in_len == 0) break;
+    }
+    nghttp2_hd_inflate_del(inflater);
+    break;
+  }
+  return names;
+}
+
+}  // namespace
+
+void TestH2MixedCaseNamesOnWire() {
+  std::print("Testing mixed-case header names on the H2 wire... ");
+
+  http2::H2Session session(http2::GetChromeH2Profile(ChromeVersion::kLatest),
+                           {});
+  assert(session.Initialize());
+
+  RequestHeaders headers;
+  headers.SetMethodStatic("GET");
+  headers.SetSchemeStatic("https");
+  headers.SetAuthority("example.com");
+  headers.SetPath("/");
+  headers.Add("X-Api-Key", "Secret");
+  // A static name with uppercase is copied and lowercased by nghttp2
+  headers.AddStatic("X-Static-Name", "1");
+  headers.AddStatic("accept", "*/*");
+  assert(session.SubmitRequest(headers, {}) > 0);
+
+  auto [data, len] = session.GetPendingData();
+  std::vector<std::string> names = DecodeHeaderNames(data, len);
+  std::vector<std::string> expected = {":method",   ":authority",
+                                       ":scheme",   ":path",
+                                       "x-api-key", "x-static-name",
+                                       "accept"};
+  assert(names == expected);
+
+  std::println("PASSED");
+}
+
+// Allocation microbenchmark: the old pipeline copied headers into a
+// vector<pair<string,string>>, then into an ordering map, then into owned
+// header strings for the session. The arena block is built once.
+void BenchmarkAllocationsPerRequest() {
+  std::println("Benchmarking allocations per request:");
+
+  constexpr int kIterations = 20000;
+  const std::string path = "/api/v1/resource?id=12345&filter=active";
+  constexpr std::string_view kOrder[] = {"user-agent", "accept", "cookie"};
+
+  // Legacy-style chain
+  size_t before = g_allocations.load();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    std::vector<std::pair<std::string, std::string>> conn_headers;
+    for (const auto& [n, v] : kSampleHeaders) {
+      conn_headers.emplace_back(std::string(n), std::string(v));
+    }
+    std::unordered_map<std::string_view, std::string_view> header_map;
+    for (const auto& [n, v] : conn_headers) header_map[n] = v;
+    std::vector<std::pair<std::string, std::string>> session_headers;
+    for (auto name : kOrder) {
+      auto it = header_map.find(name);
+      if (it != header_map.end()) {
+        session_headers.emplace_back(std::string(it->first),
+                                     std::string(it->second));
+        header_map.erase(it);
+      }
+    }
+    for (const auto& [n, v] : header_map) {
+      session_headers.emplace_back(std::string(n), std::string(v));
+    }
+    std::string method = "GET";
+    std::string session_path = path;
+    assert(session_headers.size() == std::size(kSampleHeaders));
+  }
+  auto legacy_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  double legacy_allocs =
+      static_cast<double>(g_allocations.load() - before) / kIterations;
+
+  // Arena block
+  size_t arena_blocks = 0;
+  before = g_allocations.load();
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    RequestHeaders headers;
+    headers.SetMethodStatic("GET");
+    headers.SetPath(path);
+    for (const auto& [n, v] : kSampleHeaders) {
+      headers.Add(n, v);
+    }
+    headers.ApplyOrder(kOrder);
+    assert(headers.size() == std::size(kSampleHeaders));
+    arena_blocks += ArenaBlocks(headers.arena());
+  }
+  auto arena_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  double arena_allocs =
+      static_cast<double>(g_allocations.load() - before + arena_blocks) /
+      kIterations;
+
+  std::println("  legacy: {:.1f} allocs/request, {} ns/request",
+               legacy_allocs, legacy_ns / kIterations);
+  std::println("  arena:  {:.1f} allocs/request, {} ns/request", arena_allocs,
+               arena_ns / kIterations);
+
+  // One arena block per typical request, nothing from operator new
+  assert(arena_allocs <= 1.0);
+  assert(arena_allocs < legacy_allocs);
+}
+
+int main() {
+  std::println("=== RequestHeaders Unit Tests ===\n");
+
+  TestRequestHeadersBasic();
+  TestRequestHeadersCopiesInput();
+  TestRequestHeadersGrowth();
+  TestRequestHeadersMove();
+  TestRequestHeadersApplyOrder();
+  TestRequestHeadersKeepCase();
+  TestH2MixedCaseNamesOnWire();
+  BenchmarkAllocationsPerRequest();
+
+  std::println("\nAll RequestHeaders tests passed!");
+  return 0;
+}
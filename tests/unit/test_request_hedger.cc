@@ -0,0 +1,117 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/client/request_hedger.h"
+
+#include <cassert>
+#include <print>
+
+using namespace holytls;
+
+namespace {
+
+HedgeConfig MakeConfig() {
+  HedgeConfig config;
+  config.enabled = true;
+  config.percentile = 95.0;
+  config.min_delay = std::chrono::milliseconds(5);
+  config.budget = 0.05;
+  config.min_samples = 100;
+  return config;
+}
+
+}  // namespace
+
+void TestEligible() {
+  std::print("Testing which requests may be hedged... ");
+
+  Request get;
+  get.method = Method::kGet;
+  assert(RequestHedger::Eligible(get));
+
+  Request head;
+  head.method = Method::kHead;
+  assert(RequestHedger::Eligible(head));
+
+  Request post;
+  post.method = Method::kPost;
+  assert(!RequestHedger::Eligible(post));
+
+  Request get_with_body;
+  get_with_body.method = Method::kGet;
+  get_with_body.body = {0x78};
+  assert(!RequestHedger::Eligible(get_with_body));
+
+  std::println("PASSED");
+}
+
+void TestBudget() {
+  std::print("Testing hedge budget... ");
+
+  RequestHedger hedger(MakeConfig());
+  assert(!hedger.TryHedge());
+
+  // At most one hedge per 20 requests
+  int hedges = 0;
+  for (int i = 0; i < 1000; ++i) {
+    hedger.OnRequest();
+    if (hedger.TryHedge()) {
+      hedges++;
+    }
+  }
+  assert(hedges <= 50);
+  assert(hedges >= 49);
+
+  // Quiet periods save up only a few
+  RequestHedger idle(MakeConfig());
+  for (int i = 0; i < 100000; ++i) {
+    idle.OnRequest();
+  }
+  assert(idle.budget() == RequestHedger::kMaxTokens);
+
+  std::println("PASSED");
+}
+
+void TestDelay() {
+  std::print("Testing hedge delay from TTFB... ");
+
+  RequestHedger hedger(MakeConfig());
+  core::LatencyHistogram ttfb;
+
+  // Too few samples: no hedging
+  for (int i = 0; i < 50; ++i) {
+    ttfb.Record(20000);
+  }
+  assert(hedger.DelayUs(ttfb, 0) == 0);
+
+  // Not recomputed within the refresh interval
+  for (int i = 0; i < 150; ++i) {
+    ttfb.Record(20000);
+  }
+  assert(hedger.DelayUs(ttfb, RequestHedger::kRefreshUs - 1) == 0);
+
+  uint64_t delay = hedger.DelayUs(ttfb, RequestHedger::kRefreshUs);
+  assert(delay >= 10000);
+  assert(delay <= 40000);
+
+  // Never below the configured floor
+  RequestHedger fast(MakeConfig());
+  core::LatencyHistogram fast_ttfb;
+  for (int i = 0; i < 200; ++i) {
+    fast_ttfb.Record(100);
+  }
+  assert(fast.DelayUs(fast_ttfb, 0) == 5000);
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Request Hedger Unit Tests ===\n");
+
+  TestEligible();
+  TestBudget();
+  TestDelay();
+
+  std::println("\nAll request hedger tests passed!");
+  return 0;
+}
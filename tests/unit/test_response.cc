@@ -0,0 +1,95 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include <cassert>
+#include <print>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "holytls/client.h"
+#include "holytls/http2/packed_headers.h"
+
+using namespace holytls;
+using holytls::http2::HeaderId;
+
+namespace {
+
+http2::PackedHeaders MakeHeaders() {
+  http2::PackedHeadersBuilder builder;
+  builder.SetStatus("200");
+  builder.Add("Content-Type", "text/html");
+  builder.Add("content-length", "5");
+  builder.Add("set-cookie", "a=1");
+  builder.Add("set-cookie", "b=2");
+  builder.Add("x-request-id", "abc");
+  return builder.Build();
+}
+
+}  // namespace
+
+void TestResponseHeaderLookup() {
+  std::print("Testing Response header lookup... ");
+
+  Response response(200, MakeHeaders(), {});
+
+  // Known names match case-insensitively, by name or id
+  assert(response.GetHeader("content-type") == "text/html");
+  assert(response.GetHeader("Content-Type") == "text/html");
+  assert(response.GetHeader(HeaderId::kContentType) == "text/html");
+  assert(response.HasHeader(HeaderId::kSetCookie));
+  assert(!response.HasHeader(HeaderId::kLocation));
+
+  // Custom names
+  assert(response.GetHeader("x-request-id") == "abc");
+  assert(!response.HasHeader("x-missing"));
+
+  assert(response.content_length() == 5);
+
+  std::println("PASSED");
+}
+
+void TestResponseIteration() {
+  std::print("Testing Response header iteration... ");
+
+  Response response(200, MakeHeaders(), {});
+
+  size_t cookies = 0;
+  size_t count = 0;
+  for (auto [name, value] : response.headers) {
+    if (name == "set-cookie") ++cookies;
+    ++count;
+  }
+  assert(count == 5);
+  assert(cookies == 2);
+
+  std::println("PASSED");
+}
+
+void TestResponseMovesBody() {
+  std::print("Testing Response takes body without copying... ");
+
+  std::vector<uint8_t> body = {'h', 'e', 'l', 'l', 'o'};
+  const uint8_t* data = body.data();
+
+  Response response(200, MakeHeaders(), std::move(body));
+  assert(response.body.data() == data);
+  assert(response.body_string() == "hello");
+
+  Response moved = std::move(response);
+  assert(moved.body.data() == data);
+  assert(moved.GetHeader(HeaderId::kContentLength) == "5");
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Response Unit Tests ===\n");
+
+  TestResponseHeaderLookup();
+  TestResponseIteration();
+  TestResponseMovesBody();
+
+  std::println("\nAll Response tests passed!");
+  return 0;
+}
@@ -0,0 +1,385 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/http/response_cache.h"
+
+#include <unistd.h>
+
+#include <cassert>
+#include <filesystem>
+#include <map>
+#include <print>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "holytls/http/cache_control.h"
+#include "holytls/http/cache_segment_store.h"
+
+using namespace holytls;
+using namespace holytls::http;
+
+namespace {
+
+http2::PackedHeaders MakeHeaders(
+    int status,
+    std::initializer_list<std::pair<std::string_view, std::string_view>>
+        headers) {
+  http2::PackedHeadersBuilder builder;
+  builder.SetStatus(std::to_string(status));
+  for (auto [name, value] : headers) {
+    builder.Add(name, value);
+  }
+  return builder.Build();
+}
+
+std::vector<uint8_t> Bytes(std::string_view s) {
+  return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+// Request headers as a RequestHeaderLookup
+struct FakeRequest {
+  std::map<std::string, std::string> headers;
+
+  RequestHeaderLookup Lookup() const {
+    return [this](std::string_view name) -> std::string_view {
+      auto it = headers.find(std::string(name));
+      return it == headers.end() ? std::string_view() : it->second;
+    };
+  }
+};
+
+std::string TempDir(std::string_view name) {
+  auto dir = std::filesystem::temp_directory_path() /
+             (std::string(name) + "-" + std::to_string(::getpid()));
+  std::filesystem::remove_all(dir);
+  return dir.string();
+}
+
+}  // namespace
+
+void TestParseCacheControl() {
+  std::print("Testing Cache-Control parsing... ");
+
+  CacheControl cc = ParseCacheControl("public, max-age=300, must-revalidate");
+  assert(cc.is_public && cc.must_revalidate && cc.max_age == 300);
+  assert(!cc.no_cache && !cc.no_store);
+
+  cc = ParseCacheControl("No-Store,no-cache=\"set-cookie\", private");
+  assert(cc.no_store && cc.no_cache && cc.is_private);
+  assert(cc.max_age == -1);
+
+  assert(ParseCacheControl("max-age=\"60\"").max_age == 60);
+  assert(ParseCacheControl("max-age=abc").max_age == -1);
+  assert(ParseCacheControl("max-age=99999999999").max_age ==
+         int64_t{1} << 31);
+
+  std::println("PASSED");
+}
+
+void TestFreshness() {
+  std::print("Testing freshness calculation... ");
+
+  // Date: Sun, 06 Nov 1994 08:49:37 GMT
+  constexpr uint64_t kDate = 784111777000;
+  auto headers = MakeHeaders(200, {{"date", "Sun, 06 Nov 1994 08:49:37 GMT"},
+                                   {"age", "20"}});
+  CacheControl cc = ParseCacheControl("max-age=100");
+  Freshness f = ComputeFreshness(headers, cc, kDate, kDate + 5000);
+  assert(f.explicit_lifetime);
+  assert(f.lifetime_ms == 100000);
+  // max(apparent 5s, age 20s + response delay 5s)
+  assert(f.initial_age_ms == 25000);
+
+  // Expires relative to Date
+  headers = MakeHeaders(200, {{"date", "Sun, 06 Nov 1994 08:49:37 GMT"},
+                              {"expires", "Sun, 06 Nov 1994 08:50:37 GMT"}});
+  f = ComputeFreshness(headers, {}, kDate, kDate);
+  assert(f.explicit_lifetime && f.lifetime_ms == 60000);
+
+  // Invalid Expires: already stale
+  headers = MakeHeaders(200, {{"expires", "0"}});
+  f = ComputeFreshness(headers, {}, kDate, kDate);
+  assert(f.explicit_lifetime && f.lifetime_ms == 0);
+
+  // Heuristic: 10% of the time since Last-Modified
+  headers =
+      MakeHeaders(200, {{"date", "Sun, 06 Nov 1994 08:49:37 GMT"},
+                        {"last-modified", "Sun, 06 Nov 1994 07:49:37 GMT"}});
+  f = ComputeFreshness(headers, {}, kDate, kDate);
+  assert(!f.explicit_lifetime && f.lifetime_ms == 360000);
+
+  assert(IsHeuristicallyCacheable(200) && IsHeuristicallyCacheable(404));
+  assert(!IsHeuristicallyCacheable(302) && !IsHeuristicallyCacheable(500));
+
+  std::println("PASSED");
+}
+
+void TestStoreAndLookup() {
+  std::print("Testing store and lookup... ");
+
+  ResponseCache cache;
+  FakeRequest request;
+  const std::string url = "https://example.com/api";
+  uint64_t now = ResponseCache::NowMs();
+
+  assert(cache.Lookup("GET", url, request.Lookup()).entry == nullptr);
+
+  auto body = Bytes("hello");
+  auto headers = MakeHeaders(200, {{"cache-control", "max-age=60"},
+                                   {"content-type", "text/plain"}});
+  assert(cache.Store("GET", url, request.Lookup(), 200, headers, body, now));
+
+  CacheLookup hit = cache.Lookup("GET", url + "#frag", request.Lookup());
+  assert(hit.entry != nullptr && hit.fresh);
+  assert(hit.entry->status_code == 200);
+  assert(hit.entry->body == body);
+  assert(hit.entry->headers.Get(http2::HeaderId::kContentType) ==
+         "text/plain");
+
+  // Only GET is cached
+  assert(!cache.Store("POST", url, request.Lookup(), 200, headers, body, now));
+  assert(cache.Lookup("HEAD", url, request.Lookup()).entry == nullptr);
+
+  // Request no-cache and max-age=0 force revalidation
+  request.headers["cache-control"] = "no-cache";
+  hit = cache.Lookup("GET", url, request.Lookup());
+  assert(hit.entry != nullptr && !hit.fresh);
+  request.headers["cache-control"] = "no-store";
+  assert(cache.Lookup("GET", url, request.Lookup()).entry == nullptr);
+  request.headers.clear();
+
+  // no-store responses are not kept and drop what was stored
+  auto no_store = MakeHeaders(200, {{"cache-control", "no-store"}});
+  assert(!cache.Store("GET", url, request.Lookup(), 200, no_store, body, now));
+  assert(cache.Lookup("GET", url, request.Lookup()).entry == nullptr);
+
+  // Without explicit freshness, only heuristically cacheable statuses
+  auto plain = MakeHeaders(302, {{"etag", "\"a\""}});
+  assert(!cache.Store("GET", url, request.Lookup(), 302, plain, body, now));
+
+  // ETag with no lifetime: stored, always stale
+  auto etag_only = MakeHeaders(200, {{"etag", "\"v1\""}});
+  assert(cache.Store("GET", url, request.Lookup(), 200, etag_only, body, now));
+  hit = cache.Lookup("GET", url, request.Lookup());
+  assert(hit.entry != nullptr && !hit.fresh && hit.entry->HasValidator());
+
+  // Nothing fresh and nothing to revalidate with
+  auto useless = MakeHeaders(200, {{"content-type", "text/plain"}});
+  assert(!cache.Store("GET", url + "/x", request.Lookup(), 200, useless, body,
+                      now));
+
+  // Authorization needs public or must-revalidate
+  request.headers["authorization"] = "Bearer t";
+  assert(!cache.Store("GET", url, request.Lookup(), 200, headers, body, now));
+  auto shared = MakeHeaders(200, {{"cache-control", "public, max-age=60"}});
+  assert(cache.Store("GET", url, request.Lookup(), 200, shared, body, now));
+
+  // Unsafe requests invalidate
+  cache.Invalidate(url);
+  assert(cache.Lookup("GET", url, request.Lookup()).entry == nullptr);
+
+  ResponseCacheStats stats = cache.GetStats();
+  assert(stats.hits == 1 && stats.stale == 2 && stats.stores == 3);
+
+  std::println("PASSED");
+}
+
+void TestVary() {
+  std::print("Testing Vary matching... ");
+
+  ResponseCache cache;
+  FakeRequest gzip;
+  gzip.headers["accept-encoding"] = "gzip";
+  FakeRequest br;
+  br.headers["accept-encoding"] = "br";
+
+  const std::string url = "https://example.com/vary";
+  auto headers = MakeHeaders(
+      200, {{"cache-control", "max-age=60"}, {"vary", "Accept-Encoding"}});
+  auto body = Bytes("x");
+  assert(cache.Store("GET", url, gzip.Lookup(), 200, headers, body,
+                     ResponseCache::NowMs()));
+
+  assert(cache.Lookup("GET", url, gzip.Lookup()).fresh);
+  assert(cache.Lookup("GET", url, br.Lookup()).entry == nullptr);
+
+  auto star = MakeHeaders(200, {{"cache-control", "max-age=60"},
+                                {"vary", "*"}});
+  assert(!cache.Store("GET", url + "/star", gzip.Lookup(), 200, star, body,
+                      ResponseCache::NowMs()));
+
+  std::println("PASSED");
+}
+
+void TestRevalidation() {
+  std::print("Testing 304 revalidation... ");
+
+  ResponseCache cache;
+  FakeRequest request;
+  const std::string url = "https://example.com/poll";
+  uint64_t now = ResponseCache::NowMs();
+
+  auto headers = MakeHeaders(200, {{"etag", "\"v1\""},
+                                   {"content-length", "4"},
+                                   {"x-version", "1"}});
+  auto body = Bytes("data");
+  assert(cache.Store("GET", url, request.Lookup(), 200, headers, body, now));
+
+  CacheLookup stale = cache.Lookup("GET", url, request.Lookup());
+  assert(stale.entry != nullptr && !stale.fresh);
+  assert(stale.entry->etag() == "\"v1\"");
+
+  // The 304 updates headers and freshness, never the framing
+  auto not_modified = MakeHeaders(304, {{"cache-control", "max-age=60"},
+                                        {"content-length", "0"},
+                                        {"x-version", "2"}});
+  auto updated =
+      cache.Revalidated("GET", url, stale.entry, not_modified, now);
+  assert(updated->status_code == 200);
+  assert(updated->body == body);
+  assert(updated->headers.Get("x-version") == "2");
+  assert(updated->headers.Get("content-length") == "4");
+  assert(updated->etag() == "\"v1\"");
+
+  CacheLookup fresh = cache.Lookup("GET", url, request.Lookup());
+  assert(fresh.fresh && fresh.entry->body == body);
+  assert(cache.GetStats().revalidations == 1);
+
+  std::println("PASSED");
+}
+
+void TestLruEviction() {
+  std::print("Testing memory tier LRU eviction... ");
+
+  ResponseCacheConfig config;
+  config.shards = 1;
+  config.max_memory_bytes = 4096;
+  ResponseCache cache(config);
+  FakeRequest request;
+  uint64_t now = ResponseCache::NowMs();
+
+  auto headers = MakeHeaders(200, {{"cache-control", "max-age=60"}});
+  std::vector<uint8_t> body(1000, 'b');
+  for (int i = 0; i < 3; ++i) {
+    cache.Store("GET", "https://example.com/" + std::to_string(i),
+                request.Lookup(), 200, headers, body, now);
+  }
+  // Touch 0 so 1 is the least recently used
+  assert(cache.Lookup("GET", "https://example.com/0", request.Lookup()).fresh);
+  cache.Store("GET", "https://example.com/3", request.Lookup(), 200, headers,
+              body, now);
+
+  assert(cache.Lookup("GET", "https://example.com/1", request.Lookup())
+             .entry == nullptr);
+  assert(cache.Lookup("GET", "https://example.com/0", request.Lookup()).fresh);
+  assert(cache.Lookup("GET", "https://example.com/3", request.Lookup()).fresh);
+
+  ResponseCacheStats stats = cache.GetStats();
+  assert(stats.evictions >= 1);
+  assert(stats.memory_bytes <= config.max_memory_bytes);
+
+  std::println("PASSED");
+}
+
+void TestSegmentStore() {
+  std::print("Testing disk segment store... ");
+
+  std::string dir = TempDir("holytls-segments");
+  std::vector<uint8_t> value;
+  {
+    CacheSegmentStore store(dir, 4096, 3 * 4096);
+    assert(store.Open());
+    assert(store.Put("a", Bytes("one")));
+    assert(store.Put("b", Bytes("two")));
+    assert(store.Put("a", Bytes("three")));
+    store.Remove("b");
+    assert(!store.Put("huge", std::vector<uint8_t>(8192, 0)));
+  }
+  {
+    // Reopened: the index is rebuilt from the segments
+    CacheSegmentStore store(dir, 4096, 3 * 4096);
+    assert(store.Open());
+    assert(store.Get("a", &value) && value == Bytes("three"));
+    assert(!store.Get("b", &value));
+    assert(store.entries() == 1);
+
+    // Filling past the budget drops the oldest segment whole
+    std::vector<uint8_t> chunk(1500, 'c');
+    for (int i = 0; i < 12; ++i) {
+      assert(store.Put("k" + std::to_string(i), chunk));
+    }
+    assert(store.bytes() <= 3 * 4096);
+    assert(!store.Get("a", &value));
+    assert(store.Get("k11", &value) && value == chunk);
+  }
+  std::filesystem::remove_all(dir);
+
+  std::println("PASSED");
+}
+
+void TestDiskTier() {
+  std::print("Testing disk tier persistence... ");
+
+  std::string dir = TempDir("holytls-cache");
+  ResponseCacheConfig config;
+  config.disk_path = dir;
+  config.disk_segment_bytes = 64 * 1024;
+  config.max_disk_bytes = 256 * 1024;
+  FakeRequest request;
+  auto headers = MakeHeaders(200, {{"cache-control", "max-age=600"},
+                                   {"etag", "\"d\""}});
+  auto body = Bytes("persisted body");
+  const std::string url = "https://example.com/disk";
+  {
+    ResponseCache cache(config);
+    assert(cache.disk_enabled());
+    assert(cache.Store("GET", url, request.Lookup(), 200, headers, body,
+                       ResponseCache::NowMs()));
+  }
+  {
+    // A new cache starts with an empty memory tier and promotes from disk
+    ResponseCache cache(config);
+    assert(cache.GetStats().memory_entries == 0);
+    CacheLookup hit = cache.Lookup("GET", url, request.Lookup());
+    assert(hit.entry != nullptr && hit.fresh);
+    assert(hit.entry->body == body);
+    assert(hit.entry->etag() == "\"d\"");
+    assert(hit.entry->status_code == 200);
+    assert(hit.entry->headers.status_code() == 200);
+    assert(cache.GetStats().memory_entries == 1);
+
+    cache.Clear();
+    assert(cache.Lookup("GET", url, request.Lookup()).entry == nullptr);
+
+    // Writes are queued in order: the removal follows the store
+    assert(cache.Store("GET", url, request.Lookup(), 200, headers, body,
+                       ResponseCache::NowMs()));
+    cache.Invalidate(url);
+  }
+  {
+    ResponseCache cache(config);
+    assert(cache.Lookup("GET", url, request.Lookup()).entry == nullptr);
+    assert(cache.GetStats().disk_dropped == 0);
+  }
+  std::filesystem::remove_all(dir);
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Response Cache Unit Tests ===\n");
+
+  TestParseCacheControl();
+  TestFreshness();
+  TestStoreAndLookup();
+  TestVary();
+  TestRevalidation();
+  TestLruEviction();
+  TestSegmentStore();
+  TestDiskTier();
+
+  std::println("\nAll response cache tests passed!");
+  return 0;
+}
@@ -0,0 +1,193 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/memory/slab_allocator.h"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <print>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace holytls;
+using holytls::memory::SlabAllocator;
+
+namespace {
+
+struct Object {
+  uint64_t a = 0;
+  uint64_t b = 0;
+};
+
+struct Pooled : memory::SlabAllocated<Pooled> {
+  int value = 0;
+};
+
+}  // namespace
+
+void TestAllocateAndReuse() {
+  std::print("Testing allocate and reuse... ");
+
+  SlabAllocator<Object, 16> alloc;
+  assert(alloc.allocated_count() == 0);
+
+  std::vector<Object*> objects;
+  for (int i = 0; i < 100; ++i) {
+    Object* obj = alloc.Construct();
+    obj->a = static_cast<uint64_t>(i);
+    objects.push_back(obj);
+  }
+  assert(alloc.allocated_count() == 100);
+  assert(alloc.total_capacity() >= 100);
+
+  // Distinct, cache-line aligned, and never sharing a line
+  std::set<Object*> unique(objects.begin(), objects.end());
+  assert(unique.size() == objects.size());
+  for (Object* obj : objects) {
+    assert(reinterpret_cast<uintptr_t>(obj) % kCacheLineSize == 0);
+  }
+  static_assert(SlabAllocator<Object>::slot_size() == kCacheLineSize);
+
+  for (Object* obj : objects) {
+    alloc.Destroy(obj);
+  }
+  assert(alloc.allocated_count() == 0);
+
+  // Freed slots are handed out again before new slabs
+  size_t slabs = alloc.slab_count();
+  for (int i = 0; i < 100; ++i) {
+    objects[i] = alloc.Allocate();
+  }
+  assert(alloc.slab_count() == slabs);
+  for (Object* obj : objects) {
+    alloc.Deallocate(obj);
+  }
+
+  std::println("PASSED");
+}
+
+void TestCrossThread() {
+  std::print("Testing allocation and free on different threads... ");
+
+  SlabAllocator<Object, 64> alloc;
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 5000;
+
+  // Each thread allocates a batch that another thread frees
+  std::vector<std::vector<Object*>> batches(kThreads);
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&alloc, &batches, t] {
+        for (int i = 0; i < kPerThread; ++i) {
+          Object* obj = alloc.Construct();
+          obj->a = static_cast<uint64_t>(t);
+          obj->b = static_cast<uint64_t>(i);
+          batches[t].push_back(obj);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  assert(alloc.allocated_count() == kThreads * kPerThread);
+
+  std::set<Object*> unique;
+  for (int t = 0; t < kThreads; ++t) {
+    for (int i = 0; i < kPerThread; ++i) {
+      Object* obj = batches[t][i];
+      assert(obj->a == static_cast<uint64_t>(t));
+      assert(obj->b == static_cast<uint64_t>(i));
+      unique.insert(obj);
+    }
+  }
+  assert(unique.size() == kThreads * kPerThread);
+
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&alloc, &batches, t] {
+        for (Object* obj : batches[(t + 1) % kThreads]) {
+          alloc.Destroy(obj);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  assert(alloc.allocated_count() == 0);
+
+  // Slots freed by exited threads are reused
+  size_t slabs = alloc.slab_count();
+  std::vector<Object*> again;
+  for (int i = 0; i < kThreads * kPerThread; ++i) {
+    again.push_back(alloc.Allocate());
+  }
+  assert(alloc.slab_count() == slabs);
+  for (Object* obj : again) {
+    alloc.Deallocate(obj);
+  }
+
+  std::println("PASSED");
+}
+
+void TestSlabAllocated() {
+  std::print("Testing slab-backed new/delete... ");
+
+  std::vector<std::unique_ptr<Pooled>> objects;
+  for (int i = 0; i < 200; ++i) {
+    objects.push_back(std::make_unique<Pooled>());
+    objects.back()->value = i;
+    assert(reinterpret_cast<uintptr_t>(objects.back().get()) %
+               kCacheLineSize ==
+           0);
+  }
+  for (int i = 0; i < 200; ++i) {
+    assert(objects[i]->value == i);
+  }
+  objects.clear();
+
+  auto* raw = new Pooled();
+  assert(raw->value == 0);
+  delete raw;
+
+  std::println("PASSED");
+}
+
+void TestChargedToSharedAccount() {
+  std::print("Testing slabs charged to the shared account... ");
+
+  // Growth on a reactor thread is not that reactor's memory
+  memory::MemoryAccount reactor_account;
+  memory::MemoryAccount* shared = memory::SharedMemoryAccount();
+  size_t shared_before = shared->current(memory::MemoryTag::kPoolMetadata);
+  {
+    memory::ScopedMemoryAccount scope(&reactor_account);
+    SlabAllocator<Object> alloc;
+    Object* obj = alloc.Allocate();
+    assert(reactor_account.total() == 0);
+    if constexpr (memory::kMemoryAccountingEnabled) {
+      assert(shared->current(memory::MemoryTag::kPoolMetadata) >
+             shared_before);
+    }
+    alloc.Deallocate(obj);
+  }
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Slab Allocator Unit Tests ===\n");
+
+  TestAllocateAndReuse();
+  TestCrossThread();
+  TestSlabAllocated();
+  TestChargedToSharedAccount();
+
+  std::println("\nAll slab allocator tests passed!");
+  return 0;
+}
@@ -0,0 +1,123 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/core/stats.h"
+
+#include <cassert>
+#include <cstdint>
+#include <print>
+#include <thread>
+
+using namespace holytls::core;
+
+namespace {
+
+// Reported value must be >= the true value and within one sub-bucket
+bool Within(uint64_t reported, uint64_t expected) {
+  return reported >= expected && reported <= expected + expected / 16 + 1;
+}
+
+}  // namespace
+
+void TestBucketBounds() {
+  std::print("Testing histogram bucket bounds... ");
+
+  for (uint64_t v : {0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 31ULL, 32ULL, 1000ULL,
+                     123456ULL, 1ULL << 39, (1ULL << 41) - 1}) {
+    size_t index = LatencyHistogram::BucketIndex(v);
+    assert(index < LatencyHistogram::kBuckets);
+    assert(LatencyHistogram::BucketUpperBound(index) >= v);
+    if (index > 0) {
+      assert(LatencyHistogram::BucketUpperBound(index - 1) < v);
+    }
+  }
+
+  // Indices are monotonic
+  size_t prev = 0;
+  for (uint64_t v = 0; v < 100000; v += 7) {
+    size_t index = LatencyHistogram::BucketIndex(v);
+    assert(index >= prev);
+    prev = index;
+  }
+
+  // Out of range values clamp to the last bucket
+  assert(LatencyHistogram::BucketIndex(UINT64_MAX) ==
+         LatencyHistogram::kBuckets - 1);
+
+  std::println("PASSED");
+}
+
+void TestPercentiles() {
+  std::print("Testing histogram percentiles... ");
+
+  LatencyHistogram histogram;
+  for (uint64_t v = 1; v <= 10000; ++v) {
+    histogram.Record(v);
+  }
+
+  HistogramSnapshot snapshot;
+  snapshot.Merge(histogram);
+  assert(snapshot.count() == 10000);
+  assert(snapshot.max() == 10000);
+  assert(snapshot.mean() > 5000.0 && snapshot.mean() < 5001.0);
+  assert(Within(snapshot.Percentile(50.0), 5000));
+  assert(Within(snapshot.Percentile(99.0), 9900));
+  assert(Within(snapshot.Percentile(99.9), 9990));
+  assert(snapshot.Percentile(100.0) == 10000);
+
+  HistogramSnapshot empty;
+  assert(empty.Percentile(99.0) == 0);
+  assert(empty.mean() == 0.0);
+
+  std::println("PASSED");
+}
+
+void TestMergeAcrossReactors() {
+  std::print("Testing merge across reactors... ");
+
+  ReactorStats a;
+  ReactorStats b;
+
+  // Each block has its own writer thread
+  std::thread ta([&] {
+    for (int i = 0; i < 1000; ++i) {
+      a.requests_completed.Add();
+      a.ttfb.Record(100);
+    }
+  });
+  std::thread tb([&] {
+    for (int i = 0; i < 1000; ++i) {
+      b.requests_completed.Add();
+      b.ttfb.Record(300);
+    }
+    b.bytes_received.Add(4096);
+  });
+  ta.join();
+  tb.join();
+
+  StatsSnapshot snapshot;
+  snapshot.Merge(a);
+  snapshot.Merge(b);
+  assert(snapshot.requests_completed == 2000);
+  assert(snapshot.bytes_received == 4096);
+  assert(snapshot.ttfb.count() == 2000);
+  assert(Within(snapshot.ttfb.Percentile(25.0), 100));
+  assert(Within(snapshot.ttfb.Percentile(75.0), 300));
+  assert(snapshot.ttfb.max() == 300);
+
+  // Padded so neighbouring reactors' blocks don't share cache lines
+  static_assert(alignof(ReactorStats) >= 64);
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Stats Unit Tests ===\n");
+
+  TestBucketBounds();
+  TestPercentiles();
+  TestMergeAcrossReactors();
+
+  std::println("\nAll stats tests passed!");
+  return 0;
+}
@@ -0,0 +1,136 @@
+// Copyright 2026 HolyTLS Authors
+// SPDX-License-Identifier: MIT
+
+#include "holytls/core/trace.h"
+
+#include <cassert>
+#include <cstdio>
+#include <print>
+#include <string>
+#include <vector>
+
+using namespace holytls::core;
+
+namespace {
+
+TraceRecord MakeRecord(uint64_t time_us, TraceEvent event, int64_t stream = -1,
+                       uint64_t arg = 0) {
+  TraceRecord record;
+  record.time_us = time_us;
+  record.id = 0xabc;
+  record.stream = stream;
+  record.arg = arg;
+  record.event = event;
+  return record;
+}
+
+// Counts sink calls
+class CountingSink : public TraceSink {
+ public:
+  void Record(const TraceRecord& /*record*/) override { ++count; }
+  int count = 0;
+};
+
+}  // namespace
+
+void TestRingKeepsNewest() {
+  std::print("Testing ring keeps the newest records... ");
+
+  TraceRing ring(4);
+  assert(ring.Snapshot().empty());
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    ring.Record(MakeRecord(i, TraceEvent::kPoolAcquire));
+  }
+  auto partial = ring.Snapshot();
+  assert(partial.size() == 3);
+  assert(partial[0].time_us == 0);
+
+  for (uint64_t i = 3; i < 10; ++i) {
+    ring.Record(MakeRecord(i, TraceEvent::kPoolAcquire));
+  }
+  auto full = ring.Snapshot();
+  assert(full.size() == 4);
+  for (size_t i = 0; i < full.size(); ++i) {
+    assert(full[i].time_us == 6 + i);  // Oldest first
+  }
+
+  std::println("PASSED");
+}
+
+void TestTraceCall() {
+  std::print("Testing Trace() honours the build flag... ");
+
+  CountingSink sink;
+  int object = 0;
+  Trace(&sink, TraceEvent::kConnectStart, &object);
+  Trace(static_cast<TraceSink*>(nullptr), TraceEvent::kConnectStart, &object);
+  assert(sink.count == (kTracingEnabled ? 1 : 0));
+
+  std::println("PASSED");
+}
+
+void TestFileRoundTrip() {
+  std::print("Testing binary trace file round trip... ");
+
+  std::vector<TraceRecord> records = {
+      MakeRecord(10, TraceEvent::kTlsStart),
+      MakeRecord(25, TraceEvent::kTlsEnd, -1, 2),
+      MakeRecord(30, TraceEvent::kStreamOpen, 1),
+  };
+  std::string path = "holytls_test_trace.bin";
+  assert(WriteTraceFile(path, records));
+
+  std::vector<TraceRecord> read;
+  assert(ReadTraceFile(path, &read));
+  assert(read.size() == records.size());
+  for (size_t i = 0; i < read.size(); ++i) {
+    assert(read[i].time_us == records[i].time_us);
+    assert(read[i].event == records[i].event);
+    assert(read[i].stream == records[i].stream);
+    assert(read[i].arg == records[i].arg);
+  }
+  std::remove(path.c_str());
+
+  // Not a trace file
+  assert(!ReadTraceFile("holytls_missing_trace.bin", &read));
+
+  std::println("PASSED");
+}
+
+void TestChromeJson() {
+  std::print("Testing Chrome trace JSON... ");
+
+  std::vector<TraceRecord> records = {
+      MakeRecord(100, TraceEvent::kStreamOpen, 3),
+      MakeRecord(150, TraceEvent::kStreamFirstByte, 3),
+      MakeRecord(200, TraceEvent::kStreamEnd, 3),
+  };
+  std::string json = TraceToChromeJson(records);
+
+  assert(json.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  assert(json.ends_with("]}"));
+  assert(json.find("\"name\":\"stream\",\"cat\":\"holytls\",\"ph\":\"b\"") !=
+         std::string::npos);
+  assert(json.find("\"ph\":\"e\"") != std::string::npos);
+  assert(json.find("\"id\":\"abc:3\"") != std::string::npos);
+  assert(json.find("\"name\":\"stream_first_byte\"") != std::string::npos);
+  assert(json.find("\"ts\":150") != std::string::npos);
+
+  assert(TraceToChromeJson({}) ==
+         "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}");
+
+  std::println("PASSED");
+}
+
+int main() {
+  std::println("=== Trace Unit Tests ===\n");
+
+  TestRingKeepsNewest();
+  TestTraceCall();
+  TestFileRoundTrip();
+  TestChromeJson();
+
+  std::println("\nAll trace tests passed!");
+  return 0;
+}